@@ -521,15 +521,10 @@ void fftviewer_frFFTviewer::StreamingLoop(
                     localDataResults.samplesI[ch][i] = buffers[ch][i].real();
                     localDataResults.samplesQ[ch][i] = buffers[ch][i].imag();
                 }
-            if (fftEnabled)
-            {
-                int samplesRemaining = samplesPopped;
-                while (samplesRemaining > 0 && !pthis->stopProcessing.load())
-                {
-                    samplesRemaining -= fft.PushSamples(buffers, samplesRemaining, samplesPopped - samplesRemaining);
-                }
-            }
         }
+        // never blocks, samples are dropped if the FFT workers can't keep up
+        if (fftEnabled)
+            fft.PushSamples(buffers, samplesPopped, 0);
         ++fftCounter;
         fftEnabled = pthis->enableFFT.load();
 
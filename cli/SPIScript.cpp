@@ -0,0 +1,342 @@
+#include "SPIScript.h"
+
+#include "limesuiteng/SDRDescriptor.h"
+#include "utilities/toString.h"
+
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+using namespace lime;
+using namespace std::literals::string_literals;
+using namespace std::literals::string_view_literals;
+
+static constexpr uint32_t spiWriteBit = 1 << 31;
+static constexpr uint32_t defaultPollTimeout_ms = 1000;
+// gives the hardware time to change the polled value, without flooding the bus with reads
+static constexpr std::chrono::milliseconds pollInterval{ 1 };
+
+static bool ParseNumber(const std::string& token, uint32_t maximum, int base, uint32_t& number)
+{
+    try
+    {
+        std::size_t end = 0;
+        const unsigned long value = std::stoul(token, &end, base);
+        if (end != token.size() || value > maximum)
+            return false;
+        number = value;
+        return true;
+    } catch (const std::logic_error&)
+    {
+        return false;
+    }
+}
+
+/**
+  @brief Parses the script, replacing the previously parsed operations.
+  @param text The script, lines can also be separated by ';'.
+  @param[out] error The description of the first invalid line.
+  @return Whether the whole script is valid.
+ */
+bool SPIScript::Parse(std::string_view text, std::string& error)
+{
+    mOperations.clear();
+    int lineNumber = 0;
+    int nextLineNumber = 1;
+    while (!text.empty())
+    {
+        const std::size_t lineEnd = text.find_first_of("\n;"sv);
+        std::string line{ text.substr(0, lineEnd) };
+        lineNumber = nextLineNumber;
+        if (lineEnd != std::string_view::npos && text[lineEnd] == '\n')
+            ++nextLineNumber;
+        text = lineEnd == std::string_view::npos ? std::string_view{} : text.substr(lineEnd + 1);
+
+        const std::size_t comment = line.find('#');
+        if (comment != std::string::npos)
+            line.erase(comment);
+        for (char& c : line)
+        {
+            if (c == ',')
+                c = ' ';
+        }
+
+        std::istringstream tokens(line);
+        std::vector<std::string> words;
+        for (std::string word; tokens >> word;)
+            words.push_back(word);
+        if (words.empty())
+            continue;
+
+        auto Fail = [&](std::string_view reason) {
+            error = "line "s + std::to_string(lineNumber) + ": "s + std::string{ reason } + ": "s + line;
+            mOperations.clear();
+            return false;
+        };
+
+        const std::string& keyword = words[0];
+        Operation operation{};
+        operation.line = lineNumber;
+        std::vector<uint32_t> numbers;
+        for (std::size_t i = 1; i < words.size() && keyword != "chip"sv; ++i)
+        {
+            uint32_t number = 0;
+            // poll timeouts and delays are decimal milliseconds, the rest is hexadecimal registers
+            const bool milliseconds = keyword == "delay"sv || (keyword == "poll"sv && i == 4);
+            if (!ParseNumber(words[i], milliseconds ? UINT32_MAX : 0xFFFF, milliseconds ? 10 : 16, number))
+                return Fail("invalid number "s + words[i]);
+            numbers.push_back(number);
+        }
+
+        if (keyword == "read"sv)
+        {
+            if (numbers.empty())
+                return Fail("expected read ADDR [ADDR...]"sv);
+            operation.type = OperationType::Read;
+            for (uint32_t address : numbers)
+            {
+                operation.address = address;
+                mOperations.push_back(operation);
+            }
+            continue;
+        }
+
+        if (keyword == "write"sv)
+        {
+            if (numbers.size() != 2)
+                return Fail("expected write ADDR VALUE"sv);
+            operation.type = OperationType::Write;
+            operation.address = numbers[0];
+            operation.value = numbers[1];
+        }
+        else if (keyword == "modify"sv)
+        {
+            if (numbers.size() != 3)
+                return Fail("expected modify ADDR MASK VALUE"sv);
+            operation.type = OperationType::Modify;
+            operation.address = numbers[0];
+            operation.mask = numbers[1];
+            operation.value = numbers[2];
+        }
+        else if (keyword == "poll"sv)
+        {
+            if (numbers.size() != 3 && numbers.size() != 4)
+                return Fail("expected poll ADDR MASK VALUE [TIMEOUT_MS]"sv);
+            operation.type = OperationType::Poll;
+            operation.address = numbers[0];
+            operation.mask = numbers[1];
+            operation.value = numbers[2];
+            operation.time_ms = numbers.size() == 4 ? numbers[3] : defaultPollTimeout_ms;
+            // such a poll could never succeed
+            if (operation.value & ~operation.mask)
+                return Fail("value has bits outside of the mask"sv);
+        }
+        else if (keyword == "delay"sv)
+        {
+            if (numbers.size() != 1)
+                return Fail("expected delay MS"sv);
+            operation.type = OperationType::Delay;
+            operation.time_ms = numbers[0];
+        }
+        else if (keyword == "chip"sv)
+        {
+            if (words.size() != 2)
+                return Fail("expected chip NAME"sv);
+            operation.type = OperationType::Chip;
+            operation.chip = words[1];
+        }
+        else
+            return Fail("unknown operation"sv);
+        mOperations.push_back(operation);
+    }
+    return true;
+}
+
+static std::string Describe(const SPIScript::Operation& operation, uint16_t readValue)
+{
+    std::ostringstream text;
+    text << std::hex << std::setfill('0');
+    switch (operation.type)
+    {
+    case SPIScript::OperationType::Read:
+        text << "read   "sv << std::setw(4) << operation.address << " = "sv << std::setw(4) << readValue;
+        break;
+    case SPIScript::OperationType::Write:
+        text << "write  "sv << std::setw(4) << operation.address << " "sv << std::setw(4) << operation.value;
+        break;
+    case SPIScript::OperationType::Modify:
+        text << "modify "sv << std::setw(4) << operation.address << " mask "sv << std::setw(4) << operation.mask << ": "sv
+             << std::setw(4) << readValue << " -> "sv << std::setw(4)
+             << ((readValue & ~operation.mask) | (operation.value & operation.mask));
+        break;
+    case SPIScript::OperationType::Poll:
+        text << "poll   "sv << std::setw(4) << operation.address << " mask "sv << std::setw(4) << operation.mask << " == "sv
+             << std::setw(4) << operation.value << ": "sv << std::setw(4) << readValue;
+        break;
+    case SPIScript::OperationType::Delay:
+        text << std::dec << "delay  "sv << operation.time_ms << " ms"sv;
+        break;
+    case SPIScript::OperationType::Chip:
+        text << "chip   "sv << operation.chip;
+        break;
+    }
+    return text.str();
+}
+
+/**
+  @brief Executes the parsed operations, stops at the first failure.
+  @param device The device to execute the operations on.
+  @param chipSelect The chip the operations go to, until changed by the script.
+  @param output The destination of the report of each of the operations and its timing.
+  @param[out] error The description of the failure.
+  @return Whether all of the operations were executed.
+ */
+bool SPIScript::Run(SDRDevice* device, int32_t chipSelect, std::ostream& output, std::string& error)
+{
+    // the words of the pending transaction, and the operation each of them belongs to
+    std::vector<uint32_t> mosi;
+    std::vector<uint32_t> miso;
+    std::vector<std::size_t> owners;
+    std::vector<uint16_t> readValues(mOperations.size());
+    int transactions = 0;
+    const auto scriptStart = std::chrono::steady_clock::now();
+
+    auto Report = [&](std::size_t index, double duration_ms, std::string_view details) {
+        const Operation& operation = mOperations[index];
+        output << std::setw(4) << std::setfill(' ') << std::dec << operation.line << "  "sv << std::left << std::setw(40)
+               << Describe(operation, readValues[index]) << std::right << std::fixed << std::setprecision(3) << duration_ms
+               << " ms"sv << details << std::endl;
+    };
+
+    auto Transfer = [&](const uint32_t* words, uint32_t* results, std::size_t count) {
+        OpStatus status = OpStatus::Error;
+        try
+        {
+            status = device->SPI(chipSelect, words, results, count);
+        } catch (const std::runtime_error& e)
+        {
+            error = "SPI failed: "s + e.what();
+            return false;
+        }
+        if (status != OpStatus::Success)
+        {
+            error = "SPI failed: "s + ToString(status);
+            return false;
+        }
+        ++transactions;
+        return true;
+    };
+
+    // sends the pending words in a single transaction, reports the operations completed by it
+    auto Flush = [&]() {
+        if (mosi.empty())
+            return true;
+        miso.assign(mosi.size(), 0);
+        const auto start = std::chrono::steady_clock::now();
+        if (!Transfer(mosi.data(), miso.data(), mosi.size()))
+            return false;
+        const double duration_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        const std::string details = " (transaction "s + std::to_string(transactions) + ")"s;
+        for (std::size_t i = 0; i < mosi.size(); ++i)
+        {
+            const Operation& operation = mOperations[owners[i]];
+            const bool isWrite = mosi[i] & spiWriteBit;
+            if (!isWrite)
+                readValues[owners[i]] = miso[i];
+            // the read parts of modify and poll are completed by the caller
+            if (operation.type == OperationType::Read || operation.type == OperationType::Write ||
+                (operation.type == OperationType::Modify && isWrite))
+                Report(owners[i], duration_ms, details);
+        }
+        mosi.clear();
+        owners.clear();
+        return true;
+    };
+
+    auto Queue = [&](std::size_t index, uint32_t word) {
+        mosi.push_back(word);
+        owners.push_back(index);
+    };
+
+    for (std::size_t i = 0; i < mOperations.size(); ++i)
+    {
+        const Operation& operation = mOperations[i];
+        const uint32_t address = static_cast<uint32_t>(operation.address) << 16;
+        switch (operation.type)
+        {
+        case OperationType::Read:
+            Queue(i, operation.address);
+            break;
+        case OperationType::Write:
+            Queue(i, spiWriteBit | address | operation.value);
+            break;
+        case OperationType::Modify: {
+            // the read joins the pending transaction, the write starts the next one
+            Queue(i, operation.address);
+            if (!Flush())
+                return false;
+            const uint16_t value = (readValues[i] & ~operation.mask) | (operation.value & operation.mask);
+            Queue(i, spiWriteBit | address | value);
+            break;
+        }
+        case OperationType::Poll: {
+            const auto start = std::chrono::steady_clock::now();
+            Queue(i, operation.address);
+            if (!Flush())
+                return false;
+            int reads = 1;
+            while ((readValues[i] & operation.mask) != operation.value)
+            {
+                if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(operation.time_ms))
+                {
+                    error = "line "s + std::to_string(operation.line) + ": poll timed out, "s + Describe(operation, readValues[i]);
+                    return false;
+                }
+                std::this_thread::sleep_for(pollInterval);
+                uint32_t word = operation.address;
+                uint32_t result = 0;
+                if (!Transfer(&word, &result, 1))
+                    return false;
+                readValues[i] = result;
+                ++reads;
+            }
+            Report(i,
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(),
+                " ("s + std::to_string(reads) + " reads)"s);
+            break;
+        }
+        case OperationType::Delay: {
+            if (!Flush())
+                return false;
+            const auto start = std::chrono::steady_clock::now();
+            std::this_thread::sleep_for(std::chrono::milliseconds(operation.time_ms));
+            Report(i, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(), ""sv);
+            break;
+        }
+        case OperationType::Chip: {
+            if (!Flush())
+                return false;
+            const auto& chips = device->GetDescriptor().spiSlaveIds;
+            const auto chip = chips.find(operation.chip);
+            if (chip == chips.end())
+            {
+                error = "line "s + std::to_string(operation.line) + ": device does not contain chip "s + operation.chip;
+                return false;
+            }
+            chipSelect = chip->second;
+            Report(i, 0, ""sv);
+            break;
+        }
+        }
+    }
+    if (!Flush())
+        return false;
+
+    const double total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - scriptStart).count();
+    output << std::dec << mOperations.size() << " operations in "sv << transactions << " SPI transactions, "sv << std::fixed
+           << std::setprecision(3) << total_ms << " ms"sv << std::endl;
+    return true;
+}
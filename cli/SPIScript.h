@@ -0,0 +1,56 @@
+#ifndef LIMESUITENG_CLI_SPISCRIPT_H
+#define LIMESUITENG_CLI_SPISCRIPT_H
+
+#include "limesuiteng/SDRDevice.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/** @brief A sequence of register operations, executed in as few SPI transactions as their ordering allows.
+
+  The script has one operation per line, the numbers are hexadecimal, everything after '#' is a comment:
+  - read ADDR [ADDR...]
+  - write ADDR VALUE
+  - modify ADDR MASK VALUE - writes the masked bits of the value, keeps the rest of the register
+  - poll ADDR MASK VALUE [TIMEOUT_MS] - reads every millisecond until the masked bits equal the value,
+    the value must be within the mask (default timeout 1000 ms)
+  - delay MS
+  - chip NAME - sends the following operations to another chip
+
+  The operations are never reordered. Consecutive reads and writes are sent in a single transaction,
+  which ends only where a following operation needs a value that was read (modify, poll) or host side timing (delay).
+ */
+class SPIScript
+{
+  public:
+    /** @brief The types of the script operations. */
+    enum class OperationType : uint8_t { Read, Write, Modify, Poll, Delay, Chip };
+
+    /** @brief A single operation of the script. */
+    struct Operation {
+        OperationType type;
+        int line; ///< The line of the script the operation is from.
+        uint16_t address;
+        uint16_t mask;
+        uint16_t value;
+        uint32_t time_ms; ///< The timeout of a poll, or the duration of a delay.
+        std::string chip;
+    };
+
+    bool Parse(std::string_view text, std::string& error);
+    bool Run(lime::SDRDevice* device, int32_t chipSelect, std::ostream& output, std::string& error);
+
+    /**
+      @brief Gets the parsed operations.
+      @return The operations, in the order of the script.
+     */
+    const std::vector<Operation>& GetOperations() const { return mOperations; }
+
+  private:
+    std::vector<Operation> mOperations;
+};
+
+#endif
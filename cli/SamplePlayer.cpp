@@ -0,0 +1,264 @@
+#include "SamplePlayer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+using namespace lime;
+using namespace std::literals::string_literals;
+
+// The amount of samples of each channel read at once.
+static constexpr uint32_t targetSamplesInSlot = 1 << 18;
+
+/**
+  @brief Constructs the player, the files are opened by Start().
+  @param settings The playback settings.
+ */
+SamplePlayer::SamplePlayer(const Settings& settings)
+    : mSettings(settings)
+    , mSamplesInSlot(targetSamplesInSlot)
+    , mLength(0)
+    , mPosition(0)
+    , mSlotOffset(0)
+    , mHead(0)
+    , mTail(0)
+    , mEndOfFiles(false)
+    , mStop(false)
+    , mSamplesPlayed(0)
+    , mBytesRead(0)
+    , mUnderruns(0)
+    , mLoops(0)
+    , mReadTime_ns(0)
+{
+    mSettings.channelCount = std::max<uint8_t>(mSettings.channelCount, 1);
+    if (!mSettings.splitChannels || mSettings.channelCount == 1)
+    {
+        mSettings.splitChannels = false;
+        mPaths.push_back(mSettings.path);
+        return;
+    }
+
+    const std::filesystem::path path(mSettings.path);
+    for (uint8_t i = 0; i < mSettings.channelCount; ++i)
+    {
+        const std::string name = path.stem().string() + "_ch"s + std::to_string(i) + path.extension().string();
+        mPaths.push_back((path.parent_path() / name).string());
+    }
+}
+
+SamplePlayer::~SamplePlayer()
+{
+    Stop();
+}
+
+/**
+  @brief Opens the files, starts the read ahead and waits for the ring buffer to fill up.
+  The wait is limited by the size of the ring buffer, not by the size of the files.
+  @param[out] error The description of the failure.
+  @return Whether the playback was started.
+ */
+bool SamplePlayer::Start(std::string& error)
+{
+    const std::size_t frameSize = sizeof(complex16_t) * (mSettings.splitChannels ? 1 : mSettings.channelCount);
+    mLength = UINT64_MAX;
+    for (const std::string& path : mPaths)
+    {
+        std::error_code ec;
+        const uintmax_t size = std::filesystem::file_size(path, ec);
+        mFiles.emplace_back(path, std::ifstream::in | std::ifstream::binary);
+        if (ec || !mFiles.back())
+        {
+            error = "Failed to open file: "s + path;
+            return false;
+        }
+        // an incomplete trailing frame is ignored, as are the extra samples of a longer channel file
+        mLength = std::min<uint64_t>(mLength, size / frameSize);
+    }
+    if (mLength == 0)
+    {
+        error = "No samples in file: "s + mSettings.path;
+        return false;
+    }
+
+    const std::size_t slotCount =
+        std::max<std::size_t>(mSettings.bufferSize / (mSamplesInSlot * sizeof(complex16_t) * mSettings.channelCount), 2);
+    mSlots.resize(slotCount);
+    for (Slot& slot : mSlots)
+    {
+        slot.samples = 0;
+        slot.blocks.resize(mSettings.channelCount, std::vector<complex16_t>(mSamplesInSlot));
+    }
+    if (!mSettings.splitChannels)
+        mInterleaved.resize(mSamplesInSlot * mSettings.channelCount);
+
+    mReader = std::thread(&SamplePlayer::ReadLoop, this);
+    while (mHead.load(std::memory_order_acquire) < mSlots.size() && !mEndOfFiles.load(std::memory_order_acquire))
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return true;
+}
+
+/**
+  @brief Takes the next samples of the playback, without waiting for the storage.
+  @param samples The destination buffers of each of the channels.
+  @param count The amount of samples per channel wanted.
+  @return The amount of samples per channel returned, less than count if the read ahead fell behind or at the end.
+ */
+uint32_t SamplePlayer::Read(complex16_t* const* samples, uint32_t count)
+{
+    if (mSlots.empty())
+        return 0;
+
+    uint32_t produced = 0;
+    while (produced < count)
+    {
+        const uint64_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail == mHead.load(std::memory_order_acquire))
+            break;
+
+        Slot& slot = mSlots[tail % mSlots.size()];
+        const uint32_t toCopy = std::min(count - produced, slot.samples - mSlotOffset);
+        for (uint8_t ch = 0; ch < mSettings.channelCount; ++ch)
+            std::memcpy(samples[ch] + produced, slot.blocks[ch].data() + mSlotOffset, toCopy * sizeof(complex16_t));
+        produced += toCopy;
+        mSlotOffset += toCopy;
+        if (mSlotOffset == slot.samples)
+        {
+            mSlotOffset = 0;
+            mTail.store(tail + 1, std::memory_order_release);
+            mSlotFreed.notify_one();
+        }
+    }
+
+    if (produced < count && !IsFinished())
+        mUnderruns.fetch_add(1, std::memory_order_relaxed);
+    mSamplesPlayed.fetch_add(produced, std::memory_order_relaxed);
+    return produced;
+}
+
+/**
+  @brief Gets whether all of the samples have been played.
+  @return True if the end of the files was reached and all their samples were returned, never when looping.
+ */
+bool SamplePlayer::IsFinished() const
+{
+    return mEndOfFiles.load(std::memory_order_acquire) &&
+           mTail.load(std::memory_order_relaxed) == mHead.load(std::memory_order_acquire);
+}
+
+/** @brief Stops the read ahead and closes the files. */
+void SamplePlayer::Stop()
+{
+    if (!mReader.joinable())
+        return;
+
+    {
+        std::unique_lock lck{ mMutex };
+        mStop = true;
+    }
+    mSlotFreed.notify_one();
+    mReader.join();
+    mFiles.clear();
+}
+
+void SamplePlayer::ReadLoop()
+{
+    std::unique_lock lck{ mMutex };
+    while (!mStop && !mEndOfFiles.load(std::memory_order_relaxed))
+    {
+        const uint64_t head = mHead.load(std::memory_order_relaxed);
+        if (head - mTail.load(std::memory_order_acquire) >= mSlots.size())
+        {
+            // the consumer doesn't lock when freeing the slots, so don't rely on the notification alone
+            mSlotFreed.wait_for(lck, std::chrono::milliseconds(10));
+            continue;
+        }
+        lck.unlock();
+
+        Slot& slot = mSlots[head % mSlots.size()];
+        const auto t1 = std::chrono::steady_clock::now();
+        const bool more = FillSlot(slot);
+        mReadTime_ns.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t1).count(),
+            std::memory_order_relaxed);
+        if (slot.samples > 0)
+            mHead.store(head + 1, std::memory_order_release);
+        if (!more)
+            mEndOfFiles.store(true, std::memory_order_release);
+
+        lck.lock();
+    }
+}
+
+// Reads the next samples of the files into the slot, from the beginning again when looping.
+// Returns false at the end of the files.
+bool SamplePlayer::FillSlot(Slot& slot)
+{
+    slot.samples = 0;
+    while (slot.samples < mSamplesInSlot)
+    {
+        if (mPosition == mLength)
+        {
+            if (!mSettings.loop)
+                return false;
+            for (std::ifstream& file : mFiles)
+            {
+                file.clear();
+                file.seekg(0);
+            }
+            mPosition = 0;
+            mLoops.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        const uint32_t toRead = std::min<uint64_t>(mSamplesInSlot - slot.samples, mLength - mPosition);
+        bool success = true;
+        if (mSettings.splitChannels)
+        {
+            for (uint8_t ch = 0; ch < mSettings.channelCount; ++ch)
+            {
+                mFiles[ch].read(reinterpret_cast<char*>(slot.blocks[ch].data() + slot.samples), toRead * sizeof(complex16_t));
+                success &= static_cast<bool>(mFiles[ch]);
+            }
+        }
+        else
+        {
+            const uint8_t channelCount = mSettings.channelCount;
+            mFiles[0].read(reinterpret_cast<char*>(mInterleaved.data()), toRead * channelCount * sizeof(complex16_t));
+            success = static_cast<bool>(mFiles[0]);
+            for (uint8_t ch = 0; ch < channelCount; ++ch)
+            {
+                complex16_t* dest = slot.blocks[ch].data() + slot.samples;
+                for (uint32_t i = 0; i < toRead; ++i)
+                    dest[i] = mInterleaved[i * channelCount + ch];
+            }
+        }
+        if (!success)
+        {
+            std::cerr << "Failed to read file: " << mSettings.path << std::endl;
+            return false;
+        }
+
+        mBytesRead.fetch_add(static_cast<uint64_t>(toRead) * sizeof(complex16_t) * mSettings.channelCount,
+            std::memory_order_relaxed);
+        slot.samples += toRead;
+        mPosition += toRead;
+    }
+    return true;
+}
+
+/**
+  @brief Gets the playback statistics.
+  @return The statistics, can be called while playing.
+ */
+SamplePlayer::Stats SamplePlayer::GetStats() const
+{
+    Stats stats;
+    stats.samplesPlayed = mSamplesPlayed.load(std::memory_order_relaxed);
+    stats.bytesRead = mBytesRead.load(std::memory_order_relaxed);
+    stats.underruns = mUnderruns.load(std::memory_order_relaxed);
+    stats.loops = mLoops.load(std::memory_order_relaxed);
+    const uint64_t readTime = mReadTime_ns.load(std::memory_order_relaxed);
+    stats.readRate_Bps = readTime ? stats.bytesRead * 1e9 / readTime : 0;
+    return stats;
+}
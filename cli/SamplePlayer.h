@@ -0,0 +1,95 @@
+#ifndef LIMESUITENG_CLI_SAMPLEPLAYER_H
+#define LIMESUITENG_CLI_SAMPLEPLAYER_H
+
+#include "limesuiteng/complex.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** @brief Plays samples from files, read ahead in large chunks by a background thread.
+
+  Only a fixed size ring buffer is held in memory, so the start-up time and the memory use don't depend
+  on the size of the files. The transmitting thread never waits for the storage: if the read ahead falls
+  behind, fewer samples are returned and the shortfall is counted.
+ */
+class SamplePlayer
+{
+  public:
+    /** @brief The playback settings. */
+    struct Settings {
+        std::string path; ///< The file to play, channel files have "_chN" inserted before the extension.
+        uint8_t channelCount{ 1 }; ///< The amount of channels in the files.
+        bool splitChannels{ false }; ///< Whether each channel is in a separate file instead of being interleaved.
+        bool loop{ false }; ///< Whether to restart from the beginning at the end of the files.
+        std::size_t bufferSize{ 64 << 20 }; ///< The size of the ring buffer (in bytes).
+    };
+
+    /** @brief The playback statistics. */
+    struct Stats {
+        uint64_t samplesPlayed; ///< The amount of samples per channel returned by Read().
+        uint64_t bytesRead; ///< The amount of bytes read from the files.
+        uint64_t underruns; ///< The amount of Read() calls that got fewer samples than requested before the end.
+        uint32_t loops; ///< The amount of times the playback restarted from the beginning.
+        double readRate_Bps; ///< The average rate of the reads, while reading (bytes per second).
+    };
+
+    explicit SamplePlayer(const Settings& settings);
+    ~SamplePlayer();
+
+    bool Start(std::string& error);
+    uint32_t Read(lime::complex16_t* const* samples, uint32_t count);
+    bool IsFinished() const;
+    void Stop();
+
+    /**
+      @brief Gets the amount of samples per channel in the files.
+      @return The length of a single pass of the playback.
+     */
+    uint64_t GetLength() const { return mLength; }
+
+    Stats GetStats() const;
+
+  private:
+    /** @brief A slot of the ring, holds a block of each of the files. */
+    struct Slot {
+        std::vector<std::vector<lime::complex16_t>> blocks;
+        uint32_t samples; ///< The amount of samples per channel in the slot.
+    };
+
+    void ReadLoop();
+    bool FillSlot(Slot& slot);
+
+    Settings mSettings;
+    uint32_t mSamplesInSlot;
+    uint64_t mLength;
+    uint64_t mPosition; ///< The position of the read ahead in the files (in samples per channel).
+
+    std::vector<std::string> mPaths;
+    std::vector<std::ifstream> mFiles;
+    std::vector<lime::complex16_t> mInterleaved; ///< The read buffer of an interleaved file.
+    std::vector<Slot> mSlots;
+    uint32_t mSlotOffset; ///< The amount of samples already returned from the slot at mTail.
+
+    // single producer, single consumer: the reader fills the slot at mHead, the transmitting thread empties mTail
+    std::atomic<uint64_t> mHead;
+    std::atomic<uint64_t> mTail;
+    std::atomic<bool> mEndOfFiles;
+    std::mutex mMutex;
+    std::condition_variable mSlotFreed;
+    std::thread mReader;
+    bool mStop;
+
+    std::atomic<uint64_t> mSamplesPlayed;
+    std::atomic<uint64_t> mBytesRead;
+    std::atomic<uint64_t> mUnderruns;
+    std::atomic<uint32_t> mLoops;
+    std::atomic<uint64_t> mReadTime_ns;
+};
+
+#endif
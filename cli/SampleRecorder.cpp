@@ -0,0 +1,368 @@
+#include "SampleRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fcntl.h>
+#include <iostream>
+
+#ifdef _WIN32
+    #include <io.h>
+    #include <malloc.h>
+#else
+    #include <unistd.h>
+#endif
+
+using namespace lime;
+using namespace std::literals::string_literals;
+
+// Direct I/O requires the buffers, the sizes and the file offsets to be multiples of the storage block size.
+static constexpr std::size_t ioAlignment = 4096;
+// The size of the block written to each file at once.
+static constexpr std::size_t targetBlockSize = 1 << 20;
+
+static uint8_t* AllocateAligned(std::size_t size)
+{
+#ifdef _WIN32
+    return static_cast<uint8_t*>(_aligned_malloc(size, ioAlignment));
+#else
+    return static_cast<uint8_t*>(std::aligned_alloc(ioAlignment, size));
+#endif
+}
+
+static void FreeAligned(uint8_t* ptr)
+{
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+static int OpenFile(const std::string& path, bool directIO)
+{
+#ifdef _WIN32
+    return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+    #ifdef O_DIRECT
+    if (directIO)
+        flags |= O_DIRECT;
+    #endif
+    return open(path.c_str(), flags, 0644);
+#endif
+}
+
+static bool WriteFile(int fd, const uint8_t* data, std::size_t size)
+{
+    while (size > 0)
+    {
+#ifdef _WIN32
+        const int written = _write(fd, data, static_cast<unsigned>(std::min<std::size_t>(size, 1 << 30)));
+#else
+        const ssize_t written = write(fd, data, size);
+#endif
+        if (written <= 0)
+            return false;
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+static bool TruncateFile(int fd, uint64_t size)
+{
+#ifdef _WIN32
+    return _chsize_s(fd, size) == 0;
+#else
+    return ftruncate(fd, size) == 0;
+#endif
+}
+
+static void CloseFile(int fd)
+{
+#ifdef _WIN32
+    _close(fd);
+#else
+    close(fd);
+#endif
+}
+
+static std::size_t SampleSize(DataFormat format)
+{
+    switch (format)
+    {
+    case DataFormat::I8:
+        return sizeof(complex8_t);
+    case DataFormat::F16:
+        return sizeof(complex16f_t);
+    default:
+        return sizeof(complex16_t);
+    }
+}
+
+// Converts the samples of a single channel, placing them every stride bytes.
+template<class T, class Convert>
+static void CopyChannel(uint8_t* dest, std::size_t stride, const complex16_t* src, uint32_t count, Convert convert)
+{
+    for (uint32_t i = 0; i < count; ++i)
+        *reinterpret_cast<T*>(dest + i * stride) = convert(src[i]);
+}
+
+static void ConvertChannel(uint8_t* dest, std::size_t stride, const complex16_t* src, uint32_t count, DataFormat format)
+{
+    switch (format)
+    {
+    case DataFormat::I8: {
+        auto reduce = [](int16_t value) { return static_cast<int8_t>(std::min((value + 128) >> 8, 127)); };
+        CopyChannel<complex8_t>(
+            dest, stride, src, count, [&reduce](complex16_t s) { return complex8_t(reduce(s.real()), reduce(s.imag())); });
+        break;
+    }
+    case DataFormat::F16:
+        CopyChannel<complex16f_t>(dest, stride, src, count, [](complex16_t s) {
+            return complex16f_t(s.real() / 32768.0f, s.imag() / 32768.0f);
+        });
+        break;
+    default:
+        CopyChannel<complex16_t>(dest, stride, src, count, [](complex16_t s) { return s; });
+        break;
+    }
+}
+
+/**
+  @brief Constructs the recorder, the files are created by Start().
+  @param settings The recording settings.
+ */
+SampleRecorder::SampleRecorder(const Settings& settings)
+    : mSettings(settings)
+    , mSampleSize(SampleSize(settings.format))
+    , mAlignment(ioAlignment)
+    , mHead(0)
+    , mTail(0)
+    , mStop(false)
+    , mDropping(false)
+    , mSamplesRecorded(0)
+    , mBytesWritten(0)
+    , mSamplesDropped(0)
+    , mDropEvents(0)
+    , mWriteTime_ns(0)
+    , mLongestWrite_ns(0)
+    , mPeakFilledSlots(0)
+{
+    mSettings.channelCount = std::max<uint8_t>(mSettings.channelCount, 1);
+    const std::size_t fileCount = mSettings.splitChannels ? mSettings.channelCount : 1;
+    mFrameSize = mSettings.splitChannels ? mSampleSize : mSampleSize * mSettings.channelCount;
+    // whole blocks are always a multiple of the alignment
+    mSamplesInSlot = std::max<std::size_t>(targetBlockSize / (mAlignment * mFrameSize), 1) * mAlignment;
+
+    if (fileCount == 1)
+        mPaths.push_back(mSettings.path);
+    else
+    {
+        const std::filesystem::path path(mSettings.path);
+        for (std::size_t i = 0; i < fileCount; ++i)
+        {
+            const std::string name = path.stem().string() + "_ch"s + std::to_string(i) + path.extension().string();
+            mPaths.push_back((path.parent_path() / name).string());
+        }
+    }
+}
+
+SampleRecorder::~SampleRecorder()
+{
+    Stop();
+    for (uint8_t* allocation : mAllocations)
+        FreeAligned(allocation);
+}
+
+/**
+  @brief Creates the files, allocates the ring buffer and starts the writer thread.
+  @param[out] error The description of the failure.
+  @return Whether the recording was started.
+ */
+bool SampleRecorder::Start(std::string& error)
+{
+    const std::size_t blockSize = mSamplesInSlot * mFrameSize;
+    const std::size_t slotCount = std::max<std::size_t>(mSettings.bufferSize / (blockSize * mPaths.size()), 2);
+    mSlots.resize(slotCount);
+    for (Slot& slot : mSlots)
+    {
+        slot.samples = 0;
+        for (std::size_t i = 0; i < mPaths.size(); ++i)
+        {
+            uint8_t* block = AllocateAligned(blockSize);
+            if (!block)
+            {
+                error = "Failed to allocate the recording buffer"s;
+                return false;
+            }
+            // touch the memory now, so the page faults don't happen while receiving
+            std::memset(block, 0, blockSize);
+            mAllocations.push_back(block);
+            slot.blocks.push_back(block);
+        }
+    }
+
+    for (const std::string& path : mPaths)
+    {
+        const int fd = OpenFile(path, mSettings.directIO);
+        if (fd < 0)
+        {
+            error = "Failed to open file: "s + path;
+            return false;
+        }
+        mFiles.push_back(fd);
+        mFileSizes.push_back(0);
+    }
+
+    mWriter = std::thread(&SampleRecorder::WriteLoop, this);
+    return true;
+}
+
+/**
+  @brief Queues the samples for writing, without waiting for the storage.
+  @param samples The samples of each of the channels.
+  @param count The amount of samples per channel.
+  @return Whether all of the samples were queued, the rest are dropped if the ring buffer is full.
+ */
+bool SampleRecorder::Push(const complex16_t* const* samples, uint32_t count)
+{
+    if (mFiles.empty())
+        return false;
+
+    uint32_t offset = 0;
+    while (offset < count)
+    {
+        const uint64_t head = mHead.load(std::memory_order_relaxed);
+        if (head - mTail.load(std::memory_order_acquire) >= mSlots.size())
+        {
+            mSamplesDropped.fetch_add(count - offset, std::memory_order_relaxed);
+            if (!mDropping)
+                mDropEvents.fetch_add(1, std::memory_order_relaxed);
+            mDropping = true;
+            return false;
+        }
+        mDropping = false;
+
+        Slot& slot = mSlots[head % mSlots.size()];
+        const uint32_t toCopy = std::min(count - offset, mSamplesInSlot - slot.samples);
+        for (uint8_t ch = 0; ch < mSettings.channelCount; ++ch)
+        {
+            uint8_t* dest = mSettings.splitChannels ? slot.blocks[ch] + slot.samples * mFrameSize
+                                                    : slot.blocks[0] + slot.samples * mFrameSize + ch * mSampleSize;
+            ConvertChannel(dest, mFrameSize, samples[ch] + offset, toCopy, mSettings.format);
+        }
+        slot.samples += toCopy;
+        offset += toCopy;
+        mSamplesRecorded.fetch_add(toCopy, std::memory_order_relaxed);
+
+        if (slot.samples == mSamplesInSlot)
+        {
+            mHead.store(head + 1, std::memory_order_release);
+            const uint64_t filled = head + 1 - mTail.load(std::memory_order_relaxed);
+            if (filled > mPeakFilledSlots.load(std::memory_order_relaxed))
+                mPeakFilledSlots.store(filled, std::memory_order_relaxed);
+            mSlotReady.notify_one();
+        }
+    }
+    return true;
+}
+
+/** @brief Writes out the queued samples, stops the writer thread and closes the files. */
+void SampleRecorder::Stop()
+{
+    if (!mWriter.joinable())
+        return;
+
+    {
+        std::unique_lock lck{ mMutex };
+        // the partially filled slot is written too
+        const uint64_t head = mHead.load(std::memory_order_relaxed);
+        if (head - mTail.load(std::memory_order_acquire) < mSlots.size() && mSlots[head % mSlots.size()].samples > 0)
+            mHead.store(head + 1, std::memory_order_release);
+        mStop = true;
+    }
+    mSlotReady.notify_one();
+    mWriter.join();
+
+    for (int fd : mFiles)
+        CloseFile(fd);
+    mFiles.clear();
+}
+
+void SampleRecorder::WriteLoop()
+{
+    std::unique_lock lck{ mMutex };
+    while (true)
+    {
+        // the producer doesn't lock when publishing, so don't rely on the notification alone
+        mSlotReady.wait_for(lck, std::chrono::milliseconds(10), [this] {
+            return mStop || mTail.load(std::memory_order_relaxed) != mHead.load(std::memory_order_acquire);
+        });
+        const uint64_t tail = mTail.load(std::memory_order_relaxed);
+        if (tail == mHead.load(std::memory_order_acquire))
+        {
+            if (mStop)
+                break;
+            continue;
+        }
+        lck.unlock();
+
+        Slot& slot = mSlots[tail % mSlots.size()];
+        const auto t1 = std::chrono::steady_clock::now();
+        WriteSlot(slot);
+        const uint64_t duration =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t1).count();
+        mWriteTime_ns.fetch_add(duration, std::memory_order_relaxed);
+        if (duration > mLongestWrite_ns.load(std::memory_order_relaxed))
+            mLongestWrite_ns.store(duration, std::memory_order_relaxed);
+
+        slot.samples = 0;
+        mTail.store(tail + 1, std::memory_order_release);
+        lck.lock();
+    }
+}
+
+bool SampleRecorder::WriteSlot(Slot& slot)
+{
+    const std::size_t size = slot.samples * mFrameSize;
+    // only the last slot can be partial, it's padded to the alignment and the padding is cut off afterwards
+    const std::size_t writeSize = mSettings.directIO ? (size + mAlignment - 1) / mAlignment * mAlignment : size;
+    bool success = true;
+    for (std::size_t i = 0; i < mFiles.size(); ++i)
+    {
+        std::memset(slot.blocks[i] + size, 0, writeSize - size);
+        if (!WriteFile(mFiles[i], slot.blocks[i], writeSize))
+        {
+            std::cerr << "Failed to write file: " << mPaths[i] << std::endl;
+            success = false;
+            continue;
+        }
+        mFileSizes[i] += size;
+        if (writeSize != size && !TruncateFile(mFiles[i], mFileSizes[i]))
+            success = false;
+        mBytesWritten.fetch_add(size, std::memory_order_relaxed);
+    }
+    return success;
+}
+
+/**
+  @brief Gets the recording statistics.
+  @return The statistics, can be called while recording.
+ */
+SampleRecorder::Stats SampleRecorder::GetStats() const
+{
+    Stats stats;
+    stats.samplesRecorded = mSamplesRecorded.load(std::memory_order_relaxed);
+    stats.bytesWritten = mBytesWritten.load(std::memory_order_relaxed);
+    stats.samplesDropped = mSamplesDropped.load(std::memory_order_relaxed);
+    stats.dropEvents = mDropEvents.load(std::memory_order_relaxed);
+    const uint64_t writeTime = mWriteTime_ns.load(std::memory_order_relaxed);
+    stats.writeRate_Bps = writeTime ? stats.bytesWritten * 1e9 / writeTime : 0;
+    stats.longestWrite_s = mLongestWrite_ns.load(std::memory_order_relaxed) / 1e9;
+    stats.peakFill = mSlots.empty() ? 0 : static_cast<float>(mPeakFilledSlots.load(std::memory_order_relaxed)) / mSlots.size();
+    return stats;
+}
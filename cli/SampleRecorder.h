@@ -0,0 +1,94 @@
+#ifndef LIMESUITENG_CLI_SAMPLERECORDER_H
+#define LIMESUITENG_CLI_SAMPLERECORDER_H
+
+#include "limesuiteng/complex.h"
+#include "limesuiteng/types.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** @brief Records received samples to files from a dedicated writer thread.
+
+  The samples are converted and copied into a large preallocated ring of aligned blocks by the receiving thread,
+  which never waits for the storage: if the ring is full the samples are dropped and counted instead.
+  The writer thread writes whole blocks, optionally bypassing the page cache (O_DIRECT on Linux).
+ */
+class SampleRecorder
+{
+  public:
+    /** @brief The recording settings. */
+    struct Settings {
+        std::string path; ///< The file to record to, channel files get "_chN" inserted before the extension.
+        uint8_t channelCount{ 1 }; ///< The amount of channels to record.
+        lime::DataFormat format{ lime::DataFormat::I16 }; ///< The format of the samples in the files.
+        bool splitChannels{ false }; ///< Whether to record each channel to a separate file instead of interleaving them.
+        bool directIO{ false }; ///< Whether to bypass the operating system's page cache.
+        std::size_t bufferSize{ 256 << 20 }; ///< The size of the ring buffer (in bytes).
+    };
+
+    /** @brief The recording statistics. */
+    struct Stats {
+        uint64_t samplesRecorded; ///< The amount of samples per channel given to the recorder and queued for writing.
+        uint64_t bytesWritten; ///< The amount of bytes written to the files.
+        uint64_t samplesDropped; ///< The amount of samples per channel dropped because the ring buffer was full.
+        uint32_t dropEvents; ///< The amount of times samples were dropped.
+        double writeRate_Bps; ///< The average rate of the writes, while writing (bytes per second).
+        double longestWrite_s; ///< The duration of the slowest block write.
+        float peakFill; ///< The highest ring buffer fill ratio (0 - empty, 1 - full).
+    };
+
+    explicit SampleRecorder(const Settings& settings);
+    ~SampleRecorder();
+
+    bool Start(std::string& error);
+    bool Push(const lime::complex16_t* const* samples, uint32_t count);
+    void Stop();
+
+    Stats GetStats() const;
+
+  private:
+    /** @brief A slot of the ring, holds a block for each of the files. */
+    struct Slot {
+        std::vector<uint8_t*> blocks;
+        uint32_t samples; ///< The amount of samples per channel in the slot.
+    };
+
+    void WriteLoop();
+    bool WriteSlot(Slot& slot);
+
+    Settings mSettings;
+    std::size_t mSampleSize;
+    std::size_t mFrameSize; ///< The size of the samples of all the channels written to a single file.
+    std::size_t mAlignment;
+    uint32_t mSamplesInSlot;
+
+    std::vector<std::string> mPaths;
+    std::vector<int> mFiles;
+    std::vector<uint64_t> mFileSizes;
+    std::vector<Slot> mSlots;
+    std::vector<uint8_t*> mAllocations;
+
+    // single producer, single consumer: the receiving thread fills the slot at mHead, the writer frees mTail
+    std::atomic<uint64_t> mHead;
+    std::atomic<uint64_t> mTail;
+    std::mutex mMutex;
+    std::condition_variable mSlotReady;
+    std::thread mWriter;
+    bool mStop;
+    bool mDropping;
+
+    std::atomic<uint64_t> mSamplesRecorded;
+    std::atomic<uint64_t> mBytesWritten;
+    std::atomic<uint64_t> mSamplesDropped;
+    std::atomic<uint32_t> mDropEvents;
+    std::atomic<uint64_t> mWriteTime_ns;
+    std::atomic<uint64_t> mLongestWrite_ns;
+    std::atomic<uint64_t> mPeakFilledSlots;
+};
+
+#endif
@@ -0,0 +1,228 @@
+#include "SampleRepeater.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+using namespace lime;
+
+// The amount of samples of each channel the monitor buffer holds.
+static constexpr uint32_t monitorSize = 1 << 18;
+// How often the stream statistics are checked.
+static constexpr std::chrono::milliseconds supervisionPeriod(100);
+// Late packets already in flight get reported after a raise, don't raise again for them.
+static constexpr double raiseHoldoff_s = 0.5;
+// The estimate covers the 99.9th percentile latencies, the margin covers the rest of the tail.
+static constexpr double safetyMargin = 1.25;
+
+/**
+  @brief Constructs the repeater, the forwarding starts with Start().
+  @param stream The stream operations, the stream has to be already set up.
+  @param settings The repeater settings.
+ */
+SampleRepeater::SampleRepeater(const Stream& stream, const Settings& settings)
+    : mStream(stream)
+    , mSettings(settings)
+    , mAutomatic(settings.delay < 0)
+    , mMonitor(settings.channelCount, std::vector<complex16_t>(monitorSize))
+    , mMonitorWritten(0)
+    , mMonitorRead(0)
+    , mStop(false)
+    , mForwardingAge{}
+    , mLateAtStart(0)
+    , mLastRaise_s(-raiseHoldoff_s)
+    , mDelay(settings.delay)
+    , mEstimate(0)
+    , mSamplesForwarded(0)
+    , mSamplesSkipped(0)
+    , mMonitorDropped(0)
+    , mLate(0)
+    , mDelayIncreases(0)
+    , mForwardingAge_us(0)
+{
+    // until the pipeline is measured, start with a delay that any host should manage
+    if (mAutomatic)
+        mDelay = std::max<int64_t>(mSettings.sampleRate * 0.005, 4 * mSettings.blockSize);
+}
+
+SampleRepeater::~SampleRepeater()
+{
+    Stop();
+}
+
+/** @brief Starts the forwarding thread, the stream has to be already started. */
+void SampleRepeater::Start()
+{
+    mStop = false;
+    mForwarder = std::thread(&SampleRepeater::ForwardLoop, this);
+}
+
+/** @brief Stops the forwarding thread, before the stream is stopped. */
+void SampleRepeater::Stop()
+{
+    mStop = true;
+    if (mForwarder.joinable())
+        mForwarder.join();
+}
+
+/**
+  @brief Takes the received samples from the monitor buffer, waits until enough are available.
+  @param samples The destination buffers of each of the channels.
+  @param count The amount of samples per channel wanted.
+  @param stop Ends the waiting early when set.
+  @return The amount of samples per channel returned.
+ */
+uint32_t SampleRepeater::Read(complex16_t* const* samples, uint32_t count, const std::atomic<bool>& stop)
+{
+    count = std::min(count, monitorSize);
+    const uint64_t read = mMonitorRead.load(std::memory_order_relaxed);
+    uint64_t written = mMonitorWritten.load(std::memory_order_acquire);
+    while (written - read < count && !stop.load(std::memory_order_relaxed) && !mStop.load(std::memory_order_relaxed))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        written = mMonitorWritten.load(std::memory_order_acquire);
+    }
+
+    const uint32_t available = std::min<uint64_t>(count, written - read);
+    const uint32_t offset = read % monitorSize;
+    const uint32_t firstPart = std::min(available, monitorSize - offset);
+    for (uint8_t ch = 0; ch < mSettings.channelCount; ++ch)
+    {
+        std::memcpy(samples[ch], mMonitor[ch].data() + offset, firstPart * sizeof(complex16_t));
+        std::memcpy(samples[ch] + firstPart, mMonitor[ch].data(), (available - firstPart) * sizeof(complex16_t));
+    }
+    mMonitorRead.store(read + available, std::memory_order_release);
+    return available;
+}
+
+void SampleRepeater::PushMonitor(const complex16_t* const* samples, uint32_t count)
+{
+    const uint64_t written = mMonitorWritten.load(std::memory_order_relaxed);
+    if (written - mMonitorRead.load(std::memory_order_acquire) + count > monitorSize)
+    {
+        mMonitorDropped.fetch_add(count, std::memory_order_relaxed);
+        return;
+    }
+
+    const uint32_t offset = written % monitorSize;
+    const uint32_t firstPart = std::min(count, monitorSize - offset);
+    for (uint8_t ch = 0; ch < mSettings.channelCount; ++ch)
+    {
+        std::memcpy(mMonitor[ch].data() + offset, samples[ch], firstPart * sizeof(complex16_t));
+        std::memcpy(mMonitor[ch].data(), samples[ch] + firstPart, (count - firstPart) * sizeof(complex16_t));
+    }
+    mMonitorWritten.store(written + count, std::memory_order_release);
+}
+
+void SampleRepeater::ForwardLoop()
+{
+    const uint32_t blockSize = mSettings.blockSize;
+    std::vector<std::vector<complex16_t>> buffers(mSettings.channelCount, std::vector<complex16_t>(blockSize));
+    std::vector<complex16_t*> rxSamples(mSettings.channelCount);
+    std::vector<const complex16_t*> txSamples(mSettings.channelCount);
+    for (uint8_t ch = 0; ch < mSettings.channelCount; ++ch)
+        rxSamples[ch] = buffers[ch].data();
+
+    StreamStats rxStats;
+    StreamStats txStats;
+    mStream.status(&rxStats, &txStats);
+    mLateAtStart = rxStats.late;
+
+    uint64_t nextTxTimestamp = 0;
+    const auto startTime = std::chrono::steady_clock::now();
+    auto nextSupervision = startTime + supervisionPeriod;
+    while (!mStop.load(std::memory_order_relaxed))
+    {
+        StreamMeta rxMeta{};
+        const uint32_t count = mStream.rx(rxSamples.data(), blockSize, &rxMeta);
+        if (count > 0)
+        {
+            const uint64_t txTimestamp = rxMeta.timestamp + mDelay.load(std::memory_order_relaxed);
+            // after lowering the delay, the samples that would overlap the already queued ones are skipped
+            const uint32_t skip = txTimestamp < nextTxTimestamp ? std::min<uint64_t>(nextTxTimestamp - txTimestamp, count) : 0;
+            if (skip < count)
+            {
+                for (uint8_t ch = 0; ch < mSettings.channelCount; ++ch)
+                    txSamples[ch] = rxSamples[ch] + skip;
+                StreamMeta txMeta{};
+                txMeta.timestamp = txTimestamp + skip;
+                txMeta.waitForTimestamp = true;
+                txMeta.flushPartialPacket = true;
+                const uint32_t sent = mStream.tx(txSamples.data(), count - skip, &txMeta);
+                nextTxTimestamp = txMeta.timestamp + sent;
+                mSamplesForwarded.fetch_add(sent, std::memory_order_relaxed);
+
+                // how far the hardware has moved on since receiving the block, once it's queued for transmitting
+                const uint64_t now = mStream.timestamp();
+                if (now > rxMeta.timestamp && mSettings.sampleRate > 0)
+                    mForwardingAge.Add((now - rxMeta.timestamp) * 1e9 / mSettings.sampleRate);
+            }
+            mSamplesSkipped.fetch_add(skip, std::memory_order_relaxed);
+            PushMonitor(rxSamples.data(), count);
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= nextSupervision)
+        {
+            mStream.status(&rxStats, &txStats);
+            Supervise(rxStats, txStats, std::chrono::duration<double>(now - startTime).count());
+            nextSupervision = now + supervisionPeriod;
+        }
+    }
+}
+
+// Updates the statistics, and in the automatic mode adjusts the delay.
+void SampleRepeater::Supervise(const StreamStats& rx, const StreamStats& tx, double elapsed_s)
+{
+    // the hardware reports the late Tx packets in the Rx packets
+    const uint32_t late = rx.late - mLateAtStart;
+    const uint32_t newLate = late - mLate.load(std::memory_order_relaxed);
+    mLate.store(late, std::memory_order_relaxed);
+    mForwardingAge_us.store(mForwardingAge.Percentile(0.999) / 1e3, std::memory_order_relaxed);
+    if (!mAutomatic)
+        return;
+
+    int64_t delay = mDelay.load(std::memory_order_relaxed);
+    if (newLate > 0)
+    {
+        if (elapsed_s - mLastRaise_s < raiseHoldoff_s)
+            return;
+        mLastRaise_s = elapsed_s;
+        delay += std::max<int64_t>(delay / 4, mSettings.blockSize);
+        mDelayIncreases.fetch_add(1, std::memory_order_relaxed);
+    }
+    else if (mEstimate.load(std::memory_order_relaxed) == 0 && elapsed_s >= mSettings.calibrationTime_s &&
+             mForwardingAge.count > 0 && rx.dmaToFifo.count > 0)
+    {
+        // the hardware is up to a DMA batch (and its transfer) ahead of the latest received samples,
+        // and the queued samples still have to make it through the Tx pipeline
+        const uint64_t received =
+            mSamplesForwarded.load(std::memory_order_relaxed) + mSamplesSkipped.load(std::memory_order_relaxed);
+        const double batch_ns = static_cast<double>(received) / rx.dmaToFifo.count / mSettings.sampleRate * 1e9;
+        const double latency_ns = mForwardingAge.Percentile(0.999) + batch_ns + rx.dmaToFifo.Percentile(0.999) +
+                                  tx.userToDma.Percentile(0.999);
+        const int64_t estimate = std::ceil(latency_ns * 1e-9 * mSettings.sampleRate * safetyMargin);
+        mEstimate.store(estimate, std::memory_order_relaxed);
+        delay = std::min(delay, estimate);
+    }
+    mDelay.store(delay, std::memory_order_relaxed);
+}
+
+/**
+  @brief Gets the repeater statistics.
+  @return The statistics, can be called while forwarding.
+ */
+SampleRepeater::Stats SampleRepeater::GetStats() const
+{
+    Stats stats;
+    stats.delay = mDelay.load(std::memory_order_relaxed);
+    stats.estimate = mEstimate.load(std::memory_order_relaxed);
+    stats.samplesForwarded = mSamplesForwarded.load(std::memory_order_relaxed);
+    stats.samplesSkipped = mSamplesSkipped.load(std::memory_order_relaxed);
+    stats.monitorDropped = mMonitorDropped.load(std::memory_order_relaxed);
+    stats.late = mLate.load(std::memory_order_relaxed);
+    stats.delayIncreases = mDelayIncreases.load(std::memory_order_relaxed);
+    stats.forwardingAge_us = mForwardingAge_us.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,93 @@
+#ifndef LIMESUITENG_CLI_SAMPLEREPEATER_H
+#define LIMESUITENG_CLI_SAMPLEREPEATER_H
+
+#include "limesuiteng/complex.h"
+#include "limesuiteng/StreamConfig.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+/** @brief Retransmits the received samples with a fixed delay, from a dedicated thread.
+
+  The forwarding uses small blocks and doesn't share its thread with any other processing, so the delay
+  only has to cover the stream pipeline. In the automatic mode the delay starts conservative, is lowered
+  to the minimum safe value estimated from the measured pipeline latencies, and is raised again whenever
+  the hardware reports late packets. The received samples are also copied to a monitor buffer, which
+  other processing (plotting, recording) can read without affecting the forwarding.
+ */
+class SampleRepeater
+{
+  public:
+    /** @brief The stream operations the repeater uses. */
+    struct Stream {
+        std::function<uint32_t(lime::complex16_t* const*, uint32_t, lime::StreamMeta*)> rx;
+        std::function<uint32_t(const lime::complex16_t* const*, uint32_t, const lime::StreamMeta*)> tx;
+        std::function<void(lime::StreamStats*, lime::StreamStats*)> status;
+        std::function<uint64_t()> timestamp; ///< The current hardware timestamp.
+    };
+
+    /** @brief The repeater settings. */
+    struct Settings {
+        uint8_t channelCount{ 1 };
+        double sampleRate{ 0 }; ///< The sampling rate (in Hz), required by the automatic mode.
+        uint32_t blockSize{ 1024 }; ///< The amount of samples forwarded at once.
+        int64_t delay{ -1 }; ///< The Tx timestamp offset from the Rx timestamp (in samples), negative - automatic.
+        double calibrationTime_s{ 1 }; ///< How long the pipeline latencies are measured before lowering the delay.
+    };
+
+    /** @brief The repeater statistics. */
+    struct Stats {
+        int64_t delay; ///< The current round trip delay (in samples).
+        int64_t estimate; ///< The minimum safe delay estimated from the pipeline latencies (in samples), 0 - not yet.
+        uint64_t samplesForwarded; ///< The amount of samples per channel retransmitted.
+        uint64_t samplesSkipped; ///< The amount of samples per channel not retransmitted, due to lowering the delay.
+        uint64_t monitorDropped; ///< The amount of samples per channel not copied because the monitor buffer was full.
+        uint32_t late; ///< The amount of late Tx packets since the start.
+        uint32_t delayIncreases; ///< The amount of times the delay was raised because of late packets.
+        double forwardingAge_us; ///< The 99.9th percentile of the age of the samples when queued for transmitting.
+    };
+
+    SampleRepeater(const Stream& stream, const Settings& settings);
+    ~SampleRepeater();
+
+    void Start();
+    void Stop();
+    uint32_t Read(lime::complex16_t* const* samples, uint32_t count, const std::atomic<bool>& stop);
+
+    Stats GetStats() const;
+
+  private:
+    void ForwardLoop();
+    void Supervise(const lime::StreamStats& rx, const lime::StreamStats& tx, double elapsed_s);
+    void PushMonitor(const lime::complex16_t* const* samples, uint32_t count);
+
+    Stream mStream;
+    Settings mSettings;
+    bool mAutomatic;
+
+    std::vector<std::vector<lime::complex16_t>> mMonitor; ///< The received samples for the other processing.
+    std::atomic<uint64_t> mMonitorWritten;
+    std::atomic<uint64_t> mMonitorRead;
+
+    std::thread mForwarder;
+    std::atomic<bool> mStop;
+
+    // accessed by the forwarding thread only
+    lime::DurationHistogram mForwardingAge;
+    uint32_t mLateAtStart;
+    double mLastRaise_s;
+
+    std::atomic<int64_t> mDelay;
+    std::atomic<int64_t> mEstimate;
+    std::atomic<uint64_t> mSamplesForwarded;
+    std::atomic<uint64_t> mSamplesSkipped;
+    std::atomic<uint64_t> mMonitorDropped;
+    std::atomic<uint32_t> mLate;
+    std::atomic<uint32_t> mDelayIncreases;
+    std::atomic<double> mForwardingAge_us;
+};
+
+#endif
@@ -0,0 +1,391 @@
+#include "TRXBenchmark.h"
+
+#include "limesuiteng/SDRDescriptor.h"
+#include "limesuiteng/StreamConfig.h"
+#include "limesuiteng/complex.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef __linux__
+    #include <unistd.h>
+#endif
+
+using namespace lime;
+using namespace std::literals::string_view_literals;
+
+namespace {
+
+/** @brief The CPU time used by a thread. */
+struct ThreadUsage {
+    std::string name;
+    uint64_t ticks;
+};
+
+/** @brief The cumulative state of the benchmark at a point in time. */
+struct Snapshot {
+    double time_s;
+    uint64_t rxSamples;
+    uint64_t txSamples;
+    StreamStats rx;
+    StreamStats tx;
+    std::map<int, ThreadUsage> threads; ///< The usage of each of the threads, by thread id.
+};
+
+} // namespace
+
+// Reads the CPU time of every thread of the process, empty where not supported.
+static std::map<int, ThreadUsage> ReadThreadUsage()
+{
+    std::map<int, ThreadUsage> threads;
+#ifdef __linux__
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator("/proc/self/task", ec))
+    {
+        std::ifstream statFile(entry.path() / "stat");
+        std::string stat;
+        if (!std::getline(statFile, stat))
+            continue; // the thread has ended
+        // pid (comm) state ppid ... utime stime, the name can contain spaces and parentheses
+        const std::size_t nameStart = stat.find('(');
+        const std::size_t nameEnd = stat.rfind(')');
+        if (nameStart == std::string::npos || nameEnd == std::string::npos)
+            continue;
+
+        std::istringstream fields(stat.substr(nameEnd + 1));
+        std::string field;
+        uint64_t utime = 0;
+        uint64_t stime = 0;
+        for (int index = 3; fields >> field && index <= 15; ++index)
+        {
+            if (index == 14)
+                utime = std::stoull(field);
+            else if (index == 15)
+                stime = std::stoull(field);
+        }
+        const int tid = std::stoi(entry.path().filename().string());
+        threads[tid] = ThreadUsage{ stat.substr(nameStart + 1, nameEnd - nameStart - 1), utime + stime };
+    }
+#endif
+    return threads;
+}
+
+static double TicksPerSecond()
+{
+#ifdef __linux__
+    return sysconf(_SC_CLK_TCK);
+#else
+    return 1;
+#endif
+}
+
+static std::string Quoted(std::string_view text)
+{
+    std::string quoted = "\"";
+    for (const char c : text)
+    {
+        if (c == '"' || c == '\\')
+            quoted += '\\';
+        if (static_cast<unsigned char>(c) < 0x20)
+            quoted += ' ';
+        else
+            quoted += c;
+    }
+    return quoted + '"';
+}
+
+static void WriteHistogram(std::ostream& report, std::string_view name, const DurationHistogram& histogram)
+{
+    report << Quoted(name) << ": { \"count\": "sv << histogram.count << ", \"mean\": "sv << histogram.Mean() / 1e3
+           << ", \"p50\": "sv << histogram.Percentile(0.5) / 1e3 << ", \"p90\": "sv << histogram.Percentile(0.9) / 1e3
+           << ", \"p99\": "sv << histogram.Percentile(0.99) / 1e3 << ", \"p999\": "sv << histogram.Percentile(0.999) / 1e3
+           << ", \"max\": "sv << histogram.max_ns / 1e3 << " }"sv;
+}
+
+static std::string_view ToString(TRXBenchmark::Mode mode)
+{
+    switch (mode)
+    {
+    case TRXBenchmark::Mode::Rx:
+        return "rx"sv;
+    case TRXBenchmark::Mode::Tx:
+        return "tx"sv;
+    case TRXBenchmark::Mode::FullDuplex:
+        return "trx"sv;
+    }
+    return ""sv;
+}
+
+static std::string_view ToString(DataFormat format)
+{
+    switch (format)
+    {
+    case DataFormat::I8:
+        return "I8"sv;
+    case DataFormat::I12:
+        return "I12"sv;
+    case DataFormat::I16:
+        return "I16"sv;
+    case DataFormat::F16:
+        return "F16"sv;
+    case DataFormat::F32:
+        return "F32"sv;
+    }
+    return ""sv;
+}
+
+static void WriteReport(std::ostream& report,
+    const SDRDescriptor& descriptor,
+    const TRXBenchmark::Settings& settings,
+    double sampleRate,
+    const std::vector<Snapshot>& snapshots)
+{
+    const Snapshot& first = snapshots.front();
+    const Snapshot& last = snapshots.back();
+    const double duration = last.time_s - first.time_s;
+    const double ticksPerSecond = TicksPerSecond();
+
+    report << "{\n"sv;
+    report << "  \"device\": "sv << Quoted(descriptor.name) << ",\n"sv;
+    report << "  \"mode\": "sv << Quoted(ToString(settings.mode)) << ",\n"sv;
+    report << "  \"chip\": "sv << static_cast<int>(settings.chipIndex) << ",\n"sv;
+    report << "  \"channels\": "sv << static_cast<int>(settings.channelCount) << ",\n"sv;
+    report << "  \"format\": "sv << Quoted(ToString(settings.format)) << ",\n"sv;
+    report << "  \"linkFormat\": "sv << Quoted(ToString(settings.linkFormat)) << ",\n"sv;
+    report << "  \"sampleRate\": "sv << sampleRate << ",\n"sv;
+    report << "  \"duration_s\": "sv << duration << ",\n"sv;
+    report << "  \"interval_s\": "sv << settings.interval_s << ",\n"sv;
+
+    // counters are totals, rates are per channel, latencies are in microseconds
+    // the late Tx packets are flagged by the hardware in the Rx packets, so they're counted in the Rx statistics
+    report << "  \"rx\": {\n"sv;
+    report << "    \"samples\": "sv << last.rxSamples << ",\n"sv;
+    report << "    \"samplesPerSecond\": "sv << (duration > 0 ? last.rxSamples / duration : 0) << ",\n"sv;
+    report << "    \"bytes\": "sv << last.rx.bytesTransferred << ",\n"sv;
+    report << "    \"packets\": "sv << last.rx.packets << ",\n"sv;
+    report << "    \"overruns\": "sv << last.rx.overrun << ",\n"sv;
+    report << "    \"loss\": "sv << last.rx.loss << ",\n"sv;
+    report << "    \"latency_us\": {\n      "sv;
+    WriteHistogram(report, "dmaToFifo"sv, last.rx.dmaToFifo);
+    report << ",\n      "sv;
+    WriteHistogram(report, "fifoToUser"sv, last.rx.fifoToUser);
+    report << ",\n      "sv;
+    WriteHistogram(report, "loop"sv, last.rx.loopTime);
+    report << "\n    }\n  },\n"sv;
+
+    report << "  \"tx\": {\n"sv;
+    report << "    \"samples\": "sv << last.txSamples << ",\n"sv;
+    report << "    \"samplesPerSecond\": "sv << (duration > 0 ? last.txSamples / duration : 0) << ",\n"sv;
+    report << "    \"bytes\": "sv << last.tx.bytesTransferred << ",\n"sv;
+    report << "    \"packets\": "sv << last.tx.packets << ",\n"sv;
+    report << "    \"underruns\": "sv << last.tx.underrun << ",\n"sv;
+    report << "    \"late\": "sv << last.rx.late << ",\n"sv;
+    report << "    \"latency_us\": {\n      "sv;
+    WriteHistogram(report, "userToDma"sv, last.tx.userToDma);
+    report << ",\n      "sv;
+    WriteHistogram(report, "loop"sv, last.tx.loopTime);
+    report << "\n    }\n  },\n"sv;
+
+    // CPU usage in percent of a single core, averaged over the time the thread was seen
+    struct ThreadSummary {
+        std::string name;
+        double firstTime_s;
+        uint64_t firstTicks;
+        double lastTime_s;
+        uint64_t lastTicks;
+        double peak;
+    };
+    std::map<int, ThreadSummary> threads;
+    for (std::size_t i = 0; i < snapshots.size(); ++i)
+    {
+        for (const auto& [tid, usage] : snapshots[i].threads)
+        {
+            auto found = threads.find(tid);
+            if (found == threads.end())
+            {
+                threads[tid] = ThreadSummary{ usage.name, snapshots[i].time_s, usage.ticks, snapshots[i].time_s, usage.ticks, 0 };
+                continue;
+            }
+            ThreadSummary& summary = found->second;
+            const double elapsed = snapshots[i].time_s - summary.lastTime_s;
+            if (elapsed > 0)
+                summary.peak = std::max(summary.peak, (usage.ticks - summary.lastTicks) / ticksPerSecond / elapsed * 100);
+            summary.name = usage.name;
+            summary.lastTime_s = snapshots[i].time_s;
+            summary.lastTicks = usage.ticks;
+        }
+    }
+    report << "  \"threads\": ["sv;
+    bool firstEntry = true;
+    for (const auto& [tid, summary] : threads)
+    {
+        const double elapsed = summary.lastTime_s - summary.firstTime_s;
+        const double mean = elapsed > 0 ? (summary.lastTicks - summary.firstTicks) / ticksPerSecond / elapsed * 100 : 0;
+        report << (firstEntry ? "\n"sv : ",\n"sv) << "    { \"tid\": "sv << tid << ", \"name\": "sv << Quoted(summary.name)
+               << ", \"cpuMean\": "sv << mean << ", \"cpuPeak\": "sv << summary.peak << " }"sv;
+        firstEntry = false;
+    }
+    report << (firstEntry ? "],\n"sv : "\n  ],\n"sv);
+
+    // the counters of each interval are the changes since the previous one
+    report << "  \"intervals\": ["sv;
+    for (std::size_t i = 1; i < snapshots.size(); ++i)
+    {
+        const Snapshot& previous = snapshots[i - 1];
+        const Snapshot& current = snapshots[i];
+        const double elapsed = current.time_s - previous.time_s;
+        if (elapsed <= 0)
+            continue;
+
+        report << (i == 1 ? "\n"sv : ",\n"sv) << "    { \"t\": "sv << current.time_s - first.time_s
+               << ", \"rxSamplesPerSecond\": "sv << (current.rxSamples - previous.rxSamples) / elapsed
+               << ", \"txSamplesPerSecond\": "sv << (current.txSamples - previous.txSamples) / elapsed
+               << ", \"rxOverruns\": "sv << current.rx.overrun - previous.rx.overrun << ", \"rxLoss\": "sv
+               << current.rx.loss - previous.rx.loss << ", \"txUnderruns\": "sv << current.tx.underrun - previous.tx.underrun
+               << ", \"txLate\": "sv << current.rx.late - previous.rx.late << ", \"rxFifo\": "sv
+               << (current.rx.FIFO.totalCount ? current.rx.FIFO.ratio() : 0) << ", \"txFifo\": "sv
+               << (current.tx.FIFO.totalCount ? current.tx.FIFO.ratio() : 0) << ", \"cpu\": {"sv;
+        bool firstThread = true;
+        for (const auto& [tid, usage] : current.threads)
+        {
+            auto found = previous.threads.find(tid);
+            if (found == previous.threads.end())
+                continue;
+            report << (firstThread ? " "sv : ", "sv) << Quoted(std::to_string(tid)) << ": "sv
+                   << (usage.ticks - found->second.ticks) / ticksPerSecond / elapsed * 100;
+            firstThread = false;
+        }
+        report << (firstThread ? "} }"sv : " } }"sv);
+    }
+    report << (snapshots.size() > 1 ? "\n  ]\n"sv : "]\n"sv);
+    report << "}"sv << std::endl;
+}
+
+/**
+  @brief Constructs the benchmark, the device has to be already configured.
+  @param device The device to stream from.
+  @param settings The workload settings.
+ */
+TRXBenchmark::TRXBenchmark(SDRDevice* device, const Settings& settings)
+    : mDevice(device)
+    , mSettings(settings)
+{
+}
+
+/**
+  @brief Streams for the configured duration, or until stopped, and writes the report.
+  @param report The destination of the JSON report.
+  @param stop Ends the workload early when set, the report covers the time streamed.
+  @return Whether the stream could be set up.
+ */
+bool TRXBenchmark::Run(std::ostream& report, const std::atomic<bool>& stop)
+{
+    if (mSettings.format == DataFormat::F32)
+        return Stream<complex32f_t>(report, stop);
+    if (mSettings.format == DataFormat::I16)
+        return Stream<complex16_t>(report, stop);
+
+    std::cerr << "Unsupported benchmark samples format: "sv << ToString(mSettings.format) << std::endl;
+    return false;
+}
+
+template<class T> bool TRXBenchmark::Stream(std::ostream& report, const std::atomic<bool>& stop)
+{
+    const bool rx = mSettings.mode != Mode::Tx;
+    const bool tx = mSettings.mode != Mode::Rx;
+
+    StreamConfig stream;
+    for (uint8_t ch = 0; ch < mSettings.channelCount; ++ch)
+    {
+        if (rx)
+            stream.channels[TRXDir::Rx].push_back(ch);
+        if (tx)
+            stream.channels[TRXDir::Tx].push_back(ch);
+    }
+    stream.format = mSettings.format;
+    stream.linkFormat = mSettings.linkFormat;
+    stream.hintSampleRate = mSettings.sampleRate;
+    if (mDevice->StreamSetup(stream, mSettings.chipIndex) != OpStatus::Success)
+    {
+        std::cerr << "Failed to setup data stream."sv << std::endl;
+        return false;
+    }
+
+    // the contents of the samples don't affect the throughput
+    const uint32_t samplesInCall = mSettings.samplesInCall;
+    std::vector<std::vector<T>> rxBuffers(mSettings.channelCount, std::vector<T>(samplesInCall));
+    std::vector<std::vector<T>> txBuffers(mSettings.channelCount, std::vector<T>(samplesInCall));
+    std::vector<T*> rxSamples(mSettings.channelCount);
+    std::vector<const T*> txSamples(mSettings.channelCount);
+    for (uint8_t ch = 0; ch < mSettings.channelCount; ++ch)
+    {
+        rxSamples[ch] = rxBuffers[ch].data();
+        txSamples[ch] = txBuffers[ch].data();
+    }
+
+    // full duplex transmits the received amount 10 ms ahead of the receiving, if the rate is known
+    const double sampleRate = mDevice->GetSampleRate(mSettings.chipIndex, TRXDir::Rx, 0);
+    const bool useTxTimestamps = rx && sampleRate > 0;
+    const uint64_t txLeadSamples = sampleRate * 0.01;
+
+    std::vector<Snapshot> snapshots;
+    snapshots.reserve(mSettings.duration_s / mSettings.interval_s + 2);
+    uint64_t rxSamplesTotal = 0;
+    uint64_t txSamplesTotal = 0;
+    const auto startTime = std::chrono::steady_clock::now();
+    auto TakeSnapshot = [&](double time_s) {
+        Snapshot& snapshot = snapshots.emplace_back();
+        snapshot.time_s = time_s;
+        snapshot.rxSamples = rxSamplesTotal;
+        snapshot.txSamples = txSamplesTotal;
+        mDevice->StreamStatus(mSettings.chipIndex, &snapshot.rx, &snapshot.tx);
+        snapshot.threads = ReadThreadUsage();
+    };
+
+    mDevice->StreamStart(mSettings.chipIndex);
+    TakeSnapshot(0);
+    double nextSnapshot = mSettings.interval_s;
+    double elapsed = 0;
+    while (!stop.load(std::memory_order_relaxed) && elapsed < mSettings.duration_s)
+    {
+        StreamMeta rxMeta{};
+        uint32_t samplesToSend = samplesInCall;
+        if (rx)
+        {
+            const uint32_t samplesRead = mDevice->StreamRx(mSettings.chipIndex, rxSamples.data(), samplesInCall, &rxMeta);
+            rxSamplesTotal += samplesRead;
+            samplesToSend = samplesRead;
+        }
+        if (tx && samplesToSend > 0)
+        {
+            StreamMeta txMeta{};
+            txMeta.timestamp = rxMeta.timestamp + txLeadSamples;
+            txMeta.waitForTimestamp = useTxTimestamps;
+            txMeta.flushPartialPacket = false;
+            txSamplesTotal += mDevice->StreamTx(mSettings.chipIndex, txSamples.data(), samplesToSend, &txMeta);
+        }
+
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        if (elapsed >= nextSnapshot)
+        {
+            TakeSnapshot(elapsed);
+            while (nextSnapshot <= elapsed)
+                nextSnapshot += mSettings.interval_s;
+        }
+    }
+    if (snapshots.back().time_s < elapsed)
+        TakeSnapshot(elapsed);
+
+    mDevice->StreamStop(mSettings.chipIndex);
+    mDevice->StreamDestroy(mSettings.chipIndex);
+
+    WriteReport(report, mDevice->GetDescriptor(), mSettings, sampleRate, snapshots);
+    return true;
+}
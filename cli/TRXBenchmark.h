@@ -0,0 +1,47 @@
+#ifndef LIMESUITENG_CLI_TRXBENCHMARK_H
+#define LIMESUITENG_CLI_TRXBENCHMARK_H
+
+#include "limesuiteng/SDRDevice.h"
+#include "limesuiteng/types.h"
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+/** @brief Runs a fixed duration streaming workload and reports the sustained performance as JSON.
+
+  The stream statistics and the CPU usage of each thread of the process are sampled at regular intervals,
+  so stalls and drops can be located in time, not only counted. Works the same with the simulated device,
+  so the reports can be produced and compared on machines without hardware.
+ */
+class TRXBenchmark
+{
+  public:
+    /** @brief The directions to stream. */
+    enum class Mode : uint8_t { Rx, Tx, FullDuplex };
+
+    /** @brief The workload settings. */
+    struct Settings {
+        Mode mode{ Mode::FullDuplex };
+        uint8_t chipIndex{ 0 };
+        uint8_t channelCount{ 1 };
+        lime::DataFormat format{ lime::DataFormat::I16 }; ///< The host samples format, I16 or F32.
+        lime::DataFormat linkFormat{ lime::DataFormat::I12 };
+        double sampleRate{ 0 }; ///< The hint of the sampling rate, paces the simulated device (in Hz).
+        double duration_s{ 10 };
+        double interval_s{ 1 }; ///< The period of the statistics sampling.
+        uint32_t samplesInCall{ 16384 }; ///< The amount of samples per channel in each StreamRx/StreamTx call.
+    };
+
+    TRXBenchmark(lime::SDRDevice* device, const Settings& settings);
+
+    bool Run(std::ostream& report, const std::atomic<bool>& stop);
+
+  private:
+    template<class T> bool Stream(std::ostream& report, const std::atomic<bool>& stop);
+
+    lime::SDRDevice* mDevice;
+    Settings mSettings;
+};
+
+#endif
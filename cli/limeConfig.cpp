@@ -88,7 +88,7 @@ int main(int argc, char** argv)
     args::ValueFlag<uint8_t>        txoversampleFlag(parser, "", "Transmitter interpolation 1,2,4,8...", {"txoversample"});
     args::ValueFlag<bool>           txtestsignalFlag(parser, "", "Enables transmitter test signal if available", {"txtestsignal"});
 
-    args::ValueFlag<std::string>    iniFlag(parser, "", "Path to LMS7002M .ini configuration file to use as a base", {"ini"}, "");
+    args::ValueFlag<std::string>    iniFlag(parser, "", "Path to LMS7002M .ini or .lms7snap configuration file to use as a base", {"ini"}, "");
     // clang-format on
 
     try
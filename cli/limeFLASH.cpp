@@ -1,6 +1,7 @@
 #include "common.h"
 #include <filesystem>
 #include "args.hxx"
+#include "utilities/toString.h"
 
 using namespace std;
 using namespace lime;
@@ -62,17 +63,17 @@ static const std::shared_ptr<DataStorage> FindMemoryDeviceByName(SDRDevice* devi
 }
 
 static auto lastProgressUpdate = std::chrono::steady_clock::now();
-bool progressCallBack(std::size_t bsent, std::size_t btotal, const std::string& statusMessage)
+static bool ReportProgress(std::size_t bsent, std::size_t btotal, std::string_view action)
 {
-    float percentage = 100.0 * bsent / btotal;
+    float percentage = btotal > 0 ? 100.0 * bsent / btotal : 100.0;
     const bool hasCompleted = bsent == btotal;
     auto now = std::chrono::steady_clock::now();
     // no need to spam the text with each callback
     if (now - lastProgressUpdate > std::chrono::milliseconds(10) || hasCompleted)
     {
         lastProgressUpdate = now;
-        std::cout << "[" << std::fixed << std::setprecision(0) << percentage << "] bytes written " << bsent << "/" << btotal << "\r"
-                  << std::flush;
+        std::cout << "[" << std::fixed << std::setprecision(0) << percentage << "] " << action << " " << bsent << "/" << btotal
+                  << "\r" << std::flush;
     }
     if (hasCompleted)
         cout << endl;
@@ -106,6 +107,17 @@ bool progressCallBack(std::size_t bsent, std::size_t btotal, const std::string&
     return false;
 }
 
+bool progressCallBack(std::size_t bsent, std::size_t btotal, const std::string& statusMessage)
+{
+    return ReportProgress(bsent, btotal, "bytes written"sv);
+}
+
+// The incremental write reports its compare and write phases in the status message.
+bool incrementalProgressCallBack(std::size_t bsent, std::size_t btotal, const std::string& statusMessage)
+{
+    return ReportProgress(bsent, btotal, statusMessage);
+}
+
 int main(int argc, char** argv)
 {
     // clang-format off
@@ -114,6 +126,9 @@ int main(int argc, char** argv)
     args::ValueFlag<std::string>    deviceFlag(parser, "device", "Specifies which device to use", {'d', "device"}, "");
     args::ValueFlag<std::string>    targetFlag(parser, "TARGET", "Specifies which target to use", {'t', "target"}, "");
     args::Flag                      listFlag(parser, "list", "list available device's targets", {'l', "list"});
+    args::Flag                      incrementalFlag(parser, "incremental", "Compare the memory contents first, erase and write only the sectors that differ", {'i', "incremental"});
+    args::ValueFlag<std::string>    addressFlag(parser, "ADDRESS", "The memory address to write the file to, required in incremental mode", {'a', "address"});
+    args::ValueFlag<uint32_t>       sectorSizeFlag(parser, "BYTES", "The erase sector size of the memory, in incremental mode", {"sectorSize"}, 65536);
     args::Positional<std::string>   fileFlag(parser, "file path", "Input file path", args::Options::Required);
     // clang-format on
 
@@ -167,6 +182,31 @@ int main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
+    if (!incrementalFlag && (addressFlag || sectorSizeFlag))
+    {
+        DeviceRegistry::freeDevice(device);
+        cerr << "--address and --sectorSize are only used in incremental mode"sv << endl;
+        return EXIT_FAILURE;
+    }
+    if (incrementalFlag)
+    {
+        // The gateware image targets are only written through the programming protocol, which places the data by itself.
+        // Incremental mode needs a memory that is read and written directly, at the addresses of the memory.
+        const eMemoryDevice type = memorySelect->memoryDeviceType;
+        if (type != eMemoryDevice::FPGA_FLASH && type != eMemoryDevice::EEPROM)
+        {
+            DeviceRegistry::freeDevice(device);
+            cerr << "Incremental mode is not supported for target "sv << ToString(type) << endl;
+            return EXIT_FAILURE;
+        }
+        if (!addressFlag)
+        {
+            DeviceRegistry::freeDevice(device);
+            cerr << "Incremental mode requires the memory address of the image, -a, --address"sv << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
     std::vector<char> data;
     std::ifstream inputFile;
     inputFile.open(filePath, std::ifstream::in | std::ifstream::binary);
@@ -184,8 +224,28 @@ int main(int argc, char** argv)
     inputFile.read(data.data(), cnt);
     inputFile.close();
 
-    if (memorySelect->ownerDevice->UploadMemory(memorySelect->memoryDeviceType, 0, data.data(), data.size(), progressCallBack) !=
-        OpStatus::Success)
+    OpStatus status = OpStatus::Success;
+    if (incrementalFlag)
+    {
+        Region region{ 0, static_cast<int32_t>(data.size()) };
+        try
+        {
+            region.address = std::stoul(args::get(addressFlag), nullptr, 0);
+        } catch (const std::logic_error&)
+        {
+            DeviceRegistry::freeDevice(device);
+            cerr << "Invalid address: "sv << args::get(addressFlag) << endl;
+            return EXIT_FAILURE;
+        }
+        // fails at the first read back, before anything is written, if the device does not access the target directly
+        status = memorySelect->ownerDevice->MemoryWriteIncremental(
+            memorySelect, region, data.data(), args::get(sectorSizeFlag), incrementalProgressCallBack);
+    }
+    else
+        status = memorySelect->ownerDevice->UploadMemory(
+            memorySelect->memoryDeviceType, 0, data.data(), data.size(), progressCallBack);
+
+    if (status != OpStatus::Success && status != OpStatus::Aborted)
     {
         DeviceRegistry::freeDevice(device);
         cout << "Device programming failed."sv << endl;
@@ -7,6 +7,9 @@
 #include <ctime>
 #include <string_view>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include "utilities/toString.h"
 #include "args.hxx"
 
@@ -33,63 +36,65 @@ static LogLevel strToLogLevel(const std::string_view str)
     return LogLevel::Error;
 }
 
+// The output of the device being tested on the current thread, or nullptr for the standard error output.
+static thread_local std::ostream* threadLog = nullptr;
+static std::mutex outputMutex;
+
 static void LogCallback(LogLevel lvl, const std::string& msg)
 {
     if (lvl > logVerbosity)
         return;
+    if (threadLog)
+    {
+        *threadLog << msg << endl;
+        return;
+    }
+    std::lock_guard<std::mutex> lock(outputMutex);
     cerr << msg << endl;
 }
 
 class PrintOEMTestReporter : public OEMTestReporter
 {
   public:
-    PrintOEMTestReporter(uint64_t serialNumber, const std::filesystem::path& reportFilename)
-    {
-        if (!reportFilename.empty())
-            fileOutput.open(reportFilename, std::fstream::out | std::fstream::app);
+    /** @brief The result of a single test step. */
+    struct Step {
+        std::string name;
+        int level; ///< The nesting level of the step.
+        bool passed;
+        double duration_s;
     };
-    ~PrintOEMTestReporter() override
-    {
-        if (fileOutput.is_open())
-        {
-            int fileSize = fileOutput.tellg();
-            if (fileSize == 0) // if file empty add column headers
-            {
-                for (const auto& h : headers)
-                    fileOutput << h << ",";
-                fileOutput << std::endl;
-            }
-            for (const auto& v : values)
-                fileOutput << v << ",";
-            fileOutput << std::endl;
-        }
-        fileOutput.close();
-    }
+
+    PrintOEMTestReporter(std::ostream& output)
+        : output(output){};
     void OnStart(OEMTestData& test, const std::string& testName = std::string()) override
     {
-        std::cerr << Indent() << "=== " << test.name << " ===" << std::endl;
+        output << Indent() << "=== " << test.name << " ===" << std::endl;
+        started.push_back({ steps.size(), std::chrono::steady_clock::now() });
+        steps.push_back({ test.name, indentLevel, false, 0 });
         ++indentLevel;
     }
     void OnStepUpdate(OEMTestData& test, const std::string& text = std::string()) override
     {
-        std::cerr << Indent() << text << std::endl;
+        output << Indent() << text << std::endl;
     }
     void OnSuccess(OEMTestData& test) override
     {
-        --indentLevel;
-        std::cerr << Indent() << "=== " << test.name << " - PASSED"
-                  << " ===" << std::endl
-                  << std::endl;
+        const double duration_s = Finish(test, true);
+        output << Indent() << "=== " << test.name << " - PASSED (" << std::fixed << std::setprecision(3) << duration_s << " s)"
+               << " ===" << std::endl
+               << std::endl;
     }
     void OnFail(OEMTestData& test, const std::string& reasonText = std::string()) override
     {
         assert(!test.passed);
-        --indentLevel;
-        std::cerr << Indent() << "=== " << test.name << " - FAILED";
+        const double duration_s = Finish(test, false);
+        output << Indent() << "=== " << test.name << " - FAILED";
 
         if (!reasonText.empty())
-            std::cerr << " (" << reasonText << ")";
-        std::cerr << " ===" << std::endl << std::endl;
+            output << " (" << reasonText << ")";
+        output << " (" << std::fixed << std::setprecision(3) << duration_s << " s)"
+               << " ===" << std::endl
+               << std::endl;
     }
     void ReportColumn(const std::string& header, const std::string& value) override
     {
@@ -97,7 +102,45 @@ class PrintOEMTestReporter : public OEMTestReporter
         values.push_back(value);
     }
 
+    /**
+      @brief Appends the reported columns as a line to a CSV file, adds the column headers to an empty file.
+      @param reportFilename The file to append to.
+     */
+    void AppendToFile(const std::filesystem::path& reportFilename)
+    {
+        std::fstream fileOutput(reportFilename, std::fstream::out | std::fstream::app);
+        if (!fileOutput.is_open())
+            return;
+        int fileSize = fileOutput.tellg();
+        if (fileSize == 0) // if file empty add column headers
+        {
+            for (const auto& h : headers)
+                fileOutput << h << ",";
+            fileOutput << std::endl;
+        }
+        for (const auto& v : values)
+            fileOutput << v << ",";
+        fileOutput << std::endl;
+    }
+
+    /**
+      @brief Gets the completed test steps.
+      @return The steps, in the order they were started.
+     */
+    const std::vector<Step>& GetSteps() const { return steps; }
+
   private:
+    double Finish(OEMTestData& test, bool passed)
+    {
+        --indentLevel;
+        if (started.empty())
+            return 0;
+        Step& step = steps.at(started.back().first);
+        step.passed = passed;
+        step.duration_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - started.back().second).count();
+        started.pop_back();
+        return step.duration_s;
+    }
     std::string Indent()
     {
         std::stringstream ss;
@@ -105,18 +148,134 @@ class PrintOEMTestReporter : public OEMTestReporter
             ss << "  ";
         return ss.str();
     }
+    std::ostream& output;
     int indentLevel{ 0 };
-    std::fstream fileOutput;
+    std::vector<std::pair<std::size_t, std::chrono::steady_clock::time_point>> started; ///< The unfinished steps.
+    std::vector<Step> steps;
     std::vector<std::string> headers;
     std::vector<std::string> values;
 };
 
+/** @brief The test run of a single device. */
+struct DeviceTestRun {
+    SDRDevice* device{ nullptr };
+    uint64_t serialNumber{ 0 };
+    std::string name;
+    std::ostringstream log; ///< The device output, when testing several devices at once.
+    std::unique_ptr<PrintOEMTestReporter> reporter;
+    OpStatus result{ OpStatus::Error };
+    double duration_s{ 0 };
+};
+
+static std::string SerialNumberToString(uint64_t serialNumber)
+{
+    std::stringstream ss;
+    ss << serialNumber << " (";
+    for (size_t i = 0; i < sizeof(serialNumber); ++i)
+        ss << hex << "0x" << std::setw(2) << std::setfill('0') << ((serialNumber >> 8 * i) & 0xFF) << " ";
+    ss << ")";
+    return ss.str();
+}
+
+/**
+  @brief Connects to the devices selected by the arguments.
+  @param hints The device filters, "all" selects every detected device, no filters select the only detected device.
+  @param[out] devices The connected devices.
+  @return Whether all of the selected devices were connected.
+ */
+static bool ConnectDevices(const std::vector<std::string>& hints, std::vector<SDRDevice*>& devices)
+{
+    if (std::find(hints.begin(), hints.end(), "all"s) != hints.end())
+    {
+        for (const DeviceHandle& handle : DeviceRegistry::enumerate())
+        {
+            SDRDevice* device = DeviceRegistry::makeDevice(handle);
+            if (!device)
+            {
+                cerr << "Failed to connect to: "sv << handle.Serialize() << endl;
+                return false;
+            }
+            devices.push_back(device);
+        }
+        if (devices.empty())
+            cerr << "No devices detected."sv << endl;
+        return !devices.empty();
+    }
+
+    if (hints.empty())
+    {
+        SDRDevice* device = ConnectToFilteredOrDefaultDevice(""sv);
+        if (device)
+            devices.push_back(device);
+        return device != nullptr;
+    }
+
+    for (const std::string& hint : hints)
+    {
+        SDRDevice* device = ConnectToFilteredOrDefaultDevice(hint);
+        if (!device)
+            return false;
+        devices.push_back(device);
+    }
+    return true;
+}
+
+static void RunDeviceTest(DeviceTestRun& run, bool isolatedOutput)
+{
+    std::ostream& output = isolatedOutput ? static_cast<std::ostream&>(run.log) : cerr;
+    threadLog = isolatedOutput ? &run.log : nullptr;
+    if (isolatedOutput)
+        run.device->SetMessageLogCallback([&run](LogLevel lvl, const std::string& msg) {
+            if (lvl <= logVerbosity)
+                run.log << msg << endl;
+        });
+
+    output << "Board serial number: " << SerialNumberToString(run.serialNumber) << endl;
+    run.reporter = std::make_unique<PrintOEMTestReporter>(output);
+    run.reporter->ReportColumn("S/N", std::to_string(run.serialNumber));
+
+    const auto start = std::chrono::steady_clock::now();
+    run.result = run.device->OEMTest(run.reporter.get());
+    run.duration_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (run.result == OpStatus::Success)
+        output << "OEM TEST PASSED" << endl;
+    else
+        output << "OEM TEST FAILED" << endl;
+    threadLog = nullptr;
+
+    if (isolatedOutput)
+    {
+        std::lock_guard<std::mutex> lock(outputMutex);
+        cerr << "##### " << run.name << " #####" << endl << run.log.str() << endl;
+    }
+}
+
+static void PrintSummary(const std::vector<std::unique_ptr<DeviceTestRun>>& runs, double duration_s)
+{
+    cerr << "##### Summary #####" << endl;
+    for (const auto& run : runs)
+    {
+        cerr << run->name << ": " << (run->result == OpStatus::Success ? "PASSED" : "FAILED") << " (" << std::fixed
+             << std::setprecision(3) << run->duration_s << " s)" << endl;
+        for (const auto& step : run->reporter->GetSteps())
+        {
+            std::string indent(2 * step.level + 2, ' ');
+            cerr << indent << std::left << std::setw(40 - indent.size()) << step.name << std::right << std::setw(8)
+                 << (step.passed ? "PASSED" : "FAILED") << std::setw(10) << step.duration_s << " s" << endl;
+        }
+    }
+    const int passed = std::count_if(runs.begin(), runs.end(), [](const auto& run) { return run->result == OpStatus::Success; });
+    cerr << passed << "/" << runs.size() << " devices passed in " << std::fixed << std::setprecision(3) << duration_s << " s"
+         << endl;
+}
+
 int main(int argc, char** argv)
 {
     // clang-format off
     args::ArgumentParser            parser("limeOEM - utility for device testing and custom device specific operations", "");
     args::HelpFlag                  help(parser, "help", "This help", {'h', "help"});
-    args::ValueFlag<std::string>    deviceFlag(parser, "device", "Specifies which device to use", {'d', "device"}, "");
+    args::NargsValueFlag<std::string> deviceFlag(parser, "device", "Specifies which devices to test concurrently, or \"all\"", {'d', "device"}, args::Nargs{1, static_cast<size_t>(-1)});
     args::ValueFlag<std::string>    logFlag(parser, "level", "Log verbosity levels: error, warning, info, verbose, debug", {'l', "log"}, "error");
 
     args::ValueFlag<std::string>    reportFileFlag(parser, "", "File to append test results", {'o', "output"}, "");
@@ -144,19 +303,30 @@ int main(int argc, char** argv)
     }
 
     logVerbosity = strToLogLevel(args::get(logFlag));
-    const std::string devName = args::get(deviceFlag);
     const std::string reportFilename = args::get(reportFileFlag);
 
-    SDRDevice* device = ConnectToFilteredOrDefaultDevice(devName);
-    if (!device)
+    std::vector<SDRDevice*> devices;
+    if (!ConnectDevices(args::get(deviceFlag), devices))
+    {
+        for (SDRDevice* device : devices)
+            DeviceRegistry::freeDevice(device);
         return EXIT_FAILURE;
+    }
 
-    device->SetMessageLogCallback(LogCallback);
     lime::registerLogHandler(LogCallback);
     OpStatus result = OpStatus::Success;
 
     if (serialNumberFlag)
     {
+        if (devices.size() > 1)
+        {
+            cerr << "The serial number can be written to a single device only." << endl;
+            for (SDRDevice* device : devices)
+                DeviceRegistry::freeDevice(device);
+            return EXIT_FAILURE;
+        }
+        SDRDevice* device = devices.front();
+        device->SetMessageLogCallback(LogCallback);
         uint64_t serialNumberArg = args::get(serialNumberFlag);
         OpStatus status = device->WriteSerialNumber(serialNumberArg);
         if (status != OpStatus::Success)
@@ -169,22 +339,39 @@ int main(int argc, char** argv)
 
     if (runTestsFlag)
     {
-        uint64_t serialNumber = device->GetDescriptor().serialNumber;
-        cerr << "Board serial number: " << serialNumber << " (";
-        for (size_t i = 0; i < sizeof(serialNumber); ++i)
-            cerr << hex << "0x" << std::setw(2) << std::setfill('0') << ((serialNumber >> 8 * i) & 0xFF) << " ";
-        cerr << ")" << endl;
+        // each device is tested on its own thread, their output is kept apart until the device is done
+        const bool isolatedOutput = devices.size() > 1;
+        std::vector<std::unique_ptr<DeviceTestRun>> runs;
+        for (SDRDevice* device : devices)
+        {
+            auto run = std::make_unique<DeviceTestRun>();
+            run->device = device;
+            run->serialNumber = device->GetDescriptor().serialNumber;
+            run->name = device->GetDescriptor().name + " S/N "s + std::to_string(run->serialNumber);
+            if (!isolatedOutput)
+                device->SetMessageLogCallback(LogCallback);
+            runs.push_back(std::move(run));
+        }
 
-        PrintOEMTestReporter reporter(serialNumber, reportFilename);
-        reporter.ReportColumn("S/N", std::to_string(serialNumber));
-        result = device->OEMTest(&reporter);
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (auto& run : runs)
+            threads.emplace_back(RunDeviceTest, std::ref(*run), isolatedOutput);
+        for (auto& thread : threads)
+            thread.join();
+        const double duration_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-        if (result == OpStatus::Success)
-            cerr << "OEM TEST PASSED" << endl;
-        else
-            cerr << "OEM TEST FAILED" << endl;
+        for (const auto& run : runs)
+        {
+            if (!reportFilename.empty())
+                run->reporter->AppendToFile(reportFilename);
+            if (run->result != OpStatus::Success)
+                result = run->result;
+        }
+        PrintSummary(runs, duration_s);
     }
 
-    DeviceRegistry::freeDevice(device);
+    for (SDRDevice* device : devices)
+        DeviceRegistry::freeDevice(device);
     return result != OpStatus::Success ? EXIT_FAILURE : EXIT_SUCCESS;
 }
@@ -1,4 +1,5 @@
 #include "common.h"
+#include "SPIScript.h"
 
 #include <cassert>
 #include <cstring>
@@ -116,7 +117,7 @@ static std::string ReadFile(const std::string& fileName)
     long fileSize = inputFile.tellg();
     inputFile.seekg(0, std::ios::beg);
 
-    buffer.resize(fileSize);
+    buffer.resize(fileSize + 1);
     inputFile.read(&buffer[0], fileSize);
     inputFile.close();
     buffer[fileSize] = 0;
@@ -132,6 +133,7 @@ int main(int argc, char** argv)
     args::Group                             commands(parser, "commands"); // NOLINT(cppcoreguidelines-slicing) 
     args::Command                           read(commands, "read", "Reading operation");
     args::Command                           write(commands, "write", "Do writing operation");
+    args::Command                           script(commands, "script", "Execute a script of read, write, modify, poll, delay operations");
 
     args::Group                             arguments(parser, "arguments", args::Group::Validators::DontCare, args::Options::Global); // NOLINT(cppcoreguidelines-slicing)
     args::ValueFlag<std::string>            deviceFlag(arguments, "name", "Specifies which device to use", {'d', "device"}, "");
@@ -170,6 +172,18 @@ int main(int argc, char** argv)
         return EXIT_FAILURE;
     }
 
+    // parse the whole script before touching the device
+    SPIScript spiScript;
+    if (script)
+    {
+        std::string error;
+        if (!spiScript.Parse(hexInput, error))
+        {
+            cerr << error << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
     auto handles = DeviceRegistry::enumerate();
     if (handles.size() == 0)
     {
@@ -181,13 +195,26 @@ int main(int argc, char** argv)
     if (!device)
         return EXIT_FAILURE;
 
-    int32_t chipSelect = FindChipSelectByName(device, chipName);
+    // a script can select the chip itself
+    const auto& operations = spiScript.GetOperations();
+    const bool scriptSelectsChip = !operations.empty() && operations.front().type == SPIScript::OperationType::Chip;
+    int32_t chipSelect = script && chipName.empty() && scriptSelectsChip ? 0 : FindChipSelectByName(device, chipName);
     if (chipSelect < 0)
     {
         DeviceRegistry::freeDevice(device);
         return EXIT_FAILURE;
     }
 
+    if (script)
+    {
+        std::string error;
+        const bool success = spiScript.Run(device, chipSelect, cout, error);
+        if (!success)
+            cerr << error << endl;
+        DeviceRegistry::freeDevice(device);
+        return success ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     std::vector<uint32_t> mosi;
     if (write)
         parseWriteInput(hexInput, mosi);
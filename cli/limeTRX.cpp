@@ -1,4 +1,8 @@
 #include "common.h"
+#include "SamplePlayer.h"
+#include "SampleRecorder.h"
+#include "SampleRepeater.h"
+#include "TRXBenchmark.h"
 #include "limesuiteng/StreamConfig.h"
 #include "limesuiteng/StreamComposite.h"
 #include <iostream>
@@ -6,6 +10,7 @@
 #include <cmath>
 #include <signal.h>
 #include <thread>
+#include <atomic>
 #include "kiss_fft.h"
 #include <condition_variable>
 #include <mutex>
@@ -22,7 +27,7 @@ using namespace std;
 
 std::mutex globalGnuPlotMutex; // Seems multiple plot pipes can't be used concurrently
 
-bool stopProgram(false);
+std::atomic<bool> stopProgram(false);
 void intHandler(int dummy)
 {
     //std::cerr << "Stopping\n"sv;
@@ -236,10 +241,177 @@ static std::vector<int> ParseIntArray(args::NargsValueFlag<int>& flag)
     return numbers;
 }
 
+static void PrintLatency(const char* name, const DurationHistogram& histogram)
+{
+    if (histogram.count == 0)
+        return;
+    std::cerr << "  "sv << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(1)
+              << " n:"sv << histogram.count << " mean:"sv << histogram.Mean() / 1e3 << " p50:"sv << histogram.Percentile(0.5) / 1e3
+              << " p99:"sv << histogram.Percentile(0.99) / 1e3 << " p99.9:"sv << histogram.Percentile(0.999) / 1e3 << " max:"sv
+              << histogram.max_ns / 1e3 << " us"sv << endl;
+}
+
+static void PrintStreamLatencies(SDRDevice* device, const std::vector<int>& chipIndexes)
+{
+    for (int index : chipIndexes)
+    {
+        StreamStats rx;
+        StreamStats tx;
+        device->StreamStatus(index, &rx, &tx);
+        std::cerr << "Chip "sv << index << " latencies:"sv << endl;
+        PrintLatency("Rx dma", rx.dmaToFifo);
+        PrintLatency("Rx user", rx.fifoToUser);
+        PrintLatency("Rx loop", rx.loopTime);
+        PrintLatency("Tx dma", tx.userToDma);
+        PrintLatency("Tx loop", tx.loopTime);
+    }
+}
+
+static void PrintPlayerStats(const SamplePlayer& player)
+{
+    const SamplePlayer::Stats stats = player.GetStats();
+    std::cerr << "Tx playback: "sv << stats.samplesPlayed << " samples, "sv << stats.loops << " loops, read "sv
+              << stats.bytesRead / 1e6 << " MB at "sv << stats.readRate_Bps / 1e6 << " MB/s, "sv << stats.underruns
+              << " underruns"sv << endl;
+}
+
+static void PrintRepeaterStats(const SampleRepeater& repeater, float sampleRate)
+{
+    const SampleRepeater::Stats stats = repeater.GetStats();
+    std::cerr << "Repeater: round trip "sv << stats.delay << " samples ("sv << stats.delay / sampleRate * 1e6 << " us)"sv;
+    if (stats.estimate > 0)
+        std::cerr << ", minimum safe "sv << stats.estimate << " samples"sv;
+    std::cerr << ", forwarding p99.9 "sv << stats.forwardingAge_us << " us, late "sv << stats.late << ", raised "sv
+              << stats.delayIncreases << " times, forwarded "sv << stats.samplesForwarded << " skipped "sv << stats.samplesSkipped
+              << " samples"sv << endl;
+}
+
+static void PrintRecorderStats(const SampleRecorder& recorder)
+{
+    const SampleRecorder::Stats stats = recorder.GetStats();
+    std::cerr << "Recorder: written "sv << std::fixed << std::setprecision(1) << stats.bytesWritten / 1e6 << " MB at "sv
+              << stats.writeRate_Bps / 1e6 << " MB/s, slowest write "sv << stats.longestWrite_s * 1e3 << " ms, buffer peak "sv
+              << stats.peakFill * 100 << "%, dropped "sv << stats.samplesDropped << " samples in "sv << stats.dropEvents
+              << " events"sv << endl;
+}
+
+/** @brief The "limeTRX benchmark" subcommand, streams for a fixed duration and writes a JSON performance report. */
+static int BenchmarkCommand(int argc, char** argv)
+{
+    // clang-format off
+    args::ArgumentParser                parser("limeTRX benchmark - Sustained streaming performance report", "");
+    args::HelpFlag                      helpFlag(parser, "help", "This help", {'h', "help"});
+
+    args::ValueFlag<std::string>        deviceFlag(parser, "name", "Specifies which device to use", {'d', "device"});
+    args::ValueFlag<int>                chipFlag(parser, "index", "Specify chip index", {'c', "chip"}, 0, args::Options{});
+    args::ValueFlag<std::string>        modeFlag(parser, "rx, tx, trx", "Directions to stream. Default: trx", {"mode"}, "trx", args::Options{});
+    args::ValueFlag<double>             durationFlag(parser, "s", "Duration of the workload. Default: 10", {"duration"}, 10, args::Options{});
+    args::ValueFlag<double>             intervalFlag(parser, "s", "Statistics sampling interval. Default: 1", {"interval"}, 1, args::Options{});
+    args::ImplicitValueFlag<int>        mimoFlag(parser, "channel count", "use multiple channels", {"mimo"}, 2, args::Options{});
+    args::ValueFlag<std::string>        formatFlag(parser, "I16, F32", "Host samples format. Default: I16", {"format"}, "I16", args::Options{});
+    args::ValueFlag<std::string>        linkFormatFlag(parser, "I16, I12", "Data transfer format. Default: I12", {"linkFormat"}, "I12", args::Options{});
+    args::ValueFlag<double>             sampleRateFlag(parser, "Hz", "Sampling rate hint, paces the simulated device", {"sampleRate"}, 0, args::Options{});
+    args::ValueFlag<std::string>        reportFlag(parser, "file path", "JSON report destination. Default: standard output", {'o', "output"}, "", args::Options{});
+    args::ValueFlag<std::string>        logFlag(parser, "", "Log verbosity: info, warning, error, verbose, debug", {'l', "log"}, "error", args::Options{});
+    // clang-format on
+
+    try
+    {
+        parser.ParseCLI(argc, argv);
+    } catch (args::Help&)
+    {
+        cout << parser << endl;
+        return EXIT_SUCCESS;
+    } catch (const std::exception& e)
+    {
+        cerr << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+
+    TRXBenchmark::Settings settings;
+    const std::string mode = args::get(modeFlag);
+    if (mode == "rx")
+        settings.mode = TRXBenchmark::Mode::Rx;
+    else if (mode == "tx")
+        settings.mode = TRXBenchmark::Mode::Tx;
+    else if (mode == "trx")
+        settings.mode = TRXBenchmark::Mode::FullDuplex;
+    else
+    {
+        cerr << "Invalid mode "sv << mode << endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::string format = args::get(formatFlag);
+    if (format == "I16")
+        settings.format = DataFormat::I16;
+    else if (format == "F32")
+        settings.format = DataFormat::F32;
+    else
+    {
+        cerr << "Invalid format "sv << format << endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::string linkFormat = args::get(linkFormatFlag);
+    if (linkFormat == "I16")
+        settings.linkFormat = DataFormat::I16;
+    else if (linkFormat == "I12")
+        settings.linkFormat = DataFormat::I12;
+    else
+    {
+        cerr << "Invalid linkFormat "sv << linkFormat << endl;
+        return EXIT_FAILURE;
+    }
+
+    const int channelCount = mimoFlag ? args::get(mimoFlag) : 1;
+    settings.chipIndex = args::get(chipFlag);
+    settings.channelCount = channelCount;
+    settings.duration_s = args::get(durationFlag);
+    settings.interval_s = args::get(intervalFlag);
+    settings.sampleRate = args::get(sampleRateFlag);
+    if (channelCount <= 0 || channelCount > 16 || settings.duration_s <= 0 || settings.interval_s <= 0 ||
+        settings.sampleRate < 0)
+    {
+        cerr << "Invalid benchmark settings"sv << endl;
+        return EXIT_FAILURE;
+    }
+
+    std::ofstream reportFile;
+    const std::string reportPath = args::get(reportFlag);
+    if (!reportPath.empty())
+    {
+        reportFile.open(reportPath);
+        if (!reportFile)
+        {
+            cerr << "Failed to open file: "sv << reportPath << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    logVerbosity = strToLogLevel(args::get(logFlag));
+    SDRDevice* device = ConnectToFilteredOrDefaultDevice(args::get(deviceFlag));
+    if (!device)
+        return EXIT_FAILURE;
+    device->SetMessageLogCallback(LogCallback);
+    lime::registerLogHandler(LogCallback);
+    lime::enableAsyncLogging(true);
+
+    signal(SIGINT, intHandler);
+    cerr << "Streaming "sv << mode << " for "sv << settings.duration_s << " s..."sv << endl;
+    TRXBenchmark benchmark(device, settings);
+    const bool success = benchmark.Run(reportPath.empty() ? cout : reportFile, stopProgram);
+    DeviceRegistry::freeDevice(device);
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 int main(int argc, char** argv)
 {
+    if (argc > 1 && "benchmark"sv == argv[1])
+        return BenchmarkCommand(argc - 1, argv + 1);
+
     // clang-format off
-    args::ArgumentParser                parser("limeTRX - Realtime streaming of RF samples", "");
+    args::ArgumentParser                parser("limeTRX - Realtime streaming of RF samples", "Run \"limeTRX benchmark --help\" for the sustained performance benchmark.");
     args::HelpFlag                      helpFlag(parser, "help", "This help", {'h', "help"});
 
     args::ValueFlag<std::string>        deviceFlag(parser, "name", "Specifies which device to use", {'d', "device"});
@@ -247,18 +419,27 @@ int main(int argc, char** argv)
     args::ValueFlag<std::string>        inputFlag(parser, "file path", "Waveform file for samples transmitting", {'i', "input"});
     args::ValueFlag<std::string>        outputFlag(parser, "file path", "Waveform file for received samples", {'o', "output"}, "", args::Options{});
     args::Flag                          looptxFlag(parser, "", "Loop tx samples transmission", {"looptx"});
+    args::ValueFlag<int>                inputChannelsFlag(parser, "channel count", "Number of channels in the input file. Default: 1", {"inputChannels"}, 1, args::Options{});
+    args::Flag                          splitInputFlag(parser, "", "Read each input channel from a separate file, instead of interleaved", {"splitInput"});
+    args::ValueFlag<int>                playBufferFlag(parser, "MB", "Size of the input read ahead buffer. Default: 64", {"playBuffer"}, 64, args::Options{});
     args::ValueFlag<int64_t>            samplesCountFlag(parser, "sample count", "Number of samples to receive", {'s', "samplesCount"}, 0, args::Options{});
     args::ValueFlag<int64_t>            timeFlag(parser, "ms", "Time duration in milliseconds to receive", {"time"}, 0, args::Options{});
     args::Flag                          fftFlag(parser, "", "Display Rx FFT plot", {"fft"});
     args::ValueFlag<std::string>        logFlag(parser, "", "Log verbosity: info, warning, error, verbose, debug", {'l', "log"}, "error", args::Options{});
     args::ImplicitValueFlag<int>        mimoFlag(parser, "channel count", "use multiple channels", {"mimo"}, 2, args::Options{});
-    args::ImplicitValueFlag<int64_t>    repeaterFlag(parser, "delaySamples", "retransmit received samples with a delay", {"repeater"}, 0, args::Options{});
+    args::ImplicitValueFlag<int64_t>    repeaterFlag(parser, "delaySamples", "retransmit received samples with a delay, the minimum safe delay if not given", {"repeater"}, -1, args::Options{});
+    args::ValueFlag<int>                repeaterBlockFlag(parser, "samples", "number of samples the repeater forwards at once. Default: 1024", {"repeaterBlock"}, 1024, args::Options{});
     args::ValueFlag<std::string>        linkFormatFlag(parser, "I16, I12", "Data transfer format. Default: I12", {"linkFormat"}, "I12", args::Options{});
+    args::ValueFlag<std::string>        outputFormatFlag(parser, "I16, I8, F16", "Output file samples format. Default: I16", {"outputFormat"}, "I16", args::Options{});
+    args::Flag                          splitChannelsFlag(parser, "", "Record each channel to a separate file, instead of interleaving them", {"splitChannels"});
+    args::Flag                          directIOFlag(parser, "", "Write the output file bypassing the page cache", {"directIO"});
+    args::ValueFlag<int>                recordBufferFlag(parser, "MB", "Size of the recording buffer. Default: 256", {"recordBuffer"}, 256, args::Options{});
     args::Flag                          syncPPSFlag(parser, "", "start sampling on next PPS", {"syncPPS"});
     args::ValueFlag<int>                rxSamplesInPacketFlag(parser, "packets", "number of samples in Rx packet", {"rxSamplesInPacket"}, 0, args::Options{});
     args::ValueFlag<int>                txSamplesInPacketFlag(parser, "packets", "number of samples in Tx packet", {"txSamplesInPacket"}, 0, args::Options{});
     args::ValueFlag<int>                rxPacketsInBatchFlag(parser, "packets", "number of Rx packets in data transfer", {"rxPacketsInBatch"}, 0, args::Options{});
     args::ValueFlag<int>                txPacketsInBatchFlag(parser, "packets", "number of Tx packets in data transfer", {"txPacketsInBatch"}, 0, args::Options{});
+    args::Flag                          latencyFlag(parser, "", "Print stream latency statistics", {"latency"});
 #ifdef USE_GNU_PLOT
     args::Flag                          constellationFlag(parser, "", "Display IQ constellation plot", {"constellation"});
 #endif
@@ -292,11 +473,36 @@ int main(int argc, char** argv)
     const int channelCount = mimoFlag ? args::get(mimoFlag) : 1;
     const bool repeater = repeaterFlag;
     const int64_t repeaterDelay = args::get(repeaterFlag);
+    const int repeaterBlock = args::get(repeaterBlockFlag);
     const bool syncPPS = syncPPSFlag;
     const int rxSamplesInPacket = args::get(rxSamplesInPacketFlag);
     const int txSamplesInPacket = args::get(txSamplesInPacketFlag);
     const int rxPacketsInBatch = args::get(rxPacketsInBatchFlag);
     const int txPacketsInBatch = args::get(txPacketsInBatchFlag);
+    const bool showLatency = latencyFlag;
+    const int recordBuffer = args::get(recordBufferFlag);
+    if (recordBuffer <= 0)
+    {
+        cerr << "Invalid recordBuffer "sv << recordBuffer << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (repeaterBlock <= 0)
+    {
+        cerr << "Invalid repeaterBlock "sv << repeaterBlock << std::endl;
+        return EXIT_FAILURE;
+    }
+    const int inputChannels = args::get(inputChannelsFlag);
+    if (inputChannels <= 0 || inputChannels > 16)
+    {
+        cerr << "Invalid inputChannels "sv << inputChannels << std::endl;
+        return EXIT_FAILURE;
+    }
+    const int playBuffer = args::get(playBufferFlag);
+    if (playBuffer <= 0)
+    {
+        cerr << "Invalid playBuffer "sv << playBuffer << std::endl;
+        return EXIT_FAILURE;
+    }
 
     std::vector<int> chipIndexes = ParseIntArray(chipFlag);
 
@@ -304,6 +510,7 @@ int main(int argc, char** argv)
     logVerbosity = strToLogLevel(args::get(logFlag));
     int chipIndex = 0;
     bool useComposite = false;
+    int rxChannelCount = channelCount;
 
     DataFormat linkFormat = DataFormat::I12;
     if (linkFormatFlag)
@@ -320,6 +527,23 @@ int main(int argc, char** argv)
         }
     }
 
+    DataFormat outputFormat = DataFormat::I16;
+    if (outputFormatFlag)
+    {
+        std::string val = args::get(outputFormatFlag);
+        if (val == "I16")
+            outputFormat = DataFormat::I16;
+        else if (val == "I8")
+            outputFormat = DataFormat::I8;
+        else if (val == "F16")
+            outputFormat = DataFormat::F16;
+        else
+        {
+            cerr << "Invalid outputFormat "sv << val << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
     auto handles = DeviceRegistry::enumerate();
     if (handles.size() == 0)
     {
@@ -333,6 +557,8 @@ int main(int argc, char** argv)
 
     device->SetMessageLogCallback(LogCallback);
     lime::registerLogHandler(LogCallback);
+    // don't let terminal output stall the streaming threads
+    lime::enableAsyncLogging(true);
 
     // if chip index is not specified and device has only one, use it by default
     if (chipIndexes.empty() && device->GetDescriptor().rfSOC.size() == 1)
@@ -368,6 +594,7 @@ int main(int argc, char** argv)
         if (useComposite)
         {
             std::vector<StreamAggregate> aggregates(chipIndexes.size());
+            rxChannelCount = 0;
             for (size_t i = 0; i < chipIndexes.size(); ++i)
             {
                 aggregates[i].device = device;
@@ -375,6 +602,7 @@ int main(int argc, char** argv)
                 int deviceChannelCount = device->GetDescriptor().rfSOC[chipIndexes[i]].channelCount;
                 for (int j = 0; j < deviceChannelCount; ++j)
                     aggregates[i].channels.push_back(j);
+                rxChannelCount += deviceChannelCount;
             }
             composite = new StreamComposite(std::move(aggregates));
             composite->StreamSetup(stream);
@@ -406,24 +634,30 @@ int main(int argc, char** argv)
     for (int i = 0; i < 16; ++i)
         rxData[i].resize(fftSize);
 
-    std::vector<complex16_t> txData;
-    int64_t txSent = 0;
-    if (tx && !txFilename.empty())
+    // the input is read ahead by a separate thread, so the transmitting never waits for the storage
+    std::unique_ptr<SamplePlayer> player;
+    std::vector<complex16_t> txData[16];
+    uint32_t txPending = 0; // samples read from the player, but not yet accepted by the stream
+    uint32_t txOffset = 0;
+    if (tx && !repeater && !txFilename.empty())
     {
-        std::ifstream inputFile;
-        inputFile.open(txFilename, std::ifstream::in | std::ifstream::binary);
-        if (!inputFile)
+        SamplePlayer::Settings playing;
+        playing.path = txFilename;
+        playing.channelCount = inputChannels;
+        playing.splitChannels = splitInputFlag;
+        playing.loop = loopTx;
+        playing.bufferSize = static_cast<std::size_t>(playBuffer) << 20;
+        player = std::make_unique<SamplePlayer>(playing);
+        std::string error;
+        if (!player->Start(error))
         {
-            cerr << "Failed to open file: "sv << txFilename << endl;
-            return -1;
+            cerr << error << endl;
+            return EXIT_FAILURE;
         }
-        inputFile.seekg(0, std::ios_base::end);
-        auto cnt = inputFile.tellg();
-        inputFile.seekg(0, std::ios_base::beg);
-        cerr << "File size : "sv << cnt << " bytes."sv << endl;
-        txData.resize(cnt / sizeof(complex16_t));
-        inputFile.read(reinterpret_cast<char*>(txData.data()), cnt);
-        inputFile.close();
+        for (int i = 0; i < inputChannels; ++i)
+            txData[i].resize(fftSize);
+        cerr << "Tx data from file: "sv << txFilename << " ("sv << player->GetLength() << " samples, "sv << inputChannels
+             << " channels)"sv << endl;
     }
 
     int64_t totalSamplesReceived = 0;
@@ -434,16 +668,36 @@ int main(int argc, char** argv)
     kiss_fft_cpx m_fftCalcOut[fftSize];
     fftBins[0] = 0;
 
-    std::ofstream rxFile;
+    // the samples are written from a separate thread, so storage stalls don't stop the receiving
+    std::unique_ptr<SampleRecorder> recorder;
     if (!rxFilename.empty())
     {
-        std::cout << "Rx data to file: "sv << rxFilename << std::endl;
-        rxFile.open(rxFilename, std::ofstream::out | std::ofstream::binary);
+        SampleRecorder::Settings recording;
+        recording.path = rxFilename;
+        recording.channelCount = std::min(rxChannelCount, 16);
+        recording.format = outputFormat;
+        recording.splitChannels = splitChannelsFlag;
+        recording.directIO = directIOFlag;
+        recording.bufferSize = static_cast<std::size_t>(recordBuffer) << 20;
+        recorder = std::make_unique<SampleRecorder>(recording);
+        std::string error;
+        if (!recorder->Start(error))
+        {
+            cerr << error << endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << "Rx data to file: "sv << rxFilename << " ("sv << static_cast<int>(recording.channelCount)
+                  << (recording.splitChannels ? " files)"sv : " channels interleaved)"sv) << std::endl;
     }
 
     float peakAmplitude = 0;
     float peakFrequency = 0;
     float sampleRate = device->GetSampleRate(chipIndex, TRXDir::Rx, 0);
+    if (repeater && repeaterDelay < 0 && sampleRate <= 0)
+    {
+        cerr << "Sample rate read-back not available, specify the repeater delay"sv << endl;
+        return EXIT_FAILURE;
+    }
     if (sampleRate <= 0)
         sampleRate = 1; // sample rate read-back not available, assign default value
     float frequencyLO = 0;
@@ -471,6 +725,43 @@ int main(int argc, char** argv)
     else
         device->StreamStart(chipIndex);
 
+    // the forwarding gets its own thread, the samples for the rest of the processing are taken from the repeater
+    std::unique_ptr<SampleRepeater> sampleRepeater;
+    if (repeater)
+    {
+        SampleRepeater::Stream repeaterStream;
+        repeaterStream.rx = [&](complex16_t* const* samples, uint32_t count, StreamMeta* meta) {
+            return useComposite ? composite->StreamRx(samples, count, meta) : device->StreamRx(chipIndex, samples, count, meta);
+        };
+        repeaterStream.tx = [&](const complex16_t* const* samples, uint32_t count, const StreamMeta* meta) {
+            return useComposite ? composite->StreamTx(samples, count, meta) : device->StreamTx(chipIndex, samples, count, meta);
+        };
+        repeaterStream.status = [&](StreamStats* rxStats, StreamStats* txStats) {
+            if (!useComposite)
+                return device->StreamStatus(chipIndex, rxStats, txStats);
+            // latencies of the first stream, late packets of all of them
+            device->StreamStatus(chipIndexes[0], rxStats, txStats);
+            for (size_t i = 1; i < chipIndexes.size(); ++i)
+            {
+                StreamStats chipRx;
+                device->StreamStatus(chipIndexes[i], &chipRx, nullptr);
+                rxStats->late += chipRx.late;
+            }
+        };
+        repeaterStream.timestamp = [&]() {
+            return useComposite ? composite->GetHardwareTimestamp() : device->GetHardwareTimestamp(chipIndex);
+        };
+
+        SampleRepeater::Settings repeating;
+        repeating.channelCount = std::min(rxChannelCount, 16);
+        repeating.sampleRate = sampleRate;
+        repeating.blockSize = repeaterBlock;
+        // the delay was counted from the end of the received block
+        repeating.delay = repeaterDelay < 0 ? -1 : repeaterDelay + repeaterBlock;
+        sampleRepeater = std::make_unique<SampleRepeater>(repeaterStream, repeating);
+        sampleRepeater->Start();
+    }
+
     auto startTime = std::chrono::high_resolution_clock::now();
     auto t1 = startTime - std::chrono::seconds(2); // rewind t1 to do update on first loop
     auto t2 = t1;
@@ -482,24 +773,28 @@ int main(int argc, char** argv)
         if (samplesToCollect != 0 && totalSamplesReceived > samplesToCollect)
             break;
 
-        int toSend = txData.size() - txSent > fftSize ? fftSize : txData.size() - txSent;
-        if (tx && !repeater)
+        if (player)
         {
-            if (loopTx && toSend == 0)
+            if (txPending == 0)
             {
-                txSent = 0;
-                toSend = txData.size() - txSent > fftSize ? fftSize : txData.size() - txSent;
+                complex16_t* playerSamples[16];
+                for (int i = 0; i < inputChannels; ++i)
+                    playerSamples[i] = txData[i].data();
+                txOffset = 0;
+                txPending = player->Read(playerSamples, fftSize);
             }
-            if (toSend > 0)
+            if (txPending > 0)
             {
+                // stream channels beyond the ones in the file transmit the first channel
                 const complex16_t* txSamples[16];
                 for (int i = 0; i < 16; ++i)
-                    txSamples[i] = &txData[txSent];
-                uint32_t samplesSent = useComposite ? composite->StreamTx(txSamples, toSend, &txMeta)
-                                                    : device->StreamTx(chipIndex, txSamples, toSend, &txMeta);
+                    txSamples[i] = txData[i < inputChannels ? i : 0].data() + txOffset;
+                uint32_t samplesSent = useComposite ? composite->StreamTx(txSamples, txPending, &txMeta)
+                                                    : device->StreamTx(chipIndex, txSamples, txPending, &txMeta);
                 if (samplesSent > 0)
                 {
-                    txSent += samplesSent;
+                    txOffset += samplesSent;
+                    txPending -= samplesSent;
                     txMeta.timestamp += samplesSent;
                 }
             }
@@ -508,28 +803,19 @@ int main(int argc, char** argv)
         complex16_t* rxSamples[16];
         for (int i = 0; i < 16; ++i)
             rxSamples[i] = rxData[i].data();
-        uint32_t samplesRead = useComposite ? composite->StreamRx(rxSamples, fftSize, &rxMeta)
-                                            : device->StreamRx(chipIndex, rxSamples, fftSize, &rxMeta);
+        uint32_t samplesRead = 0;
+        if (sampleRepeater)
+            samplesRead = sampleRepeater->Read(rxSamples, fftSize, stopProgram);
+        else
+            samplesRead = useComposite ? composite->StreamRx(rxSamples, fftSize, &rxMeta)
+                                       : device->StreamRx(chipIndex, rxSamples, fftSize, &rxMeta);
         if (samplesRead == 0)
             continue;
 
-        if (tx && repeater)
-        {
-            txMeta.timestamp = rxMeta.timestamp + samplesRead + repeaterDelay;
-            txMeta.waitForTimestamp = true;
-            txMeta.flushPartialPacket = true;
-            if (useComposite)
-                composite->StreamTx(rxSamples, samplesRead, &txMeta);
-            else
-                device->StreamTx(chipIndex, rxSamples, samplesRead, &txMeta);
-        }
-
         // process samples
         totalSamplesReceived += samplesRead;
-        if (!rxFilename.empty())
-        {
-            rxFile.write(reinterpret_cast<char*>(rxSamples[0]), samplesRead * sizeof(lime::complex16_t));
-        }
+        if (recorder)
+            recorder->Push(rxSamples, samplesRead);
 
         t2 = std::chrono::high_resolution_clock::now();
         const bool doUpdate = t2 - t1 > std::chrono::milliseconds(500);
@@ -576,6 +862,14 @@ int main(int argc, char** argv)
             {
                 std::cerr << "Samples received: " << totalSamplesReceived << endl;
             }
+            if (showLatency)
+                PrintStreamLatencies(device, useComposite ? chipIndexes : std::vector<int>{ chipIndex });
+            if (player)
+                PrintPlayerStats(*player);
+            if (sampleRepeater)
+                PrintRepeaterStats(*sampleRepeater, sampleRate);
+            if (recorder)
+                PrintRecorderStats(*recorder);
         }
 
 #ifdef USE_GNU_PLOT
@@ -587,6 +881,13 @@ int main(int argc, char** argv)
     // some sleep for GNU plot data to flush, otherwise sometimes cout spams  gnuplot "invalid command"
     this_thread::sleep_for(std::chrono::milliseconds(500));
 #endif
+    if (sampleRepeater)
+    {
+        sampleRepeater->Stop();
+        PrintRepeaterStats(*sampleRepeater, sampleRate);
+    }
+    if (showLatency)
+        PrintStreamLatencies(device, useComposite ? chipIndexes : std::vector<int>{ chipIndex });
     if (useComposite)
         composite->StreamStop();
     else
@@ -599,6 +900,15 @@ int main(int argc, char** argv)
         delete composite;
     DeviceRegistry::freeDevice(device);
 
-    rxFile.close();
+    if (player)
+    {
+        player->Stop();
+        PrintPlayerStats(*player);
+    }
+    if (recorder)
+    {
+        recorder->Stop();
+        PrintRecorderStats(*recorder);
+    }
     return 0;
 }
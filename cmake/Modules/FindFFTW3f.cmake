@@ -0,0 +1,31 @@
+# - Try to find the single precision FFTW3 library
+# Once done this will define
+#
+#  FFTW3F_FOUND - system has fftw3f
+#  FFTW3F_INCLUDE_DIRS - the fftw3 include directory
+#  FFTW3F_LIBRARIES - Link these to use fftw3f
+
+find_package(PkgConfig QUIET)
+if(PKG_CONFIG_FOUND)
+    pkg_check_modules(PC_FFTW3F QUIET fftw3f)
+endif()
+
+find_path(
+    FFTW3F_INCLUDE_DIR
+    NAMES fftw3.h
+    HINTS ${PC_FFTW3F_INCLUDE_DIRS})
+
+find_library(
+    FFTW3F_LIBRARY
+    NAMES fftw3f libfftw3f-3
+    HINTS ${PC_FFTW3F_LIBRARY_DIRS})
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(FFTW3f DEFAULT_MSG FFTW3F_LIBRARY FFTW3F_INCLUDE_DIR)
+
+if(FFTW3F_FOUND)
+    set(FFTW3F_INCLUDE_DIRS ${FFTW3F_INCLUDE_DIR})
+    set(FFTW3F_LIBRARIES ${FFTW3F_LIBRARY})
+endif()
+
+mark_as_advanced(FFTW3F_INCLUDE_DIR FFTW3F_LIBRARY)
@@ -156,6 +156,10 @@ lime_Result lms7002m_get_i_q_balance(
 /// @param temperature_mC Chip temperature in millidegree Celsius
 lime_Result lms7002m_get_temperature(struct lms7002m_context* self, int32_t* temperature_mC);
 
+/// @param reg606 The value of the temperature sensor ADC register 0x0606
+/// @return Chip temperature in millidegree Celsius
+int32_t lms7002m_convert_temperature(uint16_t reg606);
+
 lime_Result lms7002m_set_clock_frequency(struct lms7002m_context* self, enum lms7002m_clock_id clk_id, uint32_t freq);
 uint32_t lms7002m_get_clock_frequency(struct lms7002m_context* self, enum lms7002m_clock_id clk_id);
 
@@ -1586,6 +1586,14 @@ lime_Result lms7002m_get_i_q_balance(
     return lime_Result_Success;
 }
 
+int32_t lms7002m_convert_temperature(uint16_t reg606)
+{
+    const int32_t Vtemp = ((reg606 >> 8) & 0xFF);
+    const int32_t Vptat = (reg606 & 0xFF);
+    const int32_t Vdiff = (Vptat - Vtemp) * 1752; // * 1840 / 1050;
+    return 45000 + Vdiff;
+}
+
 lime_Result lms7002m_get_temperature(lms7002m_context* self, int32_t* milliCelsius)
 {
     lime_Result ret = lms7002m_calibrate_internal_adc(self, 32);
@@ -1601,11 +1609,13 @@ lime_Result lms7002m_get_temperature(lms7002m_context* self, int32_t* milliCelsi
     const uint16_t reg606 = lms7002m_spi_read(self, 0x0606);
     lms7002m_spi_modify_csr(self, LMS7002M_MUX_BIAS_OUT, biasMux);
 
-    const int32_t Vtemp = ((reg606 >> 8) & 0xFF);
-    const int32_t Vptat = (reg606 & 0xFF);
-    const int32_t Vdiff = (Vptat - Vtemp) * 1752; // * 1840 / 1050;
-    const int32_t temperature_mC = 45000 + Vdiff;
-    LMS7002M_LOG(self, lime_LogLevel_Debug, "Vtemp(0x%02X), Vptat(0x%02X), temp=%d mC", Vtemp, Vptat, temperature_mC);
+    const int32_t temperature_mC = lms7002m_convert_temperature(reg606);
+    LMS7002M_LOG(self,
+        lime_LogLevel_Debug,
+        "Vtemp(0x%02X), Vptat(0x%02X), temp=%d mC",
+        (reg606 >> 8) & 0xFF,
+        reg606 & 0xFF,
+        temperature_mC);
 
     if (milliCelsius != NULL)
         *milliCelsius = temperature_mC;
@@ -42,7 +42,7 @@ struct IConnectionStream {
 std::vector<std::string> Soapy_limesuiteng::getStreamFormats(
     [[maybe_unused]] const int direction, [[maybe_unused]] const size_t channel) const
 {
-    return { SOAPY_SDR_CF32, SOAPY_SDR_CS12, SOAPY_SDR_CS16 };
+    return { SOAPY_SDR_CF32, SOAPY_SDR_CS12, SOAPY_SDR_CS16, SOAPY_SDR_CS8 };
 }
 
 std::string Soapy_limesuiteng::getNativeStreamFormat(
@@ -133,12 +133,18 @@ SoapySDR::Stream* Soapy_limesuiteng::setupStream(
     {
         config.format = DataFormat::I12;
     }
+    else if (format == SOAPY_SDR_CS8)
+    {
+        config.format = DataFormat::I8;
+    }
     else
     {
         throw std::runtime_error("Soapy_limesuiteng::setupStream(format=" + format + ") unsupported stream format");
     }
 
-    config.linkFormat = config.format == DataFormat::F32 ? DataFormat::I16 : config.format;
+    // host only formats are transferred as I16
+    const bool hostOnlyFormat = config.format == DataFormat::F32 || config.format == DataFormat::I8;
+    config.linkFormat = hostOnlyFormat ? DataFormat::I16 : config.format;
 
     // Optional link format
     if (args.count("linkFormat"))
@@ -316,6 +322,12 @@ int Soapy_limesuiteng::readStream(
                 samplesReceived =
                     icstream->ownerDevice->StreamRx(0, reinterpret_cast<complex32f_t* const*>(buffs), samplesToSkip, &metadata);
                 break;
+            case DataFormat::I8:
+                samplesReceived =
+                    icstream->ownerDevice->StreamRx(0, reinterpret_cast<complex8_t* const*>(buffs), samplesToSkip, &metadata);
+                break;
+            default:
+                break;
             }
             if (samplesReceived <= 0)
                 return SOAPY_SDR_STREAM_ERROR;
@@ -341,6 +353,11 @@ int Soapy_limesuiteng::readStream(
     case DataFormat::F32:
         samplesReceived = icstream->ownerDevice->StreamRx(0, reinterpret_cast<complex32f_t* const*>(buffs), numElems, &metadata);
         break;
+    case DataFormat::I8:
+        samplesReceived = icstream->ownerDevice->StreamRx(0, reinterpret_cast<complex8_t* const*>(buffs), numElems, &metadata);
+        break;
+    default:
+        break;
     }
 
     flags = 0;
@@ -409,6 +426,11 @@ int Soapy_limesuiteng::writeStream(SoapySDR::Stream* stream,
     case DataFormat::F32:
         samplesSent = ownerDevice->StreamTx(0, reinterpret_cast<const complex32f_t* const*>(buffs), numElems, &metadata);
         break;
+    case DataFormat::I8:
+        samplesSent = ownerDevice->StreamTx(0, reinterpret_cast<const complex8_t* const*>(buffs), numElems, &metadata);
+        break;
+    default:
+        break;
     }
 
     if (samplesSent == 0)
@@ -772,6 +772,12 @@ API_EXPORT int CALL_CONV LMS_SetupStream(lms_device_t* device, lms_stream_t* str
     case lms_stream_t::LMS_FMT_I12:
         config.format = lime::DataFormat::I12;
         break;
+    case lms_stream_t::LMS_FMT_I8:
+        config.format = lime::DataFormat::I8;
+        break;
+    case lms_stream_t::LMS_FMT_F16:
+        config.format = lime::DataFormat::F16;
+        break;
     default:
         return lime::error("Setup stream failed: invalid data format."s);
     }
@@ -997,6 +1003,12 @@ API_EXPORT int CALL_CONV LMS_RecvStream(
     case lms_stream_t::LMS_FMT_I16:
         samplesProduced = ReceiveStream<lime::complex16_t>(stream, samples, sample_count, meta, timeout_ms);
         break;
+    case lms_stream_t::LMS_FMT_I8:
+        samplesProduced = ReceiveStream<lime::complex8_t>(stream, samples, sample_count, meta, timeout_ms);
+        break;
+    case lms_stream_t::LMS_FMT_F16:
+        samplesProduced = ReceiveStream<lime::complex16f_t>(stream, samples, sample_count, meta, timeout_ms);
+        break;
     default:
         break;
     }
@@ -1111,6 +1123,12 @@ API_EXPORT int CALL_CONV LMS_SendStream(
     case lms_stream_t::LMS_FMT_I16:
         samplesSent = SendStream<lime::complex16_t>(stream, samples, sample_count, meta, timeout_ms);
         break;
+    case lms_stream_t::LMS_FMT_I8:
+        samplesSent = SendStream<lime::complex8_t>(stream, samples, sample_count, meta, timeout_ms);
+        break;
+    case lms_stream_t::LMS_FMT_F16:
+        samplesSent = SendStream<lime::complex16f_t>(stream, samples, sample_count, meta, timeout_ms);
+        break;
     default:
         break;
     }
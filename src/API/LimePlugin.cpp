@@ -477,11 +477,49 @@ static OpStatus AssignDevicesToPorts(LimePluginContext* context)
     return OpStatus::Success;
 }
 
+static const char* DataFormatName(DataFormat format)
+{
+    switch (format)
+    {
+    case DataFormat::I16:
+        return "I16";
+    case DataFormat::I12:
+        return "I12";
+    case DataFormat::F32:
+        return "F32";
+    case DataFormat::I8:
+        return "I8";
+    case DataFormat::F16:
+        return "F16";
+    }
+    return "unknown";
+}
+
 static void GatherEnvironmentSettings(LimePluginContext* context, LimeSettingsProvider* configProvider)
 {
     int val = 0;
     if (GetParam(context, val, "logLevel"))
         logVerbosity = std::min(static_cast<LogLevel>(val), LogLevel::Debug);
+
+    std::string samplesFormatStr;
+    if (GetSetting(configProvider, &samplesFormatStr, "samplesFormat"))
+    {
+        if (samplesFormatStr == "F32"s)
+            context->samplesFormat = lime::DataFormat::F32;
+        else if (samplesFormatStr == "I16"s)
+            context->samplesFormat = lime::DataFormat::I16;
+        else if (samplesFormatStr == "I12"s)
+            context->samplesFormat = lime::DataFormat::I12;
+        else if (samplesFormatStr == "I8"s)
+            context->samplesFormat = lime::DataFormat::I8;
+        else if (samplesFormatStr == "F16"s)
+            context->samplesFormat = lime::DataFormat::F16;
+        else
+            Log(LogLevel::Warning,
+                "Invalid samples format (%s): keeping %s",
+                samplesFormatStr.c_str(),
+                DataFormatName(context->samplesFormat));
+    }
 }
 
 static void GatherDirectionalSettings(LimeSettingsProvider* settings, DirectionalSettings* dir, const char* varPrefix)
@@ -865,8 +903,8 @@ OpStatus ConfigureStreaming(LimePluginContext* context, const LimeRuntimeParamet
         Log(LogLevel::Debug,
             "Port[%li] Stream samples format: %s , link: %s %s",
             p,
-            stream.format == DataFormat::F32 ? "F32" : "I16",
-            stream.linkFormat == DataFormat::I12 ? "I12" : "I16",
+            DataFormatName(stream.format),
+            DataFormatName(stream.linkFormat),
             (stream.extraConfig.negateQ ? ", Negating Q samples" : ""));
 
         port.composite = new StreamComposite(aggregates);
@@ -983,6 +1021,18 @@ int LimePlugin_Write_complex16(
     return LimePlugin_Write(context, samples, count, port, meta);
 }
 
+int LimePlugin_Write_complex8(
+    LimePluginContext* context, const lime::complex8_t* const* samples, int count, int port, StreamMeta& meta)
+{
+    return LimePlugin_Write(context, samples, count, port, meta);
+}
+
+int LimePlugin_Write_complex16f(
+    LimePluginContext* context, const lime::complex16f_t* const* samples, int count, int port, StreamMeta& meta)
+{
+    return LimePlugin_Write(context, samples, count, port, meta);
+}
+
 template<class T> static int LimePlugin_Read(LimePluginContext* context, T* const* samples, int count, int port, StreamMeta& meta)
 {
     meta.waitForTimestamp = false;
@@ -1014,3 +1064,14 @@ int LimePlugin_Read_complex16(LimePluginContext* context, lime::complex16_t* con
 {
     return LimePlugin_Read(context, samples, count, port, meta);
 }
+
+int LimePlugin_Read_complex8(LimePluginContext* context, lime::complex8_t* const* samples, int count, int port, StreamMeta& meta)
+{
+    return LimePlugin_Read(context, samples, count, port, meta);
+}
+
+int LimePlugin_Read_complex16f(
+    LimePluginContext* context, lime::complex16f_t* const* samples, int count, int port, StreamMeta& meta)
+{
+    return LimePlugin_Read(context, samples, count, port, meta);
+}
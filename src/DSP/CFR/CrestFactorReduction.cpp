@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <vector>
 #include <string.h>
+#include <map>
 #include <memory>
 
 #include "comms/ISPI.h"
@@ -27,282 +28,235 @@ CrestFactorReduction::~CrestFactorReduction()
 {
 }
 
-void CrestFactorReduction::WriteRegister(const Register& reg, uint16_t value)
+namespace {
+
+/// @brief Local copy of register values, indexed by address.
+using RegisterImage = std::map<uint16_t, uint16_t>;
+
+// coefficient memories, 32 values each
+constexpr uint16_t cfrMemory0 = 0x000C << 6;
+constexpr uint16_t cfrMemory1 = 0x000D << 6;
+constexpr uint16_t firMemory0 = 0x000E << 6;
+constexpr uint16_t firMemory1 = 0x000F << 6;
+constexpr uint16_t maxCoefficientsCount = 32;
+
+uint32_t WriteCommand(uint16_t address, uint16_t value)
+{
+    return (1u << 31) | address << 16 | value;
+}
+
+void SetField(RegisterImage& image, const Register& reg, uint16_t value)
 {
-    uint32_t mosi = reg.address;
-    uint32_t miso = 0;
-    m_Comms->SPI(&mosi, &miso, 1);
     const uint16_t regMask = bitMask(reg.msb, reg.lsb);
+    uint16_t& regValue = image[reg.address];
+    regValue = (regValue & ~regMask) | ((value << reg.lsb) & regMask);
+}
 
-    uint32_t regValue = (miso & ~regMask);
-    regValue |= ((value << reg.lsb) & regMask);
-    mosi = (1 << 31) | reg.address << 16 | regValue;
-    m_Comms->SPI(&mosi, nullptr, 1);
+uint16_t GetField(const RegisterImage& image, const Register& reg)
+{
+    const uint16_t regMask = bitMask(reg.msb, reg.lsb);
+    return (image.at(reg.address) & regMask) >> reg.lsb;
 }
 
-uint16_t CrestFactorReduction::ReadRegister(const Register& reg)
+void AppendWrite(std::vector<uint32_t>& mosi, const RegisterImage& image, uint16_t address)
 {
-    uint32_t mosi = reg.address;
+    mosi.push_back(WriteCommand(address, image.at(address)));
+}
+
+} // namespace
+
+OpStatus CrestFactorReduction::ReadMAC(uint16_t& value)
+{
+    const uint32_t mosi = MAC.address;
     uint32_t miso = 0;
-    m_Comms->SPI(&mosi, &miso, 1);
-    const uint16_t regMask = bitMask(reg.msb, reg.lsb);
-    return (miso & regMask) >> reg.lsb;
+    OpStatus status = m_Comms->SPI(&mosi, &miso, 1);
+    value = miso;
+    return status;
 }
 
-void CrestFactorReduction::Configure(const CrestFactorReduction::Config& state)
+/// @brief Selects the channel and reads the registers containing the given fields in a single transaction.
+/// Addresses fully covered by the fields are not read, as all of their bits are going to be overwritten.
+OpStatus CrestFactorReduction::ReadChannelRegisters(
+    uint8_t channel, uint16_t macValue, const std::vector<Register>& fields, RegisterImage& image)
 {
-    // TODO: batch writes
-    for (uint8_t ch = 0; ch < 2; ++ch)
+    std::map<uint16_t, uint16_t> usedBits;
+    for (const Register& reg : fields)
+        usedBits[reg.address] |= bitMask(reg.msb, reg.lsb);
+
+    RegisterImage mac{ { MAC.address, macValue } };
+    SetField(mac, MAC, channel + 1);
+    std::vector<uint32_t> mosi{ WriteCommand(MAC.address, mac.at(MAC.address)) };
+    image.clear();
+    for (const auto& [address, mask] : usedBits)
     {
-        WriteRegister(MAC, ch + 1);
-        WriteRegister(RX_EQU_BYP, state.bypassRxEqualizer[ch]);
-        WriteRegister(TX_EQU_BYP, state.bypassTxEqualizer[ch]);
+        image[address] = 0;
+        if (mask != 0xFFFF)
+            mosi.push_back(address);
+    }
+
+    std::vector<uint32_t> miso(mosi.size());
+    OpStatus status = m_Comms->SPI(mosi.data(), miso.data(), mosi.size());
+    if (status != OpStatus::Success)
+        return status;
 
+    for (std::size_t i = 1; i < mosi.size(); ++i)
+        image[mosi[i]] = miso[i];
+    return OpStatus::Success;
+}
+
+OpStatus CrestFactorReduction::Configure(const CrestFactorReduction::Config& state)
+{
+    const std::vector<Register> fields = { RX_EQU_BYP,
+        TX_EQU_BYP,
+        TX_HB_BYP,
+        TX_HB_DEL,
+        SLEEP_CFR,
+        BYPASS_CFR,
+        ODD_CFR,
+        BYPASSGAIN_CFR,
+        ODD_FIR,
+        SLEEP_FIR,
+        BYPASS_FIR,
+        CFR_ORDER,
+        thresholdSpin,
+        thresholdGain };
+
+    uint16_t macValue = 0;
+    OpStatus status = ReadMAC(macValue);
+    if (status != OpStatus::Success)
+        return status;
+
+    for (uint8_t ch = 0; ch < 2; ++ch)
+    {
         const Config::CFR& cfr = state.cfr[ch];
         const Config::FIR& fir = state.fir[ch];
+        assert(fir.coefficientsCount <= maxCoefficientsCount);
 
-        const bool useOversample = std::min<uint8_t>(cfr.interpolation, 2) != 1;
+        RegisterImage image;
+        status = ReadChannelRegisters(ch, macValue, fields, image);
+        if (status != OpStatus::Success)
+            return status;
 
-        WriteRegister(TX_HB_BYP, !useOversample);
-        WriteRegister(TX_HB_DEL, useOversample);
-        WriteRegister(SLEEP_CFR, cfr.sleep);
-        WriteRegister(BYPASS_CFR, cfr.bypass);
-        WriteRegister(ODD_CFR, fir.coefficientsCount % 2);
-        WriteRegister(BYPASSGAIN_CFR, cfr.bypassGain);
-
-        assert(fir.coefficientsCount <= 32);
-        SetFIRCoefficients(fir.coefficients, fir.coefficientsCount);
-        // WriteRegister(ODD_FIR, fir.coefficientsCount % 2); // set in SetFIRCoefficients
-        WriteRegister(SLEEP_FIR, fir.sleep);
-        WriteRegister(BYPASS_FIR, fir.bypass);
-
-        if (cfr.order >= 2 && cfr.order <= 32)
-        {
-            WriteRegister(CFR_ORDER, cfr.order);
-            UpdateHannCoeff(cfr.order);
-        }
-        WriteRegister(thresholdSpin, cfr.threshold);
-        WriteRegister(thresholdGain, cfr.thresholdGain);
+        const bool useOversample = std::min<uint8_t>(cfr.interpolation, 2) != 1;
+        const bool updateOrder = cfr.order >= 2 && cfr.order <= maxCoefficientsCount;
+
+        SetField(image, RX_EQU_BYP, state.bypassRxEqualizer[ch]);
+        SetField(image, TX_EQU_BYP, state.bypassTxEqualizer[ch]);
+        SetField(image, TX_HB_BYP, !useOversample);
+        SetField(image, TX_HB_DEL, useOversample);
+        SetField(image, BYPASS_CFR, cfr.bypass);
+        SetField(image, ODD_CFR, (updateOrder ? cfr.order : fir.coefficientsCount) % 2);
+        SetField(image, BYPASSGAIN_CFR, cfr.bypassGain);
+        SetField(image, ODD_FIR, maxCoefficientsCount % 2);
+        SetField(image, BYPASS_FIR, fir.bypass);
+        SetField(image, thresholdSpin, cfr.threshold);
+        SetField(image, thresholdGain, cfr.thresholdGain);
+        if (updateOrder)
+            SetField(image, CFR_ORDER, cfr.order);
+
+        // filters are kept asleep while their coefficient memories are being written
+        SetField(image, SLEEP_FIR, 1);
+        SetField(image, SLEEP_CFR, updateOrder ? 1 : cfr.sleep);
+
+        std::vector<uint32_t> mosi;
+        AppendWrite(mosi, image, RX_EQU_BYP.address);
+        AppendWrite(mosi, image, thresholdSpin.address);
+        AppendWrite(mosi, image, thresholdGain.address);
+        if (updateOrder)
+            AppendWrite(mosi, image, CFR_ORDER.address);
+        AppendWrite(mosi, image, TX_HB_BYP.address);
+
+        AppendFIRCoefficients(mosi, fir.coefficients);
+        if (updateOrder)
+            AppendHannCoefficients(mosi, cfr.order);
+
+        // the CFR is released from sleep after loading new coefficients
+        SetField(image, SLEEP_FIR, fir.sleep);
+        SetField(image, SLEEP_CFR, updateOrder ? 0 : cfr.sleep);
+        AppendWrite(mosi, image, SLEEP_CFR.address);
+
+        status = m_Comms->SPI(mosi.data(), nullptr, mosi.size());
+        if (status != OpStatus::Success)
+            return status;
     }
+    return OpStatus::Success;
 }
 
 // Generates coefficients based on CFR order
-void CrestFactorReduction::UpdateHannCoeff(uint16_t Filt_N)
+void CrestFactorReduction::AppendHannCoefficients(std::vector<uint32_t>& mosi, uint16_t Filt_N)
 {
-    uint16_t msb, lsb = 0;
-    uint16_t data = 0;
-    uint16_t addr = 0;
-    uint16_t i = 0;
-    uint16_t j = 0;
-    uint16_t offset = 0;
-    uint16_t w[40];
-
-    // CFR registers
-    uint16_t maddressf0 = 0x000C; // 12*64=768
-    uint16_t maddressf1 = 0x000D; // 13*64=832
-    uint16_t NN = 15;
-    const uint16_t MaxFilt_N = 32;
-
-    Filt_N = std::min(Filt_N, MaxFilt_N);
-
-    for (i = 0; i < Filt_N; ++i)
-        w[i] = static_cast<uint16_t>(32768.0 * 0.25 * (1.0 - cos(2.0 * M_PI * i / (Filt_N - 1))));
-
-    WriteRegister(SLEEP_CFR, 1);
-    msb = lsb = 0;
-    data = 0;
-    i = 0;
-
-    //WriteRegister(RESET_N, 0);
-    //WriteRegister(RESET_N, 1);
+    Filt_N = std::min(Filt_N, maxCoefficientsCount);
 
-    // TODO: figure out this address mess. For now just replaced SPI write functions
-    std::vector<uint32_t> mosi;
-    while (i < MaxFilt_N)
-    {
-        addr = (2 << 15) + (maddressf0 << 6) + (msb << 4) + lsb;
-        mosi.push_back((1 << 31) | addr << 16 | data);
-        addr = (2 << 15) + (maddressf1 << 6) + (msb << 4) + lsb;
-        mosi.push_back((1 << 31) | addr << 16 | data);
-        if (lsb >= NN) // 15
-        {
-            lsb = 0;
-            msb++;
-        }
-        else
-            lsb++;
-        i++;
-    }
-    m_Comms->SPI(mosi.data(), nullptr, mosi.size());
-    mosi.clear();
+    uint16_t w[maxCoefficientsCount];
+    for (uint16_t i = 0; i < Filt_N; ++i)
+        w[i] = static_cast<uint16_t>(32768.0 * 0.25 * (1.0 - cos(2.0 * M_PI * i / (Filt_N - 1))));
 
-    msb = lsb = 0;
-    i = j = 0;
-    offset = 0;
-    while (i <= static_cast<uint16_t>((Filt_N / 2) - 1))
+    // The first memory holds the whole window, aligned to end in the middle of the second half,
+    // the second memory holds the second half of the window. Unused coefficients are zeroed.
+    const uint16_t offset = (maxCoefficientsCount / 2) - ((Filt_N + 1) / 2);
+    for (uint16_t i = 0; i < maxCoefficientsCount; ++i)
     {
-        addr = (2 << 15) + (maddressf1 << 6) + (msb << 4) + lsb;
-        if (j >= offset)
-            data = w[static_cast<uint16_t>((Filt_N + 1) / 2 + i)];
-        else
-            data = 0;
-        mosi.push_back((1 << 31) | addr << 16 | data);
-        if (lsb >= NN) // 15
-        {
-            lsb = 0;
-            msb++;
-        }
-        else
-            lsb++;
-
-        if (j >= offset)
-            i++;
-        j++;
+        const uint16_t data = (i >= offset && i < offset + Filt_N) ? w[i - offset] : 0;
+        mosi.push_back(WriteCommand(cfrMemory0 + i, data));
     }
-    m_Comms->SPI(mosi.data(), nullptr, mosi.size());
-    mosi.clear();
-
-    msb = lsb = 0;
-    i = j = 0;
-    offset = (MaxFilt_N / 2) - (static_cast<uint16_t>((Filt_N + 1) / 2));
-    while (i < Filt_N)
+    for (uint16_t i = 0; i < maxCoefficientsCount; ++i)
     {
-        addr = (2 << 15) + (maddressf0 << 6) + (msb << 4) + lsb;
-
-        if (j >= offset)
-            data = w[i];
-        else
-            data = 0;
-
-        mosi.push_back((1 << 31) | addr << 16 | data);
-        if (lsb >= NN) // 3
-        {
-            lsb = 0;
-            msb++;
-        }
-        else
-            lsb++;
-
-        if (j >= offset)
-            i++;
-        j++;
+        const uint16_t data = i < Filt_N / 2 ? w[(Filt_N + 1) / 2 + i] : 0;
+        mosi.push_back(WriteCommand(cfrMemory1 + i, data));
     }
-    m_Comms->SPI(mosi.data(), nullptr, mosi.size());
-    mosi.clear();
-
-    WriteRegister(ODD_CFR, Filt_N % 2);
-    WriteRegister(SLEEP_CFR, 0); // RELEASE SLEEP_CFR
-
-    // software reset
-    //WriteRegister(RESET_N, 0);
-    //WriteRegister(RESET_N, 1);
 }
 
-void CrestFactorReduction::SetFIRCoefficients(const int16_t* coefficients, uint16_t count)
+void CrestFactorReduction::AppendFIRCoefficients(std::vector<uint32_t>& mosi, const int16_t* coefficients)
 {
-    const int maxCoefCount = 32;
-    assert(count <= 32);
-
-    // FIR registers
-    uint16_t maddressf0 = 0x000E; // 14x64 = 896;
-    uint16_t maddressf1 = 0x000F; // 15x64 = 960;
-
-    const uint16_t Filt_N = 32;
-    uint16_t NN = 0;
-    uint16_t addr = 0;
-    uint16_t data = 0;
-    uint16_t msb = 0;
-    uint16_t lsb = 0;
-    uint16_t i = 0;
-
-    NN = 15;
-
-    // std::vector<double> coefficients;
-    // coefficients.resize(Filt_N, 0);
-
-    // for (i = 0; i < Filt_N; i++) // maxCoefCount
-    //     coefficients[i] = 0.0;
-
-    // read coeffs
-    // msb = lsb = i = 0;
-    // while (i <= (uint16_t)((Filt_N)-1))
-    // {
-    //     addr = (maddressf0 << 6) + (msb << 4) + lsb;
-    //     uint32_t mosi = addr;
-    //     uint32_t miso = 0;
-    //     m_Comms->SPI(&mosi, &miso, 1);
-    //     coefficients[i] = (double)(miso & 0xFFFF);
-    //     if (lsb >= NN) // 15
-    //     {
-    //         lsb = 0;
-    //         msb++;
-    //     }
-    //     else
-    //         lsb++;
-    //     i++;
-    // }
-
-    WriteRegister(SLEEP_FIR, 1);
-
-    std::vector<uint32_t> mosi;
-    for (i = 0; i < maxCoefCount; i++)
-    {
-        addr = (maddressf0 << 6) + i;
-        mosi.push_back((1 << 31) | addr << 16 | 0);
-        addr = (maddressf1 << 6) + i;
-        mosi.push_back((1 << 31) | addr << 16 | 0);
-    }
-    m_Comms->SPI(mosi.data(), nullptr, mosi.size());
-    mosi.clear();
-
-    msb = lsb = i = 0;
-    while (i <= static_cast<uint16_t>((Filt_N)-1))
+    // both memories hold the same coefficients, the whole memory is always written
+    for (uint16_t i = 0; i < maxCoefficientsCount; ++i)
     {
-        addr = (maddressf0 << 6) + (msb << 4) + lsb;
-        data = static_cast<uint16_t>(coefficients[i]);
-        mosi.push_back((1 << 31) | addr << 16 | data);
-
-        addr = (maddressf1 << 6) + (msb << 4) + lsb;
-        data = static_cast<uint16_t>(coefficients[i]);
-        mosi.push_back((1 << 31) | addr << 16 | data);
-        if (lsb >= NN) // 15
-        {
-            lsb = 0;
-            msb++;
-        }
-        else
-            lsb++;
-        i++;
+        const uint16_t data = static_cast<uint16_t>(coefficients[i]);
+        mosi.push_back(WriteCommand(firMemory0 + i, data));
+        mosi.push_back(WriteCommand(firMemory1 + i, data));
     }
-    m_Comms->SPI(mosi.data(), nullptr, mosi.size());
-    mosi.clear();
-
-    WriteRegister(ODD_FIR, Filt_N % 2);
-    WriteRegister(SLEEP_FIR, 0);
 }
 
-void CrestFactorReduction::SetOversample(uint8_t oversample)
+OpStatus CrestFactorReduction::SetOversample(uint8_t oversample)
 {
     // treat oversample 0 as "auto", maximum available oversample
     const uint8_t maxOversample = 2;
     oversample = std::min(oversample, maxOversample);
 
     const bool useOversample = oversample != 1;
-    // TODO: batch writes
+    uint16_t macValue = 0;
+    OpStatus status = ReadMAC(macValue);
+    if (status != OpStatus::Success)
+        return status;
+
     for (uint8_t ch = 0; ch < 2; ++ch)
     {
-        WriteRegister(MAC, ch + 1);
-        WriteRegister(TX_HB_BYP, !useOversample);
-        WriteRegister(TX_HB_DEL, useOversample);
+        RegisterImage image;
+        status = ReadChannelRegisters(ch, macValue, { TX_HB_BYP, TX_HB_DEL }, image);
+        if (status != OpStatus::Success)
+            return status;
+
+        SetField(image, TX_HB_BYP, !useOversample);
+        SetField(image, TX_HB_DEL, useOversample);
+        std::vector<uint32_t> mosi;
+        AppendWrite(mosi, image, TX_HB_BYP.address);
+        status = m_Comms->SPI(mosi.data(), nullptr, mosi.size());
+        if (status != OpStatus::Success)
+            return status;
     }
+    return OpStatus::Success;
 }
 
 uint8_t CrestFactorReduction::GetOversample()
 {
     const int ch = 0;
-    WriteRegister(MAC, ch + 1);
-    int bypass = ReadRegister(TX_HB_BYP);
-    int delay = ReadRegister(TX_HB_DEL);
+    uint16_t macValue = 0;
+    RegisterImage image;
+    if (ReadMAC(macValue) != OpStatus::Success || ReadChannelRegisters(ch, macValue, { TX_HB_BYP, TX_HB_DEL }, image) != OpStatus::Success)
+        return 1;
+
+    int bypass = GetField(image, TX_HB_BYP);
+    int delay = GetField(image, TX_HB_DEL);
     // TODO: Warn if bypass and delay are incompatible
     return (delay && !bypass) ? 2 : 1;
 }
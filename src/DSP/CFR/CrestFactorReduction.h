@@ -1,7 +1,10 @@
 #pragma once
 
 #include <stdint.h>
+#include <map>
 #include <memory>
+#include <vector>
+#include "limesuiteng/OpStatus.h"
 #include "registers.h"
 
 namespace lime {
@@ -40,18 +43,27 @@ class CrestFactorReduction
 
     CrestFactorReduction(std::shared_ptr<ISPI> comms);
     ~CrestFactorReduction();
-    void Configure(const CrestFactorReduction::Config& cfg);
 
-    void SetOversample(uint8_t oversample);
+    /// @brief Applies the configuration to both channels.
+    /// The register values are merged locally, so every channel takes one read and one write transaction.
+    /// @param cfg The configuration to apply.
+    /// @return The status of the operation.
+    OpStatus Configure(const CrestFactorReduction::Config& cfg);
+
+    /// @brief Sets the Tx interpolation of both channels.
+    /// @param oversample The oversampling ratio (0 - maximum available).
+    /// @return The status of the operation.
+    OpStatus SetOversample(uint8_t oversample);
     uint8_t GetOversample();
 
   private:
     std::shared_ptr<ISPI> m_Comms;
-    void WriteRegister(const Register& reg, uint16_t value);
-    uint16_t ReadRegister(const Register& reg);
+    OpStatus ReadMAC(uint16_t& value);
+    OpStatus ReadChannelRegisters(
+        uint8_t channel, uint16_t macValue, const std::vector<Register>& fields, std::map<uint16_t, uint16_t>& image);
 
-    void SetFIRCoefficients(const int16_t* coefficients, uint16_t count);
-    void UpdateHannCoeff(uint16_t Filt_N);
+    static void AppendFIRCoefficients(std::vector<uint32_t>& mosi, const int16_t* coefficients);
+    static void AppendHannCoefficients(std::vector<uint32_t>& mosi, uint16_t Filt_N);
 };
 
 } // namespace lime
@@ -1,224 +1,328 @@
 #include "FFT.h"
 
+#include "FFTBackend.h"
+#include "RingBuffer.h"
+#include "WelchEstimator.h"
+#include "limesuiteng/Logger.h"
+
+#include <algorithm>
 #include <cassert>
-#include <cstring>
+#include <cmath>
 #include <chrono>
+#include <condition_variable>
+#include <thread>
 
 namespace lime {
 
+/// @brief Samples buffer and partial results of a single channel.
+struct FFT::ChannelState {
+    ChannelState(uint8_t ch, std::size_t fftSize, std::size_t worker)
+        : fifo(fftSize * 4)
+        , accumulated(fftSize, 0)
+        , index(ch)
+        , workerIndex(worker)
+    {
+    }
+
+    RingBuffer<complex32f_t> fifo;
+    std::vector<float> accumulated;
+    std::size_t framesAccumulated{ 0 };
+    std::unique_ptr<WelchEstimator> welch;
+    uint64_t welchGeneration{ 0 };
+    uint8_t index;
+    std::size_t workerIndex;
+
+    std::atomic<uint64_t> pushed{ 0 };
+    std::atomic<uint64_t> processed{ 0 };
+    std::atomic<uint64_t> dropped{ 0 };
+    std::atomic<uint64_t> skipped{ 0 };
+};
+
+/// @brief Thread calculating the transforms of a subset of the channels.
+struct FFT::WorkerState {
+    std::thread thread;
+    std::vector<uint8_t> channels;
+    std::mutex wakeLock;
+    std::condition_variable wake;
+};
+
 FFT::FFT(uint8_t channelCount, uint32_t size, WindowFunctionType windowType)
-    : samplesFIFO(channelCount)
-    , channelCount(channelCount)
+    : channelCount(channelCount)
+    , mSize(size)
+    , m_fftCalcPlan(FFTPlanCache::GetDefault()->GetPlan(size))
     , currentWindowType(windowType)
-    , m_fftCalcPlan(kiss_fft_alloc(size, 0, nullptr, nullptr))
+    , mResults(channelCount)
+    , mResultReady(channelCount, false)
 {
-    m_fftCalcIn.resize(size);
-    m_fftCalcOut.resize(size);
-
-    std::for_each(samplesFIFO.begin(), samplesFIFO.end(), [&](auto& vec) { vec.Resize(size * 2); });
+    assert(m_fftCalcPlan);
+    std::vector<float> coeffs;
+    GenerateWindowCoefficients(windowType, size, coeffs);
+    mWindowCoeffs = std::make_shared<const std::vector<float>>(std::move(coeffs));
+
+    // channels are independent, so each worker takes a few of them and no per frame synchronization is needed
+    const std::size_t threadCount = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t workerCount = std::max<std::size_t>(1, std::min<std::size_t>(channelCount, threadCount));
+    for (std::size_t i = 0; i < workerCount; ++i)
+        mWorkers.push_back(std::make_unique<WorkerState>());
+    for (uint8_t ch = 0; ch < channelCount; ++ch)
+    {
+        mChannels.push_back(std::make_unique<ChannelState>(ch, size, ch % workerCount));
+        mWorkers.at(ch % workerCount)->channels.push_back(ch);
+    }
 
     doWork.store(true, std::memory_order_relaxed);
-    mWorkerThread = std::thread(&FFT::ProcessLoop, this);
-
-    GenerateWindowCoefficients(windowType, m_fftCalcIn.size(), mWindowCoeffs);
+    for (std::size_t i = 0; i < workerCount; ++i)
+        mWorkers[i]->thread = std::thread(&FFT::ProcessLoop, this, i);
 }
 
 FFT::~FFT()
 {
     doWork.store(false, std::memory_order_relaxed);
-    inputAvailable.notify_all();
-    if (mWorkerThread.joinable())
-        mWorkerThread.join();
-    kiss_fft_free(m_fftCalcPlan);
+    for (auto& worker : mWorkers)
+    {
+        {
+            std::lock_guard<std::mutex> lock(worker->wakeLock);
+        }
+        worker->wake.notify_all();
+        if (worker->thread.joinable())
+            worker->thread.join();
+    }
 }
 
 std::size_t FFT::PushSamples(const complex32f_t* const* const samples, std::size_t count, std::size_t samplesToSkip)
 {
-    std::size_t produced{ 0 };
-
+    for (uint8_t ch = 0; ch < channelCount; ++ch)
     {
-        std::unique_lock lk{ inputMutex };
-        inputAvailable.wait(lk, [&]() { return samplesFIFO[0].Capacity() != samplesFIFO[0].Size() || !doWork.load(); });
-
-        produced = samplesFIFO[0].Produce(samples[0] + samplesToSkip, count);
+        ChannelState& channel = *mChannels[ch];
+        const std::size_t produced = channel.fifo.Produce(samples[ch] + samplesToSkip, count);
+        channel.pushed.fetch_add(count, std::memory_order_relaxed);
+        if (produced < count)
+            channel.dropped.fetch_add(count - produced, std::memory_order_relaxed);
+
+        // workers also poll periodically, so a notification racing with their check is not lost for long
+        if (channel.fifo.Size() >= mSize)
+            mWorkers[channel.workerIndex]->wake.notify_one();
     }
-    inputAvailable.notify_all();
-
-    for (uint8_t ch = 1; ch < channelCount; ++ch)
-    {
-        std::size_t pushed{ 0 };
-        // Ensures the same amount of samples gets pushed all across the channel range.
-        while (pushed < produced)
-        {
-            {
-                std::unique_lock lk{ inputMutex };
-                inputAvailable.wait(lk, [&]() { return samplesFIFO[ch].Capacity() != samplesFIFO[ch].Size() || !doWork.load(); });
-
-                pushed += samplesFIFO[ch].Produce(samples[ch] + samplesToSkip + pushed, produced - pushed);
-            }
-            inputAvailable.notify_all();
-        }
-    }
-
-    return produced;
+    return count;
 }
 
 void FFT::SetResultsCallback(FFT::CallbackType fptr, void* userData)
 {
+    std::lock_guard<std::mutex> lock(mResultsLock);
     resultsCallback = fptr;
     mUserData = userData;
 }
 
 void FFT::SetWindowFunction(WindowFunctionType windowFunction)
 {
+    std::lock_guard<std::mutex> lock(mSettingsLock);
     if (currentWindowType != windowFunction)
     {
         currentWindowType = windowFunction;
-        GenerateWindowCoefficients(windowFunction, m_fftCalcIn.size(), mWindowCoeffs);
+        std::vector<float> coeffs;
+        GenerateWindowCoefficients(windowFunction, mSize, coeffs);
+        // workers keep the previous coefficients alive until they finish the current frame
+        mWindowCoeffs = std::make_shared<const std::vector<float>>(std::move(coeffs));
     }
 }
 
 void FFT::SetAverageCount(std::size_t count)
 {
-    avgCount = count;
+    avgCount.store(count, std::memory_order_relaxed);
 }
 
-std::vector<float> FFT::Calc(const std::vector<complex32f_t>& samples, WindowFunctionType window)
+void FFT::SetWelchAveraging(const WelchConfig& config)
 {
-    const int fftSize = samples.size();
-    std::vector<float> coeffs;
-    GenerateWindowCoefficients(window, fftSize, coeffs);
+    auto welchConfig = std::make_shared<WelchConfig>(config);
+    welchConfig->size = mSize;
+    std::lock_guard<std::mutex> lock(mSettingsLock);
+    mWelchConfig = welchConfig;
+    ++mWelchGeneration;
+}
 
-    std::vector<kiss_fft_cpx> fftIn(fftSize);
-    std::vector<kiss_fft_cpx> fftOut(fftSize);
-    std::vector<float> bins(fftSize);
-    kiss_fft_cfg plan = kiss_fft_alloc(fftSize, 0, nullptr, nullptr);
+void FFT::SetBlockAveraging()
+{
+    std::lock_guard<std::mutex> lock(mSettingsLock);
+    mWelchConfig.reset();
+    ++mWelchGeneration;
+}
 
-    for (int i = 0; i < fftSize; ++i)
+FFT::Stats FFT::GetStats() const
+{
+    Stats stats{};
+    for (const auto& channel : mChannels)
     {
-        fftIn[i].r = samples[i].real() * coeffs[i];
-        fftIn[i].i = samples[i].imag() * coeffs[i];
+        stats.pushed += channel->pushed.load(std::memory_order_relaxed);
+        stats.processed += channel->processed.load(std::memory_order_relaxed);
+        stats.dropped += channel->dropped.load(std::memory_order_relaxed);
+        stats.skipped += channel->skipped.load(std::memory_order_relaxed);
     }
-    kiss_fft(plan, fftIn.data(), fftOut.data());
-    for (int i = 0; i < fftSize; ++i)
+    return stats;
+}
+
+std::vector<float> FFT::Calc(const std::vector<complex32f_t>& samples, WindowFunctionType window)
+{
+    const std::size_t fftSize = samples.size();
+    std::vector<float> bins(fftSize);
+    std::shared_ptr<const IFFTPlan> plan = FFTPlanCache::GetDefault()->GetPlan(fftSize);
+    if (!plan)
+        return bins;
+
+    // display loops call this repeatedly with the same parameters, keep the buffers around
+    thread_local std::vector<complex32f_t> fftIn;
+    thread_local std::vector<complex32f_t> fftOut;
+    thread_local std::vector<float> coeffs;
+    thread_local WindowFunctionType coeffsWindow = WindowFunctionType::NONE;
+    if (coeffs.size() != fftSize || coeffsWindow != window)
     {
-        bins[i] = (fftOut[i].r * fftOut[i].r + fftOut[i].i * fftOut[i].i) / (fftSize * fftSize);
+        GenerateWindowCoefficients(window, fftSize, coeffs);
+        coeffsWindow = window;
     }
-    kiss_fft_free(plan);
+    fftIn.resize(fftSize);
+    fftOut.resize(fftSize);
+
+    for (std::size_t i = 0; i < fftSize; ++i)
+        fftIn[i] = complex32f_t(samples[i].real() * coeffs[i], samples[i].imag() * coeffs[i]);
+    plan->Execute(fftIn.data(), fftOut.data());
+    const float scale = static_cast<float>(fftSize) * fftSize;
+    for (std::size_t i = 0; i < fftSize; ++i)
+        bins[i] = (fftOut[i].real() * fftOut[i].real() + fftOut[i].imag() * fftOut[i].imag()) / scale;
     return bins;
 }
 
+std::vector<std::string> FFT::GetBackendNames()
+{
+    return GetFFTBackendNames();
+}
+
+std::string FFT::GetBackendName()
+{
+    return FFTPlanCache::GetDefault()->GetBackend()->GetName();
+}
+
+OpStatus FFT::SetBackend(const std::string& name)
+{
+    std::shared_ptr<IFFTBackend> backend = CreateFFTBackend(name);
+    if (!backend)
+        return ReportError(OpStatus::NotSupported, "FFT backend '%s' is not available", name.c_str());
+    FFTPlanCache::SetDefault(backend);
+    return OpStatus::Success;
+}
+
 void FFT::ConvertToDBFS(std::vector<float>& bins)
 {
     for (float& amplitude : bins)
         amplitude = amplitude > 0 ? 10 * log10(amplitude) : -150;
 }
 
-template<typename T> void FFT::Calculate(const std::vector<std::vector<T>>& src, std::vector<std::vector<float>>& outputBins)
+bool FFT::ProcessFrame(ChannelState& channel, complex32f_t* fftIn, complex32f_t* fftOut, std::vector<float>& bins)
 {
-    constexpr double div = []() {
-        if constexpr (std::is_same_v<T, complex16_t>)
-        {
-            return 32768.0;
-        }
-        return 1.0;
-    }();
-
-    outputBins.resize(src.size());
+    const std::size_t available = channel.fifo.Size();
+    if (available < mSize)
+        return false;
 
-    for (std::size_t ch = 0; ch < src.size(); ++ch)
+    std::shared_ptr<const std::vector<float>> coeffs;
+    std::shared_ptr<const WelchConfig> welchConfig;
+    uint64_t welchGeneration;
     {
-        assert(src.at(ch).size() == m_fftCalcIn.size());
-        for (std::size_t i = 0; i < src.at(ch).size(); ++i)
-        {
-            m_fftCalcIn.at(i).r = src.at(ch).at(i).real() / div * mWindowCoeffs.at(i);
-            m_fftCalcIn.at(i).i = src.at(ch).at(i).imag() / div * mWindowCoeffs.at(i);
-        }
-        kiss_fft(m_fftCalcPlan, m_fftCalcIn.data(), m_fftCalcOut.data());
-        outputBins.at(ch).resize(src.at(ch).size());
+        std::lock_guard<std::mutex> lock(mSettingsLock);
+        coeffs = mWindowCoeffs;
+        welchConfig = mWelchConfig;
+        welchGeneration = mWelchGeneration;
+    }
+    if (channel.welchGeneration != welchGeneration)
+    {
+        // averaging mode changed, start collecting from scratch
+        channel.welch = welchConfig ? std::make_unique<WelchEstimator>(*welchConfig) : nullptr;
+        channel.welchGeneration = welchGeneration;
+        std::fill(channel.accumulated.begin(), channel.accumulated.end(), 0);
+        channel.framesAccumulated = 0;
+    }
 
-        std::size_t output_index = 0;
-        for (std::size_t i = m_fftCalcIn.size() / 2 + 1; i < m_fftCalcIn.size(); ++i)
-            outputBins.at(ch).at(output_index++) += m_fftCalcOut[i].r * m_fftCalcOut[i].r + m_fftCalcOut[i].i * m_fftCalcOut[i].i;
+    // When falling behind, transform only the newest complete frame instead of the stale ones.
+    if (available >= 2 * mSize)
+    {
+        const std::size_t skipped = channel.fifo.Skip((available / mSize - 1) * mSize);
+        channel.skipped.fetch_add(skipped, std::memory_order_relaxed);
+        if (channel.welch)
+            channel.welch->Restart();
+    }
+    channel.fifo.Consume(fftIn, mSize);
 
-        for (std::size_t i = 0; i < m_fftCalcIn.size() / 2 + 1; ++i)
-            outputBins.at(ch).at(output_index++) += m_fftCalcOut[i].r * m_fftCalcOut[i].r + m_fftCalcOut[i].i * m_fftCalcOut[i].i;
+    if (channel.welch)
+    {
+        const bool resultReady = channel.welch->Process(fftIn, mSize) > 0;
+        channel.processed.fetch_add(mSize, std::memory_order_relaxed);
+        if (resultReady)
+            PublishResult(channel.index, channel.welch->GetResult());
+        return true;
     }
+
+    for (std::size_t i = 0; i < mSize; ++i)
+        fftIn[i] = complex32f_t(fftIn[i].real() * (*coeffs)[i], fftIn[i].imag() * (*coeffs)[i]);
+    m_fftCalcPlan->Execute(fftIn, fftOut);
+
+    // Negative frequencies first, so the bins go from -fs/2 to fs/2.
+    std::size_t outputIndex = 0;
+    for (std::size_t i = mSize / 2 + 1; i < mSize; ++i)
+        channel.accumulated[outputIndex++] += fftOut[i].real() * fftOut[i].real() + fftOut[i].imag() * fftOut[i].imag();
+    for (std::size_t i = 0; i < mSize / 2 + 1; ++i)
+        channel.accumulated[outputIndex++] += fftOut[i].real() * fftOut[i].real() + fftOut[i].imag() * fftOut[i].imag();
+    channel.processed.fetch_add(mSize, std::memory_order_relaxed);
+
+    ++channel.framesAccumulated;
+    if (channel.framesAccumulated < std::max<std::size_t>(1, avgCount.load(std::memory_order_relaxed)))
+        return true;
+
+    const float div = static_cast<float>(channel.framesAccumulated) * mSize * mSize;
+    bins.resize(mSize);
+    for (std::size_t i = 0; i < mSize; ++i)
+        bins[i] = channel.accumulated[i] / div;
+    std::fill(channel.accumulated.begin(), channel.accumulated.end(), 0);
+    channel.framesAccumulated = 0;
+
+    PublishResult(channel.index, bins);
+    return true;
 }
 
-void FFT::ProcessLoop()
+void FFT::PublishResult(uint8_t ch, const std::vector<float>& bins)
 {
-    std::vector<std::vector<complex32f_t>> samples(channelCount);
-    std::vector<std::vector<float>> fftBins;
-    std::vector<std::vector<float>> avgOutput;
-    std::vector<std::size_t> samplesReady(channelCount, 0);
+    std::lock_guard<std::mutex> lock(mResultsLock);
+    // a channel that is ahead just refreshes its result until the others catch up
+    mResults[ch] = bins;
+    mResultReady[ch] = true;
+    if (!std::all_of(mResultReady.begin(), mResultReady.end(), [](bool ready) { return ready; }))
+        return;
 
-    std::size_t resultsDone = 0;
-    while (doWork.load(std::memory_order_relaxed) == true)
-    {
-        for (uint8_t ch = 0; ch < channelCount; ++ch)
-        {
-            samples.at(ch).resize(m_fftCalcIn.size());
-            {
-                std::unique_lock lk{ inputMutex };
-                inputAvailable.wait(lk, [&]() { return samplesFIFO[ch].Size() != 0 || !doWork.load(); });
-
-                int samplesNeeded = samples.at(ch).size() - samplesReady.at(ch);
-                int ret = samplesFIFO[ch].Consume(samples.at(ch).data() + samplesReady.at(ch), samplesNeeded);
-                samplesReady.at(ch) += ret;
-            }
-            inputAvailable.notify_all();
-        }
+    if (resultsCallback)
+        resultsCallback(mResults, mUserData);
+    std::fill(mResultReady.begin(), mResultReady.end(), false);
+}
 
-        if (!std::all_of(samplesReady.begin(), samplesReady.end(), [&](const std::size_t& amount) {
-                return amount == samples.at(0).size();
-            }))
-        {
-            continue;
-        }
+void FFT::ProcessLoop(std::size_t workerIndex)
+{
+    WorkerState& worker = *mWorkers[workerIndex];
+    std::vector<complex32f_t> fftIn(mSize);
+    std::vector<complex32f_t> fftOut(mSize);
+    std::vector<float> bins(mSize);
 
-        // auto t1 = std::chrono::high_resolution_clock::now();
-        Calculate(samples, fftBins);
-        avgOutput.resize(fftBins.size());
-        ++resultsDone;
+    auto hasFrame = [&]() {
+        return std::any_of(worker.channels.begin(), worker.channels.end(), [&](uint8_t ch) {
+            return mChannels[ch]->fifo.Size() >= mSize;
+        });
+    };
 
-        for (std::size_t ch = 0; ch < fftBins.size(); ++ch)
-        {
-            samplesReady.at(ch) = 0;
-            avgOutput.at(ch).resize(fftBins.at(ch).size());
-            for (std::size_t i = 0; i < fftBins.at(ch).size(); ++i)
-            {
-                avgOutput.at(ch).at(i) += fftBins.at(ch).at(i) * fftBins.at(ch).at(i);
-            }
-        }
+    while (doWork.load(std::memory_order_relaxed) == true)
+    {
+        bool processed = false;
+        for (uint8_t ch : worker.channels)
+            processed |= ProcessFrame(*mChannels[ch], fftIn.data(), fftOut.data(), bins);
 
-        if (resultsDone < avgCount)
-        {
+        if (processed)
             continue;
-        }
 
-        if (resultsCallback)
-        {
-            for (std::size_t ch = 0; ch < fftBins.size(); ++ch)
-            {
-                const float div = static_cast<float>(resultsDone) * fftBins.at(ch).size() * fftBins.at(ch).size();
-                for (std::size_t s = 0; s < fftBins.at(ch).size(); ++s)
-                {
-                    fftBins.at(ch).at(s) /= div;
-                }
-            }
-
-            resultsCallback(fftBins, mUserData);
-        }
-        resultsDone = 0;
-
-        for (auto& vec : avgOutput)
-        {
-            std::memset(vec.data(), 0, vec.size() * sizeof(float));
-        }
-        // auto t2 = std::chrono::high_resolution_clock::now();
-        // auto timePeriod = std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count();
-        //printf("FFT update %lius\n", timePeriod);
+        std::unique_lock<std::mutex> lock(worker.wakeLock);
+        worker.wake.wait_for(lock, std::chrono::milliseconds(10), [&]() { return !doWork.load() || hasFrame(); });
     }
 }
 
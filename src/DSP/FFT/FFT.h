@@ -2,16 +2,20 @@
 
 #include "limesuiteng/complex.h"
 #include "limesuiteng/config.h"
+#include "limesuiteng/OpStatus.h"
 #include <atomic>
-#include <thread>
 #include <mutex>
-#include <condition_variable>
 #include <functional>
-#include "RingBuffer.h"
-#include "kiss_fft.h"
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace lime {
 
+class IFFTPlan;
+class WelchEstimator;
+struct WelchConfig;
+
 /// @brief Class for calculating Fast Fourier Transforms.
 class LIME_API FFT
 {
@@ -22,6 +26,18 @@ class LIME_API FFT
     /// @brief Enumeration for selecting the window coefficient function to use
     enum class WindowFunctionType : uint8_t { NONE = 0, BLACKMAN_HARRIS, HAMMING, HANNING };
 
+    /// @brief Sample counters of all the channels, for evaluating how much of the input actually got transformed.
+    struct Stats {
+        uint64_t pushed; ///< The amount of samples given to PushSamples().
+        uint64_t processed; ///< The amount of samples that went through the transform.
+        uint64_t dropped; ///< The amount of samples rejected because the channel's buffer was full.
+        uint64_t skipped; ///< The amount of buffered samples discarded to catch up with the input.
+
+        /// @brief Gets the portion of the pushed samples that were transformed.
+        /// @return The duty cycle, from 0 to 1.
+        double DutyCycle() const { return pushed > 0 ? static_cast<double>(processed) / pushed : 0; }
+    };
+
     /// @brief Constructs the FFT object.
     /// @param channelCount The amount of channels to build the FFT class for.
     /// @param size The amount of bins to use.
@@ -29,11 +45,13 @@ class LIME_API FFT
     FFT(uint8_t channelCount, uint32_t size, WindowFunctionType windowType = WindowFunctionType::BLACKMAN_HARRIS);
     ~FFT();
 
-    /// @brief Adds the given samples to the FFT calculation.
-    /// @param samples The samples to add to the calculation.
+    /// @brief Adds the given samples to the FFT calculation. Never blocks, the samples that don't fit
+    /// into a channel's buffer are dropped and counted in the statistics.
+    /// The channel buffers are single producer lock-free queues, so only one thread at a time may push samples.
+    /// @param samples The samples to add to the calculation, one array for each channel.
     /// @param count The amount of samples to add to the calculation.
     /// @param samplesToSkip The amount of samples to skip from the beginning of the sample array.
-    /// @return The amount of samples actually added to the buffer.
+    /// @return The amount of samples consumed from each channel's array (always count).
     std::size_t PushSamples(const complex32f_t* const* const samples, std::size_t count, std::size_t samplesToSkip);
 
     /// @brief Sets the function to call when a calculations update happens.
@@ -49,6 +67,18 @@ class LIME_API FFT
     /// @param count The amount of samples to average out with.
     void SetAverageCount(std::size_t count);
 
+    /// @brief Switches the results to Welch averaging of overlapping segments, instead of averaging consecutive blocks.
+    /// The results callback is then called every config.averageCount segments.
+    /// @param config The parameters of the estimation, its size is replaced by the size of this FFT.
+    void SetWelchAveraging(const WelchConfig& config);
+
+    /// @brief Switches the results back to averaging SetAverageCount() consecutive blocks.
+    void SetBlockAveraging();
+
+    /// @brief Gets the sample counters accumulated since the construction.
+    /// @return The counters summed over all the channels.
+    Stats GetStats() const;
+
     /// @brief Generates the coefficients for a given window function
     /// @param type The type of the window function to generate the coefficients for.
     /// @param coefCount The amount of coefficients to generate.
@@ -56,39 +86,59 @@ class LIME_API FFT
     static void GenerateWindowCoefficients(WindowFunctionType type, std::size_t coefCount, std::vector<float>& coeffs);
 
     /// @brief Calculates the FFT bins from the provided samples.
+    /// Plans and window coefficients are cached, so repeated calls of the same size don't allocate them again.
     /// @param samples The samples to calculate from.
     /// @param window The window function to apply to the samples before calculating the bins.
     /// @return The array of computed bins, the same width as the amount of samples.
     static std::vector<float> Calc(const std::vector<complex32f_t>& samples, WindowFunctionType window = WindowFunctionType::NONE);
 
+    /// @brief Gets the names of the available FFT implementations, the fastest one first.
+    /// @return The list of backend names.
+    static std::vector<std::string> GetBackendNames();
+
+    /// @brief Gets the name of the FFT implementation currently in use.
+    /// @return The name of the backend.
+    static std::string GetBackendName();
+
+    /// @brief Selects the FFT implementation for the following calculations.
+    /// Already constructed FFT objects keep using the previous implementation.
+    /// @param name The name of the backend (from GetBackendNames()).
+    /// @return The status of the operation.
+    static OpStatus SetBackend(const std::string& name);
+
     /// @brief Convert the amplitude in the bins to a Decibels relative to full scale.
     /// @param bins The bins to convert.
     static void ConvertToDBFS(std::vector<float>& bins);
 
   private:
-    template<typename T> void Calculate(const std::vector<std::vector<T>>& src, std::vector<std::vector<float>>& outputBins);
-    void ProcessLoop();
+    struct ChannelState;
+    struct WorkerState;
+    void ProcessLoop(std::size_t workerIndex);
+    bool ProcessFrame(ChannelState& channel, complex32f_t* fftIn, complex32f_t* fftOut, std::vector<float>& bins);
+    void PublishResult(uint8_t ch, const std::vector<float>& bins);
 
-    std::vector<RingBuffer<complex32f_t>> samplesFIFO;
+    std::vector<std::unique_ptr<ChannelState>> mChannels;
     uint8_t channelCount;
+    std::size_t mSize;
 
-    std::thread mWorkerThread;
-
+    std::shared_ptr<const IFFTPlan> m_fftCalcPlan;
+    std::shared_ptr<const std::vector<float>> mWindowCoeffs;
     WindowFunctionType currentWindowType;
-    std::vector<float> mWindowCoeffs;
-
-    kiss_fft_cfg m_fftCalcPlan;
-    std::vector<kiss_fft_cpx> m_fftCalcIn;
-    std::vector<kiss_fft_cpx> m_fftCalcOut;
+    std::shared_ptr<const WelchConfig> mWelchConfig;
+    uint64_t mWelchGeneration{ 0 };
+    std::mutex mSettingsLock;
 
+    std::vector<std::unique_ptr<WorkerState>> mWorkers;
     std::atomic<bool> doWork{};
-    std::condition_variable inputAvailable;
-    std::mutex inputMutex;
+
+    std::mutex mResultsLock;
+    std::vector<std::vector<float>> mResults;
+    std::vector<bool> mResultReady;
 
     CallbackType resultsCallback{};
     void* mUserData{};
 
-    std::size_t avgCount = 100;
+    std::atomic<std::size_t> avgCount{ 100 };
 };
 
 } // namespace lime
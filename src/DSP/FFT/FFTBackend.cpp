@@ -0,0 +1,107 @@
+#include "FFTBackend.h"
+
+#include "FFTBackendKiss.h"
+#ifdef ENABLE_FFTW
+    #include "FFTBackendFFTW.h"
+#endif
+
+#include <algorithm>
+
+namespace lime {
+
+static std::mutex gDefaultCacheLock;
+static std::shared_ptr<FFTPlanCache> gDefaultCache;
+
+/// @brief Constructs the plan cache.
+/// @param backend The backend to create the plans with.
+/// @param capacity The maximum amount of plans to hold.
+FFTPlanCache::FFTPlanCache(std::shared_ptr<IFFTBackend> backend, std::size_t capacity)
+    : mBackend(backend)
+    , mCapacity(std::max<std::size_t>(capacity, 1))
+    , mUseCounter(0)
+{
+}
+
+/// @brief Gets the plan of the given size, creating it on the first request.
+/// Plans released from the cache stay valid for as long as they are used.
+/// @param size The amount of points of the transform.
+/// @return The plan, nullptr if it could not be created.
+std::shared_ptr<const IFFTPlan> FFTPlanCache::GetPlan(std::size_t size)
+{
+    std::lock_guard<std::mutex> lock(mPlansLock);
+    auto iter = mPlans.find(size);
+    if (iter != mPlans.end())
+    {
+        iter->second.lastUse = ++mUseCounter;
+        return iter->second.plan;
+    }
+
+    std::shared_ptr<const IFFTPlan> plan = mBackend->CreatePlan(size);
+    if (!plan)
+        return nullptr;
+
+    if (mPlans.size() >= mCapacity)
+    {
+        auto leastRecent = std::min_element(mPlans.begin(), mPlans.end(), [](const auto& a, const auto& b) {
+            return a.second.lastUse < b.second.lastUse;
+        });
+        mPlans.erase(leastRecent);
+    }
+    mPlans[size] = { plan, ++mUseCounter };
+    return plan;
+}
+
+/// @brief Gets the amount of plans currently held by the cache.
+/// @return The amount of cached plans.
+std::size_t FFTPlanCache::GetPlanCount()
+{
+    std::lock_guard<std::mutex> lock(mPlansLock);
+    return mPlans.size();
+}
+
+/// @brief Gets the process wide plan cache, using the fastest available backend unless selected otherwise.
+/// @return The default plan cache.
+std::shared_ptr<FFTPlanCache> FFTPlanCache::GetDefault()
+{
+    std::lock_guard<std::mutex> lock(gDefaultCacheLock);
+    if (!gDefaultCache)
+        gDefaultCache = std::make_shared<FFTPlanCache>(CreateFFTBackend());
+    return gDefaultCache;
+}
+
+/// @brief Replaces the process wide plan cache with a new one, using the given backend.
+/// Plans already taken from the previous cache stay valid.
+/// @param backend The backend to use from now on.
+void FFTPlanCache::SetDefault(std::shared_ptr<IFFTBackend> backend)
+{
+    std::lock_guard<std::mutex> lock(gDefaultCacheLock);
+    gDefaultCache = std::make_shared<FFTPlanCache>(backend);
+}
+
+/// @brief Gets the names of the FFT backends compiled into the library, the fastest one first.
+/// @return The list of the available backend names.
+std::vector<std::string> GetFFTBackendNames()
+{
+    std::vector<std::string> names;
+#ifdef ENABLE_FFTW
+    names.push_back(FFTBackendFFTW().GetName());
+#endif
+    names.push_back(FFTBackendKiss().GetName());
+    return names;
+}
+
+/// @brief Creates the FFT backend with the given name.
+/// @param name The name of the backend (empty - the fastest available).
+/// @return The created backend, nullptr if there is no such backend.
+std::shared_ptr<IFFTBackend> CreateFFTBackend(const std::string& name)
+{
+#ifdef ENABLE_FFTW
+    if (name.empty() || name == FFTBackendFFTW().GetName())
+        return std::make_shared<FFTBackendFFTW>();
+#endif
+    if (name.empty() || name == FFTBackendKiss().GetName())
+        return std::make_shared<FFTBackendKiss>();
+    return nullptr;
+}
+
+} // namespace lime
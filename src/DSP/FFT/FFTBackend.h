@@ -0,0 +1,86 @@
+#ifndef LIME_FFTBACKEND_H
+#define LIME_FFTBACKEND_H
+
+#include "limesuiteng/complex.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace lime {
+
+/// @brief Precomputed forward complex FFT of a single size.
+class IFFTPlan
+{
+  public:
+    virtual ~IFFTPlan() = default;
+
+    /// @brief Gets the amount of points of the transform.
+    /// @return The size of the transform.
+    virtual std::size_t GetSize() const = 0;
+
+    /// @brief Calculates the forward transform. Can be called from multiple threads at once, with different buffers.
+    /// @param input The GetSize() samples to transform.
+    /// @param output The buffer for GetSize() output bins, must not overlap the input.
+    virtual void Execute(const complex32f_t* input, complex32f_t* output) const = 0;
+};
+
+/// @brief Interface of an FFT implementation.
+class IFFTBackend
+{
+  public:
+    virtual ~IFFTBackend() = default;
+
+    /// @brief Gets the name of the implementation.
+    /// @return The name of the backend.
+    virtual std::string GetName() const = 0;
+
+    /// @brief Creates the transform of the given size. Might be expensive, plans should be reused.
+    /// @param size The amount of points of the transform.
+    /// @return The created plan, nullptr on failure.
+    virtual std::shared_ptr<const IFFTPlan> CreatePlan(std::size_t size) = 0;
+};
+
+/// @brief Thread safe storage of the FFT plans, so every transform size is planned only once.
+/// Holds a limited amount of plans, the least recently used ones are released first.
+class FFTPlanCache
+{
+  public:
+    static constexpr std::size_t DEFAULT_CAPACITY = 16; ///< Amount of plans held by default.
+
+    explicit FFTPlanCache(std::shared_ptr<IFFTBackend> backend, std::size_t capacity = DEFAULT_CAPACITY);
+
+    std::shared_ptr<const IFFTPlan> GetPlan(std::size_t size);
+
+    std::size_t GetPlanCount();
+
+    /// @brief Gets the backend used to create the plans.
+    /// @return The backend of the cache.
+    const std::shared_ptr<IFFTBackend>& GetBackend() const { return mBackend; }
+
+    static std::shared_ptr<FFTPlanCache> GetDefault();
+    static void SetDefault(std::shared_ptr<IFFTBackend> backend);
+
+  private:
+    struct CachedPlan {
+        std::shared_ptr<const IFFTPlan> plan;
+        uint64_t lastUse;
+    };
+
+    std::shared_ptr<IFFTBackend> mBackend;
+    std::size_t mCapacity;
+    std::map<std::size_t, CachedPlan> mPlans;
+    uint64_t mUseCounter;
+    std::mutex mPlansLock;
+};
+
+std::vector<std::string> GetFFTBackendNames();
+std::shared_ptr<IFFTBackend> CreateFFTBackend(const std::string& name = std::string());
+
+} // namespace lime
+
+#endif // LIME_FFTBACKEND_H
@@ -0,0 +1,78 @@
+#include "FFTBackendFFTW.h"
+
+#include <fftw3.h>
+
+#include <mutex>
+
+using namespace std::literals::string_literals;
+
+namespace lime {
+
+static_assert(sizeof(fftwf_complex) == sizeof(complex32f_t), "FFTW complex layout mismatch");
+
+// FFTW planner is not thread safe, only the plan execution is
+static std::mutex gPlannerLock;
+
+namespace {
+
+class FFTWPlan : public IFFTPlan
+{
+  public:
+    explicit FFTWPlan(std::size_t size)
+        : mSize(size)
+        , mPlan(nullptr)
+    {
+        // plan on scratch buffers, Execute() uses the new-array interface on user buffers,
+        // so the plan must not assume any particular alignment
+        fftwf_complex* in = fftwf_alloc_complex(size);
+        fftwf_complex* out = fftwf_alloc_complex(size);
+        if (in && out)
+        {
+            std::lock_guard<std::mutex> lock(gPlannerLock);
+            mPlan = fftwf_plan_dft_1d(size, in, out, FFTW_FORWARD, FFTW_MEASURE | FFTW_UNALIGNED);
+        }
+        fftwf_free(in);
+        fftwf_free(out);
+    }
+
+    ~FFTWPlan() override
+    {
+        if (!mPlan)
+            return;
+        std::lock_guard<std::mutex> lock(gPlannerLock);
+        fftwf_destroy_plan(mPlan);
+    }
+
+    bool IsValid() const { return mPlan != nullptr; }
+
+    std::size_t GetSize() const override { return mSize; }
+
+    void Execute(const complex32f_t* input, complex32f_t* output) const override
+    {
+        // out of place transform does not modify the input
+        fftwf_execute_dft(mPlan,
+            reinterpret_cast<fftwf_complex*>(const_cast<complex32f_t*>(input)),
+            reinterpret_cast<fftwf_complex*>(output));
+    }
+
+  private:
+    std::size_t mSize;
+    fftwf_plan mPlan;
+};
+
+} // namespace
+
+std::string FFTBackendFFTW::GetName() const
+{
+    return "fftw"s;
+}
+
+std::shared_ptr<const IFFTPlan> FFTBackendFFTW::CreatePlan(std::size_t size)
+{
+    auto plan = std::make_shared<FFTWPlan>(size);
+    if (!plan->IsValid())
+        return nullptr;
+    return plan;
+}
+
+} // namespace lime
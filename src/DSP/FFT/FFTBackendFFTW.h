@@ -0,0 +1,18 @@
+#ifndef LIME_FFTBACKENDFFTW_H
+#define LIME_FFTBACKENDFFTW_H
+
+#include "FFTBackend.h"
+
+namespace lime {
+
+/// @brief FFT backend using the single precision FFTW library, SIMD accelerated.
+class FFTBackendFFTW : public IFFTBackend
+{
+  public:
+    std::string GetName() const override;
+    std::shared_ptr<const IFFTPlan> CreatePlan(std::size_t size) override;
+};
+
+} // namespace lime
+
+#endif // LIME_FFTBACKENDFFTW_H
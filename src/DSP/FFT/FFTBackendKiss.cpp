@@ -0,0 +1,54 @@
+#include "FFTBackendKiss.h"
+
+#include "kiss_fft.h"
+
+using namespace std::literals::string_literals;
+
+namespace lime {
+
+static_assert(sizeof(kiss_fft_cpx) == sizeof(complex32f_t), "kiss_fft must be built with float samples");
+
+namespace {
+
+class KissFFTPlan : public IFFTPlan
+{
+  public:
+    explicit KissFFTPlan(std::size_t size)
+        : mSize(size)
+        , mConfig(kiss_fft_alloc(size, 0, nullptr, nullptr))
+    {
+    }
+
+    ~KissFFTPlan() override { kiss_fft_free(mConfig); }
+
+    bool IsValid() const { return mConfig != nullptr; }
+
+    std::size_t GetSize() const override { return mSize; }
+
+    void Execute(const complex32f_t* input, complex32f_t* output) const override
+    {
+        // configuration is only read during out of place transforms, so it can be shared between threads
+        kiss_fft(mConfig, reinterpret_cast<const kiss_fft_cpx*>(input), reinterpret_cast<kiss_fft_cpx*>(output));
+    }
+
+  private:
+    std::size_t mSize;
+    kiss_fft_cfg mConfig;
+};
+
+} // namespace
+
+std::string FFTBackendKiss::GetName() const
+{
+    return "kissfft"s;
+}
+
+std::shared_ptr<const IFFTPlan> FFTBackendKiss::CreatePlan(std::size_t size)
+{
+    auto plan = std::make_shared<KissFFTPlan>(size);
+    if (!plan->IsValid())
+        return nullptr;
+    return plan;
+}
+
+} // namespace lime
@@ -0,0 +1,18 @@
+#ifndef LIME_FFTBACKENDKISS_H
+#define LIME_FFTBACKENDKISS_H
+
+#include "FFTBackend.h"
+
+namespace lime {
+
+/// @brief FFT backend using the bundled kiss_fft, always available.
+class FFTBackendKiss : public IFFTBackend
+{
+  public:
+    std::string GetName() const override;
+    std::shared_ptr<const IFFTPlan> CreatePlan(std::size_t size) override;
+};
+
+} // namespace lime
+
+#endif // LIME_FFTBACKENDKISS_H
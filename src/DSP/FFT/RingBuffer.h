@@ -1,158 +1,130 @@
 #pragma once
 
-#include <cstring>
 #include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
 #include <vector>
-#include <mutex>
 
-/// @brief A buffer for manipulating many elements at a time in a queue-like fashion.
+/// @brief A lock-free buffer for passing many elements at a time in a queue-like fashion,
+/// from a single producer thread to a single consumer thread.
 /// @tparam T The type of object to hold.
 template<class T> class RingBuffer
 {
   public:
     /// @brief Constructs the ring buffer with the default capacity.
     RingBuffer()
-        : headIndex(0)
-        , tailIndex(0)
-        , size(0)
-        , capacity(64)
+        : RingBuffer(64)
     {
-        buffer.resize(64);
     }
 
     /// @brief Constructs the ring buffer with the given capacity.
-    /// @param count The maximum capacity of the buffer.
+    /// @param count The minimum capacity of the buffer, rounded up to a power of two.
     RingBuffer(std::size_t count)
         : headIndex(0)
         , tailIndex(0)
-        , size(0)
-        , capacity(count)
     {
-        buffer.resize(count);
+        Resize(count);
     }
 
     /// @brief Removes the items from the queue and puts them into the given destination.
+    /// Must only be called from the consumer thread.
     /// @param dest The buffer to store the items in.
     /// @param count The maximum amount of items to retrieve.
     /// @return The amount of items actually retrieved.
     std::size_t Consume(T* dest, std::size_t count)
     {
-        std::lock_guard<std::mutex> lck(mMutex);
-        std::size_t consumed = 0;
-        count = std::min(count, size.load());
+        const std::size_t head = headIndex.load(std::memory_order_relaxed);
+        const std::size_t tail = tailIndex.load(std::memory_order_acquire);
+        count = std::min(count, tail - head);
 
-        if (headIndex + count >= capacity)
-        {
-            const std::size_t toCopy = capacity - headIndex;
-
-            if constexpr (std::is_trivially_copyable_v<T>)
-            {
-                std::memcpy(dest, buffer.data() + headIndex, toCopy * sizeof(T));
-            }
-            else
-            {
-                for (std::size_t i = 0; i < toCopy; ++i)
-                {
-                    dest[i] = buffer.at(i + headIndex);
-                }
-            }
-            dest += toCopy;
-            headIndex = 0;
-            size -= toCopy;
-            count -= toCopy;
-            consumed += toCopy;
-        }
+        const std::size_t offset = head & mask;
+        const std::size_t firstPart = std::min(count, buffer.size() - offset);
+        Copy(dest, buffer.data() + offset, firstPart);
+        Copy(dest + firstPart, buffer.data(), count - firstPart);
 
-        if constexpr (std::is_trivially_copyable_v<T>)
-        {
-            std::memcpy(dest, buffer.data() + headIndex, count * sizeof(T));
-        }
-        else
-        {
-            for (std::size_t i = 0; i < count; ++i)
-            {
-                dest[i] = buffer.at(i + headIndex);
-            }
-        }
-        headIndex += count;
-        size -= count;
-        consumed += count;
-        return consumed;
+        headIndex.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    /// @brief Removes the items from the queue without reading them.
+    /// Must only be called from the consumer thread.
+    /// @param count The maximum amount of items to remove.
+    /// @return The amount of items actually removed.
+    std::size_t Skip(std::size_t count)
+    {
+        const std::size_t head = headIndex.load(std::memory_order_relaxed);
+        const std::size_t tail = tailIndex.load(std::memory_order_acquire);
+        count = std::min(count, tail - head);
+        headIndex.store(head + count, std::memory_order_release);
+        return count;
     }
 
     /// @brief Adds items into the buffer.
+    /// Must only be called from the producer thread.
     /// @param src The array of items to add to the buffer.
     /// @param count The amount of items to add to the buffer.
     /// @return The amount of items actually added to the buffer.
     std::size_t Produce(const T* src, std::size_t count)
     {
-        std::lock_guard<std::mutex> lck(mMutex);
-        count = std::min(count, capacity - size);
-        std::size_t produced = 0;
+        const std::size_t tail = tailIndex.load(std::memory_order_relaxed);
+        const std::size_t head = headIndex.load(std::memory_order_acquire);
+        count = std::min(count, buffer.size() - (tail - head));
 
-        if (tailIndex + count >= capacity)
-        {
-            const std::size_t toCopy = capacity - tailIndex;
-
-            if constexpr (std::is_trivially_copyable_v<T>)
-            {
-                std::memcpy(buffer.data() + tailIndex, src, toCopy * sizeof(T));
-            }
-            else
-            {
-                for (std::size_t i = 0; i < toCopy; ++i)
-                {
-                    buffer.at(i + tailIndex) = src[i];
-                }
-            }
-            src += toCopy;
-            count -= toCopy;
-            size += toCopy;
-            produced += toCopy;
-            tailIndex = 0;
-        }
-        if constexpr (std::is_trivially_copyable_v<T>)
-        {
-            std::memcpy(buffer.data() + tailIndex, src, count * sizeof(T));
-        }
-        else
-        {
-            for (std::size_t i = 0; i < count; ++i)
-            {
-                buffer.at(i + tailIndex) = src[i];
-            }
-        }
-        tailIndex += count;
-        size += count;
-        produced += count;
-        return produced;
+        const std::size_t offset = tail & mask;
+        const std::size_t firstPart = std::min(count, buffer.size() - offset);
+        Copy(buffer.data() + offset, src, firstPart);
+        Copy(buffer.data(), src + firstPart, count - firstPart);
+
+        tailIndex.store(tail + count, std::memory_order_release);
+        return count;
     }
 
     /// @brief Gets the amount of items in the buffer.
     /// @return The amount of items currently in the buffer.
-    std::size_t Size() const { return size.load(); }
+    std::size_t Size() const
+    {
+        const std::size_t head = headIndex.load(std::memory_order_acquire);
+        return tailIndex.load(std::memory_order_acquire) - head;
+    }
 
     /// @brief Gets the total possible capacity of the buffer.
     /// @return The total possible capacity of the buffer.
-    std::size_t Capacity() const { return capacity; }
+    std::size_t Capacity() const { return buffer.size(); }
 
     /// @brief Resize the ring buffer. WARNING: all previous data will be lost.
-    /// @param count The new size of the ring buffer.
+    /// Must not be called while the producer or the consumer is using the buffer.
+    /// @param count The new minimum size of the ring buffer, rounded up to a power of two.
     void Resize(std::size_t count)
     {
-        std::unique_lock lk{ mMutex };
-        headIndex = 0;
-        tailIndex = 0;
-        size.store(0);
-        capacity = count;
-        buffer.resize(count);
+        std::size_t capacity = 1;
+        while (capacity < count)
+            capacity <<= 1;
+
+        headIndex.store(0);
+        tailIndex.store(0);
+        mask = capacity - 1;
+        buffer.resize(capacity);
     }
 
   private:
-    std::mutex mMutex;
+    static void Copy(T* dest, const T* src, std::size_t count)
+    {
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            if (count > 0)
+                std::memcpy(dest, src, count * sizeof(T));
+        }
+        else
+        {
+            std::copy(src, src + count, dest);
+        }
+    }
+
     std::vector<T> buffer;
-    std::size_t headIndex;
-    std::size_t tailIndex;
-    std::atomic<std::size_t> size;
-    std::size_t capacity;
+    std::size_t mask;
+    // Free running positions, wrapping around is handled by the unsigned arithmetic.
+    // Kept on separate cache lines, so the producer and the consumer don't contend.
+    alignas(64) std::atomic<std::size_t> headIndex;
+    alignas(64) std::atomic<std::size_t> tailIndex;
 };
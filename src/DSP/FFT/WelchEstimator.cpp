@@ -0,0 +1,130 @@
+#include "WelchEstimator.h"
+
+#include "FFTBackend.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+namespace lime {
+
+WelchEstimator::WelchEstimator(const WelchConfig& config)
+    : mConfig(config)
+{
+    mConfig.size = std::max<std::size_t>(mConfig.size, 2);
+    mConfig.overlap = std::clamp(mConfig.overlap, 0.0f, 1.0f);
+    mConfig.averageCount = std::max<std::size_t>(mConfig.averageCount, 1);
+    mConfig.alpha = std::clamp(mConfig.alpha, std::numeric_limits<float>::min(), 1.0f);
+    if (mConfig.sampleRate <= 0)
+        mConfig.sampleRate = 1;
+
+    // at least one new sample per segment
+    const std::size_t overlapSamples = std::min<std::size_t>(mConfig.size * mConfig.overlap, mConfig.size - 1);
+    mHop = mConfig.size - overlapSamples;
+
+    mPlan = FFTPlanCache::GetDefault()->GetPlan(mConfig.size);
+    assert(mPlan);
+    FFT::GenerateWindowCoefficients(mConfig.window, mConfig.size, mWindow);
+
+    double windowSum = 0;
+    double windowPowerSum = 0;
+    for (float coeff : mWindow)
+    {
+        windowSum += coeff;
+        windowPowerSum += coeff * coeff;
+    }
+    if (mConfig.scaling == WelchConfig::Scaling::Density)
+        mScale = 1.0 / (windowPowerSum * mConfig.sampleRate);
+    else
+        mScale = 1.0 / (windowSum * windowSum);
+
+    mSegment.resize(mConfig.size);
+    mFFTIn.resize(mConfig.size);
+    mFFTOut.resize(mConfig.size);
+    mAverage.resize(mConfig.size);
+    Reset();
+}
+
+WelchEstimator::~WelchEstimator() = default;
+
+std::size_t WelchEstimator::Process(const complex32f_t* samples, std::size_t count)
+{
+    const uint64_t resultsBefore = mResultsCount;
+    while (count > 0)
+    {
+        const std::size_t toCopy = std::min(count, mConfig.size - mSegmentFill);
+        std::memcpy(mSegment.data() + mSegmentFill, samples, toCopy * sizeof(complex32f_t));
+        mSegmentFill += toCopy;
+        samples += toCopy;
+        count -= toCopy;
+
+        if (mSegmentFill < mConfig.size)
+            break;
+
+        ProcessSegment();
+        // keep the overlapping tail as the beginning of the next segment
+        std::memmove(mSegment.data(), mSegment.data() + mHop, (mConfig.size - mHop) * sizeof(complex32f_t));
+        mSegmentFill = mConfig.size - mHop;
+    }
+    return mResultsCount - resultsBefore;
+}
+
+void WelchEstimator::Restart()
+{
+    mSegmentFill = 0;
+}
+
+void WelchEstimator::Reset()
+{
+    mSegmentFill = 0;
+    std::fill(mAverage.begin(), mAverage.end(), 0);
+    mSegmentsAveraged = 0;
+    mSegmentsSinceResult = 0;
+    mResult.clear();
+    mResultsCount = 0;
+}
+
+void WelchEstimator::ProcessSegment()
+{
+    const std::size_t size = mConfig.size;
+    for (std::size_t i = 0; i < size; ++i)
+        mFFTIn[i] = complex32f_t(mSegment[i].real() * mWindow[i], mSegment[i].imag() * mWindow[i]);
+    mPlan->Execute(mFFTIn.data(), mFFTOut.data());
+
+    const bool exponential = mConfig.averaging == WelchConfig::Averaging::Exponential;
+    const float weight = (exponential && mSegmentsAveraged > 0) ? mConfig.alpha : 1.0f;
+    // Negative frequencies first, the same order as the FFT class results.
+    std::size_t outputIndex = 0;
+    auto accumulate = [&](std::size_t bin) {
+        const float power = (mFFTOut[bin].real() * mFFTOut[bin].real() + mFFTOut[bin].imag() * mFFTOut[bin].imag()) * mScale;
+        float& average = mAverage[outputIndex++];
+        if (exponential)
+            average += weight * (power - average);
+        else
+            average += power;
+    };
+    for (std::size_t i = size / 2 + 1; i < size; ++i)
+        accumulate(i);
+    for (std::size_t i = 0; i < size / 2 + 1; ++i)
+        accumulate(i);
+    ++mSegmentsAveraged;
+
+    if (++mSegmentsSinceResult < mConfig.averageCount)
+        return;
+    mSegmentsSinceResult = 0;
+
+    mResult.resize(size);
+    if (exponential)
+        std::copy(mAverage.begin(), mAverage.end(), mResult.begin());
+    else
+    {
+        for (std::size_t i = 0; i < size; ++i)
+            mResult[i] = mAverage[i] / mSegmentsAveraged;
+        std::fill(mAverage.begin(), mAverage.end(), 0);
+        mSegmentsAveraged = 0;
+    }
+    ++mResultsCount;
+}
+
+} // namespace lime
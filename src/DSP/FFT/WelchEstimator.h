@@ -0,0 +1,97 @@
+#pragma once
+
+#include "FFT.h"
+#include "limesuiteng/complex.h"
+#include "limesuiteng/config.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace lime {
+
+class IFFTPlan;
+
+/// @brief Parameters of the Welch power spectral density estimation.
+struct WelchConfig {
+    /// @brief The way the segment spectrums are combined into the result.
+    enum class Averaging : uint8_t {
+        Linear, ///< Mean of averageCount segments, restarted after every result.
+        Exponential, ///< Running average weighted by alpha, never restarted.
+    };
+
+    /// @brief The units of the produced power bins.
+    enum class Scaling : uint8_t {
+        Spectrum, ///< Power in each bin, a full scale tone gives 1 in its bin.
+        Density, ///< Power per Hz, white noise gives its variance divided by the sample rate in every bin.
+    };
+
+    std::size_t size{ 1024 }; ///< The amount of samples in a segment, also the amount of the output bins.
+    float overlap{ 0.5 }; ///< Portion of the segment shared with the previous segment, [0; 1).
+    FFT::WindowFunctionType window{ FFT::WindowFunctionType::HANNING }; ///< The window applied to every segment.
+    Averaging averaging{ Averaging::Linear }; ///< The averaging method.
+    std::size_t averageCount{ 16 }; ///< The amount of segments between the results.
+    float alpha{ 0.1 }; ///< The weight of the newest segment for exponential averaging, (0; 1].
+    Scaling scaling{ Scaling::Spectrum }; ///< The units of the results.
+    double sampleRate{ 1 }; ///< The sampling rate in Hz, used for the density scaling.
+};
+
+/// @brief Estimates the power spectrum by averaging the transforms of windowed, overlapping segments (Welch's method).
+///
+/// The bins are ordered from the negative to the positive frequencies the same way as FFT results:
+/// bin i corresponds to the frequency (i + 1 - size / 2) * sampleRate / size, so DC is at index size / 2 - 1.
+class LIME_API WelchEstimator
+{
+  public:
+    /// @brief Constructs the estimator.
+    /// @param config The parameters of the estimation, out of range values are clamped.
+    explicit WelchEstimator(const WelchConfig& config);
+    ~WelchEstimator();
+
+    /// @brief Adds the samples to the estimation.
+    /// @param samples The samples to process.
+    /// @param count The amount of samples to process.
+    /// @return The amount of new results produced while processing the samples.
+    std::size_t Process(const complex32f_t* samples, std::size_t count);
+
+    /// @brief Gets the latest estimation result.
+    /// @return The power bins, empty until the first result is produced.
+    const std::vector<float>& GetResult() const { return mResult; }
+
+    /// @brief Gets the amount of results produced since the construction or the last Reset().
+    /// @return The results count.
+    uint64_t GetResultsCount() const { return mResultsCount; }
+
+    /// @brief Drops the partially collected segment, for when the input is discontinuous.
+    /// The averages collected so far are kept.
+    void Restart();
+
+    /// @brief Drops all the collected data and results.
+    void Reset();
+
+    /// @brief Gets the parameters in use, after clamping.
+    /// @return The configuration of the estimator.
+    const WelchConfig& GetConfig() const { return mConfig; }
+
+  private:
+    void ProcessSegment();
+
+    WelchConfig mConfig;
+    std::size_t mHop;
+    std::shared_ptr<const IFFTPlan> mPlan;
+    std::vector<float> mWindow;
+    float mScale;
+
+    std::vector<complex32f_t> mSegment;
+    std::size_t mSegmentFill;
+    std::vector<complex32f_t> mFFTIn;
+    std::vector<complex32f_t> mFFTOut;
+
+    std::vector<float> mAverage;
+    std::size_t mSegmentsAveraged;
+    std::size_t mSegmentsSinceResult;
+    std::vector<float> mResult;
+    uint64_t mResultsCount;
+};
+
+} // namespace lime
@@ -0,0 +1,57 @@
+#include "GainController.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std::literals::string_literals;
+
+namespace lime {
+
+// The share of the deficit corrected in one update when the signal is too weak.
+static constexpr double releaseRatio = 0.5;
+
+/// @brief Constructs the controller.
+/// @param settings The settings of the control law.
+GainController::GainController(const Settings& settings)
+    : mSettings(settings)
+{
+    if (settings.gainRange.min > settings.gainRange.max)
+        throw std::invalid_argument("Gain control range is empty"s);
+    if (settings.targetPower > settings.peakLimit)
+        throw std::invalid_argument("Gain control target power is above the peak limit"s);
+    if (settings.hysteresis < 0)
+        throw std::invalid_argument("Gain control hysteresis is negative"s);
+}
+
+/// @brief Calculates the gain to use for the next measurement.
+/// @param meanPower The mean power measured with the current gain (in dBFS).
+/// @param peakPower The peak power measured with the current gain (in dBFS).
+/// @param gain The current gain (in dB).
+/// @return The new gain (in dB), the same value if no change is needed.
+double GainController::Update(float meanPower, float peakPower, double gain) const
+{
+    double change = 0;
+    if (peakPower > mSettings.peakLimit)
+    {
+        // a clipped peak hides the real level, so back off at least by the hysteresis
+        change = std::min<double>(mSettings.peakLimit - peakPower, -std::max(mSettings.hysteresis, 1.0f));
+        change = std::min<double>(change, mSettings.targetPower - meanPower);
+    }
+    else if (meanPower > mSettings.targetPower + mSettings.hysteresis)
+        change = mSettings.targetPower - meanPower;
+    else if (meanPower < mSettings.targetPower - mSettings.hysteresis)
+    {
+        // don't raise the peaks over the limit
+        change = std::min<double>((mSettings.targetPower - meanPower) * releaseRatio, mSettings.peakLimit - peakPower);
+    }
+
+    const double step = mSettings.gainRange.step > 0 ? mSettings.gainRange.step : 1;
+    // round toward the smaller change, so the correction never overshoots
+    const double steps = change < 0 ? std::ceil(change / step) : std::floor(change / step);
+    if (steps == 0)
+        return gain;
+    return std::clamp(gain + steps * step, mSettings.gainRange.min, mSettings.gainRange.max);
+}
+
+} // namespace lime
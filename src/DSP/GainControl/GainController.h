@@ -0,0 +1,40 @@
+#ifndef LIME_GAINCONTROLLER_H
+#define LIME_GAINCONTROLLER_H
+
+#include "limesuiteng/config.h"
+#include "limesuiteng/types.h"
+
+namespace lime {
+
+/// @brief The control law of the automatic gain control: keeps the mean received power at the target level,
+/// while preventing the peaks from clipping.
+///
+/// Overloads are handled at once (fast attack), weak signals are brought up by half of the difference
+/// per update (slow release), so bursts don't make the gain oscillate. Changes smaller than the hysteresis
+/// are ignored, and the gain is kept in whole steps, as the receiver gain tables have 1 dB resolution.
+class LIME_API GainController
+{
+  public:
+    /// @brief The settings of the control law.
+    struct Settings {
+        float targetPower; ///< The wanted mean power (in dBFS).
+        float peakLimit; ///< The highest allowed peak power (in dBFS).
+        float hysteresis; ///< The deviation from the target power to tolerate (in dB).
+        Range<double> gainRange; ///< The gains that can be set (in dB).
+    };
+
+    GainController(const Settings& settings);
+
+    double Update(float meanPower, float peakPower, double gain) const;
+
+    /// @brief Gets the settings of the control law.
+    /// @return The settings.
+    const Settings& GetSettings() const { return mSettings; }
+
+  private:
+    Settings mSettings;
+};
+
+} // namespace lime
+
+#endif // LIME_GAINCONTROLLER_H
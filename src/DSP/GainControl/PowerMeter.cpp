@@ -0,0 +1,84 @@
+#include "PowerMeter.h"
+
+#include "DSP/Resampling/ResamplingKernels.h"
+#include "limesuiteng/complex.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace lime {
+
+// The reported floor, so the decibels of silence stay finite.
+static constexpr float minimumPower_dBFS = -200;
+
+/// @brief Measures the mean and the peak power of a single channel's samples.
+/// @tparam T The type of the samples.
+/// @param samples The samples to measure.
+/// @param count The amount of samples.
+/// @return The measurement, relative to the full scale of the sample type.
+template<class T> PowerMeasurement MeasurePower(const T* samples, uint32_t count)
+{
+    constexpr float inputScale = GetScalingRatio<complex32f_t, T>();
+    PowerMeasurement measurement;
+    // float accumulation of short runs keeps the loop vectorizable, the runs are summed in double
+    constexpr uint32_t runLength = 256;
+    for (uint32_t start = 0; start < count; start += runLength)
+    {
+        const uint32_t end = std::min(start + runLength, count);
+        float sum = 0;
+        float peak = 0;
+        for (uint32_t n = start; n < end; ++n)
+        {
+            const float i = samples[n].real();
+            const float q = samples[n].imag();
+            const float power = i * i + q * q;
+            sum += power;
+            peak = std::max(peak, power);
+        }
+        measurement.sum += sum;
+        measurement.peak = std::max(measurement.peak, peak);
+    }
+    measurement.sum *= inputScale * inputScale;
+    measurement.peak *= inputScale * inputScale;
+    measurement.count = count;
+    return measurement;
+}
+
+/// @brief Measures the mean and the peak power of a single channel's samples.
+/// @param samples The samples to measure.
+/// @param count The amount of samples.
+/// @param format The format of the samples.
+/// @return The measurement, relative to the full scale of the format.
+PowerMeasurement MeasurePower(const void* samples, uint32_t count, DataFormat format)
+{
+    switch (format)
+    {
+    case DataFormat::F32:
+        return MeasurePower(static_cast<const complex32f_t*>(samples), count);
+    case DataFormat::F16:
+        return MeasurePower(static_cast<const complex16f_t*>(samples), count);
+    case DataFormat::I16:
+        return MeasurePower(static_cast<const complex16_t*>(samples), count);
+    case DataFormat::I12:
+        return MeasurePower(static_cast<const complex12_t*>(samples), count);
+    case DataFormat::I8:
+        return MeasurePower(static_cast<const complex8_t*>(samples), count);
+    }
+    return PowerMeasurement();
+}
+
+/// @brief Converts the power relative to the full scale to decibels.
+/// @param power The power relative to the full scale.
+/// @return The power in dBFS, limited to -200 dBFS for silence.
+float PowerToDecibels(float power)
+{
+    return power > 0 ? std::max(10 * std::log10(power), minimumPower_dBFS) : minimumPower_dBFS;
+}
+
+template PowerMeasurement MeasurePower(const complex32f_t*, uint32_t);
+template PowerMeasurement MeasurePower(const complex16f_t*, uint32_t);
+template PowerMeasurement MeasurePower(const complex16_t*, uint32_t);
+template PowerMeasurement MeasurePower(const complex12_t*, uint32_t);
+template PowerMeasurement MeasurePower(const complex8_t*, uint32_t);
+
+} // namespace lime
@@ -0,0 +1,38 @@
+#ifndef LIME_POWERMETER_H
+#define LIME_POWERMETER_H
+
+#include "limesuiteng/config.h"
+#include "limesuiteng/types.h"
+
+#include <cstdint>
+
+namespace lime {
+
+/// @brief The power of a block of samples, relative to the full scale (a full scale complex tone has the power of 1).
+struct PowerMeasurement {
+    double sum{ 0 }; ///< The sum of the powers of the samples.
+    float peak{ 0 }; ///< The largest power of a single sample.
+    uint32_t count{ 0 }; ///< The amount of measured samples.
+
+    /// @brief Combines the measurement of another block of samples into this one.
+    /// @param other The measurement to add.
+    void Add(const PowerMeasurement& other)
+    {
+        sum += other.sum;
+        peak = other.peak > peak ? other.peak : peak;
+        count += other.count;
+    }
+
+    /// @brief Gets the mean power of the samples.
+    /// @return The mean power, 0 if nothing has been measured.
+    float Mean() const { return count ? sum / count : 0; }
+};
+
+template<class T> LIME_API PowerMeasurement MeasurePower(const T* samples, uint32_t count);
+LIME_API PowerMeasurement MeasurePower(const void* samples, uint32_t count, DataFormat format);
+
+LIME_API float PowerToDecibels(float power);
+
+} // namespace lime
+
+#endif // LIME_POWERMETER_H
@@ -0,0 +1,153 @@
+#include "IQImpairmentTracker.h"
+
+#include "DSP/Resampling/ResamplingKernels.h"
+#include "limesuiteng/complex.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace lime {
+
+// Below this variance the signal is too weak to tell the imbalance, the previous correction is kept.
+static constexpr double minimumVariance = 1e-10;
+
+/// @brief Constructs the tracker.
+/// @param timeConstant The averaging time constant of the estimation (in samples), longer is less noisy but follows slower.
+/// @param correctDC Whether to remove the DC offset.
+/// @param correctIQ Whether to correct the gain and phase imbalance.
+IQImpairmentTracker::IQImpairmentTracker(double timeConstant, bool correctDC, bool correctIQ)
+    : mTimeConstant(std::max(timeConstant, 1.0))
+    , mCorrectDC(correctDC)
+    , mCorrectIQ(correctIQ)
+{
+    Reset();
+}
+
+/// @brief Drops the collected estimation, the correction starts from the next processed samples.
+void IQImpairmentTracker::Reset()
+{
+    mStarted = false;
+    mMeanI = mMeanQ = 0;
+    mPowerI = mPowerQ = mCross = 0;
+    mOffsetI = mOffsetQ = 0;
+    mGainQ = 1;
+    mCrossGain = 0;
+}
+
+void IQImpairmentTracker::Update(double sumI, double sumQ, double sumII, double sumQQ, double sumIQ, uint32_t count)
+{
+    const double weight = mStarted ? 1 - std::exp(-(count / mTimeConstant)) : 1;
+    mStarted = true;
+    mMeanI += weight * (sumI / count - mMeanI);
+    mMeanQ += weight * (sumQ / count - mMeanQ);
+    mPowerI += weight * (sumII / count - mPowerI);
+    mPowerQ += weight * (sumQQ / count - mPowerQ);
+    mCross += weight * (sumIQ / count - mCross);
+
+    if (mCorrectDC)
+    {
+        mOffsetI = mMeanI;
+        mOffsetQ = mMeanQ;
+    }
+    if (!mCorrectIQ)
+        return;
+
+    // Gram-Schmidt: remove the part of Q correlated with I, then equalize the powers
+    const double varianceI = mPowerI - mMeanI * mMeanI;
+    const double varianceQ = mPowerQ - mMeanQ * mMeanQ;
+    const double covariance = mCross - mMeanI * mMeanQ;
+    if (varianceI < minimumVariance)
+        return;
+    const double correlation = covariance / varianceI;
+    const double residual = varianceQ - covariance * correlation;
+    if (residual < minimumVariance)
+        return;
+    mGainQ = std::sqrt(varianceI / residual);
+    mCrossGain = -correlation * mGainQ;
+}
+
+/// @brief Updates the estimation with the samples of a single channel and corrects them.
+/// @tparam T The type of the samples.
+/// @param samples The samples to process, corrected in place.
+/// @param count The amount of samples.
+template<class T> void IQImpairmentTracker::Process(T* samples, uint32_t count)
+{
+    if (count == 0)
+        return;
+
+    constexpr float inputScale = GetScalingRatio<complex32f_t, T>();
+    double sumI = 0;
+    double sumQ = 0;
+    double sumII = 0;
+    double sumQQ = 0;
+    double sumIQ = 0;
+    for (uint32_t n = 0; n < count; ++n)
+    {
+        const double i = samples[n].real() * inputScale;
+        const double q = samples[n].imag() * inputScale;
+        sumI += i;
+        sumQ += q;
+        sumII += i * i;
+        sumQQ += q * q;
+        sumIQ += i * q;
+    }
+    Update(sumI, sumQ, sumII, sumQQ, sumIQ, count);
+
+    // with the offset folded in, the correction is two multiply-adds per sample
+    const float biasQ = -mGainQ * mOffsetQ - mCrossGain * mOffsetI;
+    for (uint32_t n = 0; n < count; ++n)
+    {
+        const float i = samples[n].real() * inputScale;
+        const float q = samples[n].imag() * inputScale;
+        StoreSample(samples[n], i - mOffsetI, mGainQ * q + mCrossGain * i + biasQ);
+    }
+}
+
+/// @brief Updates the estimation with the samples of a single channel and corrects them.
+/// @param samples The samples to process, corrected in place.
+/// @param count The amount of samples.
+/// @param format The format of the samples.
+void IQImpairmentTracker::Process(void* samples, uint32_t count, DataFormat format)
+{
+    switch (format)
+    {
+    case DataFormat::F32:
+        Process(static_cast<complex32f_t*>(samples), count);
+        break;
+    case DataFormat::F16:
+        Process(static_cast<complex16f_t*>(samples), count);
+        break;
+    case DataFormat::I16:
+        Process(static_cast<complex16_t*>(samples), count);
+        break;
+    case DataFormat::I12:
+        Process(static_cast<complex12_t*>(samples), count);
+        break;
+    case DataFormat::I8:
+        Process(static_cast<complex8_t*>(samples), count);
+        break;
+    }
+}
+
+/// @brief Gets the current estimation of the impairments of the input signal.
+/// @return The impairments, before the correction.
+IQImpairments IQImpairmentTracker::GetImpairments() const
+{
+    IQImpairments impairments{ mMeanI, mMeanQ, 1, 0 };
+    const double varianceI = mPowerI - mMeanI * mMeanI;
+    const double varianceQ = mPowerQ - mMeanQ * mMeanQ;
+    if (varianceI < minimumVariance || varianceQ < minimumVariance)
+        return impairments;
+    const double covariance = mCross - mMeanI * mMeanQ;
+    impairments.gain = std::sqrt(varianceQ / varianceI);
+    impairments.phase = std::asin(std::clamp(covariance / std::sqrt(varianceI * varianceQ), -1.0, 1.0));
+    return impairments;
+}
+
+template void IQImpairmentTracker::Process(complex32f_t*, uint32_t);
+template void IQImpairmentTracker::Process(complex16f_t*, uint32_t);
+template void IQImpairmentTracker::Process(complex16_t*, uint32_t);
+template void IQImpairmentTracker::Process(complex12_t*, uint32_t);
+template void IQImpairmentTracker::Process(complex8_t*, uint32_t);
+
+} // namespace lime
@@ -0,0 +1,65 @@
+#ifndef LIME_IQIMPAIRMENTTRACKER_H
+#define LIME_IQIMPAIRMENTTRACKER_H
+
+#include "limesuiteng/config.h"
+#include "limesuiteng/types.h"
+
+#include <cstdint>
+
+namespace lime {
+
+/// @brief The estimated impairments of a received signal.
+struct IQImpairments {
+    double dcI; ///< The DC offset of I, relative to the full scale.
+    double dcQ; ///< The DC offset of Q, relative to the full scale.
+    double gain; ///< The amplitude of Q relative to the amplitude of I.
+    double phase; ///< The deviation of Q from being orthogonal to I (in radians).
+};
+
+/// @brief Tracks the DC offset and the IQ imbalance of a live signal and corrects them in place.
+///
+/// The estimation is blind: it relies on the received signal being proper (I and Q of equal power and uncorrelated),
+/// which holds for noise and practically any modulated signal. The first and second order moments of each block
+/// of samples are averaged exponentially, so the correction follows slow drifts (temperature, gain changes)
+/// without interrupting the stream. The correction keeps I as the reference and makes Q orthogonal to it
+/// with equal power.
+class LIME_API IQImpairmentTracker
+{
+  public:
+    /// @brief The default averaging time constant (in samples).
+    static constexpr double defaultTimeConstant = 1 << 20;
+
+    IQImpairmentTracker(double timeConstant = defaultTimeConstant, bool correctDC = true, bool correctIQ = true);
+
+    void Process(void* samples, uint32_t count, DataFormat format);
+    template<class T> void Process(T* samples, uint32_t count);
+
+    void Reset();
+
+    IQImpairments GetImpairments() const;
+
+  private:
+    void Update(double sumI, double sumQ, double sumII, double sumQQ, double sumIQ, uint32_t count);
+
+    double mTimeConstant;
+    bool mCorrectDC;
+    bool mCorrectIQ;
+    bool mStarted;
+
+    // exponentially averaged raw moments of the input
+    double mMeanI;
+    double mMeanQ;
+    double mPowerI;
+    double mPowerQ;
+    double mCross;
+
+    // the correction: I' = I - offsetI, Q' = gainQ * (Q - offsetQ) + crossGain * (I - offsetI)
+    float mOffsetI;
+    float mOffsetQ;
+    float mGainQ;
+    float mCrossGain;
+};
+
+} // namespace lime
+
+#endif // LIME_IQIMPAIRMENTTRACKER_H
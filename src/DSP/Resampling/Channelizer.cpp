@@ -0,0 +1,162 @@
+#define _USE_MATH_DEFINES
+#include "Channelizer.h"
+
+#include "DSP/FFT/FFTBackend.h"
+#include "FIRDesign.h"
+#include "ResamplingKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std::literals::string_literals;
+
+namespace lime {
+
+/// @brief Constructs the channelizer.
+/// @param channelCount The amount of sub-channels to split the band into.
+/// @param decimation The amount of input samples per output sample, must divide the channel count.
+/// @param outputs The sub-channels to produce, [0; channelCount).
+/// @param tapsPerChannel The amount of prototype filter coefficients per sub-channel, more gives a sharper filter.
+Channelizer::Channelizer(
+    uint16_t channelCount, uint16_t decimation, const std::vector<uint16_t>& outputs, std::size_t tapsPerChannel)
+    : mChannelCount(channelCount)
+    , mDecimation(decimation)
+    , mOutputs(outputs)
+    , mHistoryPos(0)
+    , mPhase(0)
+    , mTimeIndex(0)
+    , mExpectedTimestamp(0)
+    , mStarted(false)
+{
+    if (channelCount < 2 || decimation == 0 || channelCount % decimation != 0)
+        throw std::invalid_argument("Channelizer decimation must be a divisor of the channel count"s);
+    if (outputs.empty())
+        throw std::invalid_argument("Channelizer has no outputs"s);
+    for (uint16_t channel : outputs)
+    {
+        if (channel >= channelCount)
+            throw std::invalid_argument("Channelizer output index out of range"s);
+    }
+
+    mPlan = FFTPlanCache::GetDefault()->GetPlan(channelCount);
+    if (!mPlan)
+        throw std::runtime_error("Failed to create channelizer FFT plan"s);
+
+    // the polyphase branches have to be whole, and the summation of each branch is vectorized
+    std::size_t length = std::max<std::size_t>(tapsPerChannel, 1) * channelCount;
+    while (length % dotProductLanes != 0)
+        length += channelCount;
+    // -6 dB at the sub-channel edges, so the neighbouring sub-channels add up to a flat response
+    mTaps = DesignLowpassFIR(length, 0.5 / channelCount);
+    // the history is ordered from the oldest sample, so the coefficients are applied reversed
+    mKernel.assign(mTaps.rbegin(), mTaps.rend());
+
+    mTwiddles.resize(channelCount);
+    for (uint16_t i = 0; i < channelCount; ++i)
+        mTwiddles[i] = std::polar(1.0f, static_cast<float>(-2 * M_PI * i / channelCount));
+
+    mHistoryI.resize(length * 2);
+    mHistoryQ.resize(length * 2);
+    mSumI.resize(channelCount);
+    mSumQ.resize(channelCount);
+    mFFTIn.resize(channelCount);
+    mFFTOut.resize(channelCount);
+}
+
+Channelizer::~Channelizer() = default;
+
+/// @brief Clears the filter state, the next processed samples are treated as a new stream.
+void Channelizer::Reset()
+{
+    mStarted = false;
+}
+
+void Channelizer::Restart(uint64_t timestamp)
+{
+    std::fill(mHistoryI.begin(), mHistoryI.end(), 0);
+    std::fill(mHistoryQ.begin(), mHistoryQ.end(), 0);
+    mHistoryPos = 0;
+    mPhase = timestamp % mDecimation;
+    mTimeIndex = (timestamp + 1) % mChannelCount;
+    mStarted = true;
+}
+
+// Sums the filtered history of each polyphase branch and transforms the sums to the sub-channel bins.
+void Channelizer::Transform()
+{
+    const std::size_t length = mKernel.size();
+    const float* historyI = &mHistoryI[mHistoryPos];
+    const float* historyQ = &mHistoryQ[mHistoryPos];
+    std::fill(mSumI.begin(), mSumI.end(), 0);
+    std::fill(mSumQ.begin(), mSumQ.end(), 0);
+    for (std::size_t offset = 0; offset < length; offset += mChannelCount)
+    {
+        const float* kernel = &mKernel[offset];
+        for (std::size_t i = 0; i < mChannelCount; ++i)
+        {
+            mSumI[i] += kernel[i] * historyI[offset + i];
+            mSumQ[i] += kernel[i] * historyQ[offset + i];
+        }
+    }
+    for (std::size_t i = 0; i < mChannelCount; ++i)
+        mFFTIn[i] = complex32f_t(mSumI[i], mSumQ[i]);
+    mPlan->Execute(mFFTIn.data(), mFFTOut.data());
+}
+
+/// @brief Splits the samples of a single channel into the sub-channels.
+/// A timestamp discontinuity restarts the filter, so the samples from before the gap don't leak into the output.
+/// @tparam SrcT The type of the input samples.
+/// @tparam DestT The type of the output samples.
+/// @param src The input samples.
+/// @param count The amount of input samples.
+/// @param timestamp The timestamp of the first input sample.
+/// @param dest The destinations for each of the outputs, each must fit count / decimation + 1 samples.
+/// @return The amount of samples produced for each output.
+template<class SrcT, class DestT>
+uint32_t Channelizer::Process(const SrcT* src, uint32_t count, uint64_t timestamp, DestT* const* dest)
+{
+    if (!mStarted || timestamp != mExpectedTimestamp)
+        Restart(timestamp);
+    mExpectedTimestamp = timestamp + count;
+
+    constexpr float inputScale = GetScalingRatio<complex32f_t, SrcT>();
+    const std::size_t length = mKernel.size();
+    uint32_t produced = 0;
+    for (uint32_t n = 0; n < count; ++n)
+    {
+        mHistoryI[mHistoryPos] = mHistoryI[mHistoryPos + length] = src[n].real() * inputScale;
+        mHistoryQ[mHistoryPos] = mHistoryQ[mHistoryPos + length] = src[n].imag() * inputScale;
+        if (++mHistoryPos == length)
+            mHistoryPos = 0;
+
+        const bool outputDue = mPhase == 0;
+        if (++mPhase == mDecimation)
+            mPhase = 0;
+        const uint16_t timeIndex = mTimeIndex;
+        if (++mTimeIndex == mChannelCount)
+            mTimeIndex = 0;
+        if (!outputDue)
+            continue;
+
+        Transform();
+        for (std::size_t i = 0; i < mOutputs.size(); ++i)
+        {
+            const uint16_t channel = mOutputs[i];
+            const std::complex<float> bin(mFFTOut[channel].real(), mFFTOut[channel].imag());
+            const std::complex<float> out = bin * mTwiddles[static_cast<uint32_t>(channel) * timeIndex % mChannelCount];
+            StoreSample(dest[i][produced], out.real(), out.imag());
+        }
+        ++produced;
+    }
+    return produced;
+}
+
+template uint32_t Channelizer::Process(const complex32f_t*, uint32_t, uint64_t, complex32f_t* const*);
+template uint32_t Channelizer::Process(const complex16f_t*, uint32_t, uint64_t, complex16f_t* const*);
+template uint32_t Channelizer::Process(const complex16_t*, uint32_t, uint64_t, complex16_t* const*);
+template uint32_t Channelizer::Process(const complex16_t*, uint32_t, uint64_t, complex32f_t* const*);
+template uint32_t Channelizer::Process(const complex12_t*, uint32_t, uint64_t, complex12_t* const*);
+template uint32_t Channelizer::Process(const complex8_t*, uint32_t, uint64_t, complex8_t* const*);
+
+} // namespace lime
@@ -0,0 +1,115 @@
+#ifndef LIME_CHANNELIZER_H
+#define LIME_CHANNELIZER_H
+
+#include "limesuiteng/complex.h"
+#include "limesuiteng/config.h"
+
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace lime {
+
+class IFFTPlan;
+
+/// @brief Polyphase filter bank channelizer: splits the input band into equally spaced sub-channels,
+/// each moved to DC, low pass filtered and decimated.
+///
+/// Sub-channel k is centered at k / channelCount of the input sampling rate, the channels above the half
+/// of the count are the negative frequencies. The output of each sub-channel is the same as of a Downconverter
+/// with the prototype filter taps, but the filtering is shared by all the sub-channels and a single FFT per
+/// output sample replaces the per channel mixing, so the cost hardly depends on the amount of the sub-channels.
+/// Critically sampled when the decimation equals the channel count, oversampled when it's a divisor of it.
+/// Output samples are produced at the inputs whose timestamp is a multiple of the decimation.
+class LIME_API Channelizer
+{
+  public:
+    /// @brief The default amount of prototype filter coefficients per sub-channel.
+    static constexpr std::size_t defaultTapsPerChannel = 16;
+
+    Channelizer(uint16_t channelCount,
+        uint16_t decimation,
+        const std::vector<uint16_t>& outputs,
+        std::size_t tapsPerChannel = defaultTapsPerChannel);
+    ~Channelizer();
+
+    template<class SrcT, class DestT> uint32_t Process(const SrcT* src, uint32_t count, uint64_t timestamp, DestT* const* dest);
+
+    void Reset();
+
+    /// @brief Gets the amount of sub-channels the band is split into.
+    /// @return The amount of sub-channels (the size of the FFT).
+    uint16_t GetChannelCount() const { return mChannelCount; }
+
+    /// @brief Gets the decimation ratio.
+    /// @return The amount of input samples per output sample.
+    uint16_t GetDecimation() const { return mDecimation; }
+
+    /// @brief Gets the sub-channels being output.
+    /// @return The indexes of the sub-channels, in the order of the Process() destinations.
+    const std::vector<uint16_t>& GetOutputs() const { return mOutputs; }
+
+    /// @brief Gets the prototype low pass filter coefficients.
+    /// @return The filter applied at the input sampling rate.
+    const std::vector<float>& GetTaps() const { return mTaps; }
+
+    /// @brief Gets the group delay of the filter.
+    /// @return The delay, in input samples.
+    double GetDelay() const { return (mTaps.size() - 1) / 2.0; }
+
+    /// @brief Gets the center frequency of the sub-channel.
+    /// @param channel The index of the sub-channel.
+    /// @return The frequency relative to the input sampling rate, [-0.5; 0.5).
+    double GetCenterFrequency(uint16_t channel) const
+    {
+        return (channel < (mChannelCount + 1) / 2 ? channel : channel - mChannelCount) / static_cast<double>(mChannelCount);
+    }
+
+    /// @brief Gets the timestamp of the first output sample produced from the given input samples.
+    /// @param inputTimestamp The timestamp of the first input sample.
+    /// @return The output timestamp.
+    uint64_t GetOutputTimestamp(uint64_t inputTimestamp) const { return (inputTimestamp + mDecimation - 1) / mDecimation; }
+
+    /// @brief Gets the amount of input samples needed to produce the given amount of outputs.
+    /// @param inputTimestamp The timestamp of the first input sample.
+    /// @param outputCount The amount of output samples wanted.
+    /// @return The amount of input samples, after which the last wanted output is produced.
+    uint64_t GetInputCount(uint64_t inputTimestamp, uint32_t outputCount) const
+    {
+        if (outputCount == 0)
+            return 0;
+        return (GetOutputTimestamp(inputTimestamp) + outputCount - 1) * mDecimation - inputTimestamp + 1;
+    }
+
+  private:
+    void Restart(uint64_t timestamp);
+    void Transform();
+
+    uint16_t mChannelCount;
+    uint16_t mDecimation;
+    std::vector<uint16_t> mOutputs;
+    std::vector<float> mTaps;
+    std::vector<float> mKernel;
+    std::shared_ptr<const IFFTPlan> mPlan;
+    // rotation of the FFT bins to the output phase, indexed by channel * (time + 1) modulo channel count
+    std::vector<std::complex<float>> mTwiddles;
+
+    // inputs are stored twice, so the latest mTaps.size() samples are always contiguous
+    std::vector<float> mHistoryI;
+    std::vector<float> mHistoryQ;
+    std::size_t mHistoryPos;
+    std::vector<float> mSumI;
+    std::vector<float> mSumQ;
+    std::vector<complex32f_t> mFFTIn;
+    std::vector<complex32f_t> mFFTOut;
+
+    uint16_t mPhase;
+    uint16_t mTimeIndex;
+    uint64_t mExpectedTimestamp;
+    bool mStarted;
+};
+
+} // namespace lime
+
+#endif // LIME_CHANNELIZER_H
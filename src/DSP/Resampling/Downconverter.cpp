@@ -0,0 +1,128 @@
+#include "Downconverter.h"
+
+#include "FIRDesign.h"
+#include "ResamplingKernels.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace lime {
+
+/// @brief Constructs the downconverter.
+/// @param decimation The amount of input samples per output sample.
+/// @param frequency The frequency moved to DC, relative to the input sampling rate.
+/// @param tapsPerPhase The amount of filter coefficients per output sample, more gives a sharper filter.
+Downconverter::Downconverter(uint16_t decimation, double frequency, std::size_t tapsPerPhase)
+    : mDecimation(std::max<uint16_t>(decimation, 1))
+    , mNCO(-frequency)
+    , mHistoryPos(0)
+    , mPhase(0)
+    , mExpectedTimestamp(0)
+    , mStarted(false)
+{
+    std::size_t length = mDecimation > 1 ? tapsPerPhase * mDecimation : 1;
+    length = (length + dotProductLanes - 1) / dotProductLanes * dotProductLanes;
+    if (mDecimation > 1)
+        mTaps = DesignLowpassFIR(length, 0.4 / mDecimation);
+    else
+    {
+        // without decimation there is nothing to filter out, pass the samples through
+        mTaps.assign(length, 0);
+        mTaps.front() = 1;
+    }
+    // the history is ordered from the oldest sample, so the coefficients are applied reversed
+    mKernel.assign(mTaps.rbegin(), mTaps.rend());
+
+    mHistoryI.resize(length * 2);
+    mHistoryQ.resize(length * 2);
+}
+
+/// @brief Clears the filter state, the next processed samples are treated as a new stream.
+void Downconverter::Reset()
+{
+    mStarted = false;
+}
+
+void Downconverter::Restart(uint64_t timestamp)
+{
+    std::fill(mHistoryI.begin(), mHistoryI.end(), 0);
+    std::fill(mHistoryQ.begin(), mHistoryQ.end(), 0);
+    mHistoryPos = 0;
+    mPhase = timestamp % mDecimation;
+    mNCO.SetPhase(timestamp);
+    mStarted = true;
+}
+
+/// @brief Downconverts the samples of a single channel.
+/// A timestamp discontinuity restarts the filter, so the samples from before the gap don't leak into the output.
+/// @tparam SrcT The type of the input samples (link format).
+/// @tparam DestT The type of the output samples.
+/// @param src The input samples.
+/// @param stride The distance between the consecutive samples of this channel in the input (the amount of interleaved channels).
+/// @param count The amount of input samples of this channel.
+/// @param timestamp The timestamp of the first input sample.
+/// @param dest The destination for the output samples, must fit count / decimation + 1 samples.
+/// @return The amount of output samples produced.
+template<class SrcT, class DestT>
+uint32_t Downconverter::Process(const SrcT* src, uint8_t stride, uint32_t count, uint64_t timestamp, DestT* dest)
+{
+    if (!mStarted || timestamp != mExpectedTimestamp)
+        Restart(timestamp);
+    mExpectedTimestamp = timestamp + count;
+
+    constexpr float inputScale = GetScalingRatio<complex32f_t, SrcT>();
+    const std::size_t length = mKernel.size();
+    float ncoI[NCO::blockSize];
+    float ncoQ[NCO::blockSize];
+    float mixedI[NCO::blockSize];
+    float mixedQ[NCO::blockSize];
+
+    uint32_t produced = 0;
+    for (uint32_t blockStart = 0; blockStart < count; blockStart += NCO::blockSize)
+    {
+        const std::size_t blockLength = std::min<std::size_t>(NCO::blockSize, count - blockStart);
+        mNCO.Generate(ncoI, ncoQ, blockLength);
+        const SrcT* input = src + blockStart * stride;
+        for (std::size_t i = 0; i < blockLength; ++i)
+        {
+            const float inI = input[i * stride].real() * inputScale;
+            const float inQ = input[i * stride].imag() * inputScale;
+            mixedI[i] = inI * ncoI[i] - inQ * ncoQ[i];
+            mixedQ[i] = inI * ncoQ[i] + inQ * ncoI[i];
+        }
+
+        for (std::size_t i = 0; i < blockLength; ++i)
+        {
+            mHistoryI[mHistoryPos] = mHistoryI[mHistoryPos + length] = mixedI[i];
+            mHistoryQ[mHistoryPos] = mHistoryQ[mHistoryPos + length] = mixedQ[i];
+            if (++mHistoryPos == length)
+                mHistoryPos = 0;
+
+            const bool outputDue = mPhase == 0;
+            if (++mPhase == mDecimation)
+                mPhase = 0;
+            if (!outputDue)
+                continue;
+
+            // mHistoryPos now points to the oldest sample
+            const float outI = DotProduct(mKernel.data(), &mHistoryI[mHistoryPos], length);
+            const float outQ = DotProduct(mKernel.data(), &mHistoryQ[mHistoryPos], length);
+            StoreSample(dest[produced++], outI, outQ);
+        }
+    }
+    return produced;
+}
+
+template uint32_t Downconverter::Process(const complex16_t*, uint8_t, uint32_t, uint64_t, complex32f_t*);
+template uint32_t Downconverter::Process(const complex16_t*, uint8_t, uint32_t, uint64_t, complex16_t*);
+template uint32_t Downconverter::Process(const complex16_t*, uint8_t, uint32_t, uint64_t, complex12_t*);
+template uint32_t Downconverter::Process(const complex16_t*, uint8_t, uint32_t, uint64_t, complex8_t*);
+template uint32_t Downconverter::Process(const complex16_t*, uint8_t, uint32_t, uint64_t, complex16f_t*);
+template uint32_t Downconverter::Process(const complex12packed_t*, uint8_t, uint32_t, uint64_t, complex32f_t*);
+template uint32_t Downconverter::Process(const complex12packed_t*, uint8_t, uint32_t, uint64_t, complex16_t*);
+template uint32_t Downconverter::Process(const complex12packed_t*, uint8_t, uint32_t, uint64_t, complex12_t*);
+template uint32_t Downconverter::Process(const complex12packed_t*, uint8_t, uint32_t, uint64_t, complex8_t*);
+template uint32_t Downconverter::Process(const complex12packed_t*, uint8_t, uint32_t, uint64_t, complex16f_t*);
+
+} // namespace lime
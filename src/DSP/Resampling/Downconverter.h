@@ -0,0 +1,65 @@
+#ifndef LIME_DOWNCONVERTER_H
+#define LIME_DOWNCONVERTER_H
+
+#include "NCO.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace lime {
+
+/// @brief Digital downconverter: shifts the signal in frequency with an NCO, then low pass filters and decimates it.
+///
+/// The samples are converted from the link format while being mixed, so no full rate intermediate buffer is needed.
+/// Output samples are produced at the inputs whose timestamp is a multiple of the decimation, so the output timestamp
+/// is the input timestamp divided by the decimation. The filter delays the signal by GetDelay() input samples.
+class Downconverter
+{
+  public:
+    /// @brief The default amount of filter coefficients per output sample.
+    static constexpr std::size_t defaultTapsPerPhase = 24;
+
+    Downconverter(uint16_t decimation, double frequency, std::size_t tapsPerPhase = defaultTapsPerPhase);
+
+    template<class SrcT, class DestT>
+    uint32_t Process(const SrcT* src, uint8_t stride, uint32_t count, uint64_t timestamp, DestT* dest);
+
+    void Reset();
+
+    /// @brief Gets the decimation ratio.
+    /// @return The amount of input samples per output sample.
+    uint16_t GetDecimation() const { return mDecimation; }
+
+    /// @brief Gets the low pass filter coefficients.
+    /// @return The filter applied at the input sampling rate.
+    const std::vector<float>& GetTaps() const { return mTaps; }
+
+    /// @brief Gets the group delay of the filter.
+    /// @return The delay, in input samples.
+    double GetDelay() const { return mDecimation > 1 ? (mTaps.size() - 1) / 2.0 : 0; }
+
+    /// @brief Gets the timestamp of the first output sample produced from the given input samples.
+    /// @param inputTimestamp The timestamp of the first input sample.
+    /// @return The output timestamp.
+    uint64_t GetOutputTimestamp(uint64_t inputTimestamp) const { return (inputTimestamp + mDecimation - 1) / mDecimation; }
+
+  private:
+    void Restart(uint64_t timestamp);
+
+    uint16_t mDecimation;
+    std::vector<float> mTaps;
+    std::vector<float> mKernel;
+    NCO mNCO;
+
+    // inputs are stored twice, so the latest mTaps.size() samples are always contiguous
+    std::vector<float> mHistoryI;
+    std::vector<float> mHistoryQ;
+    std::size_t mHistoryPos;
+    uint16_t mPhase;
+    uint64_t mExpectedTimestamp;
+    bool mStarted;
+};
+
+} // namespace lime
+
+#endif // LIME_DOWNCONVERTER_H
@@ -0,0 +1,33 @@
+#define _USE_MATH_DEFINES
+#include "FIRDesign.h"
+
+#include <cmath>
+
+namespace lime {
+
+/// @brief Designs a linear phase lowpass filter as a Blackman-Harris windowed sinc.
+/// The sidelobes of the window are below -90 dB, the transition band is about 4 / length wide on each side of the cutoff.
+/// @param length The amount of coefficients.
+/// @param cutoff The -6 dB frequency, relative to the sampling rate (0; 0.5).
+/// @return The coefficients, normalized for unity gain at DC.
+std::vector<float> DesignLowpassFIR(std::size_t length, double cutoff)
+{
+    std::vector<float> taps(length);
+    const double center = (length - 1) / 2.0;
+    double sum = 0;
+    std::vector<double> coefficients(length);
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        const double t = i - center;
+        const double sinc = t == 0 ? 2 * cutoff : std::sin(2 * M_PI * cutoff * t) / (M_PI * t);
+        const double x = 2 * M_PI * i / (length - 1);
+        const double window = 0.35875 - 0.48829 * std::cos(x) + 0.14128 * std::cos(2 * x) - 0.01168 * std::cos(3 * x);
+        coefficients[i] = sinc * window;
+        sum += coefficients[i];
+    }
+    for (std::size_t i = 0; i < length; ++i)
+        taps[i] = coefficients[i] / sum;
+    return taps;
+}
+
+} // namespace lime
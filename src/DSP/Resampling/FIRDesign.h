@@ -0,0 +1,13 @@
+#ifndef LIME_FIRDESIGN_H
+#define LIME_FIRDESIGN_H
+
+#include <cstddef>
+#include <vector>
+
+namespace lime {
+
+std::vector<float> DesignLowpassFIR(std::size_t length, double cutoff);
+
+} // namespace lime
+
+#endif // LIME_FIRDESIGN_H
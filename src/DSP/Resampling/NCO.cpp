@@ -0,0 +1,57 @@
+#define _USE_MATH_DEFINES
+#include "NCO.h"
+
+#include <cassert>
+#include <cmath>
+
+namespace lime {
+
+/// @brief Constructs the oscillator, starting at zero phase.
+/// @param frequency The frequency, relative to the sampling rate (cycles per sample, negative rotates clockwise).
+NCO::NCO(double frequency)
+    : mFrequency(frequency)
+    , mPhasor(1, 0)
+    , mBlockStep(std::polar(1.0, 2 * M_PI * frequency * blockSize))
+{
+    for (std::size_t i = 0; i < blockSize; ++i)
+    {
+        const std::complex<double> rotation = std::polar(1.0, 2 * M_PI * frequency * i);
+        mRotationI[i] = rotation.real();
+        mRotationQ[i] = rotation.imag();
+    }
+}
+
+/// @brief Sets the phase to the one the oscillator has at the given sample since zero phase,
+/// so the output stays coherent with the sample counter across discontinuities.
+/// @param sampleIndex The index of the next generated sample.
+void NCO::SetPhase(uint64_t sampleIndex)
+{
+    // only the fractional cycles matter
+    const double cycles = std::fmod(mFrequency * static_cast<double>(sampleIndex), 1.0);
+    mPhasor = std::polar(1.0, 2 * M_PI * cycles);
+}
+
+/// @brief Generates the following samples of the oscillator.
+/// @param re The destination of the real parts.
+/// @param im The destination of the imaginary parts.
+/// @param count The amount of samples to generate, at most blockSize.
+void NCO::Generate(float* re, float* im, std::size_t count)
+{
+    assert(count <= blockSize);
+    const float phasorI = mPhasor.real();
+    const float phasorQ = mPhasor.imag();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        re[i] = phasorI * mRotationI[i] - phasorQ * mRotationQ[i];
+        im[i] = phasorI * mRotationQ[i] + phasorQ * mRotationI[i];
+    }
+
+    if (count == blockSize)
+        mPhasor *= mBlockStep;
+    else
+        mPhasor *= std::polar(1.0, 2 * M_PI * mFrequency * count);
+    // keep the magnitude from drifting away from 1
+    mPhasor /= std::abs(mPhasor);
+}
+
+} // namespace lime
@@ -0,0 +1,38 @@
+#ifndef LIME_NCO_H
+#define LIME_NCO_H
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+
+namespace lime {
+
+/// @brief Numerically controlled oscillator, generating the complex exponential in blocks.
+/// Each block is the block's starting phasor (kept in double precision) multiplied by a precomputed rotation table,
+/// so the phase does not drift over long runs and the inner loop vectorizes.
+class NCO
+{
+  public:
+    /// @brief The maximum amount of samples generated by a single Generate() call.
+    static constexpr std::size_t blockSize = 64;
+
+    explicit NCO(double frequency);
+
+    void SetPhase(uint64_t sampleIndex);
+    void Generate(float* re, float* im, std::size_t count);
+
+    /// @brief Gets the frequency of the oscillator.
+    /// @return The frequency, relative to the sampling rate.
+    double GetFrequency() const { return mFrequency; }
+
+  private:
+    double mFrequency;
+    std::complex<double> mPhasor;
+    std::complex<double> mBlockStep;
+    float mRotationI[blockSize];
+    float mRotationQ[blockSize];
+};
+
+} // namespace lime
+
+#endif // LIME_NCO_H
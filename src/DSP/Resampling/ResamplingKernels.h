@@ -0,0 +1,60 @@
+#ifndef LIME_RESAMPLINGKERNELS_H
+#define LIME_RESAMPLINGKERNELS_H
+
+#include "limesuiteng/complex.h"
+#include "samplesConversion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+
+namespace lime {
+
+/// @brief The amount of independent partial sums in DotProduct(), filter lengths are kept multiples of it.
+constexpr std::size_t dotProductLanes = 8;
+
+/// @brief Calculates the dot product of two arrays.
+/// Accumulates into independent partial sums, so the compiler can vectorize the loop without reassociating floats.
+/// @param a The first array.
+/// @param b The second array.
+/// @param count The length of the arrays, must be a multiple of dotProductLanes.
+/// @return The dot product.
+inline float DotProduct(const float* a, const float* b, std::size_t count)
+{
+    float partial[dotProductLanes]{};
+    for (std::size_t i = 0; i < count; i += dotProductLanes)
+        for (std::size_t j = 0; j < dotProductLanes; ++j)
+            partial[j] += a[i + j] * b[i + j];
+
+    float sum = 0;
+    for (std::size_t j = 0; j < dotProductLanes; ++j)
+        sum += partial[j];
+    return sum;
+}
+
+/// @brief Stores the normalized sample in the given format, saturating the integer formats.
+/// @tparam DestT The type of the destination sample.
+/// @param dest The destination sample.
+/// @param i The I value, full scale is 1.
+/// @param q The Q value, full scale is 1.
+template<class DestT> inline void StoreSample(DestT& dest, float i, float q)
+{
+    if constexpr (IsFloatingPointSample<DestT>())
+    {
+        dest.real(i);
+        dest.imag(q);
+    }
+    else
+    {
+        // filter ripple can overshoot full scale slightly
+        constexpr float scale = GetScalingRatio<DestT, complex32f_t>();
+        constexpr float limit = std::is_same_v<DestT, complex16_t> ? 32767 : (std::is_same_v<DestT, complex8_t> ? 127 : 2047);
+        dest.real(std::lround(std::clamp(i * scale, -limit - 1, limit)));
+        dest.imag(std::lround(std::clamp(q * scale, -limit - 1, limit)));
+    }
+}
+
+} // namespace lime
+
+#endif // LIME_RESAMPLINGKERNELS_H
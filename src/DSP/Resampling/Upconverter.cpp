@@ -0,0 +1,146 @@
+#include "Upconverter.h"
+
+#include "FIRDesign.h"
+#include "ResamplingKernels.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace lime {
+
+/// @brief Constructs the upconverter.
+/// @param interpolation The amount of output samples per input sample.
+/// @param frequency The frequency DC is moved to, relative to the output sampling rate.
+/// @param tapsPerPhase The amount of filter coefficients per input sample, more gives a sharper filter.
+Upconverter::Upconverter(uint16_t interpolation, double frequency, std::size_t tapsPerPhase)
+    : mInterpolation(std::max<uint16_t>(interpolation, 1))
+    , mNCO(frequency)
+    , mHistoryPos(0)
+    , mExpectedTimestamp(0)
+    , mStarted(false)
+{
+    mTapsPerPhase = mInterpolation > 1 ? tapsPerPhase : 1;
+    mTapsPerPhase = (mTapsPerPhase + dotProductLanes - 1) / dotProductLanes * dotProductLanes;
+    const std::size_t length = mTapsPerPhase * mInterpolation;
+    if (mInterpolation > 1)
+    {
+        mTaps = DesignLowpassFIR(length, 0.4 / mInterpolation);
+        // zero stuffing divides the signal power between the images, restore the passband gain
+        for (float& tap : mTaps)
+            tap *= mInterpolation;
+    }
+    else
+    {
+        // without interpolation there are no images to filter out, pass the samples through
+        mTaps.assign(length, 0);
+        mTaps.front() = 1;
+    }
+
+    // output phase p of input n is the sum of mTaps[j * interpolation + p] * x[n - j],
+    // the history is ordered from the oldest sample, so the coefficients are applied reversed
+    mPhaseKernels.resize(length);
+    for (std::size_t phase = 0; phase < mInterpolation; ++phase)
+        for (std::size_t j = 0; j < mTapsPerPhase; ++j)
+            mPhaseKernels[phase * mTapsPerPhase + mTapsPerPhase - 1 - j] = mTaps[j * mInterpolation + phase];
+
+    mHistoryI.resize(mTapsPerPhase * 2);
+    mHistoryQ.resize(mTapsPerPhase * 2);
+}
+
+/// @brief Clears the filter state, the next processed samples are treated as a new stream.
+void Upconverter::Reset()
+{
+    mStarted = false;
+}
+
+void Upconverter::Restart(uint64_t timestamp)
+{
+    std::fill(mHistoryI.begin(), mHistoryI.end(), 0);
+    std::fill(mHistoryQ.begin(), mHistoryQ.end(), 0);
+    mHistoryPos = 0;
+    mNCO.SetPhase(GetOutputTimestamp(timestamp));
+    mStarted = true;
+}
+
+/// @brief Upconverts the samples of a single channel.
+/// A timestamp discontinuity restarts the filter, so each burst starts from silence.
+/// Untimed samples always continue the previous ones, their timestamps carry no meaning.
+/// @tparam SrcT The type of the input samples.
+/// @tparam DestT The type of the output samples (link format).
+/// @param src The input samples.
+/// @param count The amount of input samples.
+/// @param timestamp The timestamp of the first input sample.
+/// @param useTimestamp Whether the timestamp is valid and a discontinuity should restart the filter.
+/// @param dest The destination for the output samples, must fit count * interpolation samples.
+/// @param stride The distance between the consecutive samples of this channel in the output (the amount of interleaved channels).
+/// @return The amount of output samples produced.
+template<class SrcT, class DestT>
+uint32_t Upconverter::Process(
+    const SrcT* src, uint32_t count, uint64_t timestamp, bool useTimestamp, DestT* dest, uint8_t stride)
+{
+    if (!mStarted || (useTimestamp && timestamp != mExpectedTimestamp))
+    {
+        Restart(timestamp);
+        mExpectedTimestamp = timestamp;
+    }
+    mExpectedTimestamp += count;
+
+    constexpr float inputScale = GetScalingRatio<complex32f_t, SrcT>();
+    const uint32_t total = count * mInterpolation;
+    float filteredI[NCO::blockSize];
+    float filteredQ[NCO::blockSize];
+    float ncoI[NCO::blockSize];
+    float ncoQ[NCO::blockSize];
+
+    uint32_t consumed = 0;
+    uint16_t phase = 0;
+    for (uint32_t blockStart = 0; blockStart < total; blockStart += NCO::blockSize)
+    {
+        const std::size_t blockLength = std::min<std::size_t>(NCO::blockSize, total - blockStart);
+        for (std::size_t i = 0; i < blockLength; ++i)
+        {
+            if (phase == 0)
+            {
+                const float inI = src[consumed].real() * inputScale;
+                const float inQ = src[consumed].imag() * inputScale;
+                ++consumed;
+                mHistoryI[mHistoryPos] = mHistoryI[mHistoryPos + mTapsPerPhase] = inI;
+                mHistoryQ[mHistoryPos] = mHistoryQ[mHistoryPos + mTapsPerPhase] = inQ;
+                if (++mHistoryPos == mTapsPerPhase)
+                    mHistoryPos = 0;
+            }
+
+            // mHistoryPos now points to the oldest sample
+            const float* kernel = &mPhaseKernels[phase * mTapsPerPhase];
+            filteredI[i] = DotProduct(kernel, &mHistoryI[mHistoryPos], mTapsPerPhase);
+            filteredQ[i] = DotProduct(kernel, &mHistoryQ[mHistoryPos], mTapsPerPhase);
+            if (++phase == mInterpolation)
+                phase = 0;
+        }
+
+        mNCO.Generate(ncoI, ncoQ, blockLength);
+        DestT* output = dest + blockStart * stride;
+        for (std::size_t i = 0; i < blockLength; ++i)
+        {
+            const float outI = filteredI[i] * ncoI[i] - filteredQ[i] * ncoQ[i];
+            const float outQ = filteredI[i] * ncoQ[i] + filteredQ[i] * ncoI[i];
+            StoreSample(output[i * stride], outI, outQ);
+        }
+    }
+    assert(consumed == count);
+    return total;
+}
+
+template uint32_t Upconverter::Process(const complex32f_t*, uint32_t, uint64_t, bool, complex16_t*, uint8_t);
+template uint32_t Upconverter::Process(const complex16_t*, uint32_t, uint64_t, bool, complex16_t*, uint8_t);
+template uint32_t Upconverter::Process(const complex12_t*, uint32_t, uint64_t, bool, complex16_t*, uint8_t);
+template uint32_t Upconverter::Process(const complex8_t*, uint32_t, uint64_t, bool, complex16_t*, uint8_t);
+template uint32_t Upconverter::Process(const complex16f_t*, uint32_t, uint64_t, bool, complex16_t*, uint8_t);
+template uint32_t Upconverter::Process(const complex32f_t*, uint32_t, uint64_t, bool, complex12packed_t*, uint8_t);
+template uint32_t Upconverter::Process(const complex16_t*, uint32_t, uint64_t, bool, complex12packed_t*, uint8_t);
+template uint32_t Upconverter::Process(const complex12_t*, uint32_t, uint64_t, bool, complex12packed_t*, uint8_t);
+template uint32_t Upconverter::Process(const complex8_t*, uint32_t, uint64_t, bool, complex12packed_t*, uint8_t);
+template uint32_t Upconverter::Process(const complex16f_t*, uint32_t, uint64_t, bool, complex12packed_t*, uint8_t);
+
+} // namespace lime
@@ -0,0 +1,66 @@
+#ifndef LIME_UPCONVERTER_H
+#define LIME_UPCONVERTER_H
+
+#include "NCO.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace lime {
+
+/// @brief Digital upconverter: interpolates the signal with a polyphase low pass filter, then shifts it in frequency with an NCO.
+///
+/// The samples are converted to the link format while being mixed, so no full rate intermediate buffer is needed.
+/// Every input sample produces interpolation output samples, so the output timestamp is the input timestamp multiplied
+/// by the interpolation. The filter delays the signal by GetDelay() output samples.
+class Upconverter
+{
+  public:
+    /// @brief The default amount of filter coefficients per input sample.
+    static constexpr std::size_t defaultTapsPerPhase = 24;
+
+    Upconverter(uint16_t interpolation, double frequency, std::size_t tapsPerPhase = defaultTapsPerPhase);
+
+    template<class SrcT, class DestT>
+    uint32_t Process(const SrcT* src, uint32_t count, uint64_t timestamp, bool useTimestamp, DestT* dest, uint8_t stride);
+
+    void Reset();
+
+    /// @brief Gets the interpolation ratio.
+    /// @return The amount of output samples per input sample.
+    uint16_t GetInterpolation() const { return mInterpolation; }
+
+    /// @brief Gets the low pass filter coefficients, including the interpolation gain.
+    /// @return The filter applied at the output sampling rate.
+    const std::vector<float>& GetTaps() const { return mTaps; }
+
+    /// @brief Gets the group delay of the filter.
+    /// @return The delay, in output samples.
+    double GetDelay() const { return mInterpolation > 1 ? (mTaps.size() - 1) / 2.0 : 0; }
+
+    /// @brief Gets the timestamp of the first output sample produced from the given input sample.
+    /// @param inputTimestamp The timestamp of the input sample.
+    /// @return The output timestamp.
+    uint64_t GetOutputTimestamp(uint64_t inputTimestamp) const { return inputTimestamp * mInterpolation; }
+
+  private:
+    void Restart(uint64_t timestamp);
+
+    uint16_t mInterpolation;
+    std::size_t mTapsPerPhase;
+    std::vector<float> mTaps;
+    // coefficients of each phase, reversed, mTapsPerPhase values per phase
+    std::vector<float> mPhaseKernels;
+    NCO mNCO;
+
+    // inputs are stored twice, so the latest mTapsPerPhase samples are always contiguous
+    std::vector<float> mHistoryI;
+    std::vector<float> mHistoryQ;
+    std::size_t mHistoryPos;
+    uint64_t mExpectedTimestamp;
+    bool mStarted;
+};
+
+} // namespace lime
+
+#endif // LIME_UPCONVERTER_H
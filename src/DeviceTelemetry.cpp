@@ -0,0 +1,81 @@
+#include "limesuiteng/DeviceTelemetry.h"
+
+#include "limesuiteng/SDRDevice.h"
+
+#include <cmath>
+
+namespace lime {
+
+TelemetrySampler::TelemetrySampler(
+    SDRDevice* device, std::chrono::milliseconds period, std::chrono::milliseconds temperaturePeriod, TelemetryCallback callback)
+    : mDevice(device)
+    , mPeriod(period)
+    , mTemperaturePeriod(temperaturePeriod)
+    , mCallback(callback)
+    , mStop(false)
+    , mHasSample(false)
+{
+    mThread = std::thread(&TelemetrySampler::SamplingLoop, this);
+}
+
+TelemetrySampler::~TelemetrySampler()
+{
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        mStop = true;
+    }
+    mStopRequested.notify_all();
+    if (mThread.joinable())
+        mThread.join();
+}
+
+bool TelemetrySampler::GetLatest(DeviceTelemetry& telemetry) const
+{
+    std::lock_guard<std::mutex> lock(mLock);
+    if (mHasSample)
+        telemetry = mLatest;
+    return mHasSample;
+}
+
+void TelemetrySampler::SamplingLoop()
+{
+    auto nextSample = std::chrono::steady_clock::now();
+    auto nextTemperature = nextSample;
+    std::vector<double> lastTemperatures;
+    while (true)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        const bool measureTemperature = now >= nextTemperature;
+        if (measureTemperature)
+            nextTemperature = now + mTemperaturePeriod;
+
+        DeviceTelemetry telemetry;
+        mDevice->GetTelemetry(telemetry, measureTemperature);
+
+        // the samples without the measurement keep the last measured temperature
+        lastTemperatures.resize(telemetry.modules.size(), NAN);
+        for (std::size_t i = 0; i < telemetry.modules.size(); ++i)
+        {
+            if (measureTemperature)
+                lastTemperatures[i] = telemetry.modules[i].temperature;
+            else
+                telemetry.modules[i].temperature = lastTemperatures[i];
+        }
+
+        if (mCallback)
+            mCallback(telemetry);
+
+        std::unique_lock<std::mutex> lock(mLock);
+        mLatest = std::move(telemetry);
+        mHasSample = true;
+
+        // a sample that took longer than the period is followed right away, without catching up the missed ones
+        nextSample += mPeriod;
+        if (nextSample < std::chrono::steady_clock::now())
+            nextSample = std::chrono::steady_clock::now();
+        if (mStopRequested.wait_until(lock, nextSample, [this]() { return mStop; }))
+            return;
+    }
+}
+
+} // namespace lime
@@ -1254,15 +1254,25 @@ uint32_t FPGA::SetUpVariableRxSize(uint32_t packetSize, int payloadSize, int sam
 
 OpStatus FPGA::OEMTestSetup(TestID testId, double timeout)
 {
-    uint16_t completed;
+    uint16_t completed = 0;
+    return OEMTestSetup(static_cast<uint16_t>(testId), timeout, completed);
+}
+
+/// @brief Starts the given tests at once and waits for all of them to complete.
+/// @param testMask The combination of the TestID values of the tests to run.
+/// @param timeout The maximum time to wait for the tests (in seconds), negative - don't wait.
+/// @param[out] completed The TestID values of the tests that completed.
+/// @return The status of the operation, Error if any of the tests did not complete in time.
+OpStatus FPGA::OEMTestSetup(uint16_t testMask, double timeout, uint16_t& completed)
+{
+    completed = 0;
     uint32_t addr[] = { 0x61, 0x63 };
     uint32_t vals[] = { 0x0, 0x0 };
-    uint16_t test = static_cast<uint16_t>(testId);
     if (WriteRegisters(addr, vals, 2) != OpStatus::Success)
         return OpStatus::IOFailure;
 
     auto start = std::chrono::steady_clock::now();
-    if (WriteRegister(0x61, test) != OpStatus::Success)
+    if (WriteRegister(0x61, testMask) != OpStatus::Success)
         return OpStatus::IOFailure;
 
     if (timeout < 0)
@@ -1270,8 +1280,8 @@ OpStatus FPGA::OEMTestSetup(TestID testId, double timeout)
 
     while (1)
     {
-        completed = ReadRegister(0x65);
-        if ((completed & test) == test)
+        completed = ReadRegister(0x65) & testMask;
+        if (completed == testMask)
             return OpStatus::Success;
 
         auto end = std::chrono::steady_clock::now();
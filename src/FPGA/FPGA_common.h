@@ -93,6 +93,7 @@ class FPGA
         GNSS = 1 << 4,
     };
     virtual OpStatus OEMTestSetup(TestID test, double timeout);
+    OpStatus OEMTestSetup(uint16_t testMask, double timeout, uint16_t& completed);
 
     OpStatus ConfigureSamplesStream(uint32_t channelsEnableMask, lime::DataFormat samplesFormat, bool ddr, bool trxiqpulse);
     OpStatus ResetPacketCounters(uint16_t chipId);
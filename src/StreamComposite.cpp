@@ -154,9 +154,17 @@ template LIME_API uint32_t StreamComposite::StreamRx<lime::complex16_t>(
     lime::complex16_t* const* samples, uint32_t count, StreamMeta* meta);
 template LIME_API uint32_t StreamComposite::StreamRx<lime::complex32f_t>(
     lime::complex32f_t* const* samples, uint32_t count, StreamMeta* meta);
+template LIME_API uint32_t StreamComposite::StreamRx<lime::complex8_t>(
+    lime::complex8_t* const* samples, uint32_t count, StreamMeta* meta);
+template LIME_API uint32_t StreamComposite::StreamRx<lime::complex16f_t>(
+    lime::complex16f_t* const* samples, uint32_t count, StreamMeta* meta);
 template LIME_API uint32_t StreamComposite::StreamTx<lime::complex16_t>(
     const lime::complex16_t* const* samples, uint32_t count, const StreamMeta* meta);
 template LIME_API uint32_t StreamComposite::StreamTx<lime::complex32f_t>(
     const lime::complex32f_t* const* samples, uint32_t count, const StreamMeta* meta);
+template LIME_API uint32_t StreamComposite::StreamTx<lime::complex8_t>(
+    const lime::complex8_t* const* samples, uint32_t count, const StreamMeta* meta);
+template LIME_API uint32_t StreamComposite::StreamTx<lime::complex16f_t>(
+    const lime::complex16f_t* const* samples, uint32_t count, const StreamMeta* meta);
 
 } // namespace lime
@@ -4,12 +4,14 @@
 #cmakedefine ENABLE_LIMESDR_XTRX
 #cmakedefine ENABLE_LIMESDR_MMX8
 #cmakedefine ENABLE_USB_FTDI
+#cmakedefine ENABLE_SIMULATED_DEVICE
 
 #cmakedefine ENABLE_LIMEPCIE
 
 void __loadFX3();
 void __loadFTDI();
 void __loadDeviceFactoryPCIe();
+void __loadDeviceFactorySimulated();
 
 void __loadBoardSupport()
 {
@@ -24,4 +26,8 @@ void __loadBoardSupport()
 #ifdef ENABLE_LIMEPCIE
     __loadDeviceFactoryPCIe();
 #endif
+
+#ifdef ENABLE_SIMULATED_DEVICE
+    __loadDeviceFactorySimulated();
+#endif
 }
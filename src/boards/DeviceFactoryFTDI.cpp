@@ -95,3 +95,20 @@ SDRDevice* DeviceFactoryFTDI::make(const DeviceHandle& handle)
 
     return nullptr;
 }
+
+bool DeviceFactoryFTDI::startWatching(std::function<void()> onChange)
+{
+#ifdef __unix__
+    mHotplugWatch = std::make_unique<UnixUsbHotplugWatch>(ids, onChange);
+    return mHotplugWatch->IsWatching();
+#else
+    return false;
+#endif
+}
+
+void DeviceFactoryFTDI::stopWatching()
+{
+#ifdef __unix__
+    mHotplugWatch.reset();
+#endif
+}
@@ -1,9 +1,14 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 
 #include "limesuiteng/DeviceRegistry.h"
 
+#ifdef __unix__
+    #include "comms/USB/UnixUsb.h"
+#endif
+
 namespace lime {
 
 class DeviceHandle;
@@ -15,9 +20,15 @@ class DeviceFactoryFTDI : public DeviceRegistryEntry
     DeviceFactoryFTDI();
     std::vector<DeviceHandle> enumerate(const DeviceHandle& hint) override;
     SDRDevice* make(const DeviceHandle& handle) override;
+    bool startWatching(std::function<void()> onChange) override;
+    void stopWatching() override;
 
   private:
     SDRDevice* make_LimeSDR_Mini(const DeviceHandle& handle, uint16_t vid, uint16_t pid);
+
+#ifdef __unix__
+    std::unique_ptr<UnixUsbHotplugWatch> mHotplugWatch;
+#endif
 };
 
 } // namespace lime
@@ -91,3 +91,20 @@ SDRDevice* DeviceFactoryFX3::make(const DeviceHandle& handle)
 
     return nullptr;
 }
+
+bool DeviceFactoryFX3::startWatching(std::function<void()> onChange)
+{
+#ifdef __unix__
+    mHotplugWatch = std::make_unique<UnixUsbHotplugWatch>(ids, onChange);
+    return mHotplugWatch->IsWatching();
+#else
+    return false;
+#endif
+}
+
+void DeviceFactoryFX3::stopWatching()
+{
+#ifdef __unix__
+    mHotplugWatch.reset();
+#endif
+}
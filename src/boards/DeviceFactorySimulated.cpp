@@ -0,0 +1,35 @@
+#include "DeviceFactorySimulated.h"
+
+#include "limesuiteng/DeviceHandle.h"
+#include "boards/Simulated/SimulatedSDR.h"
+
+using namespace lime;
+using namespace std::literals::string_literals;
+
+void __loadDeviceFactorySimulated(void) // TODO: fixme replace with LoadLibrary/dlopen
+{
+    static DeviceFactorySimulated simulatedSupport; // Self register on initialization
+}
+
+DeviceFactorySimulated::DeviceFactorySimulated()
+    : DeviceRegistryEntry("Simulated"s)
+{
+}
+
+std::vector<DeviceHandle> DeviceFactorySimulated::enumerate(const DeviceHandle& hint)
+{
+    std::vector<DeviceHandle> handles;
+    DeviceHandle handle;
+    handle.media = "Simulated"s;
+    handle.name = "Simulated"s;
+    handle.serial = "0"s;
+
+    if (handle.IsEqualIgnoringEmpty(hint))
+        handles.push_back(handle);
+    return handles;
+}
+
+SDRDevice* DeviceFactorySimulated::make(const DeviceHandle& handle)
+{
+    return new SimulatedSDR();
+}
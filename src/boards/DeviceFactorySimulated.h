@@ -0,0 +1,18 @@
+#pragma once
+
+#include "limesuiteng/DeviceRegistry.h"
+
+namespace lime {
+
+class DeviceHandle;
+
+/** @brief A class for the software simulated device registry entry. */
+class DeviceFactorySimulated : public DeviceRegistryEntry
+{
+  public:
+    DeviceFactorySimulated();
+    std::vector<DeviceHandle> enumerate(const DeviceHandle& hint) override;
+    SDRDevice* make(const DeviceHandle& handle) override;
+};
+
+} // namespace lime
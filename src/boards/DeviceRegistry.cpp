@@ -6,15 +6,209 @@
 #include <map>
 #include <memory>
 #include <iostream>
+#include <condition_variable>
+#include <cstdlib>
+#include <filesystem>
+#include <future>
+#include <set>
+#include <thread>
 
 using namespace lime;
 using namespace std::literals::string_literals;
 
 static std::mutex gRegistryMutex;
 static std::map<std::string, DeviceRegistryEntry*> registryEntries;
+// The registry entries that enumerated each of the handles (by their serialized form).
+static std::map<std::string, std::string> handleOwners;
+
+// The enumeration cache, guarded by gCacheMutex.
+static std::mutex gCacheMutex;
+static std::condition_variable gCacheStop;
+static bool cacheEnabled = false;
+static std::vector<DeviceHandle> cachedHandles;
+// The monitoring thread of the cache, guarded by gCacheControlMutex, which also serializes the enableCache() calls.
+static std::mutex gCacheControlMutex;
+static std::thread cacheMonitor;
+static std::map<int, DeviceRegistry::HotplugCallback> hotplugCallbacks;
+static int nextHotplugCallbackId = 0;
+// Changed by every stop, so that a monitor thread left running on its own knows to exit.
+static uint64_t cacheGeneration = 0;
+// Set by the registry entries that watch their devices.
+static bool devicesChanged = false;
 
 void __loadBoardSupport();
 
+// Probes all of the entries concurrently, gRegistryMutex has to be locked.
+static std::vector<DeviceHandle> ProbeAll(const DeviceHandle& hint)
+{
+    std::vector<std::pair<std::string, std::future<std::vector<DeviceHandle>>>> probes;
+    for (const auto& entry : registryEntries)
+    {
+        DeviceRegistryEntry* registryEntry = entry.second;
+        probes.emplace_back(entry.first, std::async(std::launch::async, [registryEntry, &hint]() {
+            return registryEntry->enumerate(hint);
+        }));
+    }
+
+    // collected in the registry order, same as probing one after another
+    std::vector<DeviceHandle> results;
+    std::set<std::string> found;
+    for (auto& probe : probes)
+    {
+        for (auto& handle : probe.second.get())
+        {
+            const std::string serialized = handle.Serialize();
+            handleOwners[serialized] = probe.first;
+            found.insert(serialized);
+            results.push_back(handle);
+        }
+    }
+
+    // forget the handles matching the hint that are gone, so that the owners don't pile up as devices come and go
+    for (auto owner = handleOwners.begin(); owner != handleOwners.end();)
+    {
+        if (found.count(owner->first) == 0 && DeviceHandle(owner->first).IsEqualIgnoringEmpty(hint))
+            owner = handleOwners.erase(owner);
+        else
+            ++owner;
+    }
+    return results;
+}
+
+// Called by the watching registry entries, from their own threads.
+static void DevicesChanged()
+{
+    {
+        std::lock_guard<std::mutex> lock(gCacheMutex);
+        devicesChanged = true;
+    }
+    gCacheStop.notify_all();
+}
+
+// A cheap summary of the system's USB and PCIe devices, changes when devices are added or removed.
+static std::string SystemDevicesFingerprint()
+{
+    std::set<std::string> names;
+    for (const char* directory : { "/sys/bus/usb/devices", "/sys/class/limepcie" })
+    {
+        std::error_code error;
+        for (const auto& node : std::filesystem::directory_iterator(directory, error))
+            names.insert(node.path().string());
+    }
+
+    std::string fingerprint;
+    for (const auto& name : names)
+        fingerprint += name + '\n';
+    return fingerprint;
+}
+
+static void NotifyChanges(const std::vector<DeviceHandle>& before, const std::vector<DeviceHandle>& after)
+{
+    std::map<int, DeviceRegistry::HotplugCallback> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(gCacheMutex);
+        callbacks = hotplugCallbacks;
+    }
+    if (callbacks.empty())
+        return;
+
+    auto Contains = [](const std::vector<DeviceHandle>& handles, const DeviceHandle& handle) {
+        for (const auto& h : handles)
+        {
+            if (h == handle)
+                return true;
+        }
+        return false;
+    };
+
+    for (const auto& handle : before)
+    {
+        if (!Contains(after, handle))
+            for (const auto& callback : callbacks)
+                callback.second(handle, false);
+    }
+    for (const auto& handle : after)
+    {
+        if (!Contains(before, handle))
+            for (const auto& callback : callbacks)
+                callback.second(handle, true);
+    }
+}
+
+static void CacheMonitorLoop(std::chrono::milliseconds pollPeriod, uint64_t generation)
+{
+    std::string fingerprint = SystemDevicesFingerprint();
+    // without the sysfs (other than Linux systems) the changes can only be found by rescanning
+    const bool hasSysfs = !fingerprint.empty();
+    bool rescanAgain = false;
+
+    std::unique_lock<std::mutex> lock(gCacheMutex);
+    auto IsRunning = [generation]() { return cacheEnabled && cacheGeneration == generation; };
+    while (IsRunning())
+    {
+        gCacheStop.wait_for(lock, pollPeriod, [&IsRunning]() { return !IsRunning() || devicesChanged; });
+        if (!IsRunning())
+            break;
+        const bool notified = devicesChanged;
+        devicesChanged = false;
+        lock.unlock();
+
+        const std::string current = SystemDevicesFingerprint();
+        if (notified || rescanAgain || !hasSysfs || current != fingerprint)
+        {
+            fingerprint = current;
+            // a just connected device might not be accessible yet, until udev has applied its permissions
+            rescanAgain = notified;
+            DeviceRegistry::rescan();
+        }
+        lock.lock();
+    }
+}
+
+// Disables the cache and waits for its monitor thread to exit.
+// The control lock is released while waiting, as the hotplug callbacks running on the monitor thread can call enableCache().
+static void StopCacheMonitor(std::unique_lock<std::mutex>& controlLock)
+{
+    for (;;)
+    {
+        {
+            std::lock_guard<std::mutex> lock(gCacheMutex);
+            cacheEnabled = false;
+            ++cacheGeneration;
+            devicesChanged = false;
+            cachedHandles.clear();
+        }
+        gCacheStop.notify_all();
+        {
+            std::lock_guard<std::mutex> lock(gRegistryMutex);
+            for (const auto& entry : registryEntries)
+                entry.second->stopWatching();
+        }
+
+        std::thread monitor;
+        monitor.swap(cacheMonitor);
+        if (!monitor.joinable())
+            return;
+        // a hotplug callback can disable the cache from the monitor thread, which then exits by itself after the callback
+        if (monitor.get_id() == std::this_thread::get_id())
+        {
+            monitor.detach();
+            return;
+        }
+
+        controlLock.unlock();
+        monitor.join();
+        controlLock.lock();
+        // the callbacks might have enabled the cache again in the meantime, stop that monitor as well
+    }
+}
+
+static void StopCacheMonitorAtExit()
+{
+    std::unique_lock<std::mutex> controlLock(gCacheControlMutex);
+    StopCacheMonitor(controlLock);
+}
+
 /*******************************************************************
  * Registry implementation
  ******************************************************************/
@@ -25,23 +219,117 @@ std::vector<DeviceHandle> DeviceRegistry::enumerate()
 
 std::vector<DeviceHandle> DeviceRegistry::enumerate(const DeviceHandle& hint)
 {
+    {
+        std::lock_guard<std::mutex> lock(gCacheMutex);
+        if (cacheEnabled)
+        {
+            std::vector<DeviceHandle> results;
+            for (const auto& handle : cachedHandles)
+            {
+                if (handle.IsEqualIgnoringEmpty(hint))
+                    results.push_back(handle);
+            }
+            return results;
+        }
+    }
+
     __loadBoardSupport();
     std::lock_guard<std::mutex> lock(gRegistryMutex);
+    return ProbeAll(hint);
+}
 
+std::vector<DeviceHandle> DeviceRegistry::rescan()
+{
+    __loadBoardSupport();
     std::vector<DeviceHandle> results;
-    for (const auto& entry : registryEntries)
     {
-        for (auto handle : entry.second->enumerate(hint))
-            results.push_back(handle);
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+        results = ProbeAll(DeviceHandle());
     }
+
+    std::vector<DeviceHandle> previous;
+    {
+        std::lock_guard<std::mutex> lock(gCacheMutex);
+        if (!cacheEnabled)
+            return results;
+        previous.swap(cachedHandles);
+        cachedHandles = results;
+    }
+    NotifyChanges(previous, results);
     return results;
 }
 
+void DeviceRegistry::enableCache(bool enable, uint32_t pollPeriod_ms)
+{
+    std::unique_lock<std::mutex> controlLock(gCacheControlMutex);
+    StopCacheMonitor(controlLock);
+    if (!enable)
+        return;
+
+    __loadBoardSupport();
+    // the monitor has to be stopped before the registry entries get destroyed at exit
+    static bool stopAtExit = std::atexit(StopCacheMonitorAtExit) == 0;
+    if (!stopAtExit)
+        lime::warning("DeviceRegistry: failed to register the enumeration cache cleanup"s);
+
+    std::vector<DeviceHandle> handles;
+    {
+        std::lock_guard<std::mutex> lock(gRegistryMutex);
+        handles = ProbeAll(DeviceHandle());
+        for (const auto& entry : registryEntries)
+        {
+            if (entry.second->startWatching(DevicesChanged))
+                lime::debug("DeviceRegistry: "s + entry.first + " reports the device changes"s);
+        }
+    }
+    uint64_t generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(gCacheMutex);
+        cachedHandles = handles;
+        cacheEnabled = true;
+        generation = cacheGeneration;
+    }
+    cacheMonitor = std::thread(CacheMonitorLoop, std::chrono::milliseconds(pollPeriod_ms), generation);
+}
+
+int DeviceRegistry::addHotplugCallback(HotplugCallback callback)
+{
+    std::lock_guard<std::mutex> lock(gCacheMutex);
+    hotplugCallbacks[nextHotplugCallbackId] = callback;
+    return nextHotplugCallbackId++;
+}
+
+void DeviceRegistry::removeHotplugCallback(int id)
+{
+    std::lock_guard<std::mutex> lock(gCacheMutex);
+    hotplugCallbacks.erase(id);
+}
+
 SDRDevice* DeviceRegistry::makeDevice(const DeviceHandle& handle)
 {
     __loadBoardSupport();
     std::lock_guard<std::mutex> lock(gRegistryMutex);
 
+    // a handle from the enumeration results already identifies its entry, no need to probe again
+    const auto owner = handleOwners.find(handle.Serialize());
+    if (owner != handleOwners.end())
+    {
+        const auto entry = registryEntries.find(owner->second);
+        if (entry != registryEntries.end())
+        {
+            try
+            {
+                SDRDevice* device = entry->second->make(handle);
+                if (device)
+                    return device;
+            } catch (const std::exception& e)
+            {
+                // the device might have been unplugged or reconnected since the enumeration, probe again
+                lime::debug("DeviceRegistry: failed to open the known handle: "s + e.what());
+            }
+        }
+    }
+
     //use the identifier as a hint to perform a discovery
     //only identifiers from the discovery function itself is used in the factory
     for (const auto& entry : registryEntries)
@@ -95,3 +383,12 @@ DeviceRegistryEntry::~DeviceRegistryEntry(void)
     registryEntries.erase(_name);
     lime::debug("DeviceRegistry Removed: "s + _name);
 }
+
+bool DeviceRegistryEntry::startWatching(std::function<void()> onChange)
+{
+    return false;
+}
+
+void DeviceRegistryEntry::stopWatching()
+{
+}
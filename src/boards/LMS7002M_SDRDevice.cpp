@@ -11,6 +11,7 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cmath>
 #include <complex>
 
@@ -368,6 +369,9 @@ OpStatus LMS7002M_SDRDevice::SetGain(uint8_t moduleIndex, TRXDir direction, uint
 {
     auto& device = mLMSChips.at(moduleIndex);
     LMS7002M::Channel enumChannel = channel > 0 ? LMS7002M::Channel::ChB : LMS7002M::Channel::ChA;
+    // the streaming gain control changes the gains from its own thread, the whole change has to be atomic
+    std::lock_guard<std::recursive_mutex> lock(device->GetControlLock());
+    LMS7002M::ChannelScope scope(device.get(), enumChannel, true);
 
     switch (gain)
     {
@@ -464,6 +468,8 @@ OpStatus LMS7002M_SDRDevice::GetGain(uint8_t moduleIndex, TRXDir direction, uint
 {
     auto& device = mLMSChips.at(moduleIndex);
     LMS7002M::Channel enumChannel = channel > 0 ? LMS7002M::Channel::ChB : LMS7002M::Channel::ChA;
+    std::lock_guard<std::recursive_mutex> lock(device->GetControlLock());
+    LMS7002M::ChannelScope scope(device.get(), enumChannel, true);
 
     switch (gain)
     {
@@ -605,6 +611,40 @@ bool LMS7002M_SDRDevice::GetSXLocked(uint8_t moduleIndex, TRXDir trx)
     return lms->GetSXLocked(trx);
 }
 
+OpStatus LMS7002M_SDRDevice::GetTelemetry(DeviceTelemetry& telemetry, bool measureTemperature)
+{
+    StartTelemetry(telemetry.modules, measureTemperature);
+    OpStatus status = FinishTelemetry(telemetry.modules);
+    telemetry.timestamp = std::chrono::system_clock::now();
+    return status;
+}
+
+void LMS7002M_SDRDevice::StartTelemetry(std::vector<DeviceTelemetry::Module>& modules, bool measureTemperature)
+{
+    modules.assign(mLMSChips.size(), DeviceTelemetry::Module{});
+    for (std::size_t i = 0; i < mLMSChips.size(); ++i)
+    {
+        modules[i].temperature = NAN;
+        if (measureTemperature)
+            modules[i].status = mLMSChips[i]->StartTemperatureMeasurement();
+    }
+}
+
+OpStatus LMS7002M_SDRDevice::FinishTelemetry(std::vector<DeviceTelemetry::Module>& modules)
+{
+    OpStatus status = OpStatus::Success;
+    for (std::size_t i = 0; i < mLMSChips.size() && i < modules.size(); ++i)
+    {
+        // the locks and RSSI are still read when the temperature measurement failed to start
+        const OpStatus readStatus = mLMSChips[i]->ReadTelemetry(modules[i]);
+        if (modules[i].status == OpStatus::Success)
+            modules[i].status = readStatus;
+        if (status == OpStatus::Success)
+            status = modules[i].status;
+    }
+    return status;
+}
+
 unsigned int LMS7002M_SDRDevice::ReadRegister(uint8_t moduleIndex, unsigned int address, bool useFPGA)
 {
     if (useFPGA)
@@ -855,6 +895,7 @@ OpStatus LMS7002M_SDRDevice::StreamSetup(const StreamConfig& config, uint8_t mod
     if (mStreamers.at(moduleIndex)->IsStreamRunning())
         return OpStatus::Busy;
 
+    mStreamers.at(moduleIndex)->SetGainControlDevice(this);
     return mStreamers.at(moduleIndex)->Setup(config);
 }
 
@@ -890,6 +931,41 @@ uint32_t LMS7002M_SDRDevice::StreamRx(uint8_t moduleIndex, complex12_t* const* d
     return mStreamers.at(moduleIndex)->StreamRx(dest, count, meta);
 }
 
+uint32_t LMS7002M_SDRDevice::StreamRx(uint8_t moduleIndex, complex8_t* const* dest, uint32_t count, StreamMeta* meta)
+{
+    return mStreamers.at(moduleIndex)->StreamRx(dest, count, meta);
+}
+
+uint32_t LMS7002M_SDRDevice::StreamRx(uint8_t moduleIndex, complex16f_t* const* dest, uint32_t count, StreamMeta* meta)
+{
+    return mStreamers.at(moduleIndex)->StreamRx(dest, count, meta);
+}
+
+OpStatus LMS7002M_SDRDevice::StreamRxHistory(uint8_t moduleIndex, complex32f_t* const* dest, uint64_t timestamp, uint32_t count)
+{
+    return mStreamers.at(moduleIndex)->StreamRxHistory(dest, timestamp, count);
+}
+
+OpStatus LMS7002M_SDRDevice::StreamRxHistory(uint8_t moduleIndex, complex16_t* const* dest, uint64_t timestamp, uint32_t count)
+{
+    return mStreamers.at(moduleIndex)->StreamRxHistory(dest, timestamp, count);
+}
+
+OpStatus LMS7002M_SDRDevice::StreamRxHistory(uint8_t moduleIndex, complex12_t* const* dest, uint64_t timestamp, uint32_t count)
+{
+    return mStreamers.at(moduleIndex)->StreamRxHistory(dest, timestamp, count);
+}
+
+OpStatus LMS7002M_SDRDevice::StreamRxHistory(uint8_t moduleIndex, complex8_t* const* dest, uint64_t timestamp, uint32_t count)
+{
+    return mStreamers.at(moduleIndex)->StreamRxHistory(dest, timestamp, count);
+}
+
+OpStatus LMS7002M_SDRDevice::StreamRxHistory(uint8_t moduleIndex, complex16f_t* const* dest, uint64_t timestamp, uint32_t count)
+{
+    return mStreamers.at(moduleIndex)->StreamRxHistory(dest, timestamp, count);
+}
+
 uint32_t LMS7002M_SDRDevice::StreamTx(
     uint8_t moduleIndex, const complex32f_t* const* samples, uint32_t count, const StreamMeta* meta)
 {
@@ -908,6 +984,17 @@ uint32_t LMS7002M_SDRDevice::StreamTx(
     return mStreamers.at(moduleIndex)->StreamTx(samples, count, meta);
 }
 
+uint32_t LMS7002M_SDRDevice::StreamTx(uint8_t moduleIndex, const complex8_t* const* samples, uint32_t count, const StreamMeta* meta)
+{
+    return mStreamers.at(moduleIndex)->StreamTx(samples, count, meta);
+}
+
+uint32_t LMS7002M_SDRDevice::StreamTx(
+    uint8_t moduleIndex, const complex16f_t* const* samples, uint32_t count, const StreamMeta* meta)
+{
+    return mStreamers.at(moduleIndex)->StreamTx(samples, count, meta);
+}
+
 void LMS7002M_SDRDevice::StreamStatus(uint8_t moduleIndex, StreamStats* rx, StreamStats* tx)
 {
     auto& trx = mStreamers.at(moduleIndex);
@@ -918,6 +1005,19 @@ void LMS7002M_SDRDevice::StreamStatus(uint8_t moduleIndex, StreamStats* rx, Stre
         *tx = trx->GetStats(TRXDir::Tx);
 }
 
+OpStatus LMS7002M_SDRDevice::UploadTxWaveform(
+    const StreamConfig& config, uint8_t moduleIndex, const void** samples, uint32_t count, UploadMemoryCallback callback)
+{
+    if (moduleIndex >= mStreamers.size())
+        return OpStatus::InvalidValue;
+
+    // waveform is loaded through the same DMA as the samples stream
+    if (mStreamers.at(moduleIndex)->IsStreamRunning())
+        return OpStatus::Busy;
+
+    return mStreamers.at(moduleIndex)->UploadTxWaveform(config, samples, count, callback);
+}
+
 OpStatus LMS7002M_SDRDevice::UploadMemory(
     eMemoryDevice device, uint8_t moduleIndex, const char* data, size_t length, UploadMemoryCallback callback)
 {
@@ -75,6 +75,19 @@ class LIME_API LMS7002M_SDRDevice : public SDRDevice
 
     bool GetSXLocked(uint8_t moduleIndex, TRXDir trx) override;
 
+    OpStatus GetTelemetry(DeviceTelemetry& telemetry, bool measureTemperature = true) override;
+
+    /// @brief Starts gathering the telemetry of all of the chips, the values are read by FinishTelemetry().
+    /// Devices made of several subdevices start all of them first, so their temperature sensors settle together.
+    /// @param modules The storage for the telemetry of each chip, a failure to start is stored in its status.
+    /// @param measureTemperature Whether to measure the temperatures.
+    void StartTelemetry(std::vector<DeviceTelemetry::Module>& modules, bool measureTemperature);
+
+    /// @brief Reads the telemetry of all of the chips, in a single SPI transaction per chip.
+    /// @param modules The storage prepared by StartTelemetry().
+    /// @return The status of the operation, the first failure of any of the chips.
+    OpStatus FinishTelemetry(std::vector<DeviceTelemetry::Module>& modules);
+
     unsigned int ReadRegister(uint8_t moduleIndex, unsigned int address, bool useFPGA = false) override;
     OpStatus WriteRegister(uint8_t moduleIndex, unsigned int address, unsigned int value, bool useFPGA = false) override;
 
@@ -111,10 +124,24 @@ class LIME_API LMS7002M_SDRDevice : public SDRDevice
     uint32_t StreamRx(uint8_t moduleIndex, complex32f_t* const* samples, uint32_t count, StreamMeta* meta) override;
     uint32_t StreamRx(uint8_t moduleIndex, complex16_t* const* samples, uint32_t count, StreamMeta* meta) override;
     uint32_t StreamRx(uint8_t moduleIndex, complex12_t* const* samples, uint32_t count, StreamMeta* meta) override;
+    uint32_t StreamRx(uint8_t moduleIndex, complex8_t* const* samples, uint32_t count, StreamMeta* meta) override;
+    uint32_t StreamRx(uint8_t moduleIndex, complex16f_t* const* samples, uint32_t count, StreamMeta* meta) override;
+    OpStatus StreamRxHistory(uint8_t moduleIndex, complex32f_t* const* samples, uint64_t timestamp, uint32_t count) override;
+    OpStatus StreamRxHistory(uint8_t moduleIndex, complex16_t* const* samples, uint64_t timestamp, uint32_t count) override;
+    OpStatus StreamRxHistory(uint8_t moduleIndex, complex12_t* const* samples, uint64_t timestamp, uint32_t count) override;
+    OpStatus StreamRxHistory(uint8_t moduleIndex, complex8_t* const* samples, uint64_t timestamp, uint32_t count) override;
+    OpStatus StreamRxHistory(uint8_t moduleIndex, complex16f_t* const* samples, uint64_t timestamp, uint32_t count) override;
     uint32_t StreamTx(uint8_t moduleIndex, const complex32f_t* const* samples, uint32_t count, const StreamMeta* meta) override;
     uint32_t StreamTx(uint8_t moduleIndex, const complex16_t* const* samples, uint32_t count, const StreamMeta* meta) override;
     uint32_t StreamTx(uint8_t moduleIndex, const complex12_t* const* samples, uint32_t count, const StreamMeta* meta) override;
+    uint32_t StreamTx(uint8_t moduleIndex, const complex8_t* const* samples, uint32_t count, const StreamMeta* meta) override;
+    uint32_t StreamTx(uint8_t moduleIndex, const complex16f_t* const* samples, uint32_t count, const StreamMeta* meta) override;
     void StreamStatus(uint8_t moduleIndex, StreamStats* rx, StreamStats* tx) override;
+    OpStatus UploadTxWaveform(const StreamConfig& config,
+        uint8_t moduleIndex,
+        const void** samples,
+        uint32_t count,
+        UploadMemoryCallback callback = nullptr) override;
 
     void SetMessageLogCallback(LogCallbackType callback) override;
 
@@ -407,6 +407,13 @@ double LimeSDR_Mini::GetTemperature(uint8_t moduleIndex)
     return LMS7002M_SDRDevice::GetTemperature(moduleIndex);
 }
 
+OpStatus LimeSDR_Mini::GetTelemetry(DeviceTelemetry& telemetry, bool measureTemperature)
+{
+    // LimeSDR-Mini v1 doesn't have a temperature sensor
+    const bool hasTemperatureSensor = mDeviceDescriptor.name != GetDeviceName(LMS_DEV_LIMESDRMINI);
+    return LMS7002M_SDRDevice::GetTelemetry(telemetry, measureTemperature && hasTemperatureSensor);
+}
+
 OpStatus LimeSDR_Mini::SetSampleRate(uint8_t moduleIndex, TRXDir trx, uint8_t channel, double sampleRate, uint8_t oversample)
 {
     const bool bypass = (oversample <= 1);
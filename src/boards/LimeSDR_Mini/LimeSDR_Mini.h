@@ -33,6 +33,7 @@ class LimeSDR_Mini : public LMS7002M_SDRDevice
     OpStatus SetClockFreq(uint8_t clk_id, double freq, uint8_t channel) override;
 
     double GetTemperature(uint8_t moduleIndex) override;
+    OpStatus GetTelemetry(DeviceTelemetry& telemetry, bool measureTemperature = true) override;
 
     OpStatus Synchronize(bool toChip) override;
 
@@ -598,8 +598,12 @@ OpStatus LimeSDR_X3::Configure(const SDRConfig& cfg, uint8_t socIndex)
                 eqCfg.fir[i].sleep = true;
                 eqCfg.fir[i].bypass = true;
             }
-            mEqualizer->Configure(eqCfg);
-            LMS2_SetSampleRate(sampleRate, cfg.channel[0].tx.oversample);
+            OpStatus status = mEqualizer->Configure(eqCfg);
+            if (status != OpStatus::Success)
+                return ReportError(status, "LimeSDR_X3: failed to configure the LMS2 equalizer");
+            status = LMS2_SetSampleRate(sampleRate, cfg.channel[0].tx.oversample);
+            if (status != OpStatus::Success)
+                return status;
         }
         else if (socIndex == 2 && sampleRate > 0)
         {
@@ -821,8 +825,10 @@ OpStatus LimeSDR_X3::SetSampleRate(uint8_t moduleIndex, TRXDir trx, uint8_t chan
             eqCfg.fir[i].sleep = true;
             eqCfg.fir[i].bypass = true;
         }
-        mEqualizer->Configure(eqCfg);
-        LMS2_SetSampleRate(sampleRate, oversample);
+        const OpStatus status = mEqualizer->Configure(eqCfg);
+        if (status != OpStatus::Success)
+            return ReportError(status, "LimeSDR_X3: failed to configure the LMS2 equalizer");
+        return LMS2_SetSampleRate(sampleRate, oversample);
     }
     else if (moduleIndex == 2 && sampleRate > 0)
     {
@@ -1148,7 +1154,7 @@ void LimeSDR_X3::LMS3SetPath(TRXDir dir, uint8_t chan, uint8_t path)
     }
 }
 
-void LimeSDR_X3::LMS2_SetSampleRate(double f_Hz, uint8_t oversample)
+OpStatus LimeSDR_X3::LMS2_SetSampleRate(double f_Hz, uint8_t oversample)
 {
     assert(mClockGeneratorCDCM);
     double txClock = f_Hz;
@@ -1158,7 +1164,9 @@ void LimeSDR_X3::LMS2_SetSampleRate(double f_Hz, uint8_t oversample)
     if (oversample == 2 || oversample == 0) // 0 is "auto", use max oversample
         txClock *= 2;
 
-    mEqualizer->SetOversample(oversample);
+    const OpStatus status = mEqualizer->SetOversample(oversample);
+    if (status != OpStatus::Success)
+        return ReportError(status, "LimeSDR_X3: failed to set the LMS2 equalizer oversampling");
 
     if (mClockGeneratorCDCM->SetFrequency(CDCM_Y0Y1, txClock, false) != 0) // Tx Ch. A&B
         throw std::runtime_error("Failed to configure CDCM_Y0Y1"s);
@@ -1169,6 +1177,7 @@ void LimeSDR_X3::LMS2_SetSampleRate(double f_Hz, uint8_t oversample)
 
     if (!mClockGeneratorCDCM->IsLocked())
         throw std::runtime_error("CDCM is not locked"s);
+    return OpStatus::Success;
 }
 
 void LimeSDR_X3::LMS3_SetSampleRate_ExternalDAC(double chA_Hz, double chB_Hz)
@@ -1232,9 +1241,10 @@ OpStatus LimeSDR_X3::MemoryRead(std::shared_ptr<DataStorage> storage, Region reg
     return mfpgaPort->MemoryRead(region.address, data, region.size);
 }
 
-OpStatus LimeSDR_X3::UploadTxWaveform(const StreamConfig& config, uint8_t moduleIndex, const void** samples, uint32_t count)
+OpStatus LimeSDR_X3::UploadTxWaveform(
+    const StreamConfig& config, uint8_t moduleIndex, const void** samples, uint32_t count, UploadMemoryCallback callback)
 {
-    // TODO: return TRXLooper::UploadTxWaveform(mFPGA, txdma, config, moduleIndex, samples, count);
+    // TODO: return LMS7002M_SDRDevice::UploadTxWaveform(config, moduleIndex, samples, count, callback);
     return OpStatus::Error;
 }
 
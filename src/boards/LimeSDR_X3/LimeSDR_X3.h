@@ -48,7 +48,11 @@ class LimeSDR_X3 : public LMS7002M_SDRDevice
         eMemoryDevice device, uint8_t moduleIndex, const char* data, size_t length, UploadMemoryCallback callback) override;
     OpStatus MemoryWrite(std::shared_ptr<DataStorage> storage, Region region, const void* data) override;
     OpStatus MemoryRead(std::shared_ptr<DataStorage> storage, Region region, void* data) override;
-    OpStatus UploadTxWaveform(const StreamConfig& config, uint8_t moduleIndex, const void** samples, uint32_t count) override;
+    OpStatus UploadTxWaveform(const StreamConfig& config,
+        uint8_t moduleIndex,
+        const void** samples,
+        uint32_t count,
+        UploadMemoryCallback callback = nullptr) override;
 
   private:
     OpStatus InitLMS1(bool skipTune = false);
@@ -65,7 +69,7 @@ class LimeSDR_X3 : public LMS7002M_SDRDevice
     void LMS3_SetSampleRate_ExternalDAC(double chA_Hz, double chB_Hz);
     static OpStatus LMS1_UpdateFPGAInterface(void* userData);
 
-    void LMS2_SetSampleRate(double f_Hz, uint8_t oversample);
+    OpStatus LMS2_SetSampleRate(double f_Hz, uint8_t oversample);
 
     enum class ePathLMS1_Rx : uint8_t { NONE, LNAH, LNAL };
     enum class ePathLMS1_Tx : uint8_t { NONE, BAND1, BAND2 };
@@ -556,39 +556,127 @@ OpStatus LimeSDR_XTRX::UploadMemory(
 
 OpStatus LimeSDR_XTRX::MemoryWrite(std::shared_ptr<DataStorage> storage, Region region, const void* data)
 {
-    if (storage == nullptr || storage->ownerDevice != this)
+    // the addresses are of the whole flash, the gateware image slots are only accessible through UploadMemory
+    if (storage == nullptr || storage->ownerDevice != this || storage->memoryDeviceType != eMemoryDevice::FPGA_FLASH)
         return OpStatus::InvalidValue;
     return fpgaPort->MemoryWrite(region.address, data, region.size);
 }
 
 OpStatus LimeSDR_XTRX::MemoryRead(std::shared_ptr<DataStorage> storage, Region region, void* data)
 {
-    if (storage == nullptr || storage->ownerDevice != this)
+    if (storage == nullptr || storage->ownerDevice != this || storage->memoryDeviceType != eMemoryDevice::FPGA_FLASH)
         return OpStatus::InvalidValue;
     return fpgaPort->MemoryRead(region.address, data, region.size);
 }
 
-OpStatus LimeSDR_XTRX::ClkTest(OEMTestReporter& reporter, TestData& results)
+class CustomParameterStash
 {
-    OEMTestData test("PCIe Reference clock");
-    reporter.OnStart(test);
-    if (mFPGA->OEMTestSetup(FPGA::TestID::HostReferenceClock, 1.0) != OpStatus::Success)
+  public:
+    CustomParameterStash(SDRDevice* dev, const std::vector<CustomParameterIO>& args)
+        : device(dev)
+        , stash(args)
     {
-        reporter.OnFail(test, "timeout");
-        return OpStatus::Error;
+        assert(dev);
+        device->CustomParameterRead(stash);
     }
+    ~CustomParameterStash() { device->CustomParameterWrite(stash); }
+
+  private:
+    SDRDevice* device;
+    std::vector<CustomParameterIO> stash;
+};
+
+// The FPGA measures each of the clocks independently, so the reference clock, GNSS and the first VCTCXO
+// measurements run at once. Only the second VCTCXO measurement has to wait for the DAC change.
+OpStatus LimeSDR_XTRX::ClockMeasurements(OEMTestReporter& reporter, TestData& results)
+{
+    constexpr uint16_t refClkTest = static_cast<uint16_t>(FPGA::TestID::HostReferenceClock);
+    constexpr uint16_t vctcxoTest = static_cast<uint16_t>(FPGA::TestID::VCTCXO);
+    constexpr uint16_t gnssTest = static_cast<uint16_t>(FPGA::TestID::GNSS);
+
+    OEMTestData test("Clock measurements");
+    reporter.OnStart(test);
 
-    uint32_t addr[] = { 0x69, 0x69, 0x69 };
-    uint32_t vals[3];
+    std::vector<CustomParameterIO> params{ { cp_vctcxo_dac.id, 0, "" } };
     try
     {
-        fpgaPort->SPI(addr, vals, 3);
+        // Store current value, and restore it on return
+        CustomParameterStash vctcxoStash(this, params);
+
+        params[0].value = cp_vctcxo_dac.minValue;
+        if (CustomParameterWrite(params) != OpStatus::Success)
+        {
+            reporter.OnFail(test, "IO failure");
+            return OpStatus::IOFailure;
+        }
+
+        // the tests that time out are reported by their own checks
+        mFPGA->OEMTestSetup(refClkTest | vctcxoTest | gnssTest, 1.0, results.clockTestsCompleted);
+
+        if (results.clockTestsCompleted & refClkTest)
+        {
+            uint32_t addr[] = { 0x69, 0x69, 0x69 };
+            fpgaPort->SPI(addr, results.refClkCounts, 3);
+        }
+
+        if (results.clockTestsCompleted & vctcxoTest)
+        {
+            uint32_t addr[] = { 0x72, 0x73 };
+            uint32_t vals[2];
+            if (mFPGA->ReadRegisters(addr, vals, 2) != OpStatus::Success)
+            {
+                reporter.OnFail(test, "IO failure");
+                return OpStatus::IOFailure;
+            }
+            results.vctcxoMinCount = vals[0] + (vals[1] << 16);
+
+            params[0].value = cp_vctcxo_dac.maxValue;
+            if (CustomParameterWrite(params) != OpStatus::Success)
+            {
+                reporter.OnFail(test, "IO failure");
+                return OpStatus::IOFailure;
+            }
+
+            uint16_t completed = 0;
+            if (mFPGA->OEMTestSetup(vctcxoTest, 1.0, completed) == OpStatus::Success)
+            {
+                if (mFPGA->ReadRegisters(addr, vals, 2) != OpStatus::Success)
+                {
+                    reporter.OnFail(test, "IO failure");
+                    return OpStatus::IOFailure;
+                }
+                results.vctcxoMaxCount = vals[0] + (vals[1] << 16);
+                results.vctcxoMeasured = true;
+            }
+        }
     } catch (...)
     {
-        reporter.OnFail(test, "SPI failed");
+        reporter.OnFail(test, "IO failure");
+        return OpStatus::IOFailure;
+    }
+
+    results.clockMeasurementsDone = true;
+    test.passed = true;
+    reporter.OnSuccess(test);
+    return OpStatus::Success;
+}
+
+OpStatus LimeSDR_XTRX::ClkTest(OEMTestReporter& reporter, TestData& results)
+{
+    OEMTestData test("PCIe Reference clock");
+    reporter.OnStart(test);
+    if (!results.clockMeasurementsDone)
+    {
+        reporter.OnFail(test, "IO failure");
         return OpStatus::IOFailure;
     }
+    if (!(results.clockTestsCompleted & static_cast<uint16_t>(FPGA::TestID::HostReferenceClock)))
+    {
+        reporter.OnFail(test, "timeout");
+        return OpStatus::Error;
+    }
 
+    const uint32_t* vals = results.refClkCounts;
     const bool pass = !(vals[0] == vals[1] && vals[1] == vals[2]);
     reporter.OnStepUpdate(
         test, "results: " + std::to_string(vals[0]) + "; " + std::to_string(vals[1]) + "; " + std::to_string(vals[2]));
@@ -610,11 +698,10 @@ OpStatus LimeSDR_XTRX::GNSSTest(OEMTestReporter& reporter, TestData& results)
 {
     OEMTestData test("GNSS");
     reporter.OnStart(test);
-    OpStatus status = mFPGA->OEMTestSetup(FPGA::TestID::GNSS, 1.0);
-    results.gnssPassed = status == OpStatus::Success;
-    if (status != OpStatus::Success)
+    results.gnssPassed = results.clockTestsCompleted & static_cast<uint16_t>(FPGA::TestID::GNSS);
+    if (!results.gnssPassed)
     {
-        reporter.OnFail(test, "timeout");
+        reporter.OnFail(test, results.clockMeasurementsDone ? "timeout" : "IO failure");
         return OpStatus::Error;
     }
     test.passed = true;
@@ -622,100 +709,35 @@ OpStatus LimeSDR_XTRX::GNSSTest(OEMTestReporter& reporter, TestData& results)
     return OpStatus::Success;
 }
 
-class CustomParameterStash
-{
-  public:
-    CustomParameterStash(SDRDevice* dev, const std::vector<CustomParameterIO>& args)
-        : device(dev)
-        , stash(args)
-    {
-        assert(dev);
-        device->CustomParameterRead(stash);
-    }
-    ~CustomParameterStash() { device->CustomParameterWrite(stash); }
-
-  private:
-    SDRDevice* device;
-    std::vector<CustomParameterIO> stash;
-};
-
 OpStatus LimeSDR_XTRX::VCTCXOTest(OEMTestReporter& reporter, TestData& results)
 {
     OEMTestData test("VCTCXO");
     reporter.OnStart(test);
-
-    unsigned count1;
-    unsigned count2;
-
-    std::vector<CustomParameterIO> params{ { cp_vctcxo_dac.id, 0, "" } };
-
-    try
+    if (!results.clockMeasurementsDone)
     {
-        OpStatus status;
-        // Store current value, and restore it on return
-        CustomParameterStash vctcxoStash(this, params);
-
-        params[0].value = cp_vctcxo_dac.minValue;
-        status = CustomParameterWrite(params);
-        if (status != OpStatus::Success)
-            return status;
-
-        status = mFPGA->OEMTestSetup(FPGA::TestID::VCTCXO, 1.0);
-        if (status != OpStatus::Success)
-        {
-            reporter.OnFail(test, "timeout");
-            return status;
-        }
-
-        uint32_t addr[] = { 0x72, 0x73 };
-        uint32_t vals[2];
-        if (mFPGA->ReadRegisters(addr, vals, 2) != OpStatus::Success)
-        {
-            reporter.OnFail(test, "IO failure");
-            return OpStatus::IOFailure;
-        }
-
-        count1 = vals[0] + (vals[1] << 16);
-        params[0].value = cp_vctcxo_dac.maxValue;
-        if (CustomParameterWrite(params) != OpStatus::Success)
-        {
-            reporter.OnFail(test, "IO failure");
-            return OpStatus::IOFailure;
-        }
-
-        status = mFPGA->OEMTestSetup(FPGA::TestID::VCTCXO, 1.0);
-        if (status != OpStatus::Success)
-        {
-            reporter.OnFail(test, "timeout");
-            return status;
-        }
-
-        if (mFPGA->ReadRegisters(addr, vals, 2) != OpStatus::Success)
-        {
-            reporter.OnFail(test, "IO failure");
-            return OpStatus::IOFailure;
-        }
+        reporter.OnFail(test, "IO failure");
+        return OpStatus::IOFailure;
+    }
+    if (!results.vctcxoMeasured)
+    {
+        reporter.OnFail(test, "timeout");
+        return OpStatus::Error;
+    }
 
-        count2 = vals[0] + (vals[1] << 16);
-        std::string str = "Count : " + std::to_string(count1) + " (min); " + std::to_string(count2) + " (max)";
-        results.vctcxoMinCount = count1;
-        results.vctcxoMaxCount = count2;
-        reporter.OnStepUpdate(test, str);
+    const uint32_t count1 = results.vctcxoMinCount;
+    const uint32_t count2 = results.vctcxoMaxCount;
+    std::string str = "Count : " + std::to_string(count1) + " (min); " + std::to_string(count2) + " (max)";
+    reporter.OnStepUpdate(test, str);
 
-        const bool fail = (count1 + 25 > count2) || (count1 + 35 < count2);
-        if (fail)
-        {
-            reporter.OnFail(test, "unexpected values");
-            return OpStatus::Error;
-        }
-        results.vctcxoPassed = true;
-        test.passed = true;
-        reporter.OnSuccess(test);
-    } catch (...)
+    const bool fail = (count1 + 25 > count2) || (count1 + 35 < count2);
+    if (fail)
     {
-        reporter.OnFail(test, "IO failure");
-        return OpStatus::IOFailure;
+        reporter.OnFail(test, "unexpected values");
+        return OpStatus::Error;
     }
+    results.vctcxoPassed = true;
+    test.passed = true;
+    reporter.OnSuccess(test);
     return OpStatus::Success;
 }
 
@@ -906,6 +928,7 @@ OpStatus LimeSDR_XTRX::OEMTest(OEMTestReporter* reporter)
     OEMTestData test("LimeSDR-XTRX OEM Test");
     reporter->OnStart(test);
     bool pass = true;
+    pass &= ClockMeasurements(*reporter, results) == OpStatus::Success;
     pass &= ClkTest(*reporter, results) == OpStatus::Success;
     pass &= VCTCXOTest(*reporter, results) == OpStatus::Success;
     pass &= GNSSTest(*reporter, results) == OpStatus::Success;
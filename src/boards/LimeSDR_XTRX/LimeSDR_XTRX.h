@@ -61,6 +61,10 @@ class LimeSDR_XTRX : public LMS7002M_SDRDevice
         TestData();
         uint32_t vctcxoMinCount{};
         uint32_t vctcxoMaxCount{};
+        uint32_t refClkCounts[3]{};
+        uint16_t clockTestsCompleted{}; ///< The FPGA tests that completed during the clock measurements
+        bool clockMeasurementsDone{};
+        bool vctcxoMeasured{};
         bool refClkPassed{};
         bool gnssPassed{};
         bool vctcxoPassed{};
@@ -75,6 +79,7 @@ class LimeSDR_XTRX : public LMS7002M_SDRDevice
         RFData lnah[2]{};
     };
 
+    OpStatus ClockMeasurements(OEMTestReporter& reporter, TestData& results);
     OpStatus ClkTest(OEMTestReporter& reporter, TestData& results);
     OpStatus VCTCXOTest(OEMTestReporter& reporter, TestData& results);
     OpStatus GNSSTest(OEMTestReporter& reporter, TestData& results);
@@ -13,6 +13,7 @@
 #include "DeviceTreeNode.h"
 #include "utilities/toString.h"
 
+#include <chrono>
 #include <cmath>
 
 namespace lime {
@@ -407,6 +408,26 @@ bool LimeSDR_MMX8::GetSXLocked(uint8_t moduleIndex, TRXDir trx)
     return mSubDevices[moduleIndex]->GetSXLocked(0, trx);
 }
 
+OpStatus LimeSDR_MMX8::GetTelemetry(DeviceTelemetry& telemetry, bool measureTemperature)
+{
+    // all of the temperature measurements are started first, so the sensors settle at the same time
+    std::vector<std::vector<DeviceTelemetry::Module>> subdeviceModules(mSubDevices.size());
+    for (std::size_t i = 0; i < mSubDevices.size(); ++i)
+        mSubDevices[i]->StartTelemetry(subdeviceModules[i], measureTemperature);
+
+    OpStatus status = OpStatus::Success;
+    telemetry.modules.clear();
+    for (std::size_t i = 0; i < mSubDevices.size(); ++i)
+    {
+        const OpStatus subdeviceStatus = mSubDevices[i]->FinishTelemetry(subdeviceModules[i]);
+        if (status == OpStatus::Success)
+            status = subdeviceStatus;
+        telemetry.modules.insert(telemetry.modules.end(), subdeviceModules[i].begin(), subdeviceModules[i].end());
+    }
+    telemetry.timestamp = std::chrono::system_clock::now();
+    return status;
+}
+
 unsigned int LimeSDR_MMX8::ReadRegister(uint8_t moduleIndex, unsigned int address, bool useFPGA)
 {
     if (moduleIndex >= 8)
@@ -689,6 +710,41 @@ uint32_t LimeSDR_MMX8::StreamRx(uint8_t moduleIndex, lime::complex12_t* const* d
     return mSubDevices[moduleIndex]->StreamRx(0, dest, count, meta);
 }
 
+uint32_t LimeSDR_MMX8::StreamRx(uint8_t moduleIndex, lime::complex8_t* const* dest, uint32_t count, StreamMeta* meta)
+{
+    return mSubDevices[moduleIndex]->StreamRx(0, dest, count, meta);
+}
+
+uint32_t LimeSDR_MMX8::StreamRx(uint8_t moduleIndex, lime::complex16f_t* const* dest, uint32_t count, StreamMeta* meta)
+{
+    return mSubDevices[moduleIndex]->StreamRx(0, dest, count, meta);
+}
+
+OpStatus LimeSDR_MMX8::StreamRxHistory(uint8_t moduleIndex, lime::complex32f_t* const* dest, uint64_t timestamp, uint32_t count)
+{
+    return mSubDevices[moduleIndex]->StreamRxHistory(0, dest, timestamp, count);
+}
+
+OpStatus LimeSDR_MMX8::StreamRxHistory(uint8_t moduleIndex, lime::complex16_t* const* dest, uint64_t timestamp, uint32_t count)
+{
+    return mSubDevices[moduleIndex]->StreamRxHistory(0, dest, timestamp, count);
+}
+
+OpStatus LimeSDR_MMX8::StreamRxHistory(uint8_t moduleIndex, lime::complex12_t* const* dest, uint64_t timestamp, uint32_t count)
+{
+    return mSubDevices[moduleIndex]->StreamRxHistory(0, dest, timestamp, count);
+}
+
+OpStatus LimeSDR_MMX8::StreamRxHistory(uint8_t moduleIndex, lime::complex8_t* const* dest, uint64_t timestamp, uint32_t count)
+{
+    return mSubDevices[moduleIndex]->StreamRxHistory(0, dest, timestamp, count);
+}
+
+OpStatus LimeSDR_MMX8::StreamRxHistory(uint8_t moduleIndex, lime::complex16f_t* const* dest, uint64_t timestamp, uint32_t count)
+{
+    return mSubDevices[moduleIndex]->StreamRxHistory(0, dest, timestamp, count);
+}
+
 uint32_t LimeSDR_MMX8::StreamTx(
     uint8_t moduleIndex, const lime::complex32f_t* const* samples, uint32_t count, const StreamMeta* meta)
 {
@@ -707,6 +763,18 @@ uint32_t LimeSDR_MMX8::StreamTx(
     return mSubDevices[moduleIndex]->StreamTx(0, samples, count, meta);
 }
 
+uint32_t LimeSDR_MMX8::StreamTx(
+    uint8_t moduleIndex, const lime::complex8_t* const* samples, uint32_t count, const StreamMeta* meta)
+{
+    return mSubDevices[moduleIndex]->StreamTx(0, samples, count, meta);
+}
+
+uint32_t LimeSDR_MMX8::StreamTx(
+    uint8_t moduleIndex, const lime::complex16f_t* const* samples, uint32_t count, const StreamMeta* meta)
+{
+    return mSubDevices[moduleIndex]->StreamTx(0, samples, count, meta);
+}
+
 void LimeSDR_MMX8::StreamStatus(uint8_t moduleIndex, StreamStats* rx, StreamStats* tx)
 {
     mSubDevices[moduleIndex]->StreamStatus(0, rx, tx);
@@ -812,7 +880,11 @@ OpStatus LimeSDR_MMX8::MemoryWrite(std::shared_ptr<DataStorage> storage, Region
         return ReportError(OpStatus::InvalidValue, "Invalid storage"s);
 
     if (storage->ownerDevice == this)
+    {
+        if (storage->memoryDeviceType != eMemoryDevice::EEPROM)
+            return ReportError(OpStatus::InvalidValue, "Only the EEPROM can be accessed directly"s);
         return mMainFPGAcomms->MemoryWrite(region.address, data, region.size);
+    }
 
     SDRDevice* dev = storage->ownerDevice;
     if (dev == nullptr)
@@ -827,7 +899,11 @@ OpStatus LimeSDR_MMX8::MemoryRead(std::shared_ptr<DataStorage> storage, Region r
         return ReportError(OpStatus::InvalidValue, "Invalid storage"s);
 
     if (storage->ownerDevice == this)
+    {
+        if (storage->memoryDeviceType != eMemoryDevice::EEPROM)
+            return ReportError(OpStatus::InvalidValue, "Only the EEPROM can be accessed directly"s);
         return mMainFPGAcomms->MemoryRead(region.address, data, region.size);
+    }
 
     SDRDevice* dev = storage->ownerDevice;
     if (dev == nullptr)
@@ -836,9 +912,10 @@ OpStatus LimeSDR_MMX8::MemoryRead(std::shared_ptr<DataStorage> storage, Region r
     return dev->MemoryRead(storage, region, data);
 }
 
-OpStatus LimeSDR_MMX8::UploadTxWaveform(const StreamConfig& config, uint8_t moduleIndex, const void** samples, uint32_t count)
+OpStatus LimeSDR_MMX8::UploadTxWaveform(
+    const StreamConfig& config, uint8_t moduleIndex, const void** samples, uint32_t count, UploadMemoryCallback callback)
 {
-    return mSubDevices[moduleIndex]->UploadTxWaveform(config, 0, samples, count);
+    return mSubDevices[moduleIndex]->UploadTxWaveform(config, 0, samples, count, callback);
 }
 
 } //namespace lime
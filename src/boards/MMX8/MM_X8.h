@@ -89,6 +89,8 @@ class LimeSDR_MMX8 : public SDRDevice
 
     bool GetSXLocked(uint8_t moduleIndex, TRXDir trx) override;
 
+    OpStatus GetTelemetry(DeviceTelemetry& telemetry, bool measureTemperature = true) override;
+
     unsigned int ReadRegister(uint8_t moduleIndex, unsigned int address, bool useFPGA = false) override;
     OpStatus WriteRegister(uint8_t moduleIndex, unsigned int address, unsigned int value, bool useFPGA = false) override;
 
@@ -127,12 +129,23 @@ class LimeSDR_MMX8 : public SDRDevice
     uint32_t StreamRx(uint8_t moduleIndex, lime::complex32f_t* const* samples, uint32_t count, StreamMeta* meta) override;
     uint32_t StreamRx(uint8_t moduleIndex, lime::complex16_t* const* samples, uint32_t count, StreamMeta* meta) override;
     uint32_t StreamRx(uint8_t moduleIndex, lime::complex12_t* const* samples, uint32_t count, StreamMeta* meta) override;
+    uint32_t StreamRx(uint8_t moduleIndex, lime::complex8_t* const* samples, uint32_t count, StreamMeta* meta) override;
+    uint32_t StreamRx(uint8_t moduleIndex, lime::complex16f_t* const* samples, uint32_t count, StreamMeta* meta) override;
+    OpStatus StreamRxHistory(uint8_t moduleIndex, lime::complex32f_t* const* samples, uint64_t timestamp, uint32_t count) override;
+    OpStatus StreamRxHistory(uint8_t moduleIndex, lime::complex16_t* const* samples, uint64_t timestamp, uint32_t count) override;
+    OpStatus StreamRxHistory(uint8_t moduleIndex, lime::complex12_t* const* samples, uint64_t timestamp, uint32_t count) override;
+    OpStatus StreamRxHistory(uint8_t moduleIndex, lime::complex8_t* const* samples, uint64_t timestamp, uint32_t count) override;
+    OpStatus StreamRxHistory(uint8_t moduleIndex, lime::complex16f_t* const* samples, uint64_t timestamp, uint32_t count) override;
     uint32_t StreamTx(
         uint8_t moduleIndex, const lime::complex32f_t* const* samples, uint32_t count, const StreamMeta* meta) override;
     uint32_t StreamTx(
         uint8_t moduleIndex, const lime::complex16_t* const* samples, uint32_t count, const StreamMeta* meta) override;
     uint32_t StreamTx(
         uint8_t moduleIndex, const lime::complex12_t* const* samples, uint32_t count, const StreamMeta* meta) override;
+    uint32_t StreamTx(
+        uint8_t moduleIndex, const lime::complex8_t* const* samples, uint32_t count, const StreamMeta* meta) override;
+    uint32_t StreamTx(
+        uint8_t moduleIndex, const lime::complex16f_t* const* samples, uint32_t count, const StreamMeta* meta) override;
     void StreamStatus(uint8_t moduleIndex, StreamStats* rx, StreamStats* tx) override;
 
     OpStatus SPI(uint32_t chipSelect, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override;
@@ -148,7 +161,11 @@ class LimeSDR_MMX8 : public SDRDevice
         eMemoryDevice device, uint8_t moduleIndex, const char* data, size_t length, UploadMemoryCallback callback) override;
     OpStatus MemoryWrite(std::shared_ptr<DataStorage> storage, Region region, const void* data) override;
     OpStatus MemoryRead(std::shared_ptr<DataStorage> storage, Region region, void* data) override;
-    OpStatus UploadTxWaveform(const StreamConfig& config, uint8_t moduleIndex, const void** samples, uint32_t count) override;
+    OpStatus UploadTxWaveform(const StreamConfig& config,
+        uint8_t moduleIndex,
+        const void** samples,
+        uint32_t count,
+        UploadMemoryCallback callback = nullptr) override;
 
   private:
     std::shared_ptr<IComms> mMainFPGAcomms;
@@ -0,0 +1,156 @@
+#include "SimulatedSDR.h"
+
+#include "comms/ISPI.h"
+#include "comms/SimulatedDMA.h"
+#include "DeviceTreeNode.h"
+#include "FPGA/FPGA_common.h"
+#include "limesuiteng/LMS7002M.h"
+#include "protocols/TRXLooper.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace std::literals::string_literals;
+
+namespace lime {
+
+static const uint8_t SPI_LMS7002M = 0;
+static const uint8_t SPI_FPGA = 1;
+
+/// @brief SPI port backed by plain memory, reads return the last written values.
+class SimulatedRegisters : public ISPI
+{
+  public:
+    SimulatedRegisters()
+        : registers(65536, 0)
+    {
+    }
+
+    OpStatus SPI(const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const uint32_t word = MOSI[i];
+            if (word & (1 << 31))
+            {
+                registers[(word >> 16) & 0x7FFF] = word & 0xFFFF;
+                continue;
+            }
+            // read requests put the address either in the upper or in the lower half of the word
+            const uint16_t address = word > 0xFFFF ? (word >> 16) & 0x7FFF : word;
+            if (MISO)
+                MISO[i] = registers[address];
+        }
+        return OpStatus::Success;
+    }
+
+    OpStatus SPI(uint32_t chipSelect, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        return SPI(MOSI, MISO, count);
+    }
+
+  private:
+    std::vector<uint16_t> registers;
+};
+
+/// @brief Constructs a new simulated device.
+SimulatedSDR::SimulatedSDR()
+    : LMS7002M_SDRDevice()
+    , mFPGARegisters(std::make_shared<SimulatedRegisters>())
+    , mLMSRegisters(std::make_shared<SimulatedRegisters>())
+    , mSampleRate(0)
+{
+    SDRDescriptor& desc = mDeviceDescriptor;
+    desc.name = "Simulated"s;
+    desc.spiSlaveIds = { { "LMS7002M"s, SPI_LMS7002M }, { "FPGA"s, SPI_FPGA } };
+
+    mFPGA = std::make_unique<FPGA>(mFPGARegisters, mLMSRegisters);
+
+    desc.rfSOC.push_back(GetDefaultLMS7002MDescriptor());
+    mLMSChips.push_back(std::make_unique<LMS7002M>(mLMSRegisters));
+
+    mRxDMA = std::make_shared<SimulatedDMA>(DataTransferDirection::DeviceToHost);
+    mTxDMA = std::make_shared<SimulatedDMA>(DataTransferDirection::HostToDevice, mRxDMA);
+    mStreamers.push_back(std::make_unique<TRXLooper>(mRxDMA, mTxDMA, mFPGA.get(), mLMSChips.at(0).get(), 0));
+
+    auto fpgaNode = std::make_shared<DeviceTreeNode>("FPGA"s, eDeviceTreeNodeClass::FPGA, mFPGA.get());
+    fpgaNode->children.push_back(
+        std::make_shared<DeviceTreeNode>("LMS7002M"s, eDeviceTreeNodeClass::LMS7002M, mLMSChips.at(0).get()));
+    desc.socTree = std::make_shared<DeviceTreeNode>("Simulated"s, eDeviceTreeNodeClass::SDRDevice, this);
+    desc.socTree->children.push_back(fpgaNode);
+}
+
+OpStatus SimulatedSDR::Configure(const SDRConfig& cfg, uint8_t moduleIndex)
+{
+    if (moduleIndex >= mLMSChips.size())
+        return ReportError(OpStatus::OutOfRange, "Invalid module index (%i)", moduleIndex);
+
+    // only the sample rate matters for the simulation
+    for (const ChannelConfig& channel : cfg.channel)
+    {
+        if (channel.rx.enabled && channel.rx.sampleRate > 0)
+            mSampleRate = channel.rx.sampleRate;
+        else if (channel.tx.enabled && channel.tx.sampleRate > 0)
+            mSampleRate = channel.tx.sampleRate;
+    }
+    return OpStatus::Success;
+}
+
+OpStatus SimulatedSDR::Init()
+{
+    return OpStatus::Success;
+}
+
+double SimulatedSDR::GetSampleRate(uint8_t moduleIndex, TRXDir trx, uint8_t channel, uint32_t* rf_samplerate)
+{
+    if (rf_samplerate)
+        *rf_samplerate = mSampleRate;
+    return mSampleRate;
+}
+
+OpStatus SimulatedSDR::SetSampleRate(uint8_t moduleIndex, TRXDir trx, uint8_t channel, double sampleRate, uint8_t oversample)
+{
+    mSampleRate = sampleRate;
+    return OpStatus::Success;
+}
+
+OpStatus SimulatedSDR::SPI(uint32_t chipSelect, const uint32_t* MOSI, uint32_t* MISO, uint32_t count)
+{
+    switch (chipSelect)
+    {
+    case SPI_LMS7002M:
+        return mLMSRegisters->SPI(MOSI, MISO, count);
+    case SPI_FPGA:
+        return mFPGARegisters->SPI(MOSI, MISO, count);
+    default:
+        return ReportError(OpStatus::InvalidValue, "Invalid SPI chip select (%i)", chipSelect);
+    }
+}
+
+double SimulatedSDR::GetClockFreq(uint8_t clk_id, uint8_t channel)
+{
+    auto iter = mClocks.find(clk_id);
+    return iter != mClocks.end() ? iter->second : 0;
+}
+
+OpStatus SimulatedSDR::SetClockFreq(uint8_t clk_id, double freq, uint8_t channel)
+{
+    mClocks[clk_id] = freq;
+    return OpStatus::Success;
+}
+
+/// @copydoc SDRDevice::StreamSetup()
+/// Rx samples are produced at StreamConfig::hintSampleRate if it's set, otherwise at the configured sample rate.
+/// If neither is set, samples are produced as fast as they are consumed.
+OpStatus SimulatedSDR::StreamSetup(const StreamConfig& config, uint8_t moduleIndex)
+{
+    const double sampleRate = config.hintSampleRate > 0 ? config.hintSampleRate : mSampleRate;
+    std::size_t channelCount = 0;
+    for (const auto& direction : config.channels)
+        channelCount = std::max(channelCount, direction.second.size());
+    mRxDMA->SetStreamFormat(config.linkFormat, channelCount, sampleRate);
+    mTxDMA->SetStreamFormat(config.linkFormat, channelCount, sampleRate);
+    return LMS7002M_SDRDevice::StreamSetup(config, moduleIndex);
+}
+
+} // namespace lime
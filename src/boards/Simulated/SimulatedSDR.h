@@ -0,0 +1,57 @@
+#ifndef LIME_SIMULATEDSDR_H
+#define LIME_SIMULATEDSDR_H
+
+#include "LMS7002M_SDRDevice.h"
+
+#include <map>
+#include <memory>
+
+namespace lime {
+
+class ISPI;
+class SimulatedDMA;
+
+/**
+  @brief Device without any hardware, for testing and benchmarking the samples streaming.
+
+  Registers of the FPGA and the LMS7002M are simulated by plain memory, samples
+  streaming goes through SimulatedDMA. RF configuration is accepted, but has no effect.
+ */
+class SimulatedSDR : public LMS7002M_SDRDevice
+{
+  public:
+    SimulatedSDR();
+
+    OpStatus Configure(const SDRConfig& config, uint8_t moduleIndex) override;
+    OpStatus Init() override;
+
+    double GetSampleRate(uint8_t moduleIndex, TRXDir trx, uint8_t channel, uint32_t* rf_samplerate = nullptr) override;
+    OpStatus SetSampleRate(uint8_t moduleIndex, TRXDir trx, uint8_t channel, double sampleRate, uint8_t oversample) override;
+
+    double GetClockFreq(uint8_t clk_id, uint8_t channel) override;
+    OpStatus SetClockFreq(uint8_t clk_id, double freq, uint8_t channel) override;
+
+    OpStatus StreamSetup(const StreamConfig& config, uint8_t moduleIndex) override;
+
+    OpStatus SPI(uint32_t chipSelect, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override;
+
+    /// @brief Gets the simulated Rx DMA, for inspecting the streaming results.
+    /// @return The simulated Rx DMA.
+    std::shared_ptr<SimulatedDMA> GetRxDMA() const { return mRxDMA; }
+
+    /// @brief Gets the simulated Tx DMA, for inspecting the streaming results.
+    /// @return The simulated Tx DMA.
+    std::shared_ptr<SimulatedDMA> GetTxDMA() const { return mTxDMA; }
+
+  private:
+    std::shared_ptr<ISPI> mFPGARegisters;
+    std::shared_ptr<ISPI> mLMSRegisters;
+    std::shared_ptr<SimulatedDMA> mRxDMA;
+    std::shared_ptr<SimulatedDMA> mTxDMA;
+    std::map<uint8_t, double> mClocks;
+    double mSampleRate;
+};
+
+} // namespace lime
+
+#endif // LIME_SIMULATEDSDR_H
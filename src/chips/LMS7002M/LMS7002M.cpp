@@ -45,6 +45,11 @@ using namespace LMS7002MCSR_Data;
 using namespace std::literals::string_literals;
 using namespace std::literals::string_view_literals;
 
+// The binary configuration snapshot: the magic, the version, the reference clock,
+// then the register count and the address/value pairs of the channel A and B pages, all little-endian.
+static constexpr char snapshotMagic[8] = { 'L', 'M', 'S', '7', 'S', 'N', 'A', 'P' };
+static constexpr uint16_t snapshotVersion = 1;
+
 // converts [-1:1] into [-32768:32767]
 static constexpr int16_t NormalFloatToInt16(const float value)
 {
@@ -269,6 +274,8 @@ LMS7002M::LMS7002M(std::shared_ptr<ISPI> port)
     , useCache(0)
     , mRegistersMap(new LMS7002M_RegistersMap())
     , controlPort(port)
+    , mTemperatureMeasurementStarted(false)
+    , mTemperatureBiasMux(0)
     , mC_impl(nullptr)
 {
     struct lms7002m_hooks hooks {
@@ -594,7 +601,11 @@ OpStatus LMS7002M::LoadConfig(const std::string& filename, bool tuneDynamicValue
         f.close();
         return ReportError(OpStatus::FileNotFound, "LoadConfig(%s) - file not found", filename.c_str());
     }
+    char magic[sizeof(snapshotMagic)]{};
+    f.read(magic, sizeof(magic));
     f.close();
+    if (std::memcmp(magic, snapshotMagic, sizeof(snapshotMagic)) == 0)
+        return LoadConfigSnapshot(filename, tuneDynamicValues);
 
     uint16_t addr = 0;
     uint16_t value = 0;
@@ -690,25 +701,201 @@ OpStatus LMS7002M::LoadConfig(const std::string& filename, bool tuneDynamicValue
 
     if (tuneDynamicValues)
     {
-        Modify_SPI_Reg_bits(LMS7002MCSR::MAC, 2);
-        if (!Get_SPI_Reg_bits(LMS7002MCSR::PD_VCO))
-            TuneVCO(VCO_Module::VCO_SXT);
-        Modify_SPI_Reg_bits(LMS7002MCSR::MAC, 1);
-        if (!Get_SPI_Reg_bits(LMS7002MCSR::PD_VCO))
-            TuneVCO(VCO_Module::VCO_SXR);
-        if (!Get_SPI_Reg_bits(LMS7002MCSR::PD_VCO_CGEN))
+        status = TuneDynamicValues();
+        if (status != OpStatus::Success)
+            return status;
+    }
+    SetActiveChannel(Channel::ChA);
+    return OpStatus::Success;
+}
+
+// Tunes the VCOs that are enabled, and reconfigures the interface clocks when the CGEN is enabled.
+OpStatus LMS7002M::TuneDynamicValues()
+{
+    Modify_SPI_Reg_bits(LMS7002MCSR::MAC, 2);
+    if (!Get_SPI_Reg_bits(LMS7002MCSR::PD_VCO))
+        TuneVCO(VCO_Module::VCO_SXT);
+    Modify_SPI_Reg_bits(LMS7002MCSR::MAC, 1);
+    if (!Get_SPI_Reg_bits(LMS7002MCSR::PD_VCO))
+        TuneVCO(VCO_Module::VCO_SXR);
+    if (!Get_SPI_Reg_bits(LMS7002MCSR::PD_VCO_CGEN))
+    {
+        TuneVCO(VCO_Module::VCO_CGEN);
+        if (mCallback_onCGENChange)
+            return mCallback_onCGENChange(mCallback_onCGENChange_userData);
+    }
+    return OpStatus::Success;
+}
+
+// The addresses of the registers stored in the configuration files.
+std::vector<uint16_t> LMS7002M::ConfigRegisterAddresses(Channel channel)
+{
+    std::vector<uint16_t> addresses;
+    for (const auto& memorySectionPair : MemorySectionAddresses)
+    {
+        // channel B only has its own copy of the MAC mapped registers
+        if (channel == Channel::ChB && memorySectionPair.first == MemorySection::RSSI_DC_CALIBRATION)
+            continue;
+        for (uint16_t addr = memorySectionPair.second[0]; addr <= memorySectionPair.second[1]; ++addr)
+            if (channel == Channel::ChA || addr >= 0x0100)
+                addresses.push_back(addr);
+    }
+    return addresses;
+}
+
+// Reads the registers of the active channel in the form they have to be written back.
+std::vector<uint16_t> LMS7002M::ReadConfigRegisters(const std::vector<uint16_t>& addresses)
+{
+    std::vector<uint16_t> values(addresses.size(), 0);
+    for (std::size_t i = 0; i < addresses.size(); ++i)
+    {
+        if (addresses[i] >= 0x5C3 && addresses[i] <= 0x5CA)
+            SPI_write(addresses[i], 0x4000); //perform read-back from DAC
+        values[i] = Get_SPI_Reg_bits(addresses[i], 15, 0, false);
+
+        //registers 0x5C3 - 0x53A return inverted value field when DAC value read-back is performed
+        if (addresses[i] >= 0x5C3 && addresses[i] <= 0x5C6 && (values[i] & 0x400)) //sign bit 10
+            values[i] = 0x400 | (~values[i] & 0x3FF); //magnitude bits  9:0
+        else if (addresses[i] >= 0x5C7 && addresses[i] <= 0x5CA && (values[i] & 0x40)) //sign bit 6
+            values[i] = 0x40 | (~values[i] & 0x3F); //magnitude bits  5:0
+        else if (addresses[i] == 0x5C2)
+            values[i] &= 0xFF00; //do not save calibration start triggers
+    }
+    return values;
+}
+
+static void PutSnapshotValue(std::vector<uint8_t>& data, uint64_t value, int bytes)
+{
+    for (int i = 0; i < bytes; ++i)
+        data.push_back((value >> (8 * i)) & 0xFF);
+}
+
+static bool GetSnapshotValue(const std::vector<uint8_t>& data, std::size_t& offset, int bytes, uint64_t& value)
+{
+    if (offset + bytes > data.size())
+        return false;
+    value = 0;
+    for (int i = 0; i < bytes; ++i)
+        value |= static_cast<uint64_t>(data[offset + i]) << (8 * i);
+    offset += bytes;
+    return true;
+}
+
+OpStatus LMS7002M::SaveConfigSnapshot(const std::string& filename)
+{
+    ChannelScope scope(this);
+
+    std::vector<uint8_t> data(snapshotMagic, snapshotMagic + sizeof(snapshotMagic));
+    PutSnapshotValue(data, snapshotVersion, 2);
+    uint64_t referenceClock = 0;
+    const double referenceClock_Hz = GetReferenceClk_SX(TRXDir::Rx);
+    std::memcpy(&referenceClock, &referenceClock_Hz, sizeof(referenceClock));
+    PutSnapshotValue(data, referenceClock, 8);
+
+    for (Channel channel : { Channel::ChA, Channel::ChB })
+    {
+        SetActiveChannel(channel);
+        const std::vector<uint16_t> addresses = ConfigRegisterAddresses(channel);
+        const std::vector<uint16_t> values = ReadConfigRegisters(addresses);
+        PutSnapshotValue(data, addresses.size(), 2);
+        for (std::size_t i = 0; i < addresses.size(); ++i)
         {
-            TuneVCO(VCO_Module::VCO_CGEN);
-            if (mCallback_onCGENChange)
-                return mCallback_onCGENChange(mCallback_onCGENChange_userData);
+            PutSnapshotValue(data, addresses[i], 2);
+            PutSnapshotValue(data, values[i], 2);
         }
     }
-    SetActiveChannel(Channel::ChA);
+
+    std::ofstream fout(filename, std::ios::binary);
+    fout.write(reinterpret_cast<const char*>(data.data()), data.size());
+    if (!fout.good())
+        return ReportError(OpStatus::IOFailure, "SaveConfig(%s) - failed to write the file", filename.c_str());
     return OpStatus::Success;
 }
 
+OpStatus LMS7002M::LoadConfigSnapshot(const std::string& filename, bool tuneDynamicValues)
+{
+    std::ifstream f(filename, std::ios::binary);
+    const std::vector<uint8_t> data{ std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>() };
+    f.close();
+
+    std::size_t offset = sizeof(snapshotMagic);
+    uint64_t version = 0;
+    uint64_t referenceClock = 0;
+    if (!GetSnapshotValue(data, offset, 2, version) || version != snapshotVersion ||
+        !GetSnapshotValue(data, offset, 8, referenceClock))
+        return ReportError(OpStatus::InvalidValue, "LoadConfig(%s) - unsupported snapshot version", filename.c_str());
+    double referenceClock_Hz = 0;
+    std::memcpy(&referenceClock_Hz, &referenceClock, sizeof(referenceClock_Hz));
+
+    // Both of the register pages are uploaded in a single batch, the MAC writes switch between them.
+    std::vector<uint16_t> addrToWrite;
+    std::vector<uint16_t> dataToWrite;
+    uint16_t x0020_value = Get_SPI_Reg_bits(MAC.address, 15, 0, false);
+    for (Channel channel : { Channel::ChA, Channel::ChB })
+    {
+        uint64_t count = 0;
+        if (!GetSnapshotValue(data, offset, 2, count))
+            return ReportError(OpStatus::InvalidValue, "LoadConfig(%s) - truncated snapshot", filename.c_str());
+
+        addrToWrite.push_back(MAC.address);
+        dataToWrite.push_back((x0020_value & ~0x0003) | (channel == Channel::ChA ? 1 : 2));
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            uint64_t addr = 0;
+            uint64_t value = 0;
+            if (!GetSnapshotValue(data, offset, 2, addr) || !GetSnapshotValue(data, offset, 2, value))
+                return ReportError(OpStatus::InvalidValue, "LoadConfig(%s) - truncated snapshot", filename.c_str());
+
+            if (addr == MAC.address) //skip register containing channel selection
+            {
+                x0020_value = value;
+                continue;
+            }
+            if (addr >= 0x5C3 && addr <= 0x5CA) //enable analog DC correction
+            {
+                addrToWrite.push_back(addr);
+                dataToWrite.push_back(value & 0x3FFF);
+                addrToWrite.push_back(addr);
+                dataToWrite.push_back(value | 0x8000);
+            }
+            else
+            {
+                addrToWrite.push_back(addr);
+                dataToWrite.push_back(value);
+            }
+        }
+    }
+    addrToWrite.push_back(MAC.address);
+    dataToWrite.push_back(x0020_value);
+
+    // the saved VCO capacitor (CSW) values are only valid for the same reference clock
+    const bool sameReferenceClock = GetReferenceClk_SX(TRXDir::Rx) == referenceClock_Hz;
+
+    OpStatus status = SPI_write_batch(addrToWrite.data(), dataToWrite.data(), addrToWrite.size(), true);
+    if (status != OpStatus::Success && controlPort != nullptr)
+        return status;
+    SetReferenceClk_SX(TRXDir::Rx, referenceClock_Hz);
+    SetReferenceClk_SX(TRXDir::Tx, referenceClock_Hz);
+    ResetLogicRegisters();
+
+    if (tuneDynamicValues && !sameReferenceClock)
+        status = TuneDynamicValues();
+    else if (!Get_SPI_Reg_bits(LMS7002MCSR::PD_VCO_CGEN) && mCallback_onCGENChange)
+    {
+        // the interface clocks still have to follow the restored CGEN frequency
+        status = mCallback_onCGENChange(mCallback_onCGENChange_userData);
+    }
+    SetActiveChannel(Channel::ChA);
+    return status;
+}
+
 OpStatus LMS7002M::SaveConfig(const std::string& filename)
 {
+    const std::string_view extension{ snapshotExtension };
+    if (filename.size() >= extension.size() &&
+        std::string_view{ filename }.substr(filename.size() - extension.size()) == extension)
+        return SaveConfigSnapshot(filename);
+
     std::ofstream fout;
     fout.open(filename);
     fout << "[file_info]"sv << std::endl;
@@ -720,29 +907,12 @@ OpStatus LMS7002M::SaveConfig(const std::string& filename)
 
     ChannelScope scope(this);
 
-    std::vector<uint16_t> addrToRead;
-    for (const auto& memorySectionPair : MemorySectionAddresses)
-        for (uint16_t addr = memorySectionPair.second[0]; addr <= memorySectionPair.second[1]; ++addr)
-            addrToRead.push_back(addr);
-
-    std::vector<uint16_t> dataReceived;
-    dataReceived.resize(addrToRead.size(), 0);
-
     fout << "[lms7002_registers_a]"sv << std::endl;
     SetActiveChannel(Channel::ChA);
+    std::vector<uint16_t> addrToRead = ConfigRegisterAddresses(Channel::ChA);
+    std::vector<uint16_t> dataReceived = ReadConfigRegisters(addrToRead);
     for (uint16_t i = 0; i < addrToRead.size(); ++i)
     {
-        if (addrToRead[i] >= 0x5C3 && addrToRead[i] <= 0x5CA)
-            SPI_write(addrToRead[i], 0x4000); //perform read-back from DAC
-        dataReceived[i] = Get_SPI_Reg_bits(addrToRead[i], 15, 0, false);
-
-        //registers 0x5C3 - 0x53A return inverted value field when DAC value read-back is performed
-        if (addrToRead[i] >= 0x5C3 && addrToRead[i] <= 0x5C6 && (dataReceived[i] & 0x400)) //sign bit 10
-            dataReceived[i] = 0x400 | (~dataReceived[i] & 0x3FF); //magnitude bits  9:0
-        else if (addrToRead[i] >= 0x5C7 && addrToRead[i] <= 0x5CA && (dataReceived[i] & 0x40)) //sign bit 6
-            dataReceived[i] = 0x40 | (~dataReceived[i] & 0x3F); //magnitude bits  5:0
-        else if (addrToRead[i] == 0x5C2)
-            dataReceived[i] &= 0xFF00; //do not save calibration start triggers
         std::snprintf(addr, sizeof(addr), "0x%04X", addrToRead[i]);
         std::snprintf(value, sizeof(value), "0x%04X", dataReceived[i]);
         fout << addr << "="sv << value << std::endl;
@@ -756,17 +926,11 @@ OpStatus LMS7002M::SaveConfig(const std::string& filename)
     }
 
     fout << "[lms7002_registers_b]"sv << std::endl;
-    addrToRead.clear(); //add only B channel addresses
-    for (const auto& memorySectionPair : MemorySectionAddresses)
-        if (memorySectionPair.first != MemorySection::RSSI_DC_CALIBRATION)
-            for (uint16_t addr = memorySectionPair.second[0]; addr <= memorySectionPair.second[1]; ++addr)
-                if (addr >= 0x0100)
-                    addrToRead.push_back(addr);
-
     SetActiveChannel(Channel::ChB);
+    addrToRead = ConfigRegisterAddresses(Channel::ChB);
+    dataReceived = ReadConfigRegisters(addrToRead);
     for (uint16_t i = 0; i < addrToRead.size(); ++i)
     {
-        dataReceived[i] = Get_SPI_Reg_bits(addrToRead[i], 15, 0, false);
         std::snprintf(addr, sizeof(addr), "0x%04X", addrToRead[i]);
         std::snprintf(value, sizeof(value), "0x%04X", dataReceived[i]);
         fout << addr << "="sv << value << std::endl;
@@ -1297,6 +1461,7 @@ uint16_t LMS7002M::SPI_read(uint16_t address, bool fromChip, OpStatus* status)
 
 OpStatus LMS7002M::SPI_write_batch(const uint16_t* spiAddr, const uint16_t* spiData, uint16_t cnt, bool toChip)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlLock);
     toChip |= !useCache;
     int mac = mRegistersMap->GetValue(0, MAC.address) & 0x0003;
     std::vector<uint32_t> data;
@@ -1342,6 +1507,7 @@ OpStatus LMS7002M::SPI_write_batch(const uint16_t* spiAddr, const uint16_t* spiD
 
 OpStatus LMS7002M::SPI_read_batch(const uint16_t* spiAddr, uint16_t* spiData, uint16_t cnt)
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlLock);
     if (!controlPort)
     {
         return ReportError(OpStatus::IOFailure, "No device connected"s);
@@ -1626,6 +1792,7 @@ void LMS7002M::ModifyRegistersDefaults(const std::vector<std::pair<uint16_t, uin
 
 bool LMS7002M::IsSynced()
 {
+    std::lock_guard<std::recursive_mutex> lock(mControlLock);
     if (!controlPort)
         return false;
 
@@ -1896,6 +2063,105 @@ float_type LMS7002M::GetTemperature()
     return milliCelsius / 1e3;
 }
 
+OpStatus LMS7002M::StartTemperatureMeasurement()
+{
+    std::lock_guard<std::recursive_mutex> lock(mControlLock);
+    lime_Result result = lms7002m_calibrate_internal_adc(mC_impl, 32);
+    if (result != lime_Result_Success)
+        return ResultToStatus(result);
+    Modify_SPI_Reg_bits(RSSI_PD, 0);
+    Modify_SPI_Reg_bits(RSSI_RSSIMODE, 0);
+    if (!mTemperatureMeasurementStarted)
+        mTemperatureBiasMux = Get_SPI_Reg_bits(MUX_BIAS_OUT);
+    OpStatus status = Modify_SPI_Reg_bits(MUX_BIAS_OUT, 2);
+    if (status != OpStatus::Success)
+        return status;
+
+    // same settling time as lms7002m_get_temperature()
+    mTemperatureSettled = std::chrono::steady_clock::now() + std::chrono::milliseconds(250);
+    mTemperatureMeasurementStarted = true;
+    return OpStatus::Success;
+}
+
+OpStatus LMS7002M::ReadTelemetry(DeviceTelemetry::Module& telemetry)
+{
+    if (!controlPort)
+        return ReportError(OpStatus::IOFailure, "No device connected"s);
+
+    std::unique_lock<std::recursive_mutex> lock(mControlLock);
+    // the other threads can use the chip while the temperature sensor settles, and might restart the measurement
+    while (mTemperatureMeasurementStarted && std::chrono::steady_clock::now() < mTemperatureSettled)
+    {
+        const auto settled = mTemperatureSettled;
+        lock.unlock();
+        std::this_thread::sleep_until(settled);
+        lock.lock();
+    }
+    const bool readTemperature = mTemperatureMeasurementStarted;
+
+    // the writes only select the registers to read, and are restored to the cached values at the end
+    std::vector<uint32_t> mosi;
+    auto Write = [&mosi](uint16_t address, uint16_t value) {
+        mosi.push_back((1 << 31) | (static_cast<uint32_t>(address) << 16) | value);
+    };
+    auto Read = [&mosi](uint16_t address) {
+        mosi.push_back(address);
+        return mosi.size() - 1;
+    };
+
+    const uint16_t macRegister = mRegistersMap->GetValue(0, MAC.address);
+    const uint16_t captureMask = (1 << CAPTURE.msb) | (0x3 << CAPSEL.lsb);
+    std::array<std::size_t, 2> sxLockIndex{};
+    std::array<std::size_t, 2> rssiIndex{};
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        // channel A page selects SXR, channel B page selects SXT
+        // the RSSI is calculated continuously, capturing it does not need the wait of GetRSSI()
+        const uint16_t captureRegister = mRegistersMap->GetValue(ch, CAPTURE.address);
+        const uint16_t captureRSSI = captureRegister & ~captureMask;
+        if (ch > 0)
+            Write(CAPTURE.address, mRegistersMap->GetValue(ch - 1, CAPTURE.address));
+        Write(MAC.address, (macRegister & ~0x3) | (ch + 1));
+        Write(CAPTURE.address, captureRSSI);
+        Write(CAPTURE.address, captureRSSI | (1 << CAPTURE.msb));
+        sxLockIndex[ch] = Read(VCO_CMPHO.address);
+        rssiIndex[ch] = Read(0x040E);
+        Read(0x040F);
+    }
+    Write(CAPTURE.address, mRegistersMap->GetValue(1, CAPTURE.address));
+    Write(MAC.address, macRegister);
+    const std::size_t cgenLockIndex = Read(VCO_CMPHO_CGEN.address);
+    std::size_t temperatureIndex = 0;
+    const uint16_t biasRegister = (mRegistersMap->GetValue(0, MUX_BIAS_OUT.address) & ~(0x3 << MUX_BIAS_OUT.lsb)) |
+                                  (mTemperatureBiasMux << MUX_BIAS_OUT.lsb);
+    if (readTemperature)
+    {
+        temperatureIndex = Read(0x0606);
+        Write(MUX_BIAS_OUT.address, biasRegister);
+    }
+
+    std::vector<uint32_t> miso(mosi.size(), 0);
+    OpStatus status = controlPort->SPI(mosi.data(), miso.data(), mosi.size());
+    if (readTemperature)
+    {
+        mRegistersMap->SetValue(0, MUX_BIAS_OUT.address, biasRegister);
+        mTemperatureMeasurementStarted = false;
+    }
+    if (status != OpStatus::Success)
+        return status;
+
+    auto IsLocked = [](uint32_t value) { return ((value >> 12) & 0x3) == 0x2; };
+    telemetry.cgenLocked = IsLocked(miso[cgenLockIndex]);
+    telemetry.rssi.resize(2);
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        telemetry.sxLocked[ch] = IsLocked(miso[sxLockIndex[ch]]);
+        telemetry.rssi[ch] = ((miso[rssiIndex[ch] + 1] & 0xFFFF) << 2) | (miso[rssiIndex[ch]] & 0x3);
+    }
+    telemetry.temperature = readTemperature ? lms7002m_convert_temperature(miso[temperatureIndex]) / 1e3 : NAN;
+    return OpStatus::Success;
+}
+
 OpStatus LMS7002M::CopyChannelRegisters(const Channel src, const Channel dest, const bool copySX)
 {
     ChannelScope scope(this);
@@ -0,0 +1,312 @@
+#define _USE_MATH_DEFINES
+#include "SimulatedDMA.h"
+
+#include "limesuiteng/complex.h"
+#include "protocols/BufferInterleaving.h"
+#include "protocols/DataPacket.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+using namespace std::literals::string_literals;
+
+namespace lime {
+
+static constexpr int bufferCount = 64;
+static constexpr int bufferSize = 65536;
+static constexpr int maxPayloadSize = 4080;
+// period of the Rx test tone, divides all the possible samples counts in packet,
+// so every packet payload can be identical, while the signal stays continuous
+static constexpr int tonePeriod = 5;
+static constexpr uint8_t waveformLoadFlag = 1 << 5;
+
+/// @brief Constructs the simulated DMA.
+/// @param dir The data transfer direction to simulate.
+/// @param rxClock The Rx direction providing the current timestamp, to validate Tx packets against (Tx only).
+SimulatedDMA::SimulatedDMA(DataTransferDirection dir, std::shared_ptr<SimulatedDMA> rxClock)
+    : mRxClock(rxClock)
+    , mDir(dir)
+    , mLinkFormat(DataFormat::I12)
+    , mChannelCount(1)
+    , mSampleRate(0)
+    , mFrameSize(3)
+    , mPacketSize(0)
+    , mSamplesInPacket(0)
+    , mPacketsInBuffer(1)
+    , mEnabled(false)
+    , mCompleted(0)
+    , mReleased(0)
+    , mNextTimestamp(0)
+    , mOverflows(0)
+    , mTxDropped(false)
+    , mTxNextTimestamp(-1)
+    , mTxPackets(0)
+    , mTxSamples(0)
+    , mTxLate(0)
+    , mTxDiscontinuities(0)
+    , mWaveformLoading(false)
+{
+    mappings.resize(bufferCount);
+    for (auto& memoryBlock : mappings)
+    {
+        memoryBlock.size = bufferSize;
+        memoryBlock.buffer = new uint8_t[memoryBlock.size];
+        std::memset(memoryBlock.buffer, 0, memoryBlock.size);
+    }
+}
+
+SimulatedDMA::~SimulatedDMA()
+{
+    for (auto& memoryBlock : mappings)
+        delete[] memoryBlock.buffer;
+}
+
+OpStatus SimulatedDMA::Initialize()
+{
+    return OpStatus::Success;
+}
+
+/// @brief Sets the samples format the simulated FPGA is configured with.
+/// @param linkFormat The samples format used in the packets.
+/// @param channelCount The amount of channels interleaved in the packets.
+/// @param sampleRate The rate at which Rx samples are produced (0 - as fast as they are consumed).
+void SimulatedDMA::SetStreamFormat(DataFormat linkFormat, uint8_t channelCount, double sampleRate)
+{
+    mLinkFormat = linkFormat;
+    mChannelCount = std::max<uint8_t>(channelCount, 1);
+    mSampleRate = sampleRate;
+    mFrameSize = (linkFormat == DataFormat::I16 ? 4 : 3) * mChannelCount;
+    mSamplesInPacket = maxPayloadSize / mFrameSize;
+    mPacketSize = sizeof(StreamHeader) + mSamplesInPacket * mFrameSize;
+}
+
+std::vector<IDMA::Buffer> SimulatedDMA::GetBuffers() const
+{
+    return mappings;
+}
+
+std::string SimulatedDMA::GetName() const
+{
+    return "sim"s;
+}
+
+OpStatus SimulatedDMA::Enable(bool enable)
+{
+    if (!enable)
+    {
+        mEnabled.store(false, std::memory_order_relaxed);
+        return OpStatus::Success;
+    }
+
+    mCompleted.store(0, std::memory_order_relaxed);
+    mReleased.store(0, std::memory_order_relaxed);
+    mTxNextTimestamp = -1;
+    mWaveformLoading = false;
+    if (mDir == DataTransferDirection::DeviceToHost)
+    {
+        mNextTimestamp.store(0, std::memory_order_relaxed);
+        mOverflows.store(0, std::memory_order_relaxed);
+        mTxDropped.store(false, std::memory_order_relaxed);
+    }
+    else
+    {
+        mTxPackets.store(0, std::memory_order_relaxed);
+        mTxSamples.store(0, std::memory_order_relaxed);
+        mTxLate.store(0, std::memory_order_relaxed);
+        mTxDiscontinuities.store(0, std::memory_order_relaxed);
+    }
+    mStartTime = std::chrono::steady_clock::now();
+    mEnabled.store(true, std::memory_order_release);
+    return OpStatus::Success;
+}
+
+OpStatus SimulatedDMA::EnableContinuous(bool enable, uint32_t maxTransferSize, uint8_t irqPeriod)
+{
+    if (enable && mDir == DataTransferDirection::DeviceToHost)
+    {
+        if (mPacketSize == 0)
+            SetStreamFormat(mLinkFormat, mChannelCount, mSampleRate);
+        const uint32_t transferSize = std::min<uint32_t>(maxTransferSize, bufferSize);
+        mPacketsInBuffer = std::max<uint32_t>(transferSize / mPacketSize, 1);
+        FillPayloadPattern(mPacketsInBuffer);
+    }
+    return Enable(enable);
+}
+
+void SimulatedDMA::FillPayloadPattern(uint32_t packetsInBuffer)
+{
+    std::vector<complex32f_t> tone(mSamplesInPacket);
+    for (uint32_t i = 0; i < mSamplesInPacket; ++i)
+    {
+        const float phase = 2 * M_PI * (i % tonePeriod) / tonePeriod;
+        tone[i] = complex32f_t(0.7 * std::cos(phase), 0.7 * std::sin(phase));
+    }
+    const void* src[2] = { tone.data(), tone.data() };
+    DataConversion conversion{ DataFormat::F32, mLinkFormat, mChannelCount };
+
+    for (auto& memoryBlock : mappings)
+    {
+        for (uint32_t i = 0; i < packetsInBuffer; ++i)
+        {
+            uint8_t* packet = memoryBlock.buffer + i * mPacketSize;
+            StreamHeader* header = reinterpret_cast<StreamHeader*>(packet);
+            header->Clear();
+            header->SetPayloadSize(Interleave(packet + sizeof(StreamHeader), src, mSamplesInPacket, conversion));
+        }
+    }
+}
+
+/// @brief Fills the free buffers with the Rx packets that are due according to the sample rate.
+void SimulatedDMA::Produce()
+{
+    if (!mEnabled.load(std::memory_order_acquire))
+        return;
+
+    const int64_t batchSamples = static_cast<int64_t>(mSamplesInPacket) * mPacketsInBuffer;
+    int64_t timestamp = mNextTimestamp.load(std::memory_order_relaxed);
+    int64_t target = INT64_MAX;
+    if (mSampleRate > 0)
+    {
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - mStartTime;
+        target = elapsed.count() * mSampleRate;
+    }
+
+    while (timestamp + batchSamples <= target)
+    {
+        const uint64_t completed = mCompleted.load(std::memory_order_relaxed);
+        if (completed - mReleased.load(std::memory_order_acquire) >= mappings.size())
+        {
+            if (target == INT64_MAX)
+                break;
+            // host is not keeping up, FPGA drops whatever does not fit into the buffers
+            const int64_t droppedBatches = (target - timestamp) / batchSamples;
+            timestamp += droppedBatches * batchSamples;
+            mOverflows.fetch_add(droppedBatches, std::memory_order_relaxed);
+            break;
+        }
+
+        uint8_t* buffer = mappings[completed % mappings.size()].buffer;
+        for (uint32_t i = 0; i < mPacketsInBuffer; ++i)
+        {
+            StreamHeader* header = reinterpret_cast<StreamHeader*>(buffer + i * mPacketSize);
+            // FPGA reports dropped Tx packets in the Rx packets header
+            header->header0 = mTxDropped.exchange(false, std::memory_order_relaxed) ? (1 << 3) : 0;
+            header->counter = timestamp;
+            timestamp += mSamplesInPacket;
+        }
+        mCompleted.store(completed + 1, std::memory_order_release);
+    }
+    mNextTimestamp.store(timestamp, std::memory_order_relaxed);
+}
+
+/// @brief Validates the Tx packets of a submitted transfer.
+void SimulatedDMA::Consume(const uint8_t* data, uint32_t size)
+{
+    const int64_t rxNow = mRxClock ? mRxClock->GetTimestamp() : -1;
+    uint32_t offset = 0;
+    while (offset + sizeof(StreamHeader) <= size)
+    {
+        const StreamHeader* header = reinterpret_cast<const StreamHeader*>(data + offset);
+        if (header->reserved[0] & waveformLoadFlag)
+        {
+            // waveform loading packets carry the payload size in the reserved bytes
+            const uint32_t payloadSize = std::min<uint32_t>(
+                header->reserved[1] | (header->reserved[2] << 8), size - offset - sizeof(StreamHeader));
+            if (!mWaveformLoading)
+                mWaveform.clear();
+            mWaveformLoading = true;
+            const uint8_t* payload = data + offset + sizeof(StreamHeader);
+            mWaveform.insert(mWaveform.end(), payload, payload + payloadSize);
+            offset += sizeof(StreamHeader) + payloadSize;
+            continue;
+        }
+
+        uint32_t payloadSize = header->GetPayloadSize();
+        if (payloadSize == 0)
+            payloadSize = maxPayloadSize;
+        payloadSize = std::min<uint32_t>(payloadSize, size - offset - sizeof(StreamHeader));
+        const uint32_t samplesCount = payloadSize / mFrameSize;
+
+        if (!header->getIgnoreTimestamp())
+        {
+            if (mTxNextTimestamp >= 0 && header->counter < mTxNextTimestamp)
+                mTxDiscontinuities.fetch_add(1, std::memory_order_relaxed);
+            if (header->counter < rxNow)
+            {
+                mTxLate.fetch_add(1, std::memory_order_relaxed);
+                mRxClock->mTxDropped.store(true, std::memory_order_relaxed);
+            }
+            mTxNextTimestamp = header->counter + samplesCount;
+        }
+
+        mTxPackets.fetch_add(1, std::memory_order_relaxed);
+        mTxSamples.fetch_add(samplesCount, std::memory_order_relaxed);
+        offset += sizeof(StreamHeader) + payloadSize;
+    }
+}
+
+SimulatedDMA::State SimulatedDMA::GetCounters()
+{
+    if (mDir == DataTransferDirection::DeviceToHost)
+        Produce();
+    return { mCompleted.load(std::memory_order_acquire) & 0xFFFF };
+}
+
+OpStatus SimulatedDMA::SubmitRequest(uint64_t index, uint32_t bytesCount, DataTransferDirection dir, bool irq)
+{
+    if (!mEnabled.load(std::memory_order_acquire))
+        return OpStatus::Error;
+    if (index >= mappings.size() || bytesCount > mappings[index].size)
+        return OpStatus::OutOfRange;
+
+    if (mDir == DataTransferDirection::DeviceToHost)
+    {
+        // buffer is given back to the device for filling
+        mReleased.fetch_add(1, std::memory_order_release);
+        return OpStatus::Success;
+    }
+
+    // the device consumes the data immediately
+    Consume(mappings[index].buffer, bytesCount);
+    mCompleted.fetch_add(1, std::memory_order_release);
+    return OpStatus::Success;
+}
+
+OpStatus SimulatedDMA::Wait()
+{
+    if (mDir == DataTransferDirection::HostToDevice || mSampleRate <= 0)
+        return OpStatus::Success;
+    if (mCompleted.load(std::memory_order_acquire) - mReleased.load(std::memory_order_acquire) > 0)
+        return OpStatus::Success;
+
+    // sleep until the next Rx transfer is due
+    const int64_t batchSamples = static_cast<int64_t>(mSamplesInPacket) * mPacketsInBuffer;
+    const double dueTime = (mNextTimestamp.load(std::memory_order_relaxed) + batchSamples) / mSampleRate;
+    const auto due = mStartTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                      std::chrono::duration<double>(dueTime));
+    const auto timeoutLimit = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    std::this_thread::sleep_until(std::min(due, timeoutLimit));
+    return OpStatus::Success;
+}
+
+void SimulatedDMA::BufferOwnership(uint16_t index, DataTransferDirection dir)
+{
+    // simulated buffers are plain host memory, nothing to flush
+}
+
+/// @brief Gets the statistics of the Tx packets consumed since the last enable.
+/// @return The Tx statistics.
+SimulatedDMA::TxStats SimulatedDMA::GetTxStats() const
+{
+    TxStats stats;
+    stats.packets = mTxPackets.load(std::memory_order_relaxed);
+    stats.samples = mTxSamples.load(std::memory_order_relaxed);
+    stats.late = mTxLate.load(std::memory_order_relaxed);
+    stats.discontinuities = mTxDiscontinuities.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace lime
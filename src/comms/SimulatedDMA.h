@@ -0,0 +1,104 @@
+#ifndef LIME_SIMULATEDDMA_H
+#define LIME_SIMULATEDDMA_H
+
+#include "comms/IDMA.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace lime {
+
+/**
+  @brief DMA interface simulating the FPGA side of samples streaming, without any hardware.
+
+  In DeviceToHost direction it produces FPGA Rx packets with valid headers and continuous timestamps,
+  paced by the configured sample rate (or as fast as they are consumed, if the sample rate is 0).
+  If the host does not release the buffers in time, the data is dropped as the FPGA would do.
+  In HostToDevice direction it consumes FPGA Tx packets and checks their timestamps against
+  the timestamps of the paired Rx direction. Late packets are flagged in the Rx packets headers.
+  Waveform loading packets are collected into a simulated waveform memory instead.
+ */
+class SimulatedDMA : public IDMA
+{
+  public:
+    /// @brief Statistics of the consumed Tx packets.
+    struct TxStats {
+        uint64_t packets; ///< The amount of consumed packets.
+        uint64_t samples; ///< The amount of consumed samples.
+        uint64_t late; ///< The amount of packets which timestamps were already in the past.
+        uint64_t discontinuities; ///< The amount of packets which timestamps overlapped the previous packet.
+    };
+
+    SimulatedDMA(DataTransferDirection dir, std::shared_ptr<SimulatedDMA> rxClock = nullptr);
+    ~SimulatedDMA();
+
+    OpStatus Initialize() override;
+    OpStatus Enable(bool enabled) override;
+    OpStatus EnableContinuous(bool enabled, uint32_t maxTransferSize, uint8_t irqPeriod) override;
+
+    State GetCounters() override;
+    OpStatus SubmitRequest(uint64_t index, uint32_t bytesCount, DataTransferDirection dir, bool irq) override;
+
+    OpStatus Wait() override;
+    void BufferOwnership(uint16_t index, DataTransferDirection dir) override;
+
+    std::vector<IDMA::Buffer> GetBuffers() const override;
+    std::string GetName() const override;
+
+    void SetStreamFormat(DataFormat linkFormat, uint8_t channelCount, double sampleRate);
+
+    /// @brief Gets the timestamp of the next sample to be produced by the Rx direction.
+    /// @return The current simulated hardware timestamp.
+    inline int64_t GetTimestamp() const { return mNextTimestamp.load(std::memory_order_relaxed); }
+
+    TxStats GetTxStats() const;
+
+    /// @brief Gets the amount of Rx transfers dropped, because the host did not release buffers in time.
+    /// @return The amount of dropped transfers.
+    inline uint64_t GetOverflowCount() const { return mOverflows.load(std::memory_order_relaxed); }
+
+    /// @brief Gets the waveform memory, as loaded by the last waveform upload.
+    /// @return The payloads of the received waveform loading packets.
+    const std::vector<uint8_t>& GetWaveform() const { return mWaveform; }
+
+  private:
+    void Produce();
+    void Consume(const uint8_t* data, uint32_t size);
+    void FillPayloadPattern(uint32_t packetsInBuffer);
+
+    std::vector<Buffer> mappings;
+    std::shared_ptr<SimulatedDMA> mRxClock;
+    DataTransferDirection mDir;
+
+    DataFormat mLinkFormat;
+    uint8_t mChannelCount;
+    double mSampleRate;
+    uint32_t mFrameSize;
+    uint32_t mPacketSize;
+    uint32_t mSamplesInPacket;
+    uint32_t mPacketsInBuffer;
+
+    std::atomic<bool> mEnabled;
+    std::chrono::steady_clock::time_point mStartTime;
+    std::atomic<uint64_t> mCompleted;
+    std::atomic<uint64_t> mReleased;
+    std::atomic<int64_t> mNextTimestamp;
+    std::atomic<uint64_t> mOverflows;
+    std::atomic<bool> mTxDropped;
+
+    int64_t mTxNextTimestamp;
+    std::atomic<uint64_t> mTxPackets;
+    std::atomic<uint64_t> mTxSamples;
+    std::atomic<uint64_t> mTxLate;
+    std::atomic<uint64_t> mTxDiscontinuities;
+
+    std::vector<uint8_t> mWaveform;
+    bool mWaveformLoading;
+};
+
+} // namespace lime
+
+#endif // LIME_SIMULATEDDMA_H
@@ -2,6 +2,7 @@
 
 #include <thread>
 #include <cassert>
+#include <mutex>
 
 #ifdef __unix__
     #ifdef __GNUC__
@@ -21,8 +22,10 @@ using namespace std::literals::string_literals;
 namespace lime {
 
 static libusb_context* gContextLibUsb{ nullptr };
-static int activeUSBconnections = 0;
+static std::atomic<int> activeUSBconnections{ 0 };
 static std::thread gUSBProcessingThread; // single thread for processing USB callbacks
+// The sessions can be started and ended from multiple threads, the first and the last one set up and clean up the library.
+static std::mutex gSessionMutex;
 
 static void HandleLibusbEvents(libusb_context* context)
 {
@@ -40,6 +43,7 @@ static void HandleLibusbEvents(libusb_context* context)
 
 static int SessionRefCountIncrement()
 {
+    std::lock_guard<std::mutex> lock(gSessionMutex);
     ++activeUSBconnections;
     if (activeUSBconnections == 1)
     {
@@ -62,6 +66,7 @@ static int SessionRefCountIncrement()
 
 static int SessionRefCountDecrement()
 {
+    std::lock_guard<std::mutex> lock(gSessionMutex);
     --activeUSBconnections;
     if (activeUSBconnections == 0 && gUSBProcessingThread.joinable())
     {
@@ -384,6 +389,55 @@ void UnixUsb::FreeAsyncContext(void* context)
     delete reinterpret_cast<AsyncContext*>(context);
 }
 
+static int LIBUSB_CALL OnHotplugEvent(libusb_context* context, libusb_device* device, libusb_hotplug_event event, void* userData)
+{
+    const auto& onChange = *static_cast<const std::function<void()>*>(userData);
+    onChange();
+    return 0; // keeps the callback registered
+}
+
+UnixUsbHotplugWatch::UnixUsbHotplugWatch(const std::set<IUSB::VendorProductId>& ids, std::function<void()> onChange)
+    : mOnChange(onChange)
+{
+    // the events are delivered by the USB processing thread of the session
+    SessionRefCountIncrement();
+    if (!gContextLibUsb || !libusb_has_capability(LIBUSB_CAP_HAS_HOTPLUG))
+        return;
+
+    for (const auto& id : ids)
+    {
+        libusb_hotplug_callback_handle handle{};
+        int returnCode = libusb_hotplug_register_callback(gContextLibUsb,
+            static_cast<libusb_hotplug_event>(LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED | LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT),
+            static_cast<libusb_hotplug_flag>(0),
+            id.vendorId,
+            id.productId,
+            LIBUSB_HOTPLUG_MATCH_ANY,
+            OnHotplugEvent,
+            &mOnChange,
+            &handle);
+        if (returnCode != LIBUSB_SUCCESS)
+        {
+            lime::warning("libusb: failed to register hotplug callback: %s", libusb_strerror(libusb_error(returnCode)));
+            continue;
+        }
+        mHandles.push_back(handle);
+    }
+}
+
+UnixUsbHotplugWatch::~UnixUsbHotplugWatch()
+{
+    // no callback is running or called after the deregistration returns
+    for (int handle : mHandles)
+        libusb_hotplug_deregister_callback(gContextLibUsb, handle);
+    SessionRefCountDecrement();
+}
+
+bool UnixUsbHotplugWatch::IsWatching() const
+{
+    return !mHandles.empty();
+}
+
 OpStatus UnixUsb::ClaimInterface(int32_t interface_number)
 {
     assert(dev_handle);
@@ -3,6 +3,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <mutex>
 
 struct libusb_device_handle;
@@ -63,4 +64,25 @@ class UnixUsb : IUSB
     };
 };
 
+/// @brief Calls a function whenever one of the given USB devices is attached or detached, using the libusb hotplug events.
+class UnixUsbHotplugWatch
+{
+  public:
+    /// @brief Starts watching the devices.
+    /// @param ids The vendor and product IDs of the devices to watch.
+    /// @param onChange The function to call, from the USB processing thread, so it must not block.
+    UnixUsbHotplugWatch(const std::set<IUSB::VendorProductId>& ids, std::function<void()> onChange);
+    UnixUsbHotplugWatch(const UnixUsbHotplugWatch&) = delete;
+    UnixUsbHotplugWatch& operator=(const UnixUsbHotplugWatch&) = delete;
+    ~UnixUsbHotplugWatch();
+
+    /// @brief Gets whether the changes are reported, libusb does not support the hotplug events on all platforms.
+    /// @return True if the watched devices report their changes.
+    bool IsWatching() const;
+
+  private:
+    std::function<void()> mOnChange;
+    std::vector<int> mHandles;
+};
+
 } // namespace lime
@@ -1047,7 +1047,9 @@ typedef struct {
     enum {
         LMS_FMT_F32 = 0, ///<32-bit floating point
         LMS_FMT_I16, ///<16-bit integers
-        LMS_FMT_I12 ///<12-bit integers stored in 16-bit variables
+        LMS_FMT_I12, ///<12-bit integers stored in 16-bit variables
+        LMS_FMT_I8, ///<8-bit integers
+        LMS_FMT_F16 ///<16-bit floating point
     } dataFmt;
 
     //! Data link format
@@ -1,6 +1,8 @@
 #ifndef LIME_DEVICES_REGISTRY_H
 #define LIME_DEVICES_REGISTRY_H
 
+#include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -52,6 +54,43 @@ class LIME_API DeviceRegistry
      * \return The list of available registry modules.
      */
     static std::vector<std::string> moduleNames(void);
+
+    /*!
+     * Probes all of the connection types concurrently, and updates the enumeration cache if it is enabled.
+     * \return A list of handles which can be used to make a connection
+     */
+    static std::vector<DeviceHandle> rescan();
+
+    /*!
+     * Enables or disables the enumeration cache.
+     * While enabled, enumerate() returns the cached handles without probing the connections,
+     * and a background thread rescans the devices whenever the USB or PCIe devices of the system change.
+     * The entries that can watch their devices (see DeviceRegistryEntry::startWatching()) report the changes as they happen,
+     * the rest are found by polling.
+     * \param enable Whether to use the cache.
+     * \param pollPeriod_ms How often to check the system for added or removed devices.
+     */
+    static void enableCache(bool enable, uint32_t pollPeriod_ms = 1000);
+
+    /*!
+     * The definition of a function to call when a device is added or removed.
+     * Called from the cache's background thread, only while the cache is enabled.
+     * The callback may disable the cache.
+     */
+    typedef std::function<void(const DeviceHandle& handle, bool connected)> HotplugCallback;
+
+    /*!
+     * Registers a function to call when a device is added or removed.
+     * \param callback The function to call.
+     * \return The identifier to remove the callback with.
+     */
+    static int addHotplugCallback(HotplugCallback callback);
+
+    /*!
+     * Removes a function registered with addHotplugCallback().
+     * \param id The identifier of the callback.
+     */
+    static void removeHotplugCallback(int id);
 };
 
 /*******************************************************************
@@ -98,6 +137,17 @@ class LIME_API DeviceRegistryEntry
      */
     virtual SDRDevice* make(const DeviceHandle& handle) = 0;
 
+    /*!
+     * Starts watching for the devices of this entry being connected or disconnected.
+     * The default implementation does not watch, the changes are then found by polling.
+     * \param onChange The function to call when the devices might have changed, it must not block.
+     * \return Whether the entry reports the changes.
+     */
+    virtual bool startWatching(std::function<void()> onChange);
+
+    //! Stops watching for the device changes, started with startWatching().
+    virtual void stopWatching();
+
   private:
     std::string _name;
 };
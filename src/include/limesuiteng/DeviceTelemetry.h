@@ -0,0 +1,84 @@
+#ifndef LIME_DEVICETELEMETRY_H
+#define LIME_DEVICETELEMETRY_H
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "limesuiteng/config.h"
+#include "limesuiteng/OpStatus.h"
+
+namespace lime {
+
+class SDRDevice;
+
+/// @brief The health values of all of the modules of a device, gathered at one point in time.
+struct LIME_API DeviceTelemetry {
+    /// @brief The health values of a single module (RF chip).
+    struct Module {
+        OpStatus status{ OpStatus::Success }; ///< The status of reading the values of the module.
+        double temperature{ 0 }; ///< The temperature of the chip (in degrees Celsius), NaN when it was not measured.
+        bool cgenLocked{ false }; ///< Whether the VCO comparators of the clock generator are locked.
+        std::array<bool, 2> sxLocked{}; ///< Whether the LO synthesizers are locked, indexed by TRXDir.
+        std::vector<uint32_t> rssi; ///< The received signal strength indicator of each of the receiver channels.
+    };
+
+    std::chrono::system_clock::time_point timestamp; ///< The time when the values were read.
+    std::vector<Module> modules; ///< The values of each of the modules of the device.
+};
+
+/// @brief The definition of a function to call when a new telemetry sample is gathered.
+typedef std::function<void(const DeviceTelemetry&)> TelemetryCallback;
+
+/// @brief Gathers the telemetry of a device periodically in a background thread.
+/// The device has to outlive the sampler.
+class LIME_API TelemetrySampler
+{
+  public:
+    TelemetrySampler() = delete;
+
+    /// @brief Constructs the sampler and starts sampling.
+    /// @param device The device to gather the telemetry of.
+    /// @param period The period of gathering the telemetry.
+    /// @param temperaturePeriod The period of measuring the temperature, the samples in between
+    /// carry the last measured temperature. Zero measures it in every sample.
+    /// @param callback The function to call with each of the samples (optional).
+    TelemetrySampler(SDRDevice* device,
+        std::chrono::milliseconds period,
+        std::chrono::milliseconds temperaturePeriod = std::chrono::milliseconds(0),
+        TelemetryCallback callback = nullptr);
+    TelemetrySampler(const TelemetrySampler&) = delete;
+    TelemetrySampler& operator=(const TelemetrySampler&) = delete;
+
+    /// @brief Stops sampling.
+    ~TelemetrySampler();
+
+    /// @brief Gets the most recent sample.
+    /// @param telemetry The storage for the sample.
+    /// @return Whether any sample has been gathered yet.
+    bool GetLatest(DeviceTelemetry& telemetry) const;
+
+  private:
+    void SamplingLoop();
+
+    SDRDevice* mDevice;
+    std::chrono::milliseconds mPeriod;
+    std::chrono::milliseconds mTemperaturePeriod;
+    TelemetryCallback mCallback;
+
+    mutable std::mutex mLock;
+    std::condition_variable mStopRequested;
+    bool mStop;
+    bool mHasSample;
+    DeviceTelemetry mLatest;
+    std::thread mThread;
+};
+
+} // namespace lime
+
+#endif
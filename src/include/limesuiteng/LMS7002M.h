@@ -9,15 +9,18 @@
 
 #include "limesuiteng/types.h"
 #include "limesuiteng/config.h"
+#include "limesuiteng/DeviceTelemetry.h"
 #include "limesuiteng/OpStatus.h"
 #include "limesuiteng/LMS7002MCSR.h"
 
 #include <array>
+#include <chrono>
 #include <cstdarg>
 #include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <utility>
 #include <vector>
@@ -72,6 +75,14 @@ class LIME_API LMS7002M
      */
     std::shared_ptr<ISPI> GetConnection() const { return controlPort; }
 
+    /*!
+     * @brief Gets the lock serializing the accesses to the chip between threads.
+     * Single register accesses take it on their own. Hold it over a sequence of accesses that has to
+     * appear atomic to the other threads, and restore the active channel before releasing it.
+     * @return The control lock of the chip.
+     */
+    std::recursive_mutex& GetControlLock() { return mControlLock; }
+
     virtual ~LMS7002M();
 
     /*!
@@ -165,9 +176,15 @@ class LIME_API LMS7002M
      */
     OpStatus ResetLogicRegisters();
 
+    /// @brief The file name extension SaveConfig() writes binary snapshots for.
+    static constexpr const char* snapshotExtension = ".lms7snap";
+
     /*!
      * @brief Reads configuration file and uploads registers to chip
-     * @param filename Configuration source file
+     *
+     * Binary snapshots are uploaded in a single register batch, and the VCOs are only retuned
+     * if the reference clock differs from the one the snapshot was saved with.
+     * @param filename Configuration source file (INI text or binary snapshot)
      * @param tuneDynamicValues Whether to tune the dynamic values or not
      * @return The status of the operation
      */
@@ -175,7 +192,7 @@ class LIME_API LMS7002M
 
     /*!
      * @brief Reads all registers from chip and saves to file
-     * @param filename destination filename
+     * @param filename destination filename, a binary snapshot is written if it ends with snapshotExtension
      * @return The status of the operation
      */
     OpStatus SaveConfig(const std::string& filename);
@@ -789,6 +806,23 @@ class LIME_API LMS7002M
      */
     float_type GetTemperature();
 
+    /*!
+     * @brief Starts measuring the temperature, the result is read by the next ReadTelemetry().
+     * The sensor needs time to settle, starting the measurement on several chips
+     * before reading any of them lets them settle at the same time.
+     * @return The status of the operation
+     */
+    OpStatus StartTemperatureMeasurement();
+
+    /*!
+     * @brief Reads the VCO locks, the RSSI of both channels and the started temperature measurement
+     * in a single SPI transaction, the register configuration is left unchanged.
+     * Holds the control lock, except while waiting for the temperature sensor to settle.
+     * @param telemetry The storage for the values, the temperature is NaN if the measurement was not started.
+     * @return The status of the operation
+     */
+    OpStatus ReadTelemetry(DeviceTelemetry::Module& telemetry);
+
     /*!
      * @brief Batches multiple register writes into least amount of transactions
      * @param spiAddr spi register addresses to be written
@@ -925,10 +959,21 @@ class LIME_API LMS7002M
     std::shared_ptr<ISPI> controlPort;
     std::array<int, 2> opt_gain_tbb{};
     OpStatus LoadConfigLegacyFile(const std::string& filename);
+    OpStatus LoadConfigSnapshot(const std::string& filename, bool tuneDynamicValues);
+    OpStatus SaveConfigSnapshot(const std::string& filename);
+    OpStatus TuneDynamicValues();
+    std::vector<uint16_t> ConfigRegisterAddresses(Channel channel);
+    std::vector<uint16_t> ReadConfigRegisters(const std::vector<uint16_t>& addresses);
 
     int16_t ReadAnalogDC(const uint16_t addr);
     uint16_t GetRSSIDelayCounter();
 
+    bool mTemperatureMeasurementStarted;
+    uint16_t mTemperatureBiasMux; ///< The MUX_BIAS_OUT value to restore after the temperature measurement.
+    std::chrono::steady_clock::time_point mTemperatureSettled;
+
+    std::recursive_mutex mControlLock; ///< Serializes the chip accesses of the application and the background threads.
+
     lms7002m_context* mC_impl;
 };
 } // namespace lime
@@ -154,6 +154,14 @@ LIME_API int LimePlugin_Read_complex32f(
     LimePluginContext* context, lime::complex32f_t* const* samples, int nsamples, int port, lime::StreamMeta& meta);
 LIME_API int LimePlugin_Read_complex16(
     LimePluginContext* context, lime::complex16_t* const* samples, int nsamples, int port, lime::StreamMeta& meta);
+LIME_API int LimePlugin_Write_complex8(
+    LimePluginContext* context, const lime::complex8_t* const* samples, int nsamples, int port, lime::StreamMeta& meta);
+LIME_API int LimePlugin_Write_complex16f(
+    LimePluginContext* context, const lime::complex16f_t* const* samples, int nsamples, int port, lime::StreamMeta& meta);
+LIME_API int LimePlugin_Read_complex8(
+    LimePluginContext* context, lime::complex8_t* const* samples, int nsamples, int port, lime::StreamMeta& meta);
+LIME_API int LimePlugin_Read_complex16f(
+    LimePluginContext* context, lime::complex16f_t* const* samples, int nsamples, int port, lime::StreamMeta& meta);
 
 template<class T> void CopyCArrayToVector(std::vector<T>& vec, const T* arr, size_t count)
 {
@@ -38,6 +38,21 @@ typedef std::function<void(const LogLevel level, const std::string& message)> Lo
 LIME_API void registerLogHandler(const LogHandlerCString handler);
 LIME_API void registerLogHandler(const LogHandler handler);
 
+/*!
+ * Enable or disable asynchronous logging.
+ * When enabled, logging calls only queue the message and return immediately,
+ * the log handler is then called from a dedicated logging thread.
+ * If the queue is full, messages are dropped and counted.
+ * Disabling delivers all the queued messages before returning.
+ */
+LIME_API void enableAsyncLogging(bool enable);
+
+//! Block until all the queued log messages are delivered to the log handler.
+LIME_API void flushLog(void);
+
+//! Get the amount of log messages dropped because the asynchronous logging queue was full.
+LIME_API uint64_t GetDroppedLogMessagesCount(void);
+
 //! Get the error code to string + any optional message reported.
 LIME_API const char* GetLastErrorMessageCString(void);
 LIME_API const std::string& GetLastErrorMessage(void);
@@ -1,7 +1,14 @@
 #include "limesuiteng/SDRDevice.h"
+#include "limesuiteng/DeviceTelemetry.h"
+#include "limesuiteng/SDRDescriptor.h"
 #include "limesuiteng/StreamConfig.h"
 
 #include "limesuiteng/Logger.h"
+#include "limesuiteng/types.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 
 using namespace lime;
 using namespace std::literals::string_literals;
@@ -10,6 +17,37 @@ StreamConfig::Extras::Extras()
     : usePoll{ true }
     , negateQ{ false }
     , waitPPS{ false }
+    , rxHistoryDuration{ 0 }
+    , rxDither{ false }
+    , rxPowerMetering{ false }
+{
+}
+
+StreamConfig::Extras::FrequencyConversion::FrequencyConversion()
+    : rateRatio{ 1 }
+    , frequencyOffset{ 0, 0 }
+{
+}
+
+StreamConfig::Extras::Channelization::Channelization()
+    : channelCount{ 0 }
+    , decimation{ 0 }
+{
+}
+
+StreamConfig::Extras::GainControl::GainControl()
+    : enabled{ false }
+    , targetPower{ -20 }
+    , peakLimit{ -1 }
+    , hysteresis{ 3 }
+    , updatePeriod{ 0 }
+{
+}
+
+StreamConfig::Extras::ImpairmentCorrection::ImpairmentCorrection()
+    : dc{ false }
+    , iq{ false }
+    , timeConstant{ 0 }
 {
 }
 
@@ -35,7 +73,57 @@ StreamConfig::StreamConfig()
 
 SDRDevice::~SDRDevice(){};
 
-OpStatus SDRDevice::UploadTxWaveform(const StreamConfig& config, uint8_t moduleIndex, const void** samples, uint32_t count)
+OpStatus SDRDevice::UploadTxWaveform(
+    const StreamConfig& config, uint8_t moduleIndex, const void** samples, uint32_t count, UploadMemoryCallback callback)
+{
+    return OpStatus::NotImplemented;
+}
+
+uint32_t SDRDevice::StreamRx(uint8_t moduleIndex, lime::complex8_t* const* samples, uint32_t count, StreamMeta* meta)
+{
+    ReportError(OpStatus::NotImplemented, "I8 samples format not implemented"s);
+    return 0;
+}
+
+uint32_t SDRDevice::StreamRx(uint8_t moduleIndex, lime::complex16f_t* const* samples, uint32_t count, StreamMeta* meta)
+{
+    ReportError(OpStatus::NotImplemented, "F16 samples format not implemented"s);
+    return 0;
+}
+
+uint32_t SDRDevice::StreamTx(uint8_t moduleIndex, const lime::complex8_t* const* samples, uint32_t count, const StreamMeta* meta)
+{
+    ReportError(OpStatus::NotImplemented, "I8 samples format not implemented"s);
+    return 0;
+}
+
+uint32_t SDRDevice::StreamTx(uint8_t moduleIndex, const lime::complex16f_t* const* samples, uint32_t count, const StreamMeta* meta)
+{
+    ReportError(OpStatus::NotImplemented, "F16 samples format not implemented"s);
+    return 0;
+}
+
+OpStatus SDRDevice::StreamRxHistory(uint8_t moduleIndex, lime::complex32f_t* const* samples, uint64_t timestamp, uint32_t count)
+{
+    return OpStatus::NotImplemented;
+}
+
+OpStatus SDRDevice::StreamRxHistory(uint8_t moduleIndex, lime::complex16_t* const* samples, uint64_t timestamp, uint32_t count)
+{
+    return OpStatus::NotImplemented;
+}
+
+OpStatus SDRDevice::StreamRxHistory(uint8_t moduleIndex, lime::complex12_t* const* samples, uint64_t timestamp, uint32_t count)
+{
+    return OpStatus::NotImplemented;
+}
+
+OpStatus SDRDevice::StreamRxHistory(uint8_t moduleIndex, lime::complex8_t* const* samples, uint64_t timestamp, uint32_t count)
+{
+    return OpStatus::NotImplemented;
+}
+
+OpStatus SDRDevice::StreamRxHistory(uint8_t moduleIndex, lime::complex16f_t* const* samples, uint64_t timestamp, uint32_t count)
 {
     return OpStatus::NotImplemented;
 }
@@ -103,6 +191,103 @@ OpStatus SDRDevice::MemoryRead(std::shared_ptr<DataStorage> storage, Region regi
     return OpStatus::NotImplemented;
 }
 
+OpStatus SDRDevice::MemoryErase(std::shared_ptr<DataStorage> storage, Region region)
+{
+    return OpStatus::NotImplemented;
+}
+
+OpStatus SDRDevice::MemoryWriteIncremental(
+    std::shared_ptr<DataStorage> storage, Region region, const void* data, uint32_t sectorSize, UploadMemoryCallback callback)
+{
+    if (sectorSize == 0 || region.address < 0 || region.size < 0)
+        return ReportError(OpStatus::InvalidValue, "Invalid incremental memory write region"s);
+
+    const uint8_t* source = static_cast<const uint8_t*>(data);
+    const int64_t begin = region.address;
+    const int64_t end = begin + region.size;
+    const int64_t firstSector = begin - begin % sectorSize;
+    std::vector<uint8_t> sector(sectorSize);
+
+    // The part of the sector that is covered by the region.
+    auto Overlap = [&](int64_t sectorAddress) {
+        const int64_t from = std::max(begin, sectorAddress);
+        const int64_t to = std::min(end, sectorAddress + sectorSize);
+        return Region{ static_cast<int32_t>(from), static_cast<int32_t>(to - from) };
+    };
+
+    std::vector<int64_t> changedSectors;
+    std::size_t bytesCompared = 0;
+    if (callback && callback(bytesCompared, region.size, "bytes compared"s))
+        return OpStatus::Aborted;
+    for (int64_t address = firstSector; address < end; address += sectorSize)
+    {
+        const Region overlap = Overlap(address);
+        OpStatus status = MemoryRead(storage, overlap, sector.data());
+        if (status != OpStatus::Success)
+            return status;
+        if (std::memcmp(sector.data(), source + (overlap.address - begin), overlap.size) != 0)
+            changedSectors.push_back(address);
+        bytesCompared += overlap.size;
+        if (callback && callback(bytesCompared, region.size, "bytes compared"s))
+            return OpStatus::Aborted;
+    }
+
+    const std::size_t bytesToWrite = changedSectors.size() * sectorSize;
+    std::size_t bytesWritten = 0;
+    if (callback && callback(bytesWritten, bytesToWrite, "bytes written"s))
+        return OpStatus::Aborted;
+    for (int64_t address : changedSectors)
+    {
+        const Region sectorRegion{ static_cast<int32_t>(address), static_cast<int32_t>(sectorSize) };
+        const Region overlap = Overlap(address);
+        OpStatus status = OpStatus::Success;
+        // the erase clears the whole sector, so the contents outside of the region have to be written back
+        if (overlap.size != sectorRegion.size)
+            status = MemoryRead(storage, sectorRegion, sector.data());
+        if (status != OpStatus::Success)
+            return status;
+        std::memcpy(sector.data() + (overlap.address - address), source + (overlap.address - begin), overlap.size);
+
+        status = MemoryErase(storage, sectorRegion);
+        if (status != OpStatus::Success && status != OpStatus::NotImplemented)
+            return status;
+        status = MemoryWrite(storage, sectorRegion, sector.data());
+        if (status != OpStatus::Success)
+            return status;
+        bytesWritten += sectorSize;
+        if (callback && callback(bytesWritten, bytesToWrite, "bytes written"s))
+            return OpStatus::Aborted;
+    }
+    return OpStatus::Success;
+}
+
+OpStatus SDRDevice::GetTelemetry(DeviceTelemetry& telemetry, bool measureTemperature)
+{
+    // generic fallback, reads each of the values separately
+    telemetry.timestamp = std::chrono::system_clock::now();
+    telemetry.modules.clear();
+    OpStatus status = OpStatus::Success;
+    for (uint8_t i = 0; i < GetDescriptor().rfSOC.size(); ++i)
+    {
+        DeviceTelemetry::Module module;
+        module.temperature = NAN;
+        try
+        {
+            module.cgenLocked = GetCGENLocked(i);
+            module.sxLocked[static_cast<int>(TRXDir::Rx)] = GetSXLocked(i, TRXDir::Rx);
+            module.sxLocked[static_cast<int>(TRXDir::Tx)] = GetSXLocked(i, TRXDir::Tx);
+            if (measureTemperature)
+                module.temperature = GetTemperature(i);
+        } catch (const std::exception& e)
+        {
+            module.status = ReportError(OpStatus::Error, "Module %i telemetry: %s", i, e.what());
+            status = module.status;
+        }
+        telemetry.modules.push_back(module);
+    }
+    return status;
+}
+
 void SDRDevice::StreamStart(const std::vector<uint8_t>& moduleIndexes)
 {
     for (uint8_t i : moduleIndexes)
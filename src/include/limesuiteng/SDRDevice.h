@@ -23,6 +23,7 @@ struct StreamStats;
 struct DataStorage;
 struct Region;
 struct CustomParameterIO;
+struct DeviceTelemetry;
 class OEMTestReporter;
 
 enum class eMemoryDevice : uint8_t;
@@ -300,6 +301,13 @@ class LIME_API SDRDevice
     /// @return A value indicating whether the VCO comparators of the clock generator are locked or not.
     virtual bool GetSXLocked(uint8_t moduleIndex, TRXDir trx) = 0;
 
+    /// @brief Gathers the health values (temperature, VCO locks, RSSI) of all of the modules at once,
+    /// using as few control transactions as the device allows.
+    /// @param telemetry The storage for the gathered values.
+    /// @param measureTemperature Whether to measure the temperatures, which takes the longest.
+    /// @return The status of the operation, the status of each module is stored in the telemetry.
+    virtual OpStatus GetTelemetry(DeviceTelemetry& telemetry, bool measureTemperature = true);
+
     /// @brief Reads the value of the given register.
     /// @param moduleIndex The device index to read from.
     /// @param address The memory address to read from.
@@ -463,6 +471,26 @@ class LIME_API SDRDevice
     virtual uint32_t StreamRx(uint8_t moduleIndex, lime::complex16_t* const* samples, uint32_t count, StreamMeta* meta) = 0;
     /// @copydoc SDRDevice::StreamRx()
     virtual uint32_t StreamRx(uint8_t moduleIndex, lime::complex12_t* const* samples, uint32_t count, StreamMeta* meta) = 0;
+    /// @copydoc SDRDevice::StreamRx()
+    virtual uint32_t StreamRx(uint8_t moduleIndex, lime::complex8_t* const* samples, uint32_t count, StreamMeta* meta);
+    /// @copydoc SDRDevice::StreamRx()
+    virtual uint32_t StreamRx(uint8_t moduleIndex, lime::complex16f_t* const* samples, uint32_t count, StreamMeta* meta);
+
+    /// @brief Copies already received samples out of the Rx history buffer (see StreamConfig::Extras::rxHistoryDuration).
+    /// @param moduleIndex The index of the device to read the samples from.
+    /// @param samples The buffer to put the samples in.
+    /// @param timestamp The hardware timestamp of the first sample to copy.
+    /// @param count The amount of samples to copy.
+    /// @return OpStatus::Success if the whole time window was copied, OpStatus::OutOfRange if it's not retained.
+    virtual OpStatus StreamRxHistory(uint8_t moduleIndex, lime::complex32f_t* const* samples, uint64_t timestamp, uint32_t count);
+    /// @copydoc SDRDevice::StreamRxHistory()
+    virtual OpStatus StreamRxHistory(uint8_t moduleIndex, lime::complex16_t* const* samples, uint64_t timestamp, uint32_t count);
+    /// @copydoc SDRDevice::StreamRxHistory()
+    virtual OpStatus StreamRxHistory(uint8_t moduleIndex, lime::complex12_t* const* samples, uint64_t timestamp, uint32_t count);
+    /// @copydoc SDRDevice::StreamRxHistory()
+    virtual OpStatus StreamRxHistory(uint8_t moduleIndex, lime::complex8_t* const* samples, uint64_t timestamp, uint32_t count);
+    /// @copydoc SDRDevice::StreamRxHistory()
+    virtual OpStatus StreamRxHistory(uint8_t moduleIndex, lime::complex16f_t* const* samples, uint64_t timestamp, uint32_t count);
 
     /// @brief Transmits packets from all the active streams in the device.
     /// @param moduleIndex The index of the device to transmit the samples with.
@@ -478,6 +506,11 @@ class LIME_API SDRDevice
     /// @copydoc SDRDevice::StreamRx()
     virtual uint32_t StreamTx(
         uint8_t moduleIndex, const lime::complex12_t* const* samples, uint32_t count, const StreamMeta* meta) = 0;
+    /// @copydoc SDRDevice::StreamTx()
+    virtual uint32_t StreamTx(uint8_t moduleIndex, const lime::complex8_t* const* samples, uint32_t count, const StreamMeta* meta);
+    /// @copydoc SDRDevice::StreamTx()
+    virtual uint32_t StreamTx(
+        uint8_t moduleIndex, const lime::complex16f_t* const* samples, uint32_t count, const StreamMeta* meta);
 
     /// @brief Retrieves the current stream statistics.
     /// @param moduleIndex The index of the device to retrieve the status from.
@@ -485,13 +518,22 @@ class LIME_API SDRDevice
     /// @param tx The pointer (or nullptr if not needed) to store the transmit statistics to.
     virtual void StreamStatus(uint8_t moduleIndex, StreamStats* rx, StreamStats* tx) = 0;
 
+    /// @brief The definition of a function to call whenever memory is being uploaded.
+    /// Returning true aborts the upload.
+    typedef std::function<bool(std::size_t bsent, std::size_t btotal, const std::string&)> UploadMemoryCallback;
+
     /// @brief Uploads waveform to on board memory for later use.
     /// @param config The configuration of the stream.
     /// @param moduleIndex The index of the device to upload the waveform to.
     /// @param samples The samples to upload to the device.
     /// @param count The amount of samples to upload to the device.
+    /// @param callback The callback to call for progress updates (optional).
     /// @return Operation status.
-    virtual OpStatus UploadTxWaveform(const StreamConfig& config, uint8_t moduleIndex, const void** samples, uint32_t count);
+    virtual OpStatus UploadTxWaveform(const StreamConfig& config,
+        uint8_t moduleIndex,
+        const void** samples,
+        uint32_t count,
+        UploadMemoryCallback callback = nullptr);
 
     /// @copydoc ISPI::SPI()
     /// @param spiBusAddress The SPI address of the device to use.
@@ -541,9 +583,6 @@ class LIME_API SDRDevice
     /// @return The pointer to the internal device.
     virtual void* GetInternalChip(uint32_t index) = 0;
 
-    /// @brief The definition of a function to call whenever memory is being uploaded.
-    typedef std::function<bool(std::size_t bsent, std::size_t btotal, const std::string&)> UploadMemoryCallback;
-
     /// @brief Uploads the given memory into the specified device.
     /// @param device The memory device to upload the memory to.
     /// @param moduleIndex The index of the main device to upload the memory to.
@@ -568,6 +607,29 @@ class LIME_API SDRDevice
     /// @return The operation success state.
     virtual OpStatus MemoryRead(std::shared_ptr<DataStorage> storage, Region region, void* data);
 
+    /// @brief Erases the given region of a flash memory, the region has to consist of whole sectors.
+    /// Storages that erase the sectors as part of MemoryWrite() don't implement it.
+    /// @param storage The storage device to erase.
+    /// @param region Information of the region to erase.
+    /// @return The operation success state.
+    virtual OpStatus MemoryErase(std::shared_ptr<DataStorage> storage, Region region);
+
+    /// @brief Writes the given data into the memory, erasing and writing only the sectors whose contents differ.
+    /// Each of the sectors is read back and compared first, so reprogramming a mostly unchanged image only takes
+    /// a fraction of the full upload time. The parts of the first and last sectors outside the region are preserved.
+    /// The storage has to be accessible with MemoryRead() and MemoryWrite(), the region is in the addresses of the memory itself.
+    /// @param storage The storage device to write to.
+    /// @param region Information of the region in which to write the data to.
+    /// @param data The data to write into the specified memory.
+    /// @param sectorSize The erase sector size of the memory (in bytes).
+    /// @param callback The callback to call for the progress of the compare and then the write phase (optional).
+    /// @return The operation success state.
+    virtual OpStatus MemoryWriteIncremental(std::shared_ptr<DataStorage> storage,
+        Region region,
+        const void* data,
+        uint32_t sectorSize,
+        UploadMemoryCallback callback = nullptr);
+
     /// @brief Runs various device specific tests to check functionality
     /// @param reporter Object for handling test results callbacks
     /// @return The operation success state.
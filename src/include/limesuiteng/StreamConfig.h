@@ -4,8 +4,98 @@
 #include "limesuiteng/config.h"
 #include "limesuiteng/types.h"
 
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
 namespace lime {
 
+/**
+  @brief Log-linear histogram of durations (in nanoseconds).
+
+  Every power of two range is split into SUB_BINS bins, so the relative resolution is 25%
+  from a few nanoseconds up to several seconds. Recording a value is a handful of integer
+  operations and does not allocate, so it can be done from the streaming loops.
+ */
+struct DurationHistogram {
+    static constexpr int SUB_BINS_LOG2 = 2; ///< Log2 of the amount of bins per power of two range.
+    static constexpr int SUB_BINS = 1 << SUB_BINS_LOG2; ///< The amount of bins per power of two range.
+    static constexpr int BIN_COUNT = 128; ///< The total amount of bins.
+
+    uint64_t bins[BIN_COUNT]; ///< The amount of recorded values that fell into each bin.
+    uint64_t count; ///< The total amount of recorded values.
+    uint64_t total_ns; ///< The sum of all the recorded values.
+    uint64_t max_ns; ///< The largest recorded value.
+
+    /// @brief Gets the index of the bin the given value falls into.
+    /// @param ns The value to get the bin of.
+    /// @return The index of the bin.
+    static constexpr int BinIndex(uint64_t ns)
+    {
+        if (ns < SUB_BINS)
+            return static_cast<int>(ns);
+        int msb = 0;
+#if defined(__GNUC__) || defined(__clang__)
+        msb = 63 - __builtin_clzll(ns);
+#else
+        for (uint64_t v = ns >> 1; v; v >>= 1)
+            ++msb;
+#endif
+        const int mantissa = static_cast<int>(ns >> (msb - SUB_BINS_LOG2)) & (SUB_BINS - 1);
+        const int index = (msb - SUB_BINS_LOG2 + 1) * SUB_BINS + mantissa;
+        return index < BIN_COUNT ? index : BIN_COUNT - 1;
+    }
+
+    /// @brief Gets the smallest value that falls into the given bin.
+    /// @param index The index of the bin.
+    /// @return The lower bound of the bin (in nanoseconds).
+    static constexpr uint64_t BinLowerBound(int index)
+    {
+        if (index < SUB_BINS)
+            return index;
+        const int msb = index / SUB_BINS + SUB_BINS_LOG2 - 1;
+        return static_cast<uint64_t>(SUB_BINS + index % SUB_BINS) << (msb - SUB_BINS_LOG2);
+    }
+
+    /// @brief Records a single value.
+    /// @param ns The value to record (in nanoseconds).
+    inline void Add(uint64_t ns)
+    {
+        ++bins[BinIndex(ns)];
+        ++count;
+        total_ns += ns;
+        if (ns > max_ns)
+            max_ns = ns;
+    }
+
+    /// @brief Gets the average of the recorded values.
+    /// @return The mean value (in nanoseconds), 0 if nothing has been recorded.
+    constexpr double Mean() const { return count ? static_cast<double>(total_ns) / count : 0; }
+
+    /// @brief Gets the approximate value below which the given fraction of the recorded values fall.
+    /// @param fraction The fraction of the values [0; 1] (i.e. 0.99 for 99th percentile).
+    /// @return The upper bound of the bin containing the percentile (in nanoseconds), 0 if nothing has been recorded.
+    uint64_t Percentile(double fraction) const
+    {
+        if (count == 0)
+            return 0;
+        uint64_t target = static_cast<uint64_t>(fraction * count + 0.5);
+        if (target == 0)
+            target = 1;
+        uint64_t accumulated = 0;
+        for (int i = 0; i < BIN_COUNT; ++i)
+        {
+            accumulated += bins[i];
+            if (accumulated >= target)
+            {
+                const uint64_t upperBound = i + 1 < BIN_COUNT ? BinLowerBound(i + 1) - 1 : max_ns;
+                return upperBound < max_ns ? upperBound : max_ns;
+            }
+        }
+        return max_ns;
+    }
+};
+
 /// @brief Structure for holding the statistics of a stream
 struct StreamStats {
     /// @brief Structure for storing the first in first out queue statistics
@@ -28,6 +118,20 @@ struct StreamStats {
     uint32_t underrun; ///< The amount of packets underrun.
     uint32_t loss; ///< The amount of packets that are lost.
     uint32_t late; ///< The amount of packets that arrived late for transmitting and were dropped.
+
+    /// Rx: time from noticing a completed DMA transfer until its samples are placed into the FIFO.
+    DurationHistogram dmaToFifo;
+    /// Rx: time samples spend in the FIFO until they are taken by StreamRx().
+    DurationHistogram fifoToUser;
+    /// Tx: time from samples being placed into the FIFO by StreamTx() until they are submitted to DMA.
+    DurationHistogram userToDma;
+    /// Time of the worker loop iterations that transferred data.
+    DurationHistogram loopTime;
+
+    /// Rx: the mean power of each channel over the last statistics period (in dBFS), requires power metering.
+    float meanPower[2];
+    /// Rx: the peak power of each channel over the last statistics period (in dBFS), requires power metering.
+    float peakPower[2];
 };
 
 /// @brief Configuration settings for a stream.
@@ -42,6 +146,65 @@ struct LIME_API StreamConfig {
             uint32_t packetsInBatch; ///< The amount of packets to send in a single transfer.
         };
 
+        /// @brief Host side frequency shift and sample rate change between the link and the user's samples.
+        struct FrequencyConversion {
+            FrequencyConversion();
+
+            /// @brief The ratio between the link and the user sampling rates.
+            /// Default: 1 - no rate change.
+            uint16_t rateRatio;
+            /// @brief The frequency shift of each channel (in Hz), relative to the link sampling rate. Requires hintSampleRate.
+            /// Default: 0 - no shift.
+            float frequencyOffset[2];
+        };
+
+        /// @brief Splitting of the received band into equally spaced sub-channels with a polyphase filter bank.
+        struct Channelization {
+            Channelization();
+
+            /// @brief The amount of sub-channels the band is split into, sub-channel k is centered at k / channelCount
+            /// of the sampling rate, the upper half of the sub-channels are the negative frequencies.
+            /// Default: 0 - disabled.
+            uint16_t channelCount;
+            /// @brief The ratio between the input and the sub-channel sampling rates, must be a divisor of channelCount.
+            /// Default: 0 - same as channelCount (critically sampled).
+            uint16_t decimation;
+            /// @brief The sub-channels returned by SDRDevice::StreamRx(), in the order of its destination buffers.
+            std::vector<uint16_t> outputs;
+        };
+
+        /// @brief Host side automatic gain control of the received channels.
+        struct GainControl {
+            GainControl();
+
+            /// @brief Whether to adjust the generic Rx gain (LNA, TIA and PGA) of the channels.
+            /// Default: false.
+            bool enabled;
+            /// @brief The wanted mean power of the received signal (in dBFS).
+            /// Default: -20.
+            float targetPower;
+            /// @brief The highest allowed peak power of the received signal (in dBFS), the gain is reduced above it.
+            /// Default: -1.
+            float peakLimit;
+            /// @brief The deviation from the target power to tolerate without changing the gain (in dB).
+            /// Default: 3.
+            float hysteresis;
+            /// @brief The amount of samples to measure the power over between the gain updates.
+            /// Default: 0 - 10 ms at hintSampleRate, or 65536 samples if it's not set.
+            uint32_t updatePeriod;
+        };
+
+        /// @brief Continuous software correction of the receiver impairments, estimated from the received samples.
+        struct ImpairmentCorrection {
+            ImpairmentCorrection();
+
+            bool dc; ///< Whether to remove the DC offset.
+            bool iq; ///< Whether to correct the gain and phase imbalance between I and Q.
+            /// @brief The averaging time constant of the estimation (in samples), longer is less noisy but follows slower.
+            /// Default: 0 - 2^20 samples.
+            uint32_t timeConstant;
+        };
+
         Extras();
         bool usePoll; ///< Whether to use a polling strategy for PCIe devices.
 
@@ -50,6 +213,47 @@ struct LIME_API StreamConfig {
 
         bool negateQ; ///< Whether to negate the Q element before sending the data or not.
         bool waitPPS; ///< Start sampling from next following PPS.
+
+        /// @brief Duration (in seconds) of the most recent Rx samples to retain for SDRDevice::StreamRxHistory().
+        /// Requires hintSampleRate to be set.
+        /// Default: 0 - disabled.
+        float rxHistoryDuration;
+
+        /// @brief Whether to add triangular dither instead of rounding when reducing the received samples to DataFormat::I8.
+        /// Default: false - round to the nearest value.
+        bool rxDither;
+
+        /// @brief Whether to measure the mean and the peak power of each received channel, reported by
+        /// StreamMeta and StreamStats. The measurement is done on the samples before the channelization.
+        /// Default: false.
+        bool rxPowerMetering;
+
+        /// @brief Downconversion of the received samples: the signal at frequencyOffset is moved to DC,
+        /// low pass filtered and decimated by rateRatio before being returned by SDRDevice::StreamRx().
+        /// StreamRx() timestamps then count the decimated samples (hardware timestamp / rateRatio).
+        /// Can't be used together with rxHistoryDuration.
+        FrequencyConversion rxDownconversion;
+
+        /// @brief Upconversion of the transmitted samples: the samples given to SDRDevice::StreamTx() are interpolated
+        /// by rateRatio, low pass filtered and moved from DC to frequencyOffset.
+        /// StreamTx() timestamps then count the samples before interpolation (hardware timestamp / rateRatio).
+        FrequencyConversion txUpconversion;
+
+        /// @brief Channelization of the received samples, done after the downconversion when both are enabled.
+        /// SDRDevice::StreamRx() then fills a buffer for each of the outputs, with the count and the timestamps
+        /// in sub-channel samples (input timestamp / decimation). Requires a single Rx channel.
+        Channelization rxChannelization;
+
+        /// @brief Tracking and correction of the DC offset and the IQ imbalance of each received channel, applied
+        /// before the history and the channelization. Follows the drifts of the hardware calibration without
+        /// interrupting the stream. Assumes the received signal has equal power in I and Q.
+        /// Can't be used together with rxDownconversion.
+        ImpairmentCorrection rxImpairmentCorrection;
+
+        /// @brief Automatic gain control of the received channels, based on the power metering (enables it).
+        /// The gain is changed from a separate thread, the Rx gains must not be changed manually while it's enabled.
+        /// The gain in effect is reported by StreamMeta.
+        GainControl rxGainControl;
     };
 
     /// @brief The definition of the function that gets called whenever a stream status changes.
@@ -98,6 +302,33 @@ struct StreamMeta {
      * In TX: send samples to HW even if packet is not completely filled (end TX burst).
      */
     bool flushPartialPacket;
+
+    /**
+     * In RX: the mean power of each channel (in dBFS), measured over the received packets the returned samples
+     * were taken from. Set only if StreamConfig::Extras::rxPowerMetering is enabled.
+     * In TX: not used/ignored.
+     */
+    float meanPower[2];
+
+    /**
+     * In RX: the peak power of each channel (in dBFS), measured like the mean power.
+     * In TX: not used/ignored.
+     */
+    float peakPower[2];
+
+    /**
+     * In RX: the gain of each channel (in dB) set by the automatic gain control, the latest one that took effect
+     * before the end of the returned samples. Set only if StreamConfig::Extras::rxGainControl is enabled.
+     * In TX: not used/ignored.
+     */
+    float gain[2];
+
+    /**
+     * In RX: the timestamp of the first sample that could have been received with the reported gain.
+     * Samples up to the latency of the data transfer after it might still have the previous gain.
+     * In TX: not used/ignored.
+     */
+    uint64_t gainTimestamp;
 };
 
 } // namespace lime
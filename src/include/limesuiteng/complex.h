@@ -2,6 +2,7 @@
 #define LIME_COMPLEX_H
 
 #include <cstdint>
+#include <cstring>
 #include <type_traits>
 
 #if __cplusplus < 201402L
@@ -123,6 +124,10 @@ template<class T> struct POD_complex_t {
     T q; ///< The Q component of the number.
 };
 
+/** @brief Structure to hold an 8 bit integer complex number. */
+using complex8_t = POD_complex_t<int8_t>;
+static_assert(std::is_trivially_copyable<complex8_t>::value == true, "complex8_t is not trivially copyable");
+
 /** @brief Structure to hold a 16 bit integer complex number. */
 using complex16_t = POD_complex_t<int16_t>;
 static_assert(std::is_trivially_copyable<complex16_t>::value == true, "complex16_t is not trivially copyable");
@@ -145,6 +150,87 @@ class complex12_t : public complex16_t
 };
 static_assert(std::is_trivially_copyable<complex12_t>::value == true, "complex12_t is not trivially copyable");
 
+/** @brief IEEE 754 half precision (16 bit) floating-point number.
+    Used only for storing the samples, the arithmetic is done after converting to float.
+*/
+struct float16_t {
+    float16_t() = default;
+
+    /// @brief Constructs the number from a float, rounding to the nearest representable value.
+    /// @param value The value of the number.
+    float16_t(float value)
+        : bits(FromFloat(value))
+    {
+    }
+
+    /// @brief Converts the number to a float, the conversion is exact.
+    operator float() const { return ToFloat(bits); }
+
+    /// @brief Converts the float to the half precision bit pattern, rounding to the nearest even.
+    /// @param value The value to convert.
+    /// @return The half precision bit pattern.
+    static uint16_t FromFloat(float value)
+    {
+        uint32_t f;
+        std::memcpy(&f, &value, sizeof(f));
+        const uint16_t sign = (f >> 16) & 0x8000;
+        f &= 0x7FFFFFFF;
+
+        uint16_t h;
+        if (f >= 0x47800000) // too large for half precision: infinity, or NaN
+            h = f > 0x7F800000 ? 0x7E00 : 0x7C00;
+        else if (f < 0x38800000) // half precision subnormal or zero
+        {
+            // adding 0.5 aligns the mantissa to the subnormal position, the FPU does the rounding
+            float aligned;
+            std::memcpy(&aligned, &f, sizeof(f));
+            aligned += 0.5f;
+            std::memcpy(&f, &aligned, sizeof(f));
+            h = f - 0x3F000000;
+        }
+        else
+        {
+            // rebias the exponent and round the mantissa to nearest even
+            const uint32_t mantissaOdd = (f >> 13) & 1;
+            f += 0xC8000FFF + mantissaOdd;
+            h = f >> 13;
+        }
+        return sign | h;
+    }
+
+    /// @brief Converts the half precision bit pattern to a float.
+    /// @param value The half precision bit pattern.
+    /// @return The converted value.
+    static float ToFloat(uint16_t value)
+    {
+        const uint32_t sign = (value & 0x8000) << 16;
+        uint32_t f = (value & 0x7FFF) << 13;
+        const uint32_t exponent = f & 0x0F800000;
+        f += (127 - 15) << 23; // rebias the exponent
+        if (exponent == 0x0F800000) // infinity or NaN
+            f += (128 - 16) << 23;
+        else if (exponent == 0) // subnormal, renormalize through the FPU
+        {
+            f += 1 << 23;
+            float renormalized;
+            std::memcpy(&renormalized, &f, sizeof(f));
+            renormalized -= 6.103515625e-05f; // 2^-14
+            std::memcpy(&f, &renormalized, sizeof(f));
+        }
+        f |= sign;
+        float result;
+        std::memcpy(&result, &f, sizeof(f));
+        return result;
+    }
+
+    uint16_t bits; ///< The IEEE 754 binary16 bit pattern.
+};
+static_assert(sizeof(float16_t) == 2, "float16_t must be 2 bytes");
+
+/** @brief Structure to hold a 16 bit float complex number. */
+using complex16f_t = POD_complex_t<float16_t>;
+static_assert(std::is_trivially_copyable<complex16f_t>::value == true, "complex16f_t is not trivially copyable");
+
 /** @brief Structure to hold a 32 bit float complex number. */
 using complex32f_t = POD_complex_t<float>;
 static_assert(std::is_trivially_copyable<complex32f_t>::value == true, "complex32f_t is not trivially copyable");
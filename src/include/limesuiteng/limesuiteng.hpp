@@ -3,6 +3,7 @@
 
 #include "limesuiteng/DeviceRegistry.h"
 #include "limesuiteng/DeviceHandle.h"
+#include "limesuiteng/DeviceTelemetry.h"
 #include "limesuiteng/Logger.h"
 #include "limesuiteng/RFSOCDescriptor.h"
 #include "limesuiteng/SDRConfig.h"
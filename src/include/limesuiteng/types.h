@@ -15,6 +15,8 @@ enum class DataFormat : uint8_t {
     I16, ///< 16-bit integers.
     I12, ///< 12-bit integers. Stored as int16_t, but the expected range is [-2048;2047]
     F32, ///< 32-bit floating-point.
+    I8, ///< 8-bit integers. Host side only, the expected range is [-128;127]
+    F16, ///< 16-bit (IEEE 754 half precision) floating-point. Host side only
 };
 
 /// @brief Available gain types on the devices.
@@ -0,0 +1,232 @@
+#include "AsyncLogger.h"
+#include "LoggerInternal.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+    #include <pthread.h>
+#endif
+
+namespace lime {
+
+static_assert((AsyncLogger::QUEUE_SIZE & (AsyncLogger::QUEUE_SIZE - 1)) == 0, "queue size must be a power of two");
+
+static constexpr std::chrono::milliseconds drainPeriod{ 2 };
+
+/// @brief Gets the process wide asynchronous logger.
+/// @return The asynchronous logger instance.
+AsyncLogger& AsyncLogger::Instance()
+{
+    static AsyncLogger instance;
+    return instance;
+}
+
+AsyncLogger::AsyncLogger()
+    : mSlots(nullptr)
+    , mEnqueuePos(0)
+    , mDequeuePos(0)
+    , mDropped(0)
+    , mReportedDropped(0)
+    , mEnabled(false)
+    , mTerminate(false)
+    , mWorkerId()
+{
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    Enable(false);
+}
+
+/// @brief Starts or stops the asynchronous delivery. When stopping, all queued messages are delivered first.
+/// @param enable Whether to deliver the messages asynchronously.
+void AsyncLogger::Enable(bool enable)
+{
+    std::lock_guard<std::mutex> lock(mControlLock);
+    if (enable == mEnabled.load(std::memory_order_relaxed))
+        return;
+
+    if (enable)
+    {
+        // allocated on first use, the queue is large and most applications log synchronously
+        if (!mSlots)
+        {
+            mSlots.reset(new Slot[QUEUE_SIZE]);
+            for (std::size_t i = 0; i < QUEUE_SIZE; ++i)
+                mSlots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        mTerminate.store(false, std::memory_order_relaxed);
+        mThread = std::thread(&AsyncLogger::DrainLoop, this);
+#ifdef __linux__
+        pthread_setname_np(mThread.native_handle(), "lime:log");
+#endif
+        mEnabled.store(true, std::memory_order_release);
+        return;
+    }
+
+    mEnabled.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> drainLock(mDrainLock);
+        mTerminate.store(true, std::memory_order_relaxed);
+        mWakeUp.notify_all();
+    }
+    if (mThread.joinable())
+        mThread.join();
+
+    // deliver whatever got queued while the thread was shutting down
+    std::lock_guard<std::mutex> drainLock(mDrainLock);
+    Drain();
+}
+
+/// @brief Queues a message, formatting it directly into the queue memory.
+/// @param level The level of the message.
+/// @param sink The handler to deliver the message to (nullptr - the registered global log handler).
+/// @param format The format string of the message.
+/// @param args The format arguments.
+/// @return True if the message was queued, false if it was dropped.
+bool AsyncLogger::Post(LogLevel level, const std::shared_ptr<const LogHandler>& sink, const char* format, va_list args)
+{
+    Slot* slot = Claim();
+    if (!slot)
+        return false;
+
+    slot->level = level;
+    slot->sink = sink;
+    if (std::vsnprintf(slot->text, MAX_MSG_LEN, format, args) < 0)
+        slot->text[0] = '\0';
+    Publish(slot);
+    return true;
+}
+
+/// @brief Queues an already formatted message.
+/// @param level The level of the message.
+/// @param sink The handler to deliver the message to (nullptr - the registered global log handler).
+/// @param text The message, truncated to MAX_MSG_LEN - 1 characters.
+/// @return True if the message was queued, false if it was dropped.
+bool AsyncLogger::Post(LogLevel level, const std::shared_ptr<const LogHandler>& sink, const char* text)
+{
+    Slot* slot = Claim();
+    if (!slot)
+        return false;
+
+    slot->level = level;
+    slot->sink = sink;
+    const std::size_t length = std::min(std::strlen(text), MAX_MSG_LEN - 1);
+    std::memcpy(slot->text, text, length);
+    slot->text[length] = '\0';
+    Publish(slot);
+    return true;
+}
+
+/// @brief Blocks until all the messages queued before the call are delivered.
+void AsyncLogger::Flush()
+{
+    const std::size_t target = mEnqueuePos.load(std::memory_order_acquire);
+    if (std::this_thread::get_id() == mWorkerId.load(std::memory_order_acquire))
+        return; // called from a log handler, can't wait for itself
+
+    if (!IsEnabled())
+    {
+        std::lock_guard<std::mutex> drainLock(mDrainLock);
+        Drain();
+        return;
+    }
+
+    mWakeUp.notify_all();
+    // bounded wait, a producer that claimed a slot might never publish it
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (mDequeuePos.load(std::memory_order_acquire) < target && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+AsyncLogger::Slot* AsyncLogger::Claim()
+{
+    if (!mSlots)
+        return nullptr; // posting requires the logger to be enabled first
+    std::size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Slot& slot = mSlots[pos & (QUEUE_SIZE - 1)];
+        const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0)
+        {
+            if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                return &slot;
+        }
+        else if (diff < 0)
+        {
+            // queue is full
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        else
+            pos = mEnqueuePos.load(std::memory_order_relaxed);
+    }
+}
+
+void AsyncLogger::Publish(Slot* slot)
+{
+    const std::size_t sequence = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(sequence + 1, std::memory_order_release);
+}
+
+/// @brief Delivers all the currently published messages. Must be called with mDrainLock held.
+/// @return The amount of delivered messages.
+std::size_t AsyncLogger::Drain()
+{
+    if (!mSlots)
+        return 0; // never enabled
+    std::size_t delivered = 0;
+    std::size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Slot& slot = mSlots[pos & (QUEUE_SIZE - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+            break;
+
+        if (slot.sink)
+        {
+            (*slot.sink)(slot.level, slot.text);
+            slot.sink.reset();
+        }
+        else
+            Logger::logHandlerCString(slot.level, slot.text);
+
+        slot.sequence.store(pos + QUEUE_SIZE, std::memory_order_release);
+        ++pos;
+        ++delivered;
+        mDequeuePos.store(pos, std::memory_order_release);
+    }
+
+    const uint64_t dropped = mDropped.load(std::memory_order_relaxed);
+    if (dropped != mReportedDropped)
+    {
+        char msg[128];
+        std::snprintf(
+            msg, sizeof(msg), "Logger: %lu messages dropped, queue full", static_cast<unsigned long>(dropped - mReportedDropped));
+        mReportedDropped = dropped;
+        Logger::logHandlerCString(LogLevel::Warning, msg);
+    }
+    return delivered;
+}
+
+void AsyncLogger::DrainLoop()
+{
+    // published by the worker itself, mThread can't be read without the control lock
+    mWorkerId.store(std::this_thread::get_id(), std::memory_order_release);
+    std::unique_lock<std::mutex> lock(mDrainLock);
+    while (!mTerminate.load(std::memory_order_relaxed))
+    {
+        // producers never notify, to stay lock-free, so just poll periodically
+        if (Drain() == 0)
+            mWakeUp.wait_for(lock, drainPeriod);
+    }
+    Drain();
+    mWorkerId.store(std::thread::id(), std::memory_order_release);
+}
+
+} // namespace lime
@@ -0,0 +1,83 @@
+#ifndef LIME_ASYNCLOGGER_H
+#define LIME_ASYNCLOGGER_H
+
+#include "limesuiteng/Logger.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace lime {
+
+/**
+  @brief Asynchronous delivery of log messages.
+
+  Producers format the message directly into a preallocated slot of a bounded lock-free
+  multi-producer queue and return immediately. A dedicated thread drains the queue
+  and passes the messages to the registered log handler, so slow terminals or blocking
+  callbacks can't stall the threads that are logging.
+  If the queue is full, the message is dropped and counted.
+ */
+class AsyncLogger
+{
+  public:
+    /// Maximum length of a single message, including the null terminator, the same as for the synchronous delivery.
+    static constexpr std::size_t MAX_MSG_LEN = 4096;
+    static constexpr std::size_t QUEUE_SIZE = 512; ///< Amount of messages the queue can hold, must be a power of two.
+
+    static AsyncLogger& Instance();
+
+    ~AsyncLogger();
+
+    void Enable(bool enable);
+
+    /// @brief Gets whether messages are currently delivered asynchronously.
+    /// @return True if asynchronous delivery is enabled.
+    inline bool IsEnabled() const { return mEnabled.load(std::memory_order_relaxed); }
+
+    bool Post [[gnu::format(printf, 4, 0)]] (
+        LogLevel level, const std::shared_ptr<const LogHandler>& sink, const char* format, va_list args);
+    bool Post(LogLevel level, const std::shared_ptr<const LogHandler>& sink, const char* text);
+
+    void Flush();
+
+    /// @brief Gets the amount of messages dropped because the queue was full.
+    /// @return The amount of dropped messages.
+    inline uint64_t DroppedCount() const { return mDropped.load(std::memory_order_relaxed); }
+
+  private:
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        std::shared_ptr<const LogHandler> sink; ///< Owned by the message, so it outlives whoever posted it.
+        LogLevel level;
+        char text[MAX_MSG_LEN];
+    };
+
+    AsyncLogger();
+
+    Slot* Claim();
+    void Publish(Slot* slot);
+    std::size_t Drain();
+    void DrainLoop();
+
+    std::unique_ptr<Slot[]> mSlots;
+    alignas(64) std::atomic<std::size_t> mEnqueuePos;
+    alignas(64) std::atomic<std::size_t> mDequeuePos;
+    alignas(64) std::atomic<uint64_t> mDropped;
+    uint64_t mReportedDropped;
+
+    std::atomic<bool> mEnabled;
+    std::atomic<bool> mTerminate;
+    std::atomic<std::thread::id> mWorkerId;
+    std::thread mThread;
+    std::mutex mControlLock;
+    std::mutex mDrainLock;
+    std::condition_variable mWakeUp;
+};
+
+} // namespace lime
+
+#endif // LIME_ASYNCLOGGER_H
@@ -8,6 +8,7 @@
 
 #include "limesuiteng/Logger.h"
 #include "LoggerInternal.h"
+#include "AsyncLogger.h"
 
 #include <iostream>
 #include <string>
@@ -84,9 +85,34 @@ void debug(const std::string& text)
 
 void log(const LogLevel level, const std::string& text)
 {
+    if (Logger::IsDiscarded(level))
+        return;
+
+    AsyncLogger& async = AsyncLogger::Instance();
+    if (async.IsEnabled())
+    {
+        async.Post(level, nullptr, text.c_str());
+        return;
+    }
+
     Logger::logHandler(level, text);
 }
 
+void enableAsyncLogging(bool enable)
+{
+    AsyncLogger::Instance().Enable(enable);
+}
+
+void flushLog(void)
+{
+    AsyncLogger::Instance().Flush();
+}
+
+uint64_t GetDroppedLogMessagesCount(void)
+{
+    return AsyncLogger::Instance().DroppedCount();
+}
+
 OpStatus ReportError(const OpStatus errnum)
 {
     return ReportError(errnum, ToString(errnum));
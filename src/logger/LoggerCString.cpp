@@ -2,6 +2,7 @@
 
 #include "limesuiteng/Logger.h"
 #include "LoggerInternal.h"
+#include "AsyncLogger.h"
 
 namespace lime {
 
@@ -36,6 +37,12 @@ void registerLogHandler(const LogHandlerCString handler)
     Logger::logHandler = handler ? Logger::logHandlerWrapper : Logger::defaultLogHandler;
 }
 
+bool Logger::IsDiscarded(const LogLevel level)
+{
+    // default handlers don't print anything above warnings, skip formatting such messages
+    return level > LogLevel::Warning && Logger::logHandlerCString == Logger::defaultLogHandlerCString;
+}
+
 const char* GetLastErrorMessageCString(void)
 {
     return Logger::_reportedErrorMessage.c_str();
@@ -43,7 +50,17 @@ const char* GetLastErrorMessageCString(void)
 
 void log [[gnu::format(printf, 2, 0)]] (const LogLevel level, const char* format, va_list argList)
 {
-    char buff[4096];
+    if (Logger::IsDiscarded(level))
+        return;
+
+    AsyncLogger& async = AsyncLogger::Instance();
+    if (async.IsEnabled())
+    {
+        async.Post(level, nullptr, format, argList);
+        return;
+    }
+
+    char buff[AsyncLogger::MAX_MSG_LEN];
     int ret = std::vsnprintf(buff, sizeof(buff), format, argList);
     if (ret > 0)
         Logger::logHandlerCString(level, buff);
@@ -18,6 +18,8 @@ class Logger
     static void defaultLogHandler(const LogLevel level, const std::string& message);
     static void logHandlerWrapper(const LogLevel level, const std::string& message);
 
+    static bool IsDiscarded(const LogLevel level);
+
     static LogHandlerCString logHandlerCString;
     static LogHandler logHandler;
 
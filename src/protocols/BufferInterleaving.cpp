@@ -1,7 +1,12 @@
 #include "BufferInterleaving.h"
 
+#include <algorithm>
+#include <cassert>
+
 #include "FPGA/FPGA_common.h"
 #include "samplesConversion.h"
+#include "DSP/Resampling/Downconverter.h"
+#include "DSP/Resampling/Upconverter.h"
 
 namespace lime {
 
@@ -30,6 +35,20 @@ static int DeinterleaveCompressionType(DestT* const* dest, const uint8_t* buffer
         return DeinterleaveMIMO<complex12packed_t>(dest, buffer, length, fmt);
 }
 
+template<class SrcT>
+static int DeinterleaveDithered(complex8_t* const* dest, const uint8_t* buffer, uint32_t length, const DataConversion& fmt)
+{
+    // each Rx stream converts in its own thread
+    static thread_local TriangularDither dither;
+    const SrcT* src = reinterpret_cast<const SrcT*>(buffer);
+    const uint8_t stride = fmt.channelCount > 1 ? 2 : 1;
+    const uint32_t samplesProduced = length / sizeof(SrcT) / stride;
+    for (uint32_t i = 0; i < samplesProduced; ++i)
+        for (uint8_t ch = 0; ch < stride; ++ch)
+            DitheredRescale(dest[ch][i], src[i * stride + ch], dither);
+    return samplesProduced;
+}
+
 int Deinterleave(void* const* dest, const uint8_t* buffer, uint32_t length, const DataConversion& fmt)
 {
     int samplesProduced;
@@ -48,10 +67,95 @@ int Deinterleave(void* const* dest, const uint8_t* buffer, uint32_t length, cons
         samplesProduced =
             DeinterleaveCompressionType<complex12_t>(reinterpret_cast<complex12_t* const*>(dest), buffer, length, fmt);
         break;
+    case DataFormat::I8:
+        if (!fmt.dither)
+            samplesProduced =
+                DeinterleaveCompressionType<complex8_t>(reinterpret_cast<complex8_t* const*>(dest), buffer, length, fmt);
+        else if (fmt.srcFormat == DataFormat::I12)
+            samplesProduced =
+                DeinterleaveDithered<complex12packed_t>(reinterpret_cast<complex8_t* const*>(dest), buffer, length, fmt);
+        else
+            samplesProduced = DeinterleaveDithered<complex16_t>(reinterpret_cast<complex8_t* const*>(dest), buffer, length, fmt);
+        break;
+    case DataFormat::F16:
+        samplesProduced =
+            DeinterleaveCompressionType<complex16f_t>(reinterpret_cast<complex16f_t* const*>(dest), buffer, length, fmt);
+        break;
     }
     return samplesProduced;
 }
 
+template<class SrcT, class DestT>
+static int DownconvertChannels(DestT* const* dest,
+    const uint8_t* buffer,
+    uint32_t length,
+    const DataConversion& fmt,
+    Downconverter* const* downconverters,
+    uint8_t downconverterCount,
+    uint64_t timestamp)
+{
+    const SrcT* src = reinterpret_cast<const SrcT*>(buffer);
+    const uint8_t stride = std::max<uint8_t>(fmt.channelCount, 1);
+    const uint32_t count = length / sizeof(SrcT) / stride;
+    int samplesProduced = 0;
+    for (uint8_t ch = 0; ch < downconverterCount && ch < stride; ++ch)
+        samplesProduced = downconverters[ch]->Process(src + ch, stride, count, timestamp, dest[ch]);
+    return samplesProduced;
+}
+
+template<class DestT>
+static int DownconvertCompressionType(DestT* const* dest,
+    const uint8_t* buffer,
+    uint32_t length,
+    const DataConversion& fmt,
+    Downconverter* const* downconverters,
+    uint8_t downconverterCount,
+    uint64_t timestamp)
+{
+    if (fmt.srcFormat == DataFormat::I12)
+        return DownconvertChannels<complex12packed_t>(dest, buffer, length, fmt, downconverters, downconverterCount, timestamp);
+    return DownconvertChannels<complex16_t>(dest, buffer, length, fmt, downconverters, downconverterCount, timestamp);
+}
+
+/// @brief Converts the link format samples and downconverts them, in a single pass over the data.
+/// All the downconverters must have the same decimation, so every channel produces the same amount of samples.
+/// @param dest The destination arrays of each channel.
+/// @param buffer The interleaved link format samples.
+/// @param length The size of the buffer (in bytes).
+/// @param fmt The formats and the amount of the interleaved channels.
+/// @param downconverters The downconverters of the first downconverterCount channels.
+/// @param downconverterCount The amount of channels to process, the rest are skipped.
+/// @param timestamp The timestamp of the first sample in the buffer.
+/// @return The amount of samples produced for each channel.
+int DeinterleaveDownconvert(void* const* dest,
+    const uint8_t* buffer,
+    uint32_t length,
+    const DataConversion& fmt,
+    Downconverter* const* downconverters,
+    uint8_t downconverterCount,
+    uint64_t timestamp)
+{
+    switch (fmt.destFormat)
+    {
+    default:
+    case DataFormat::I16:
+        return DownconvertCompressionType(
+            reinterpret_cast<complex16_t* const*>(dest), buffer, length, fmt, downconverters, downconverterCount, timestamp);
+    case DataFormat::F32:
+        return DownconvertCompressionType(
+            reinterpret_cast<complex32f_t* const*>(dest), buffer, length, fmt, downconverters, downconverterCount, timestamp);
+    case DataFormat::I12:
+        return DownconvertCompressionType(
+            reinterpret_cast<complex12_t* const*>(dest), buffer, length, fmt, downconverters, downconverterCount, timestamp);
+    case DataFormat::I8:
+        return DownconvertCompressionType(
+            reinterpret_cast<complex8_t* const*>(dest), buffer, length, fmt, downconverters, downconverterCount, timestamp);
+    case DataFormat::F16:
+        return DownconvertCompressionType(
+            reinterpret_cast<complex16f_t* const*>(dest), buffer, length, fmt, downconverters, downconverterCount, timestamp);
+    }
+}
+
 template<class DestT, class SrcT>
 static int InterleaveMIMO(uint8_t* buffer, const SrcT* const* input, uint32_t count, const DataConversion& fmt)
 {
@@ -94,8 +198,129 @@ int Interleave(uint8_t* dest, const void* const* src, uint32_t count, const Data
     case DataFormat::I12:
         bytesProduced = InterleaveCompressionType<complex12_t>(dest, reinterpret_cast<const complex12_t* const*>(src), count, fmt);
         break;
+    case DataFormat::I8:
+        bytesProduced = InterleaveCompressionType<complex8_t>(dest, reinterpret_cast<const complex8_t* const*>(src), count, fmt);
+        break;
+    case DataFormat::F16:
+        bytesProduced =
+            InterleaveCompressionType<complex16f_t>(dest, reinterpret_cast<const complex16f_t* const*>(src), count, fmt);
+        break;
     }
     return bytesProduced;
 }
 
+template<class DestT, class SrcT>
+static int UpconvertChannels(uint8_t* buffer,
+    const SrcT* const* src,
+    uint32_t count,
+    const DataConversion& fmt,
+    Upconverter* const* upconverters,
+    uint8_t upconverterCount,
+    uint64_t timestamp,
+    bool useTimestamp)
+{
+    DestT* dest = reinterpret_cast<DestT*>(buffer);
+    const uint8_t stride = std::max<uint8_t>(fmt.channelCount, 1);
+    const uint32_t outputCount = count * upconverters[0]->GetInterpolation();
+    for (uint8_t ch = 0; ch < stride; ++ch)
+    {
+        if (ch < upconverterCount)
+            upconverters[ch]->Process(src[ch], count, timestamp, useTimestamp, dest + ch, stride);
+        else
+        {
+            // link channel without samples to transmit
+            for (uint32_t i = 0; i < outputCount; ++i)
+                dest[i * stride + ch] = DestT();
+        }
+    }
+    return outputCount * stride * sizeof(DestT);
+}
+
+template<class SrcT>
+static int UpconvertCompressionType(uint8_t* dest,
+    const SrcT* const* src,
+    uint32_t count,
+    const DataConversion& fmt,
+    Upconverter* const* upconverters,
+    uint8_t upconverterCount,
+    uint64_t timestamp,
+    bool useTimestamp)
+{
+    if (fmt.destFormat == DataFormat::I12)
+        return UpconvertChannels<complex12packed_t>(dest, src, count, fmt, upconverters, upconverterCount, timestamp, useTimestamp);
+    return UpconvertChannels<complex16_t>(dest, src, count, fmt, upconverters, upconverterCount, timestamp, useTimestamp);
+}
+
+/// @brief Upconverts the samples and converts them to the link format, in a single pass over the data.
+/// All the upconverters must have the same interpolation, so every channel produces the same amount of samples.
+/// @param dest The destination buffer for the interleaved link format samples.
+/// @param src The source arrays of each channel.
+/// @param count The amount of samples to take from each channel.
+/// @param fmt The formats and the amount of the interleaved channels.
+/// @param upconverters The upconverters of the first upconverterCount channels.
+/// @param upconverterCount The amount of channels with samples, the rest of the link channels are filled with zeros.
+/// @param timestamp The timestamp of the first sample in the source arrays (before interpolation).
+/// @param useTimestamp Whether the timestamp is valid, untimed samples continue the previously upconverted ones.
+/// @return The amount of bytes written to the destination.
+int InterleaveUpconvert(uint8_t* dest,
+    const void* const* src,
+    uint32_t count,
+    const DataConversion& fmt,
+    Upconverter* const* upconverters,
+    uint8_t upconverterCount,
+    uint64_t timestamp,
+    bool useTimestamp)
+{
+    assert(upconverterCount > 0);
+    switch (fmt.srcFormat)
+    {
+    default:
+    case DataFormat::I16:
+        return UpconvertCompressionType(dest,
+            reinterpret_cast<const complex16_t* const*>(src),
+            count,
+            fmt,
+            upconverters,
+            upconverterCount,
+            timestamp,
+            useTimestamp);
+    case DataFormat::F32:
+        return UpconvertCompressionType(dest,
+            reinterpret_cast<const complex32f_t* const*>(src),
+            count,
+            fmt,
+            upconverters,
+            upconverterCount,
+            timestamp,
+            useTimestamp);
+    case DataFormat::I12:
+        return UpconvertCompressionType(dest,
+            reinterpret_cast<const complex12_t* const*>(src),
+            count,
+            fmt,
+            upconverters,
+            upconverterCount,
+            timestamp,
+            useTimestamp);
+    case DataFormat::I8:
+        return UpconvertCompressionType(dest,
+            reinterpret_cast<const complex8_t* const*>(src),
+            count,
+            fmt,
+            upconverters,
+            upconverterCount,
+            timestamp,
+            useTimestamp);
+    case DataFormat::F16:
+        return UpconvertCompressionType(dest,
+            reinterpret_cast<const complex16f_t* const*>(src),
+            count,
+            fmt,
+            upconverters,
+            upconverterCount,
+            timestamp,
+            useTimestamp);
+    }
+}
+
 } // namespace lime
@@ -5,15 +5,34 @@
 
 namespace lime {
 
+class Downconverter;
+class Upconverter;
+
 /// @brief Structure defining how to convert the samples data.
 struct DataConversion {
     DataFormat srcFormat; ///< The format to convert from.
     DataFormat destFormat; ///< The format to convert to.
     uint8_t channelCount; ///< The amount of channels the data has.
+    bool dither{ false }; ///< Whether to dither the samples quantized to DataFormat::I8, instead of rounding them.
 };
 
 int Deinterleave(void* const* dest, const uint8_t* buffer, uint32_t length, const DataConversion& fmt);
+int DeinterleaveDownconvert(void* const* dest,
+    const uint8_t* buffer,
+    uint32_t length,
+    const DataConversion& fmt,
+    Downconverter* const* downconverters,
+    uint8_t downconverterCount,
+    uint64_t timestamp);
 int Interleave(uint8_t* dest, const void* const* src, uint32_t count, const DataConversion& fmt);
+int InterleaveUpconvert(uint8_t* dest,
+    const void* const* src,
+    uint32_t count,
+    const DataConversion& fmt,
+    Upconverter* const* upconverters,
+    uint8_t upconverterCount,
+    uint64_t timestamp,
+    bool useTimestamp);
 
 } // namespace lime
 
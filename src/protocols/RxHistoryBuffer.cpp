@@ -0,0 +1,241 @@
+#include "RxHistoryBuffer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef __linux__
+    #include <sys/mman.h>
+#endif
+#ifdef _WIN32
+    #include <malloc.h>
+#endif
+
+using namespace std::literals::string_literals;
+
+namespace lime {
+
+static constexpr std::size_t hugePageSize = 2 * 1024 * 1024;
+
+/// @brief Constructs the history buffer and preallocates all of its memory.
+/// @param capacity The amount of samples per channel to retain.
+/// @param channelCount The amount of channels to retain (max 2).
+/// @param frameSize The size of a single sample (in bytes).
+RxHistoryBuffer::RxHistoryBuffer(uint32_t capacity, uint8_t channelCount, uint8_t frameSize)
+    : mStorage(nullptr)
+    , mStorageSize(0)
+    , mChannel{ nullptr, nullptr }
+    , mCapacity(capacity)
+    , mChannelCount(std::min<uint8_t>(channelCount, 2))
+    , mFrameSize(frameSize)
+    , mHugePages(false)
+    , mMapped(false)
+    , mStart(0)
+    , mValidEnd(0)
+    , mWriteEnd(0)
+{
+    if (mCapacity == 0 || mChannelCount == 0 || mFrameSize == 0)
+        throw std::invalid_argument("Invalid Rx history buffer dimensions"s);
+
+    const std::size_t channelSize = static_cast<std::size_t>(mCapacity) * mFrameSize;
+    mStorageSize = channelSize * mChannelCount;
+
+#ifdef __linux__
+    // Prefer explicit huge pages, as the whole buffer is being swept continuously
+    // and regular pages would thrash the TLB. MAP_POPULATE prefaults the memory,
+    // so the Rx loop does not take page faults on first write.
+    const std::size_t hugeSize = (mStorageSize + hugePageSize - 1) / hugePageSize * hugePageSize;
+    void* ptr = mmap(nullptr, hugeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE, -1, 0);
+    if (ptr != MAP_FAILED)
+    {
+        mStorageSize = hugeSize;
+        mHugePages = true;
+    }
+    else
+    {
+        ptr = mmap(nullptr, mStorageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED)
+            throw std::runtime_error("Failed to allocate Rx history buffer"s);
+        // fallback to transparent huge pages, if they are enabled
+        madvise(ptr, mStorageSize, MADV_HUGEPAGE);
+        std::memset(ptr, 0, mStorageSize);
+    }
+    mStorage = static_cast<uint8_t*>(ptr);
+    mMapped = true;
+#else
+    #if __unix__
+    mStorage = static_cast<uint8_t*>(std::aligned_alloc(4096, (mStorageSize + 4095) / 4096 * 4096));
+    #else
+    mStorage = static_cast<uint8_t*>(_aligned_malloc(mStorageSize, 4096));
+    #endif
+    if (!mStorage)
+        throw std::runtime_error("Failed to allocate Rx history buffer"s);
+    std::memset(mStorage, 0, mStorageSize);
+#endif
+
+    for (uint8_t i = 0; i < mChannelCount; ++i)
+        mChannel[i] = mStorage + channelSize * i;
+}
+
+RxHistoryBuffer::~RxHistoryBuffer()
+{
+#ifdef __linux__
+    if (mMapped)
+        munmap(mStorage, mStorageSize);
+#elif __unix__
+    free(mStorage);
+#else
+    _aligned_free(mStorage);
+#endif
+}
+
+/// @brief Discards all the retained samples.
+void RxHistoryBuffer::Reset()
+{
+    mValidEnd.store(0, std::memory_order_relaxed);
+    mWriteEnd.store(0, std::memory_order_relaxed);
+    mStart.store(0, std::memory_order_release);
+}
+
+/// @brief Stores the given samples, overwriting the oldest ones.
+/// @param src The source arrays of the samples, one for each channel.
+/// @param count The amount of samples to store.
+/// @param timestamp The timestamp of the first sample.
+void RxHistoryBuffer::Write(const void* const* src, uint32_t count, uint64_t timestamp)
+{
+    if (count == 0)
+        return;
+
+    uint32_t skip = 0;
+    if (count > mCapacity)
+    {
+        skip = count - mCapacity;
+        count = mCapacity;
+        timestamp += skip;
+    }
+
+    const uint64_t start = mStart.load(std::memory_order_relaxed);
+    const uint64_t end = mValidEnd.load(std::memory_order_relaxed);
+    const uint64_t writeEnd = timestamp + count;
+
+    const bool isEmpty = start == end;
+    if (isEmpty || timestamp < end)
+    {
+        // first samples or the timestamps went backwards, start retaining from scratch
+        mValidEnd.store(timestamp, std::memory_order_relaxed);
+        mStart.store(timestamp, std::memory_order_relaxed);
+    }
+
+    mWriteEnd.store(writeEnd, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (!isEmpty && timestamp > end)
+    {
+        // samples were lost, don't leave stale data in the gap
+        const uint64_t gap = std::min<uint64_t>(timestamp - end, mCapacity - count);
+        Fill(timestamp - gap, gap);
+    }
+
+    for (uint8_t i = 0; i < mChannelCount; ++i)
+    {
+        if (src[i] == nullptr)
+            continue;
+        CopyIn(i, timestamp, static_cast<const uint8_t*>(src[i]) + skip * mFrameSize, count);
+    }
+
+    mValidEnd.store(writeEnd, std::memory_order_release);
+}
+
+/// @brief Copies out the samples of the given time window.
+/// @param dest The destination arrays, one for each channel (nullptr to skip the channel).
+/// @param timestamp The timestamp of the first sample to copy.
+/// @param count The amount of samples to copy.
+/// @return OpStatus::Success if the whole window was copied,
+/// OpStatus::OutOfRange if the window is not retained (or was overwritten while copying).
+OpStatus RxHistoryBuffer::Read(void* const* dest, uint64_t timestamp, uint32_t count) const
+{
+    if (count > mCapacity)
+        return OpStatus::OutOfRange;
+
+    uint64_t oldest = 0;
+    uint64_t newest = 0;
+    const uint64_t start = mStart.load(std::memory_order_acquire);
+    if (!GetRange(&oldest, &newest))
+        return OpStatus::OutOfRange;
+    if (timestamp < oldest || timestamp + count > newest)
+        return OpStatus::OutOfRange;
+
+    for (uint8_t i = 0; i < mChannelCount; ++i)
+    {
+        if (dest[i] == nullptr)
+            continue;
+        CopyOut(i, timestamp, static_cast<uint8_t*>(dest[i]), count);
+    }
+
+    // verify that the writer has not reached the copied region in the meantime
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t writeEnd = mWriteEnd.load(std::memory_order_relaxed);
+    if (mStart.load(std::memory_order_relaxed) != start)
+        return OpStatus::OutOfRange;
+    if (writeEnd > mCapacity && timestamp < writeEnd - mCapacity)
+        return OpStatus::OutOfRange;
+    return OpStatus::Success;
+}
+
+/// @brief Gets the range of the currently retained samples timestamps.
+/// @param oldest [out] The timestamp of the oldest retained sample.
+/// @param newest [out] The timestamp following the newest retained sample.
+/// @return True if any samples are retained.
+bool RxHistoryBuffer::GetRange(uint64_t* oldest, uint64_t* newest) const
+{
+    const uint64_t start = mStart.load(std::memory_order_acquire);
+    const uint64_t end = mValidEnd.load(std::memory_order_acquire);
+    const uint64_t writeEnd = mWriteEnd.load(std::memory_order_acquire);
+    if (end <= start)
+        return false;
+
+    uint64_t first = start;
+    if (writeEnd > mCapacity)
+        first = std::max(first, writeEnd - mCapacity);
+    if (first >= end)
+        return false;
+
+    if (oldest)
+        *oldest = first;
+    if (newest)
+        *newest = end;
+    return true;
+}
+
+void RxHistoryBuffer::CopyIn(uint8_t channel, uint64_t timestamp, const uint8_t* src, uint32_t count)
+{
+    const uint32_t index = timestamp % mCapacity;
+    const uint32_t firstPart = std::min(count, mCapacity - index);
+    std::memcpy(mChannel[channel] + index * mFrameSize, src, firstPart * mFrameSize);
+    if (firstPart < count)
+        std::memcpy(mChannel[channel], src + firstPart * mFrameSize, (count - firstPart) * mFrameSize);
+}
+
+void RxHistoryBuffer::CopyOut(uint8_t channel, uint64_t timestamp, uint8_t* dest, uint32_t count) const
+{
+    const uint32_t index = timestamp % mCapacity;
+    const uint32_t firstPart = std::min(count, mCapacity - index);
+    std::memcpy(dest, mChannel[channel] + index * mFrameSize, firstPart * mFrameSize);
+    if (firstPart < count)
+        std::memcpy(dest + firstPart * mFrameSize, mChannel[channel], (count - firstPart) * mFrameSize);
+}
+
+void RxHistoryBuffer::Fill(uint64_t timestamp, uint32_t count)
+{
+    const uint32_t index = timestamp % mCapacity;
+    const uint32_t firstPart = std::min(count, mCapacity - index);
+    for (uint8_t i = 0; i < mChannelCount; ++i)
+    {
+        std::memset(mChannel[i] + index * mFrameSize, 0, firstPart * mFrameSize);
+        if (firstPart < count)
+            std::memset(mChannel[i], 0, (count - firstPart) * mFrameSize);
+    }
+}
+
+} // namespace lime
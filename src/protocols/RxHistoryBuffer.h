@@ -0,0 +1,70 @@
+#ifndef LIME_RXHISTORYBUFFER_H
+#define LIME_RXHISTORYBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "limesuiteng/OpStatus.h"
+
+namespace lime {
+
+/**
+  @brief Ring buffer retaining the most recent Rx samples, indexed by hardware timestamp.
+
+  Sample with timestamp `ts` is always stored at ring position `ts % capacity`, so any time window
+  that is still retained can be copied out directly, without searching.
+  Single writer (the Rx receive loop), any number of readers. The writer never blocks or allocates,
+  readers detect if the requested window has been overwritten while it was being copied.
+  Samples lost in transport are retained as zeros.
+ */
+class RxHistoryBuffer
+{
+  public:
+    RxHistoryBuffer(uint32_t capacity, uint8_t channelCount, uint8_t frameSize);
+    ~RxHistoryBuffer();
+
+    RxHistoryBuffer(const RxHistoryBuffer&) = delete;
+    RxHistoryBuffer& operator=(const RxHistoryBuffer&) = delete;
+
+    void Reset();
+    void Write(const void* const* src, uint32_t count, uint64_t timestamp);
+    OpStatus Read(void* const* dest, uint64_t timestamp, uint32_t count) const;
+    bool GetRange(uint64_t* oldest, uint64_t* newest) const;
+
+    /// @brief Gets the amount of samples per channel the buffer can retain.
+    /// @return The capacity of the buffer (in samples).
+    constexpr uint32_t capacity() const { return mCapacity; }
+
+    /// @brief Gets the size of a single stored sample.
+    /// @return The size of a single sample (in bytes).
+    constexpr uint8_t frameSize() const { return mFrameSize; }
+
+    /// @brief Gets whether the storage is backed by huge pages.
+    /// @return True if huge pages are used.
+    constexpr bool isHugePageBacked() const { return mHugePages; }
+
+  private:
+    void CopyIn(uint8_t channel, uint64_t timestamp, const uint8_t* src, uint32_t count);
+    void CopyOut(uint8_t channel, uint64_t timestamp, uint8_t* dest, uint32_t count) const;
+    void Fill(uint64_t timestamp, uint32_t count);
+
+    uint8_t* mStorage;
+    std::size_t mStorageSize;
+    uint8_t* mChannel[2];
+    uint32_t mCapacity;
+    uint8_t mChannelCount;
+    uint8_t mFrameSize;
+    bool mHugePages;
+    bool mMapped;
+
+    // [mStart, mValidEnd) is the range of completely written samples,
+    // mWriteEnd is the end of the range currently being written.
+    std::atomic<uint64_t> mStart;
+    std::atomic<uint64_t> mValidEnd;
+    std::atomic<uint64_t> mWriteEnd;
+};
+
+} // namespace lime
+
+#endif // LIME_RXHISTORYBUFFER_H
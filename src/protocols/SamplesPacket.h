@@ -31,6 +31,7 @@ template<uint8_t chCount> class SamplesPacket
         pkt->length = 0;
         pkt->mCapacity = samplesCount;
         pkt->frameSize = frameSize;
+        pkt->queuedTime = 0;
         for (int i = 0; i < chCount; ++i)
         {
             pkt->channel[i] = (ptr + headerSize) + (samplesCount * frameSize) * i;
@@ -172,6 +173,9 @@ template<uint8_t chCount> class SamplesPacket
 
   public:
     uint64_t timestamp; ///< The timestamp of the packet.
+    int64_t queuedTime; ///< The time (steady clock, in nanoseconds) when the packet was placed into the FIFO.
+    float meanPower[chCount]; ///< Rx: the mean power of each channel's samples, relative to the full scale.
+    float peakPower[chCount]; ///< Rx: the peak power of each channel's samples, relative to the full scale.
 
   private:
     uint8_t* head[chCount];
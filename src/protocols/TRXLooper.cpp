@@ -2,9 +2,16 @@
 
 #include "AvgRmsCounter.h"
 #include "comms/IDMA.h"
+#include "DSP/GainControl/GainController.h"
+#include "DSP/IQCorrection/IQImpairmentTracker.h"
+#include "DSP/Resampling/Channelizer.h"
+#include "DSP/Resampling/Downconverter.h"
+#include "DSP/Resampling/Upconverter.h"
 #include "FPGA/FPGA_common.h"
 #include "limesuiteng/LMS7002M.h"
 #include "limesuiteng/Logger.h"
+#include "limesuiteng/SDRDescriptor.h"
+#include "logger/AsyncLogger.h"
 #include "chips/LMS7002M/LMS7002MCSR_Data.h"
 #include "LMSBoards.h"
 #include "threadHelper.h"
@@ -14,7 +21,9 @@
 #include <algorithm>
 #include <cassert>
 #include <ciso646>
+#include <cmath>
 #include <complex>
+#include <limits>
 #include <queue>
 
 using namespace std::literals::string_literals;
@@ -27,6 +36,7 @@ static constexpr uint16_t defaultSamplesInPkt = 256;
 
 static constexpr bool showStats{ false };
 static constexpr int statsPeriod_ms{ 1000 }; // at 122.88 MHz MIMO, fpga tx pkt counter overflows every 272ms
+static constexpr std::size_t gainChangesToKeep{ 16 };
 
 static int ReadySlots(uint32_t writer, uint32_t reader, uint32_t ringSize)
 {
@@ -45,6 +55,17 @@ static constexpr int64_t ts_to_us(int64_t fs, int64_t ts)
     return n * 1000000 + ((r * 1000000) / fs);
 }
 
+/// @brief Converts steady clock time point to nanoseconds, for storing in the samples packets.
+static inline int64_t ToNanoseconds(steady_clock::time_point t)
+{
+    return duration_cast<nanoseconds>(t.time_since_epoch()).count();
+}
+
+static inline uint64_t ElapsedNanoseconds(int64_t from, int64_t to)
+{
+    return to > from ? to - from : 0;
+}
+
 template<class T> static uint32_t indexListToMask(const std::vector<T>& indexes)
 {
     uint32_t mask = 0;
@@ -53,6 +74,22 @@ template<class T> static uint32_t indexListToMask(const std::vector<T>& indexes)
     return mask;
 }
 
+// Size of a single channel sample in the host memory.
+static uint8_t HostSampleSize(DataFormat format)
+{
+    switch (format)
+    {
+    case DataFormat::F32:
+        return sizeof(complex32f_t);
+    case DataFormat::F16:
+        return sizeof(complex16f_t);
+    case DataFormat::I8:
+        return sizeof(complex8_t);
+    default:
+        return sizeof(complex16_t);
+    }
+}
+
 /// @brief Constructs a new TRXLooper object.
 /// @param rx The DMA communications interface to receive the data from.
 /// @param tx The DMA communications interface to send the data to.
@@ -63,8 +100,8 @@ TRXLooper::TRXLooper(std::shared_ptr<IDMA> rx, std::shared_ptr<IDMA> tx, FPGA* f
     : fpga(f)
     , lms(chip)
     , chipId(moduleIndex)
-    , mCallback_logMessage(nullptr)
     , mStreamEnabled(false)
+    , mGainDevice(nullptr)
 {
     mRxArgs.dma = rx;
     mTxArgs.dma = tx;
@@ -77,6 +114,50 @@ TRXLooper::~TRXLooper()
 {
     Stop();
     Teardown();
+    // deliver the queued messages while the device is still there,
+    // the messages left after a timed out flush keep their own reference to the callback
+    AsyncLogger::Instance().Flush();
+}
+
+/// @brief Sets the callback to use for message logging.
+/// @param callback The new callback to use.
+void TRXLooper::SetMessageLogCallback(SDRDevice::LogCallbackType callback)
+{
+    std::shared_ptr<const SDRDevice::LogCallbackType> replacement;
+    if (callback)
+        replacement = std::make_shared<const SDRDevice::LogCallbackType>(std::move(callback));
+    std::atomic_store(&mCallback_logMessage, replacement);
+}
+
+/// @brief Gets the callback to use for message logging.
+/// @return The current callback, which stays valid even if it gets replaced while in use.
+std::shared_ptr<const SDRDevice::LogCallbackType> TRXLooper::GetLogCallback() const
+{
+    return std::atomic_load(&mCallback_logMessage);
+}
+
+/// @brief Sets the device whose generic Rx gain the automatic gain control adjusts.
+/// @param device The device owning this stream's chip, or nullptr to disable the gain control.
+void TRXLooper::SetGainControlDevice(SDRDevice* device)
+{
+    mGainDevice = device;
+}
+
+/// @brief Passes the message to the log callback, without blocking if asynchronous logging is enabled.
+/// Intended for the streaming loops, where blocking callbacks would cause data drops.
+/// @param level The level of the message.
+/// @param msg The message to log.
+void TRXLooper::PostLogMessage(LogLevel level, const char* msg)
+{
+    const auto callback = GetLogCallback();
+    if (!callback)
+        return;
+
+    AsyncLogger& async = AsyncLogger::Instance();
+    if (async.IsEnabled())
+        async.Post(level, callback, msg);
+    else
+        (*callback)(level, msg);
 }
 
 /// @brief Gets the current timestamp of the hardware.
@@ -243,11 +324,11 @@ void TRXLooper::Stop()
                 mRx.cv.wait(lck);
         }
 
-        if (mCallback_logMessage)
+        if (const auto callback = GetLogCallback())
         {
             char msg[256];
             std::snprintf(msg, sizeof(msg), "Rx%i stop: packetsIn: %li", chipId, mRx.stats.packets);
-            mCallback_logMessage(LogLevel::Verbose, msg);
+            (*callback)(LogLevel::Verbose, msg);
         }
     }
 
@@ -266,7 +347,7 @@ void TRXLooper::Stop()
         uint32_t fpgaTxPktIngressCount;
         uint32_t fpgaTxPktDropCounter;
         fpga->ReadTxPacketCounters(chipId, &fpgaTxPktIngressCount, &fpgaTxPktDropCounter);
-        if (mCallback_logMessage)
+        if (const auto callback = GetLogCallback())
         {
             char msg[512];
             std::snprintf(msg,
@@ -279,7 +360,7 @@ void TRXLooper::Stop()
                 fpgaTxPktIngressCount,
                 (mTx.stats.packets & 0xFFFFFFFF) - fpgaTxPktIngressCount,
                 fpgaTxPktDropCounter);
-            mCallback_logMessage(LogLevel::Verbose, msg);
+            (*callback)(LogLevel::Verbose, msg);
         }
     }
 }
@@ -327,7 +408,7 @@ OpStatus TRXLooper::RxSetup()
 
     mRx.packetsToBatch = std::clamp<uint8_t>(mRx.packetsToBatch, 1, dmaBufferSize / packetSize);
 
-    if (mCallback_logMessage)
+    if (const auto callback = GetLogCallback())
     {
         float bufferTimeDuration;
         if (mConfig.hintSampleRate)
@@ -345,7 +426,7 @@ OpStatus TRXLooper::RxSetup()
             mRx.packetsToBatch * packetSize,
             (mConfig.linkFormat == DataFormat::I12 ? "I12" : "I16"),
             bufferTimeDuration * 1e6);
-        mCallback_logMessage(LogLevel::Verbose, msg);
+        (*callback)(LogLevel::Verbose, msg);
     }
 
     std::vector<uint8_t*> dmaBuffers(dmaChunks.size());
@@ -365,6 +446,54 @@ OpStatus TRXLooper::RxSetup()
         sizeof(complex32f_t) * mRx.packetsToBatch * samplesInPkt * chCount + SamplesPacketType::headerSize;
     mRx.memPool = std::make_unique<MemoryPool>(1024, upperAllocationLimit, 8, name);
 
+    mRxHistory.reset();
+    const std::size_t rxChannelCount = mConfig.channels.at(lime::TRXDir::Rx).size();
+    if (mConfig.extraConfig.rxHistoryDuration > 0 && rxChannelCount > 0)
+    {
+        if (mConfig.hintSampleRate <= 0)
+            return ReportError(OpStatus::InvalidValue, "Rx history requires hintSampleRate"s);
+
+        // computed in double, so that long durations are rejected instead of wrapping around
+        const double requestedSamples =
+            std::ceil(static_cast<double>(mConfig.extraConfig.rxHistoryDuration) * mConfig.hintSampleRate);
+        if (requestedSamples > std::numeric_limits<uint32_t>::max())
+            return ReportError(OpStatus::OutOfRange,
+                "Rx%i history of %g s at %g Hz exceeds the maximum of %u samples",
+                chipId,
+                mConfig.extraConfig.rxHistoryDuration,
+                mConfig.hintSampleRate,
+                std::numeric_limits<uint32_t>::max());
+        const uint32_t historySamples = static_cast<uint32_t>(requestedSamples);
+        const uint8_t frameSize = HostSampleSize(mConfig.format);
+        try
+        {
+            mRxHistory = std::make_unique<RxHistoryBuffer>(historySamples, rxChannelCount, frameSize);
+        } catch (std::exception& e)
+        {
+            return ReportError(OpStatus::Error, "Rx%i history: %s", chipId, e.what());
+        }
+        lime::debug("Rx%i history: %u samples per channel, huge pages: %s",
+            chipId,
+            historySamples,
+            mRxHistory->isHugePageBacked() ? "yes" : "no");
+    }
+
+    status = RxDownconversionSetup();
+    if (status != OpStatus::Success)
+        return status;
+
+    status = RxChannelizationSetup();
+    if (status != OpStatus::Success)
+        return status;
+
+    status = RxImpairmentCorrectionSetup();
+    if (status != OpStatus::Success)
+        return status;
+
+    status = RxGainControlSetup();
+    if (status != OpStatus::Success)
+        return status;
+
     // Don't just use REALTIME scheduling, or at least be cautious with it.
     // if the thread blocks for too long, Linux can trigger RT throttling
     // which can cause unexpected data packet losses and timing issues.
@@ -395,6 +524,208 @@ OpStatus TRXLooper::RxSetup()
     return OpStatus::Success;
 }
 
+/// @brief Creates the downconverters of the Rx channels, if the stream configuration requests them.
+/// @return The status of the operation.
+OpStatus TRXLooper::RxDownconversionSetup()
+{
+    mRxDownconverters.clear();
+    const StreamConfig::Extras::FrequencyConversion& ddc = mConfig.extraConfig.rxDownconversion;
+    const std::size_t rxChannelCount = mConfig.channels.at(lime::TRXDir::Rx).size();
+    const bool shifted = ddc.frequencyOffset[0] != 0 || ddc.frequencyOffset[1] != 0;
+    if ((ddc.rateRatio <= 1 && !shifted) || rxChannelCount == 0)
+        return OpStatus::Success;
+
+    if (shifted && mConfig.hintSampleRate <= 0)
+        return ReportError(OpStatus::InvalidValue, "Rx downconversion frequency offset requires hintSampleRate"s);
+    if (mRxHistory)
+        return ReportError(OpStatus::NotSupported, "Rx history can't be used together with Rx downconversion"s);
+
+    for (std::size_t i = 0; i < rxChannelCount; ++i)
+    {
+        const uint8_t channel = mConfig.channels.at(lime::TRXDir::Rx).at(i);
+        double frequency = shifted ? ddc.frequencyOffset[channel & 1] / mConfig.hintSampleRate : 0;
+        // negateQ conjugates the downconverted samples, so the shift direction has to be mirrored
+        if (mConfig.extraConfig.negateQ)
+            frequency = -frequency;
+        mRxDownconverters.push_back(std::make_unique<Downconverter>(std::max<uint16_t>(ddc.rateRatio, 1), frequency));
+    }
+    lime::debug("Rx%i downconversion: decimation %i, filter taps %i",
+        chipId,
+        mRxDownconverters.front()->GetDecimation(),
+        static_cast<int>(mRxDownconverters.front()->GetTaps().size()));
+    return OpStatus::Success;
+}
+
+/// @brief Creates the Rx channelizer, if the stream configuration requests it.
+/// @return The status of the operation.
+OpStatus TRXLooper::RxChannelizationSetup()
+{
+    mRxChannelizer.reset();
+    const StreamConfig::Extras::Channelization& split = mConfig.extraConfig.rxChannelization;
+    if (split.channelCount == 0)
+        return OpStatus::Success;
+
+    if (mConfig.channels.at(lime::TRXDir::Rx).size() != 1)
+        return ReportError(OpStatus::NotSupported, "Rx channelization requires a single Rx channel"s);
+
+    const uint16_t decimation = split.decimation != 0 ? split.decimation : split.channelCount;
+    try
+    {
+        mRxChannelizer = std::make_unique<Channelizer>(split.channelCount, decimation, split.outputs);
+    } catch (std::exception& e)
+    {
+        return ReportError(OpStatus::InvalidValue, "Rx%i channelization: %s", chipId, e.what());
+    }
+    mRxChannelizerDest.resize(split.outputs.size());
+    lime::debug("Rx%i channelization: %i sub-channels, decimation %i, %i outputs, filter taps %i",
+        chipId,
+        mRxChannelizer->GetChannelCount(),
+        mRxChannelizer->GetDecimation(),
+        static_cast<int>(split.outputs.size()),
+        static_cast<int>(mRxChannelizer->GetTaps().size()));
+    return OpStatus::Success;
+}
+
+/// @brief Creates the DC and IQ imbalance trackers of the Rx channels, if the stream configuration requests them.
+/// @return The status of the operation.
+OpStatus TRXLooper::RxImpairmentCorrectionSetup()
+{
+    mRxImpairmentTrackers.clear();
+    const StreamConfig::Extras::ImpairmentCorrection& correction = mConfig.extraConfig.rxImpairmentCorrection;
+    if (!correction.dc && !correction.iq)
+        return OpStatus::Success;
+
+    // the impairments are estimated on the link samples, a frequency shift would turn them into tones
+    if (!mRxDownconverters.empty())
+        return ReportError(OpStatus::NotSupported, "Rx impairment correction can't be used together with Rx downconversion"s);
+
+    const double timeConstant =
+        correction.timeConstant != 0 ? correction.timeConstant : IQImpairmentTracker::defaultTimeConstant;
+    for (std::size_t i = 0; i < mConfig.channels.at(lime::TRXDir::Rx).size(); ++i)
+        mRxImpairmentTrackers.push_back(std::make_unique<IQImpairmentTracker>(timeConstant, correction.dc, correction.iq));
+    lime::debug("Rx%i impairment correction: DC %s, IQ %s, time constant %g samples",
+        chipId,
+        correction.dc ? "on" : "off",
+        correction.iq ? "on" : "off",
+        timeConstant);
+    return OpStatus::Success;
+}
+
+/// @brief Creates the automatic gain control and starts its thread, if the stream configuration requests it.
+/// @return The status of the operation.
+OpStatus TRXLooper::RxGainControlSetup()
+{
+    mRxGainControl.controller.reset();
+    mRxGainControl.changes.clear();
+    mRxGainControl.measured = false;
+    mRxGainControl.terminate = false;
+    mRxGainControl.settleTimestamp.store(0, std::memory_order_relaxed);
+    const StreamConfig::Extras::GainControl& agc = mConfig.extraConfig.rxGainControl;
+    const std::vector<uint8_t>& channels = mConfig.channels.at(lime::TRXDir::Rx);
+    if (!agc.enabled || channels.empty())
+        return OpStatus::Success;
+
+    if (!mGainDevice)
+        return ReportError(OpStatus::NotSupported, "Rx gain control is not supported by the device"s);
+    const RFSOCDescriptor& soc = mGainDevice->GetDescriptor().rfSOC.at(chipId);
+    const auto ranges = soc.gainRange.find(TRXDir::Rx);
+    if (ranges == soc.gainRange.end() || ranges->second.count(eGainTypes::GENERIC) == 0)
+        return ReportError(OpStatus::NotSupported, "Rx%i gain control: the gain range is unknown", chipId);
+
+    GainController::Settings settings{ agc.targetPower, agc.peakLimit, agc.hysteresis, ranges->second.at(eGainTypes::GENERIC) };
+    try
+    {
+        mRxGainControl.controller = std::make_unique<GainController>(settings);
+    } catch (std::exception& e)
+    {
+        return ReportError(OpStatus::InvalidValue, "Rx%i gain control: %s", chipId, e.what());
+    }
+
+    // the measurements are made on the samples after the downconversion
+    const StreamConfig::Extras::FrequencyConversion& ddc = mConfig.extraConfig.rxDownconversion;
+    const double sampleRate = mConfig.hintSampleRate / std::max<uint16_t>(ddc.rateRatio, 1);
+    mRxGainControl.updatePeriod = agc.updatePeriod;
+    if (mRxGainControl.updatePeriod == 0)
+        mRxGainControl.updatePeriod = sampleRate > 0 ? std::ceil(sampleRate / 100) : 65536;
+
+    GainChange initial{ 0, { 0, 0 } };
+    for (std::size_t i = 0; i < channels.size(); ++i)
+    {
+        double gain = 0;
+        if (mGainDevice->GetGain(chipId, TRXDir::Rx, channels[i], eGainTypes::GENERIC, gain) != OpStatus::Success)
+            return ReportError(OpStatus::IOFailure, "Rx%i gain control: failed to read the gain", chipId);
+        initial.gain[i] = gain;
+    }
+    mRxGainControl.changes.push_back(initial);
+
+    mRxGainControl.thread = std::thread(&TRXLooper::RxGainControlLoop, this);
+#ifdef __linux__
+    char threadName[16]; // limited to 16 chars, including null byte.
+    snprintf(threadName, sizeof(threadName), "lime:AGC%i", chipId);
+    pthread_setname_np(mRxGainControl.thread.native_handle(), threadName);
+#endif
+    lime::debug("Rx%i gain control: target %g dBFS, peak limit %g dBFS, update every %u samples",
+        chipId,
+        agc.targetPower,
+        agc.peakLimit,
+        mRxGainControl.updatePeriod);
+    return OpStatus::Success;
+}
+
+/// @brief Applies the gain control law to the measurements posted by the Rx loop.
+/// The gain changes are done here, so the slow control transfers don't delay the Rx loop.
+void TRXLooper::RxGainControlLoop()
+{
+    GainControlState& agc = mRxGainControl;
+    const std::vector<uint8_t>& channels = mConfig.channels.at(lime::TRXDir::Rx);
+
+    std::unique_lock lck{ agc.mutex };
+    float gain[2] = { agc.changes.back().gain[0], agc.changes.back().gain[1] };
+    while (true)
+    {
+        agc.cv.wait(lck, [&agc] { return agc.measured || agc.terminate; });
+        if (agc.terminate)
+            break;
+        PowerMeasurement power[2] = { agc.power[0], agc.power[1] };
+        agc.measured = false;
+        lck.unlock();
+
+        GainChange change{ 0, { gain[0], gain[1] } };
+        bool changed = false;
+        for (std::size_t i = 0; i < channels.size(); ++i)
+        {
+            const double newGain =
+                agc.controller->Update(PowerToDecibels(power[i].Mean()), PowerToDecibels(power[i].peak), gain[i]);
+            if (newGain == gain[i])
+                continue;
+            if (!changed)
+                change.timestamp = mRx.lastTimestamp.load(std::memory_order_relaxed);
+            changed = true;
+            if (mGainDevice->SetGain(chipId, TRXDir::Rx, channels[i], eGainTypes::GENERIC, newGain) != OpStatus::Success)
+            {
+                char msg[64];
+                std::snprintf(msg, sizeof(msg), "Rx%i gain control: failed to set the gain", chipId);
+                PostLogMessage(LogLevel::Warning, msg);
+                continue;
+            }
+            change.gain[i] = newGain;
+        }
+        // the samples received until now might have been measured with the old gain
+        if (changed)
+            agc.settleTimestamp.store(mRx.lastTimestamp.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        lck.lock();
+        if (changed)
+        {
+            agc.changes.push_back(change);
+            if (agc.changes.size() > gainChangesToKeep)
+                agc.changes.pop_front();
+            gain[0] = change.gain[0];
+            gain[1] = change.gain[1];
+        }
+    }
+}
+
 struct DMATransactionCounter {
     uint64_t requests{ 0 };
     uint64_t completed{ 0 };
@@ -444,6 +775,7 @@ void TRXLooper::ReceivePacketsLoop()
     conversion.srcFormat = mConfig.linkFormat;
     conversion.destFormat = mConfig.format;
     conversion.channelCount = std::max(mConfig.channels.at(lime::TRXDir::Tx).size(), mConfig.channels.at(lime::TRXDir::Rx).size());
+    conversion.dither = mConfig.extraConfig.rxDither;
 
     const int32_t bufferCount = mRxArgs.buffers.size();
     const int32_t readSize = mRxArgs.packetSize * mRxArgs.packetsToBatch;
@@ -453,7 +785,7 @@ void TRXLooper::ReceivePacketsLoop()
     StreamStats& stats = mRx.stats;
     auto& fifo = mRx.fifo;
 
-    const uint8_t outputSampleSize = mConfig.format == DataFormat::F32 ? sizeof(complex32f_t) : sizeof(complex16_t);
+    const uint8_t outputSampleSize = HostSampleSize(mConfig.format);
     const int32_t outputPktSize = SamplesPacketType::headerSize + mRxArgs.packetsToBatch * samplesInPkt * outputSampleSize;
 
     DeltaVariable<int32_t> overrun(0);
@@ -468,9 +800,27 @@ void TRXLooper::ReceivePacketsLoop()
     int64_t expectedTS = 0;
     SamplesPacketType* outputPkt = nullptr;
 
+    std::vector<Downconverter*> downconverters;
+    for (const auto& ddc : mRxDownconverters)
+    {
+        ddc->Reset();
+        downconverters.push_back(ddc.get());
+    }
+    const int linkSampleSize = mConfig.linkFormat == DataFormat::I16 ? sizeof(complex16_t) : sizeof(complex12packed_t);
+
     uint32_t lastHwIndex{ 0 };
     DMATransactionCounter counters;
 
+    // time when each DMA buffer was noticed as completed, for latency statistics
+    std::vector<int64_t> completionTime(bufferCount, 0);
+
+    const std::size_t rxChannelCount = mConfig.channels.at(lime::TRXDir::Rx).size();
+    const bool meterPower = mConfig.extraConfig.rxPowerMetering || mRxGainControl.controller;
+    PowerMeasurement periodPower[2];
+    PowerMeasurement gainControlPower[2];
+    // after a gain change, the DMA buffers can still hold samples received with the previous gain
+    const uint64_t transferLatency = static_cast<uint64_t>(bufferCount) * mRxArgs.packetsToBatch * samplesInPkt;
+
     assert(mRx.stagingPacket == nullptr); // should be clean start
     assert(fifo->empty());
 
@@ -490,6 +840,12 @@ void TRXLooper::ReceivePacketsLoop()
 
         // print stats
         t2 = std::chrono::steady_clock::now();
+        if (counterDiff > 0)
+        {
+            const int64_t now = ToNanoseconds(t2);
+            for (int64_t i = counters.completed - counterDiff; i < static_cast<int64_t>(counters.completed); ++i)
+                completionTime[i % bufferCount] = now;
+        }
         const auto timePeriod{ std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count() };
         if (timePeriod >= statsPeriod_ms)
         {
@@ -516,15 +872,22 @@ void TRXLooper::ReceivePacketsLoop()
                 fifo->size());
             if (showStats)
                 printf("%s\n", msg);
-            if (mCallback_logMessage)
+            if (GetLogCallback())
             {
                 bool showAsWarning = overrun.delta() || loss.delta();
                 LogLevel level = showAsWarning ? LogLevel::Warning : LogLevel::Debug;
-                mCallback_logMessage(level, msg);
+                PostLogMessage(level, msg);
             }
             overrun.checkpoint();
             loss.checkpoint();
             Bps = 0;
+
+            for (std::size_t i = 0; meterPower && i < rxChannelCount; ++i)
+            {
+                stats.meanPower[i] = PowerToDecibels(periodPower[i].Mean());
+                stats.peakPower[i] = PowerToDecibels(periodPower[i].peak);
+                periodPower[i] = PowerMeasurement();
+            }
         }
 
         if (counters.completed - counters.requests == 0)
@@ -552,7 +915,8 @@ void TRXLooper::ReceivePacketsLoop()
         const uint8_t* buffer{ dmaBuffers.at(currentBufferIndex) };
 
         const FPGA_RxDataPacket* pkt = reinterpret_cast<const FPGA_RxDataPacket*>(buffer);
-        outputPkt->timestamp = pkt->counter;
+        const uint64_t batchTimestamp = pkt->counter;
+        outputPkt->timestamp = downconverters.empty() ? pkt->counter : downconverters.front()->GetOutputTimestamp(pkt->counter);
 
         bool reportProblems = false;
         const int srcPktCount = mRxArgs.packetsToBatch;
@@ -577,9 +941,24 @@ void TRXLooper::ReceivePacketsLoop()
             }
 
             const int payloadSize{ packetSize - headerSize };
-            const int samplesProduced = Deinterleave(outputPkt->back(), pkt->data, payloadSize, conversion);
-            outputPkt->SetSize(outputPkt->size() + samplesProduced);
-            expectedTS = pkt->counter + samplesProduced;
+            if (downconverters.empty())
+            {
+                const int samplesProduced = Deinterleave(outputPkt->back(), pkt->data, payloadSize, conversion);
+                outputPkt->SetSize(outputPkt->size() + samplesProduced);
+                expectedTS = pkt->counter + samplesProduced;
+            }
+            else
+            {
+                const int samplesProduced = DeinterleaveDownconvert(outputPkt->back(),
+                    pkt->data,
+                    payloadSize,
+                    conversion,
+                    downconverters.data(),
+                    downconverters.size(),
+                    pkt->counter);
+                outputPkt->SetSize(outputPkt->size() + samplesProduced);
+                expectedTS = pkt->counter + payloadSize / (linkSampleSize * conversion.channelCount);
+            }
         }
         stats.packets += srcPktCount;
         stats.timestamp = expectedTS;
@@ -595,11 +974,72 @@ void TRXLooper::ReceivePacketsLoop()
             case DataFormat::F32:
                 outputPkt->Scale<complex32f_t>(1, -1, mConfig.channels.at(lime::TRXDir::Rx).size());
                 break;
+            case DataFormat::I8:
+                outputPkt->Scale<complex8_t>(1, -1, mConfig.channels.at(lime::TRXDir::Rx).size());
+                break;
+            case DataFormat::F16:
+                outputPkt->Scale<complex16f_t>(1, -1, mConfig.channels.at(lime::TRXDir::Rx).size());
+                break;
             default:
                 break;
             }
         }
 
+        if (!mRxImpairmentTrackers.empty())
+        {
+            void* const* channels = outputPkt->front();
+            for (std::size_t i = 0; i < mRxImpairmentTrackers.size(); ++i)
+                mRxImpairmentTrackers[i]->Process(channels[i], outputPkt->size(), mConfig.format);
+        }
+
+        if (meterPower)
+        {
+            void* const* channels = outputPkt->front();
+            const bool settled =
+                batchTimestamp >= mRxGainControl.settleTimestamp.load(std::memory_order_relaxed) + transferLatency;
+            for (std::size_t i = 0; i < rxChannelCount; ++i)
+            {
+                const PowerMeasurement power = MeasurePower(channels[i], outputPkt->size(), mConfig.format);
+                outputPkt->meanPower[i] = power.Mean();
+                outputPkt->peakPower[i] = power.peak;
+                periodPower[i].Add(power);
+                if (settled)
+                    gainControlPower[i].Add(power);
+            }
+
+            if (mRxGainControl.controller && gainControlPower[0].count >= mRxGainControl.updatePeriod)
+            {
+                // never wait for the gain control thread, the measurement is dropped if it's busy
+                std::unique_lock lck{ mRxGainControl.mutex, std::try_to_lock };
+                if (lck.owns_lock())
+                {
+                    mRxGainControl.power[0] = gainControlPower[0];
+                    mRxGainControl.power[1] = gainControlPower[1];
+                    mRxGainControl.measured = true;
+                    mRxGainControl.cv.notify_one();
+                }
+                gainControlPower[0] = gainControlPower[1] = PowerMeasurement();
+            }
+        }
+
+        // retain samples before handing them to the FIFO, so they are kept even if the FIFO overflows
+        if (mRxHistory)
+        {
+            uint8_t* const* channels = reinterpret_cast<uint8_t* const*>(outputPkt->front());
+            for (int i = 0; i < srcPktCount; ++i)
+            {
+                pkt = reinterpret_cast<const FPGA_RxDataPacket*>(&buffer[packetSize * i]);
+                const std::size_t offset = i * samplesInPkt * outputSampleSize;
+                const void* src[2] = { channels[0] + offset, nullptr };
+                if (rxChannelCount > 1)
+                    src[1] = channels[1] + offset;
+                mRxHistory->Write(src, samplesInPkt, pkt->counter);
+            }
+        }
+
+        const int64_t queuedTime = ToNanoseconds(std::chrono::steady_clock::now());
+        stats.dmaToFifo.Add(ElapsedNanoseconds(completionTime[currentBufferIndex], queuedTime));
+        outputPkt->queuedTime = queuedTime;
         if (fifo->push(outputPkt, false))
         {
             outputPkt = nullptr;
@@ -614,6 +1054,7 @@ void TRXLooper::ReceivePacketsLoop()
         bool requestIRQ = (counters.requests % irqPeriod) == 0;
         ++counters.requests;
         mRxArgs.dma->SubmitRequest(currentBufferIndex, readSize, DataTransferDirection::DeviceToHost, requestIRQ);
+        stats.loopTime.Add(ElapsedNanoseconds(ToNanoseconds(t2), ToNanoseconds(std::chrono::steady_clock::now())));
 
         // one callback for the entire batch
         if (reportProblems && mConfig.statusCallback)
@@ -654,6 +1095,33 @@ void TRXLooper::RxTeardown()
 
     delete mRx.fifo.release();
     delete mRx.memPool.release();
+    mRxHistory.reset();
+    mRxDownconverters.clear();
+    mRxChannelizer.reset();
+    mRxImpairmentTrackers.clear();
+
+    if (mRxGainControl.thread.joinable())
+    {
+        {
+            std::unique_lock lck{ mRxGainControl.mutex };
+            mRxGainControl.terminate = true;
+        }
+        mRxGainControl.cv.notify_one();
+        mRxGainControl.thread.join();
+    }
+    mRxGainControl.controller.reset();
+}
+
+/// @brief Converts the hardware timestamp to the timestamp of the samples returned by StreamRx().
+/// @param timestamp The hardware timestamp.
+/// @return The timestamp after the downconversion and the channelization.
+uint64_t TRXLooper::RxOutputTimestamp(uint64_t timestamp) const
+{
+    if (!mRxDownconverters.empty())
+        timestamp = mRxDownconverters.front()->GetOutputTimestamp(timestamp);
+    if (mRxChannelizer)
+        timestamp = mRxChannelizer->GetOutputTimestamp(timestamp);
+    return timestamp;
 }
 
 template<class T> uint32_t TRXLooper::StreamRxTemplate(T* const* dest, uint32_t count, StreamMeta* meta)
@@ -664,6 +1132,12 @@ template<class T> uint32_t TRXLooper::StreamRxTemplate(T* const* dest, uint32_t
 
     bool firstIteration = true;
 
+    const bool meterPower = meta && (mConfig.extraConfig.rxPowerMetering || mRxGainControl.controller);
+    const std::size_t rxChannelCount = mConfig.channels.at(TRXDir::Rx).size();
+    float powerSum[2] = { 0, 0 };
+    float peakPower[2] = { 0, 0 };
+    uint32_t powerCount = 0;
+
     assert(dest);
     assert(dest[0]);
     if (useChannelB)
@@ -677,28 +1151,58 @@ template<class T> uint32_t TRXLooper::StreamRxTemplate(T* const* dest, uint32_t
             lime::error("No samples or timeout"s);
             return samplesProduced;
         }
+        if (mRx.stagingPacket->queuedTime != 0)
+        {
+            mRx.stats.fifoToUser.Add(
+                ElapsedNanoseconds(mRx.stagingPacket->queuedTime, ToNanoseconds(std::chrono::steady_clock::now())));
+            mRx.stagingPacket->queuedTime = 0; // count only the first read of the packet
+        }
 
+        const uint64_t packetTimestamp = mRx.stagingPacket->timestamp;
         if (!timestampSet && meta)
         {
-            meta->timestamp = mRx.stagingPacket->timestamp;
+            meta->timestamp = mRxChannelizer ? mRxChannelizer->GetOutputTimestamp(packetTimestamp) : packetTimestamp;
             timestampSet = true;
         }
 
         uint32_t expectedCount = count - samplesProduced;
-        const uint32_t samplesToCopy = std::min(expectedCount, mRx.stagingPacket->size());
-
         T* const* src = reinterpret_cast<T* const*>(mRx.stagingPacket->front());
+        uint32_t samplesConsumed = 0;
 
-        std::memcpy(&dest[0][samplesProduced], src[0], samplesToCopy * sizeof(T));
-
-        if (useChannelB)
+        if (mRxChannelizer)
         {
-            assert(dest[1]);
-            std::memcpy(&dest[1][samplesProduced], src[1], samplesToCopy * sizeof(T));
+            // consume only the samples needed for the requested outputs, the rest stay for the next call
+            const uint32_t samplesToProcess =
+                std::min<uint64_t>(mRxChannelizer->GetInputCount(packetTimestamp, expectedCount), mRx.stagingPacket->size());
+            for (std::size_t i = 0; i < mRxChannelizerDest.size(); ++i)
+                mRxChannelizerDest[i] = &dest[i][samplesProduced];
+            samplesProduced += mRxChannelizer->Process(
+                src[0], samplesToProcess, packetTimestamp, reinterpret_cast<T* const*>(mRxChannelizerDest.data()));
+            mRx.stagingPacket->pop(samplesToProcess);
+            samplesConsumed = samplesToProcess;
         }
+        else
+        {
+            const uint32_t samplesToCopy = std::min(expectedCount, mRx.stagingPacket->size());
+            std::memcpy(&dest[0][samplesProduced], src[0], samplesToCopy * sizeof(T));
+
+            if (useChannelB)
+            {
+                assert(dest[1]);
+                std::memcpy(&dest[1][samplesProduced], src[1], samplesToCopy * sizeof(T));
+            }
 
-        mRx.stagingPacket->pop(samplesToCopy);
-        samplesProduced += samplesToCopy;
+            mRx.stagingPacket->pop(samplesToCopy);
+            samplesProduced += samplesToCopy;
+            samplesConsumed = samplesToCopy;
+        }
+
+        for (std::size_t i = 0; meterPower && i < rxChannelCount; ++i)
+        {
+            powerSum[i] += mRx.stagingPacket->meanPower[i] * samplesConsumed;
+            peakPower[i] = std::max(peakPower[i], mRx.stagingPacket->peakPower[i]);
+        }
+        powerCount += samplesConsumed;
 
         if (mRx.stagingPacket->empty())
         {
@@ -711,6 +1215,24 @@ template<class T> uint32_t TRXLooper::StreamRxTemplate(T* const* dest, uint32_t
         //     return samplesProduced;
     }
 
+    for (std::size_t i = 0; meterPower && i < rxChannelCount; ++i)
+    {
+        meta->meanPower[i] = PowerToDecibels(powerCount ? powerSum[i] / powerCount : 0);
+        meta->peakPower[i] = PowerToDecibels(peakPower[i]);
+    }
+    if (meta && mRxGainControl.controller)
+    {
+        // the latest change before the end of the returned samples, the oldest kept one if all are later
+        const uint64_t endTimestamp = meta->timestamp + samplesProduced;
+        std::unique_lock lck{ mRxGainControl.mutex };
+        auto change = mRxGainControl.changes.rbegin();
+        while (std::next(change) != mRxGainControl.changes.rend() && RxOutputTimestamp(change->timestamp) >= endTimestamp)
+            ++change;
+        meta->gain[0] = change->gain[0];
+        meta->gain[1] = change->gain[1];
+        meta->gainTimestamp = RxOutputTimestamp(change->timestamp);
+    }
+
     return samplesProduced;
 }
 
@@ -736,6 +1258,62 @@ uint32_t TRXLooper::StreamRx(lime::complex12_t* const* samples, uint32_t count,
     return StreamRxTemplate<complex12_t>(samples, count, meta);
 }
 
+uint32_t TRXLooper::StreamRx(lime::complex8_t* const* samples, uint32_t count, StreamMeta* meta)
+{
+    return StreamRxTemplate<complex8_t>(samples, count, meta);
+}
+
+uint32_t TRXLooper::StreamRx(lime::complex16f_t* const* samples, uint32_t count, StreamMeta* meta)
+{
+    return StreamRxTemplate<complex16f_t>(samples, count, meta);
+}
+
+template<class T> OpStatus TRXLooper::StreamRxHistoryTemplate(T* const* dest, uint64_t timestamp, uint32_t count)
+{
+    if (!mRxHistory)
+        return ReportError(OpStatus::NotSupported, "Rx history is not enabled"s);
+    if (sizeof(T) != mRxHistory->frameSize())
+        return ReportError(OpStatus::InvalidValue, "Rx history samples format mismatch"s);
+
+    assert(dest);
+    void* channels[2] = { dest[0], mConfig.channels.at(TRXDir::Rx).size() > 1 ? dest[1] : nullptr };
+    return mRxHistory->Read(channels, timestamp, count);
+}
+
+/// @brief Copies out already received samples from the Rx history buffer.
+/// @param samples The buffer to put the samples in.
+/// @param timestamp The timestamp of the first sample to copy.
+/// @param count The amount of samples to copy.
+/// @return OpStatus::Success if the whole window was copied, OpStatus::OutOfRange if it's no longer (or not yet) retained.
+OpStatus TRXLooper::StreamRxHistory(complex32f_t* const* samples, uint64_t timestamp, uint32_t count)
+{
+    return StreamRxHistoryTemplate<complex32f_t>(samples, timestamp, count);
+}
+
+/// @copydoc TRXLooper::StreamRxHistory()
+OpStatus TRXLooper::StreamRxHistory(complex16_t* const* samples, uint64_t timestamp, uint32_t count)
+{
+    return StreamRxHistoryTemplate<complex16_t>(samples, timestamp, count);
+}
+
+/// @copydoc TRXLooper::StreamRxHistory()
+OpStatus TRXLooper::StreamRxHistory(complex12_t* const* samples, uint64_t timestamp, uint32_t count)
+{
+    return StreamRxHistoryTemplate<complex12_t>(samples, timestamp, count);
+}
+
+/// @copydoc TRXLooper::StreamRxHistory()
+OpStatus TRXLooper::StreamRxHistory(complex8_t* const* samples, uint64_t timestamp, uint32_t count)
+{
+    return StreamRxHistoryTemplate<complex8_t>(samples, timestamp, count);
+}
+
+/// @copydoc TRXLooper::StreamRxHistory()
+OpStatus TRXLooper::StreamRxHistory(complex16f_t* const* samples, uint64_t timestamp, uint32_t count)
+{
+    return StreamRxHistoryTemplate<complex16f_t>(samples, timestamp, count);
+}
+
 OpStatus TRXLooper::TxSetup()
 {
     OpStatus status = mTxArgs.dma->Initialize();
@@ -783,7 +1361,11 @@ OpStatus TRXLooper::TxSetup()
     mTxArgs.packetsToBatch = mTx.packetsToBatch;
     mTxArgs.samplesInPacket = samplesInPkt;
 
-    if (mCallback_logMessage)
+    status = TxUpconversionSetup();
+    if (status != OpStatus::Success)
+        return status;
+
+    if (const auto callback = GetLogCallback())
     {
         float bufferTimeDuration;
         if (mConfig.hintSampleRate)
@@ -798,7 +1380,7 @@ OpStatus TRXLooper::TxSetup()
             samplesInPkt,
             mTx.packetsToBatch,
             bufferTimeDuration * 1e6);
-        mCallback_logMessage(LogLevel::Verbose, msg);
+        (*callback)(LogLevel::Verbose, msg);
     }
 
     const std::string name = "MemPool_Tx"s + std::to_string(chipId);
@@ -832,6 +1414,38 @@ OpStatus TRXLooper::TxSetup()
     return OpStatus::Success;
 }
 
+/// @brief Creates the upconverters of the Tx channels, if the stream configuration requests them.
+/// @return The status of the operation.
+OpStatus TRXLooper::TxUpconversionSetup()
+{
+    mTxUpconverters.clear();
+    const StreamConfig::Extras::FrequencyConversion& duc = mConfig.extraConfig.txUpconversion;
+    const std::size_t txChannelCount = mConfig.channels.at(lime::TRXDir::Tx).size();
+    const bool shifted = duc.frequencyOffset[0] != 0 || duc.frequencyOffset[1] != 0;
+    if ((duc.rateRatio <= 1 && !shifted) || txChannelCount == 0)
+        return OpStatus::Success;
+
+    if (shifted && mConfig.hintSampleRate <= 0)
+        return ReportError(OpStatus::InvalidValue, "Tx upconversion frequency offset requires hintSampleRate"s);
+    if (duc.rateRatio > mTxArgs.samplesInPacket)
+        return ReportError(OpStatus::InvalidValue, "Tx upconversion rate ratio can't exceed %i", mTxArgs.samplesInPacket);
+
+    for (std::size_t i = 0; i < txChannelCount; ++i)
+    {
+        const uint8_t channel = mConfig.channels.at(lime::TRXDir::Tx).at(i);
+        double frequency = shifted ? duc.frequencyOffset[channel & 1] / mConfig.hintSampleRate : 0;
+        // negateQ conjugates the samples before the upconversion, so the shift direction has to be mirrored
+        if (mConfig.extraConfig.negateQ)
+            frequency = -frequency;
+        mTxUpconverters.push_back(std::make_unique<Upconverter>(std::max<uint16_t>(duc.rateRatio, 1), frequency));
+    }
+    lime::debug("Tx%i upconversion: interpolation %i, filter taps %i",
+        chipId,
+        mTxUpconverters.front()->GetInterpolation(),
+        static_cast<int>(mTxUpconverters.front()->GetTaps().size()));
+    return OpStatus::Success;
+}
+
 void TRXLooper::TxWorkLoop()
 {
     lime::debug("Tx worker thread ready.");
@@ -894,6 +1508,15 @@ void TRXLooper::TransmitPacketsLoop()
     SamplesPacketType* srcPkt = nullptr;
 
     TxBufferManager<SamplesPacketType> output(mimo, compressed, mTxArgs.samplesInPacket, mTxArgs.packetsToBatch, mConfig.format);
+    std::vector<Upconverter*> upconverters;
+    for (const auto& duc : mTxUpconverters)
+    {
+        duc->Reset();
+        upconverters.push_back(duc.get());
+    }
+    output.SetUpconverters(upconverters);
+    // source packets timestamps are counted before the interpolation
+    const int64_t interpolation = upconverters.empty() ? 1 : upconverters.front()->GetInterpolation();
 
     mTxArgs.dma->BufferOwnership(0, DataTransferDirection::DeviceToHost);
     output.Reset(dmaBuffers[0], mTxArgs.bufferSize);
@@ -911,6 +1534,9 @@ void TRXLooper::TransmitPacketsLoop()
     uint64_t lastHwIndex = 0;
     DMATransactionCounter counters;
 
+    // queue time of the oldest samples placed in the current output buffer
+    int64_t outputQueuedTime = 0;
+
     while (mTx.terminate.load(std::memory_order_relaxed) == false)
     {
         IDMA::State dma{ mTxArgs.dma->GetCounters() };
@@ -939,7 +1565,7 @@ void TRXLooper::TransmitPacketsLoop()
             double avgTxAdvance = 0, rmsTxAdvance = 0;
             txTSAdvance.GetResult(avgTxAdvance, rmsTxAdvance);
             loss.set(stats.loss);
-            if (showStats || mCallback_logMessage)
+            if (showStats || GetLogCallback())
             {
                 char msg[512];
                 std::snprintf(msg,
@@ -965,11 +1591,11 @@ void TRXLooper::TransmitPacketsLoop()
                     fifo->size());
                 if (showStats)
                     lime::info("%s", msg);
-                if (mCallback_logMessage)
+                if (GetLogCallback())
                 {
                     bool showAsWarning = underrun.delta() || loss.delta();
                     LogLevel level = showAsWarning ? LogLevel::Warning : LogLevel::Debug;
-                    mCallback_logMessage(level, msg);
+                    PostLogMessage(level, msg);
                 }
             }
             loss.checkpoint();
@@ -997,6 +1623,12 @@ void TRXLooper::TransmitPacketsLoop()
                     case DataFormat::F32:
                         srcPkt->Scale<complex32f_t>(1, -1, mConfig.channels.at(lime::TRXDir::Tx).size());
                         break;
+                    case DataFormat::I8:
+                        srcPkt->Scale<complex8_t>(1, -1, mConfig.channels.at(lime::TRXDir::Tx).size());
+                        break;
+                    case DataFormat::F16:
+                        srcPkt->Scale<complex16f_t>(1, -1, mConfig.channels.at(lime::TRXDir::Tx).size());
+                        break;
                     default:
                         break;
                     }
@@ -1007,7 +1639,7 @@ void TRXLooper::TransmitPacketsLoop()
             if (srcPkt->useTimestamp && isRxActive)
             {
                 int64_t rxNow = mRx.lastTimestamp.load(std::memory_order_relaxed);
-                const int64_t txAdvance = srcPkt->timestamp - rxNow;
+                const int64_t txAdvance = srcPkt->timestamp * interpolation - rxNow;
                 if (mConfig.hintSampleRate)
                 {
                     int64_t timeAdvance = ts_to_us(mConfig.hintSampleRate, txAdvance);
@@ -1025,6 +1657,8 @@ void TRXLooper::TransmitPacketsLoop()
                 }
             }
 
+            if (outputQueuedTime == 0)
+                outputQueuedTime = srcPkt->queuedTime;
             const bool doFlush = output.consume(srcPkt);
 
             if (srcPkt->empty())
@@ -1093,6 +1727,12 @@ void TRXLooper::TransmitPacketsLoop()
             continue;
         }
 
+        const int64_t submitTime = ToNanoseconds(std::chrono::steady_clock::now());
+        if (outputQueuedTime != 0)
+            stats.userToDma.Add(ElapsedNanoseconds(outputQueuedTime, submitTime));
+        outputQueuedTime = 0;
+        stats.loopTime.Add(ElapsedNanoseconds(ToNanoseconds(t2), submitTime));
+
         pendingWrites.push(wrInfo);
         stagingBufferIndex = (stagingBufferIndex + 1) % bufferCount;
         mTxArgs.dma->BufferOwnership(stagingBufferIndex, DataTransferDirection::DeviceToHost);
@@ -1136,6 +1776,7 @@ void TRXLooper::TxTeardown()
 
     delete mTx.fifo.release();
     delete mTx.memPool.release();
+    mTxUpconverters.clear();
 }
 
 template<class T> uint32_t TRXLooper::StreamTxTemplate(const T* const* samples, uint32_t count, const StreamMeta* meta)
@@ -1153,6 +1794,7 @@ template<class T> uint32_t TRXLooper::StreamTxTemplate(const T* const* samples,
 
     if (mTx.stagingPacket && mTx.stagingPacket->timestamp + mTx.stagingPacket->size() != meta->timestamp)
     {
+        mTx.stagingPacket->queuedTime = ToNanoseconds(std::chrono::steady_clock::now());
         if (!mTx.fifo->push(mTx.stagingPacket))
             return 0;
 
@@ -1192,6 +1834,7 @@ template<class T> uint32_t TRXLooper::StreamTxTemplate(const T* const* samples,
             if (samplesRemaining == 0)
                 mTx.stagingPacket->flush = flush;
 
+            mTx.stagingPacket->queuedTime = ToNanoseconds(std::chrono::steady_clock::now());
             if (!mTx.fifo->push(mTx.stagingPacket))
                 break;
 
@@ -1224,6 +1867,18 @@ uint32_t TRXLooper::StreamTx(const lime::complex12_t* const* samples, uint32_t c
     return StreamTxTemplate(samples, count, meta);
 }
 
+/// @copydoc TRXLooper::StreamTx()
+uint32_t TRXLooper::StreamTx(const lime::complex8_t* const* samples, uint32_t count, const StreamMeta* meta)
+{
+    return StreamTxTemplate(samples, count, meta);
+}
+
+/// @copydoc TRXLooper::StreamTx()
+uint32_t TRXLooper::StreamTx(const lime::complex16f_t* const* samples, uint32_t count, const StreamMeta* meta)
+{
+    return StreamTxTemplate(samples, count, meta);
+}
+
 /// @brief Gets statistics from a specified transfer direction.
 /// @param dir The direction of which to get the statistics.
 /// @return The statistics of the transfers.
@@ -1251,20 +1906,48 @@ StreamStats TRXLooper::GetStats(TRXDir dir) const
     return stats;
 }
 
+/// @brief Uploads the waveform to the FPGA memory through the Tx DMA of this stream.
+/// @param config The configuration of the stream.
+/// @param samples The samples to upload.
+/// @param count The amount of samples to upload.
+/// @param callback The callback to call for progress updates (optional).
+/// @return The status of the operation.
+OpStatus TRXLooper::UploadTxWaveform(
+    const StreamConfig& config, const void** samples, uint32_t count, SDRDevice::UploadMemoryCallback callback)
+{
+    return UploadTxWaveform(fpga, mTxArgs.dma, config, chipId, samples, count, callback);
+}
+
 /// @copydoc SDRDevice::UploadTxWaveform()
 /// @param fpga The FPGA device to use.
 /// @param dma The data channel to use.
+/// Samples are sent in full size packets, batched to fill whole DMA buffers. The upload is
+/// complete once the DMA counters report all the submitted transfers as done.
+/// Progress is reported in samples.
 OpStatus TRXLooper::UploadTxWaveform(FPGA* fpga,
     std::shared_ptr<IDMA> dma,
     const lime::StreamConfig& config,
     uint8_t moduleIndex,
     const void** samples,
-    uint32_t count)
+    uint32_t count,
+    SDRDevice::UploadMemoryCallback callback)
 {
-    const int samplesInPkt = 256;
-    const bool useChannelB = config.channels.at(lime::TRXDir::Tx).size() > 1;
-    const bool mimo = config.channels.at(lime::TRXDir::Tx).size() == 2;
-    const bool compressed = config.linkFormat == DataFormat::I12;
+    constexpr int irqPeriod{ 4 }; // Interrupt request period
+    constexpr auto completionTimeout{ std::chrono::seconds(1) };
+
+    const bool mimo = config.channels.at(lime::TRXDir::Tx).size() > 1;
+    const uint8_t channelCount = mimo ? 2 : 1;
+    const uint32_t frameSize = (config.linkFormat == DataFormat::I16 ? 4 : 3) * channelCount;
+    const uint32_t samplesInPkt = sizeof(FPGA_TxDataPacket::data) / frameSize;
+    const std::size_t sampleStride = HostSampleSize(config.format);
+    const DataConversion conversion{ config.format, config.linkFormat, channelCount };
+
+    const auto dmaChunks{ dma->GetBuffers() };
+    if (dmaChunks.empty())
+        return ReportError(OpStatus::Error, "Failed to upload waveform, no DMA buffers"s);
+    const uint32_t bufferCount = dmaChunks.size();
+    const uint32_t packetsInBatch = std::max<uint32_t>(1, dmaChunks.front().size / sizeof(FPGA_TxDataPacket));
+
     fpga->SelectModule(moduleIndex);
     fpga->WriteRegister(0x000C, mimo ? 0x3 : 0x1); //channels 0,1
     if (config.linkFormat == DataFormat::I16)
@@ -1274,79 +1957,93 @@ OpStatus TRXLooper::UploadTxWaveform(FPGA* fpga,
 
     fpga->WriteRegister(0x000D, 0x4); // WFM_LOAD
 
-    const auto dmaChunks{ dma->GetBuffers() };
-
-    std::vector<uint8_t*> dmaBuffers(dmaChunks.size());
-    for (uint32_t i = 0; i < dmaChunks.size(); ++i)
-        dmaBuffers[i] = dmaChunks[i].buffer;
-
     dma->Enable(true);
 
-    uint32_t samplesRemaining = count;
-    uint8_t stagingBufferIndex = 0;
+    uint32_t samplesSubmitted = 0;
+    int64_t transfersSubmitted = 0;
+    int64_t transfersCompleted = 0;
+    uint32_t lastHwIndex = dma->GetCounters().transfersCompleted;
+    // total amount of samples submitted, up to and including the transfer using each buffer
+    std::vector<uint32_t> transferEnd(bufferCount);
+    auto lastProgressTime = std::chrono::steady_clock::now();
+    OpStatus status = OpStatus::Success;
 
-    while (samplesRemaining > 0)
+    while (transfersCompleted < transfersSubmitted || samplesSubmitted < count)
     {
-        // IDMA::State state{ dma->GetCounters() };
-        dma->Wait(); // block until there is a free DMA buffer
+        const IDMA::State state{ dma->GetCounters() };
+        const int counterDiff = ReadySlots(state.transfersCompleted, lastHwIndex, 65536);
+        lastHwIndex = state.transfersCompleted;
+        if (counterDiff > 0)
+        {
+            transfersCompleted = std::min<int64_t>(transfersCompleted + counterDiff, transfersSubmitted);
+            lastProgressTime = std::chrono::steady_clock::now();
+            const uint32_t samplesDone = transferEnd.at((transfersCompleted - 1) % bufferCount);
+            if (callback && callback(samplesDone, count, "Uploading waveform"s))
+            {
+                status = OpStatus::Aborted;
+                break;
+            }
+        }
 
-        int samplesToSend = samplesRemaining > samplesInPkt ? samplesInPkt : samplesRemaining;
-        int samplesDataSize = 0;
+        const bool canSubmit = transfersSubmitted - transfersCompleted < static_cast<int64_t>(bufferCount) - 1;
+        if (samplesSubmitted >= count || !canSubmit)
+        {
+            if (std::chrono::steady_clock::now() - lastProgressTime > completionTimeout)
+            {
+                status = ReportError(OpStatus::Timeout,
+                    "Waveform upload timed out, %li of %li transfers completed",
+                    transfersCompleted,
+                    transfersSubmitted);
+                break;
+            }
+            dma->Wait(); // block until a transfer completes
+            continue;
+        }
 
+        const uint32_t stagingBufferIndex = transfersSubmitted % bufferCount;
         dma->BufferOwnership(stagingBufferIndex, DataTransferDirection::DeviceToHost);
 
-        FPGA_TxDataPacket* pkt = reinterpret_cast<FPGA_TxDataPacket*>(dmaBuffers[stagingBufferIndex]);
-        pkt->counter = 0;
-        pkt->reserved[0] = 0;
-
-        if (config.format == DataFormat::I16)
-        {
-            const lime::complex16_t* src[2] = { &static_cast<const lime::complex16_t*>(samples[0])[count - samplesRemaining],
-                useChannelB ? &static_cast<const lime::complex16_t*>(samples[1])[count - samplesRemaining] : nullptr };
-            samplesDataSize = FPGA::Samples2FPGAPacketPayload(src, samplesToSend, mimo, compressed, pkt->data);
-        }
-        else if (config.format == DataFormat::F32)
+        uint8_t* dest = dmaChunks[stagingBufferIndex].buffer;
+        uint32_t transferSize = 0;
+        for (uint32_t i = 0; i < packetsInBatch && samplesSubmitted < count; ++i)
         {
-            const lime::complex32f_t* src[2] = { &static_cast<const lime::complex32f_t*>(samples[0])[count - samplesRemaining],
-                useChannelB ? &static_cast<const lime::complex32f_t*>(samples[1])[count - samplesRemaining] : nullptr };
-            samplesDataSize = FPGA::Samples2FPGAPacketPayloadFloat(src, samplesToSend, mimo, compressed, pkt->data);
+            const uint32_t samplesToSend = std::min(samplesInPkt, count - samplesSubmitted);
+            const void* src[2] = { static_cast<const uint8_t*>(samples[0]) + samplesSubmitted * sampleStride,
+                mimo ? static_cast<const uint8_t*>(samples[1]) + samplesSubmitted * sampleStride : nullptr };
+
+            // DMA memory is write only, to read from the buffer will trigger Bus errors
+            FPGA_TxDataPacket* pkt = reinterpret_cast<FPGA_TxDataPacket*>(dest + transferSize);
+            const int samplesDataSize = Interleave(pkt->data, src, samplesToSend, conversion);
+            const int payloadSize = (samplesDataSize / 4) * 4;
+            if (samplesDataSize % 4 != 0)
+                lime::warning("Packet samples count not multiple of 4"s);
+
+            pkt->ClearHeader();
+            pkt->reserved[2] = (payloadSize >> 8) & 0xFF; //WFM loading
+            pkt->reserved[1] = payloadSize & 0xFF; //WFM loading
+            pkt->reserved[0] = 0x1 << 5; //WFM loading
+
+            transferSize += sizeof(FPGA_TxDataPacket) - sizeof(pkt->data) + payloadSize;
+            samplesSubmitted += samplesToSend;
         }
 
-        int payloadSize = (samplesDataSize / 4) * 4;
-        if (samplesDataSize % 4 != 0)
-            lime::warning("Packet samples count not multiple of 4"s);
-        pkt->reserved[2] = (payloadSize >> 8) & 0xFF; //WFM loading
-        pkt->reserved[1] = payloadSize & 0xFF; //WFM loading
-        pkt->reserved[0] = 0x1 << 5; //WFM loading
-
         dma->BufferOwnership(stagingBufferIndex, DataTransferDirection::HostToDevice);
 
-        size_t transferSize = 16 + payloadSize;
-        assert(transferSize <= dmaChunks.front().size);
-        bool requestIRQ = (stagingBufferIndex % 4) == 0;
-
-        // DMA memory is write only, to read from the buffer will trigger Bus errors
-        const OpStatus status{ dma->SubmitRequest(
-            stagingBufferIndex, transferSize, DataTransferDirection::HostToDevice, requestIRQ) };
-        if (status != OpStatus::Success)
+        const bool lastTransfer = samplesSubmitted >= count;
+        const bool requestIRQ = (stagingBufferIndex % irqPeriod) == 0 || lastTransfer;
+        if (dma->SubmitRequest(stagingBufferIndex, transferSize, DataTransferDirection::HostToDevice, requestIRQ) !=
+            OpStatus::Success)
         {
-            dma->Enable(false);
-            return ReportError(OpStatus::IOFailure, "Failed to submit dma write (%i) %s", errno, strerror(errno));
+            status = ReportError(OpStatus::IOFailure, "Failed to submit dma write (%i) %s", errno, strerror(errno));
+            break;
         }
-
-        samplesRemaining -= samplesToSend;
-        stagingBufferIndex = (stagingBufferIndex + 1) % dmaBuffers.size();
+        transferEnd[stagingBufferIndex] = samplesSubmitted;
+        ++transfersSubmitted;
     }
 
-    // Give some time to load samples to FPGA
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
     dma->Enable(false);
-
     fpga->StopWaveformPlayback();
-    if (samplesRemaining != 0)
-        return ReportError(OpStatus::Error, "Failed to upload waveform"s);
-
-    return OpStatus::Success;
+    return status;
 }
 
 } // namespace lime
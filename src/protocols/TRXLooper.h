@@ -2,6 +2,7 @@
 #define TRXLooper_H
 
 #include <vector>
+#include <deque>
 #include <atomic>
 #include <thread>
 #include <mutex>
@@ -12,9 +13,16 @@
 #include "PacketsFIFO.h"
 #include "memory/MemoryPool.h"
 #include "SamplesPacket.h"
+#include "RxHistoryBuffer.h"
+#include "DSP/GainControl/PowerMeter.h"
 
 namespace lime {
 
+class Channelizer;
+class IQImpairmentTracker;
+class Downconverter;
+class GainController;
+class Upconverter;
 class FPGA;
 class IDMA;
 class LMS7002M;
@@ -44,25 +52,39 @@ class TRXLooper
     uint32_t StreamRx(lime::complex32f_t* const* samples, uint32_t count, StreamMeta* meta);
     uint32_t StreamRx(lime::complex16_t* const* samples, uint32_t count, StreamMeta* meta);
     uint32_t StreamRx(lime::complex12_t* const* samples, uint32_t count, StreamMeta* meta);
+    uint32_t StreamRx(lime::complex8_t* const* samples, uint32_t count, StreamMeta* meta);
+    uint32_t StreamRx(lime::complex16f_t* const* samples, uint32_t count, StreamMeta* meta);
+    OpStatus StreamRxHistory(lime::complex32f_t* const* samples, uint64_t timestamp, uint32_t count);
+    OpStatus StreamRxHistory(lime::complex16_t* const* samples, uint64_t timestamp, uint32_t count);
+    OpStatus StreamRxHistory(lime::complex12_t* const* samples, uint64_t timestamp, uint32_t count);
+    OpStatus StreamRxHistory(lime::complex8_t* const* samples, uint64_t timestamp, uint32_t count);
+    OpStatus StreamRxHistory(lime::complex16f_t* const* samples, uint64_t timestamp, uint32_t count);
     uint32_t StreamTx(const lime::complex32f_t* const* samples, uint32_t count, const StreamMeta* meta);
     uint32_t StreamTx(const lime::complex16_t* const* samples, uint32_t count, const StreamMeta* meta);
     uint32_t StreamTx(const lime::complex12_t* const* samples, uint32_t count, const StreamMeta* meta);
+    uint32_t StreamTx(const lime::complex8_t* const* samples, uint32_t count, const StreamMeta* meta);
+    uint32_t StreamTx(const lime::complex16f_t* const* samples, uint32_t count, const StreamMeta* meta);
 
     /// @brief Sets the callback to use for message logging.
     /// @param callback The new callback to use.
-    void SetMessageLogCallback(SDRDevice::LogCallbackType callback) { mCallback_logMessage = callback; }
+    void SetMessageLogCallback(SDRDevice::LogCallbackType callback);
+
+    void SetGainControlDevice(SDRDevice* device);
 
     StreamStats GetStats(TRXDir tx) const;
 
     /// @brief The type of a sample packet.
     typedef SamplesPacket<2> SamplesPacketType;
 
+    OpStatus UploadTxWaveform(
+        const StreamConfig& config, const void** samples, uint32_t count, SDRDevice::UploadMemoryCallback callback = nullptr);
     static OpStatus UploadTxWaveform(FPGA* fpga,
         std::shared_ptr<IDMA> port,
         const StreamConfig& config,
         uint8_t moduleIndex,
         const void** samples,
-        uint32_t count);
+        uint32_t count,
+        SDRDevice::UploadMemoryCallback callback = nullptr);
 
     /** @brief The transfer arguments. */
     struct TransferArgs {
@@ -76,15 +98,25 @@ class TRXLooper
 
   private:
     OpStatus RxSetup();
+    OpStatus RxDownconversionSetup();
+    OpStatus RxChannelizationSetup();
+    OpStatus RxImpairmentCorrectionSetup();
+    OpStatus RxGainControlSetup();
     void RxWorkLoop();
+    void RxGainControlLoop();
     void ReceivePacketsLoop();
     void RxTeardown();
+    uint64_t RxOutputTimestamp(uint64_t timestamp) const;
 
     OpStatus TxSetup();
+    OpStatus TxUpconversionSetup();
     void TxWorkLoop();
     void TransmitPacketsLoop();
     void TxTeardown();
 
+    std::shared_ptr<const SDRDevice::LogCallbackType> GetLogCallback() const;
+    void PostLogMessage(LogLevel level, const char* msg);
+
     uint64_t mTimestampOffset;
     lime::StreamConfig mConfig;
 
@@ -95,7 +127,8 @@ class TRXLooper
     LMS7002M* lms;
     uint8_t chipId;
 
-    SDRDevice::LogCallbackType mCallback_logMessage;
+    /// Replaced atomically, the streaming threads and the queued asynchronous messages hold their own references.
+    std::shared_ptr<const SDRDevice::LogCallbackType> mCallback_logMessage;
     std::condition_variable streamActive;
     std::mutex streamMutex;
     bool mStreamEnabled;
@@ -144,7 +177,38 @@ class TRXLooper
     Stream mRx;
     Stream mTx;
 
+    std::unique_ptr<RxHistoryBuffer> mRxHistory;
+    std::vector<std::unique_ptr<Downconverter>> mRxDownconverters;
+    std::unique_ptr<Channelizer> mRxChannelizer;
+    std::vector<void*> mRxChannelizerDest;
+    std::vector<std::unique_ptr<IQImpairmentTracker>> mRxImpairmentTrackers;
+
+    /// @brief A change of the Rx gains made by the automatic gain control.
+    struct GainChange {
+        uint64_t timestamp; ///< The hardware timestamp of the first sample that could have the new gains.
+        float gain[2]; ///< The gains of the channels (in dB).
+    };
+
+    /// @brief The state shared between the Rx loop, the gain control thread and the Rx readers.
+    struct GainControlState {
+        std::unique_ptr<GainController> controller;
+        std::thread thread;
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool terminate{ false };
+        bool measured{ false }; ///< Whether a new measurement is waiting for the gain control thread.
+        PowerMeasurement power[2];
+        uint32_t updatePeriod{ 0 }; ///< The amount of samples to measure before updating the gain.
+        std::atomic<uint64_t> settleTimestamp{ 0 }; ///< Measurements before this timestamp are discarded.
+        std::deque<GainChange> changes; ///< The latest gain changes, oldest first.
+    };
+
+    SDRDevice* mGainDevice;
+    GainControlState mRxGainControl;
+    std::vector<std::unique_ptr<Upconverter>> mTxUpconverters;
+
     template<class T> uint32_t StreamRxTemplate(T* const* dest, uint32_t count, StreamMeta* meta);
+    template<class T> OpStatus StreamRxHistoryTemplate(T* const* dest, uint64_t timestamp, uint32_t count);
     template<class T> uint32_t StreamTxTemplate(const T* const* samples, uint32_t count, const StreamMeta* meta);
 };
 
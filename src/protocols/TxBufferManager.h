@@ -3,8 +3,10 @@
 
 #include <cstdint>
 #include <cstring>
+#include <vector>
 
 #include "BufferInterleaving.h"
+#include "DSP/Resampling/Upconverter.h"
 #include "limesuiteng/SDRDevice.h"
 #include "protocols/DataPacket.h"
 
@@ -33,6 +35,7 @@ template<class T> class TxBufferManager
         , maxSamplesInPkt(maxSamplesInPkt)
         , packetsCreated(0)
         , payloadSize(0)
+        , interpolation(1)
     {
         bytesForFrame = (compressed ? 3 : 4) * (mimo ? 2 : 1);
         conversion.srcFormat = inputFormat; //DataFormat::F32;
@@ -41,6 +44,15 @@ template<class T> class TxBufferManager
         maxPayloadSize = std::min(4080u, bytesForFrame * maxSamplesInPkt);
     }
 
+    /// @brief Sets the upconverters to pass the samples through, instead of converting them directly to the link format.
+    /// The source packets timestamps are then counted before the interpolation.
+    /// @param channelUpconverters The upconverters of each transmitted channel (empty - no upconversion).
+    void SetUpconverters(const std::vector<Upconverter*>& channelUpconverters)
+    {
+        upconverters = channelUpconverters;
+        interpolation = upconverters.empty() ? 1 : upconverters.front()->GetInterpolation();
+    }
+
     /// @brief Resets the buffer to point to an empty buffer.
     /// @param memPtr The pointer of memory to set.
     /// @param capacity The total capacity of the buffer.
@@ -61,7 +73,7 @@ template<class T> class TxBufferManager
     /// @return Whether there still is space or not.
     constexpr bool hasSpace() const
     {
-        const bool packetNotFull = payloadSize < maxPayloadSize;
+        const bool packetNotFull = payloadSize + bytesForFrame * interpolation <= maxPayloadSize;
         const bool spaceAvailable = mCapacity - bytesUsed > sizeof(StreamHeader);
         return packetNotFull && spaceAvailable;
     }
@@ -73,7 +85,7 @@ template<class T> class TxBufferManager
     {
         while (!src->empty())
         {
-            if (payloadSize >= maxPayloadSize || payloadSize == maxSamplesInPkt * bytesForFrame)
+            if (payloadSize + bytesForFrame * interpolation > maxPayloadSize)
             {
                 header = reinterpret_cast<StreamHeader*>(mData + bytesUsed);
                 header->Clear();
@@ -85,14 +97,25 @@ template<class T> class TxBufferManager
             if (payloadSize == 0)
             {
                 ++packetsCreated;
-                header->counter = src->timestamp;
+                header->counter = src->timestamp * interpolation;
                 bytesUsed += sizeof(StreamHeader);
             }
             const uint32_t freeSpace = std::min(maxPayloadSize - payloadSize, mCapacity - bytesUsed - 16);
-            const uint32_t transferCount = std::min(freeSpace / bytesForFrame, std::min(src->size(), maxSamplesInPkt));
+            // counted in source samples, each produces interpolation frames
+            const uint32_t transferCount =
+                std::min(freeSpace / (bytesForFrame * interpolation), std::min(src->size(), maxSamplesInPkt / interpolation));
             if (transferCount > 0)
             {
-                int samplesDataSize = Interleave(payloadPtr, src->front(), transferCount, conversion);
+                int samplesDataSize = upconverters.empty()
+                                          ? Interleave(payloadPtr, src->front(), transferCount, conversion)
+                                          : InterleaveUpconvert(payloadPtr,
+                                                src->front(),
+                                                transferCount,
+                                                conversion,
+                                                upconverters.data(),
+                                                upconverters.size(),
+                                                src->timestamp,
+                                                src->useTimestamp);
                 src->pop(transferCount);
                 payloadPtr = payloadPtr + samplesDataSize;
                 payloadSize += samplesDataSize;
@@ -150,6 +173,8 @@ template<class T> class TxBufferManager
     uint16_t packetsCreated;
     uint32_t payloadSize;
     uint8_t bytesForFrame;
+    std::vector<Upconverter*> upconverters;
+    uint16_t interpolation;
 };
 
 } // namespace lime
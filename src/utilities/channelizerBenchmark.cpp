@@ -0,0 +1,85 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "DSP/Resampling/Channelizer.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace lime;
+
+// Measures the processing cost of the polyphase channelizer and reports the CPU load it would take
+// to channelize the full Rx stream at the common LMS7002M sampling rates, in total and per sub-channel.
+
+static constexpr double sampleRates[] = { 61.44e6, 122.88e6 };
+static constexpr uint32_t samplesInCall = 65536;
+
+static double MeasureSamplesPerSecond(uint16_t channelCount, uint16_t decimation, double duration)
+{
+    std::vector<uint16_t> outputs(channelCount);
+    for (uint16_t i = 0; i < channelCount; ++i)
+        outputs[i] = i;
+    Channelizer channelizer(channelCount, decimation, outputs);
+
+    std::vector<complex16_t> input(samplesInCall);
+    for (uint32_t i = 0; i < samplesInCall; ++i)
+    {
+        const double phase = 2 * M_PI * 0.1234 * i;
+        input[i] = complex16_t(16384 * std::cos(phase), 16384 * std::sin(phase));
+    }
+    std::vector<std::vector<complex32f_t>> output(channelCount, std::vector<complex32f_t>(samplesInCall / decimation + 1));
+    std::vector<complex32f_t*> dest(channelCount);
+    for (uint16_t i = 0; i < channelCount; ++i)
+        dest[i] = output[i].data();
+
+    uint64_t timestamp = 0;
+    float checksum = 0;
+    auto t1 = std::chrono::steady_clock::now();
+    auto t2 = t1;
+    do
+    {
+        channelizer.Process(input.data(), samplesInCall, timestamp, dest.data());
+        checksum += output[timestamp / samplesInCall % channelCount][0].real();
+        timestamp += samplesInCall;
+        t2 = std::chrono::steady_clock::now();
+    } while (std::chrono::duration<double>(t2 - t1).count() < duration);
+
+    if (std::isnan(checksum))
+        fprintf(stderr, "invalid channelizer results\n");
+    return timestamp / std::chrono::duration<double>(t2 - t1).count();
+}
+
+int main(int argc, char** argv)
+{
+    const double duration = argc > 1 ? atof(argv[1]) : 0.5;
+    if (duration <= 0)
+    {
+        printf("Usage: channelizerBenchmark [duration_s]\n"
+               "  duration_s - time to benchmark each configuration (default: 0.5)\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("CPU load in percent of a single core, all sub-channels produced\n");
+    printf("%9s %11s %12s", "channels", "decimation", "MSamples/s");
+    for (double rate : sampleRates)
+        printf("   %6.2f MSps: total  per channel", rate / 1e6);
+    printf("\n");
+    for (uint16_t channelCount = 16; channelCount <= 1024; channelCount *= 4)
+    {
+        // critically sampled and 2x oversampled
+        for (uint16_t decimation : { channelCount, static_cast<uint16_t>(channelCount / 2) })
+        {
+            const double throughput = MeasureSamplesPerSecond(channelCount, decimation, duration);
+            printf("%9i %11i %12.2f", channelCount, decimation, throughput / 1e6);
+            for (double rate : sampleRates)
+            {
+                const double load = 100 * rate / throughput;
+                printf("   %18.1f %12.3f", load, load / channelCount);
+            }
+            printf("\n");
+        }
+    }
+    return EXIT_SUCCESS;
+}
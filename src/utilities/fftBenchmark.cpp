@@ -0,0 +1,80 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include "DSP/FFT/FFT.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace lime;
+
+// Compares the throughput of the FFT backends available in the library,
+// for the transform sizes commonly used by the spectrum displays.
+
+static constexpr std::size_t minSize = 256;
+static constexpr std::size_t maxSize = 65536;
+
+static double MeasureTransformsPerSecond(const std::vector<complex32f_t>& samples, double duration, double& firstCallTime)
+{
+    auto t1 = std::chrono::steady_clock::now();
+    // first call includes the planning
+    std::vector<float> bins = FFT::Calc(samples, FFT::WindowFunctionType::BLACKMAN_HARRIS);
+    auto t2 = std::chrono::steady_clock::now();
+    firstCallTime = std::chrono::duration<double>(t2 - t1).count();
+
+    uint64_t transforms = 0;
+    float checksum = 0;
+    t1 = std::chrono::steady_clock::now();
+    do
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            bins = FFT::Calc(samples, FFT::WindowFunctionType::BLACKMAN_HARRIS);
+            checksum += bins[transforms % bins.size()];
+            ++transforms;
+        }
+        t2 = std::chrono::steady_clock::now();
+    } while (std::chrono::duration<double>(t2 - t1).count() < duration);
+
+    if (std::isnan(checksum))
+        fprintf(stderr, "invalid FFT results\n");
+    return transforms / std::chrono::duration<double>(t2 - t1).count();
+}
+
+int main(int argc, char** argv)
+{
+    const double duration = argc > 1 ? atof(argv[1]) : 0.25;
+    if (duration <= 0)
+    {
+        printf("Usage: fftBenchmark [duration_s]\n"
+               "  duration_s - time to benchmark each transform size (default: 0.25)\n");
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<std::string> backends = FFT::GetBackendNames();
+    for (const std::string& backend : backends)
+    {
+        if (FFT::SetBackend(backend) != OpStatus::Success)
+            return EXIT_FAILURE;
+
+        printf("%s:\n", backend.c_str());
+        printf("%10s %16s %14s %16s\n", "size", "transforms/s", "MSamples/s", "first call, ms");
+        for (std::size_t size = minSize; size <= maxSize; size *= 2)
+        {
+            std::vector<complex32f_t> samples(size);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                const double phase = 2 * M_PI * 0.1 * i;
+                samples[i] = complex32f_t(0.5 * std::cos(phase), 0.5 * std::sin(phase));
+            }
+
+            double firstCallTime = 0;
+            const double rate = MeasureTransformsPerSecond(samples, duration, firstCallTime);
+            printf("%10zu %16.0f %14.2f %16.3f\n", size, rate, rate * size / 1e6, firstCallTime * 1e3);
+        }
+    }
+    return EXIT_SUCCESS;
+}
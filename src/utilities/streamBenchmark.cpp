@@ -0,0 +1,183 @@
+#include "limesuiteng/SDRDevice.h"
+#include "limesuiteng/StreamConfig.h"
+#include "limesuiteng/DeviceRegistry.h"
+#include "limesuiteng/DeviceHandle.h"
+#include "limesuiteng/complex.h"
+#include "limesuiteng/Logger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace lime;
+using namespace std::literals::string_literals;
+
+// Streams samples through the software simulated device (no hardware required)
+// and reports the host side throughput and latencies of every samples format.
+
+static constexpr uint32_t samplesInCall = 4096;
+
+struct BenchmarkResult {
+    uint64_t rxSamples;
+    uint64_t txSamples;
+    double seconds;
+    StreamStats rx;
+    StreamStats tx;
+};
+
+static void PrintHistogram(const char* title, const DurationHistogram& histogram)
+{
+    if (histogram.count == 0)
+        return;
+    printf("    %-10s mean: %8.1f us, p50: %8.1f us, p99: %8.1f us, max: %8.1f us\n",
+        title,
+        histogram.Mean() / 1e3,
+        histogram.Percentile(0.5) / 1e3,
+        histogram.Percentile(0.99) / 1e3,
+        histogram.max_ns / 1e3);
+}
+
+template<class T>
+static OpStatus RunBenchmark(SDRDevice* device, DataFormat format, uint8_t channelCount, double sampleRate, double duration,
+    BenchmarkResult& result)
+{
+    StreamConfig stream;
+    for (uint8_t ch = 0; ch < channelCount; ++ch)
+    {
+        stream.channels[TRXDir::Rx].push_back(ch);
+        stream.channels[TRXDir::Tx].push_back(ch);
+    }
+    stream.format = format;
+    stream.linkFormat = format == DataFormat::I16 ? DataFormat::I16 : DataFormat::I12;
+    stream.hintSampleRate = sampleRate;
+
+    OpStatus status = device->StreamSetup(stream, 0);
+    if (status != OpStatus::Success)
+        return status;
+
+    std::vector<std::vector<T>> rxBuffers(channelCount, std::vector<T>(samplesInCall));
+    std::vector<std::vector<T>> txBuffers(channelCount, std::vector<T>(samplesInCall));
+    std::vector<T*> rxSamples(channelCount);
+    std::vector<const T*> txSamples(channelCount);
+    for (uint8_t ch = 0; ch < channelCount; ++ch)
+    {
+        rxSamples[ch] = rxBuffers[ch].data();
+        txSamples[ch] = txBuffers[ch].data();
+    }
+
+    // unpaced Rx runs as fast as it's consumed, so Tx timestamps can't be kept ahead of it
+    const bool useTxTimestamps = sampleRate > 0;
+    const uint64_t txLeadSamples = sampleRate * 0.01;
+
+    result.rxSamples = 0;
+    result.txSamples = 0;
+    device->StreamStart(0);
+    const auto startTime = std::chrono::steady_clock::now();
+    auto now = startTime;
+    while (std::chrono::duration<double>(now - startTime).count() < duration)
+    {
+        StreamMeta rxMeta{};
+        const uint32_t samplesRead = device->StreamRx(0, rxSamples.data(), samplesInCall, &rxMeta);
+        if (samplesRead == 0)
+            break;
+        result.rxSamples += samplesRead;
+
+        StreamMeta txMeta{};
+        txMeta.timestamp = rxMeta.timestamp + txLeadSamples;
+        txMeta.waitForTimestamp = useTxTimestamps;
+        txMeta.flushPartialPacket = false;
+        result.txSamples += device->StreamTx(0, txSamples.data(), samplesRead, &txMeta);
+        now = std::chrono::steady_clock::now();
+    }
+    result.seconds = std::chrono::duration<double>(now - startTime).count();
+    device->StreamStatus(0, &result.rx, &result.tx);
+    device->StreamStop(0);
+    device->StreamDestroy(0);
+    return OpStatus::Success;
+}
+
+static void PrintResult(const char* name, uint8_t channelCount, const BenchmarkResult& result)
+{
+    const double rxRate = result.seconds > 0 ? result.rxSamples / result.seconds : 0;
+    const double txRate = result.seconds > 0 ? result.txSamples / result.seconds : 0;
+    printf("%s, %i channel(s): Rx %.2f MSps, Tx %.2f MSps per channel\n", name, channelCount, rxRate / 1e6, txRate / 1e6);
+    printf("    Rx overrun: %u, loss: %u; Tx underrun: %u, late: %u\n",
+        result.rx.overrun,
+        result.rx.loss,
+        result.tx.underrun,
+        result.tx.late);
+    PrintHistogram("DMA->FIFO", result.rx.dmaToFifo);
+    PrintHistogram("FIFO->user", result.rx.fifoToUser);
+    PrintHistogram("user->DMA", result.tx.userToDma);
+    PrintHistogram("Rx loop", result.rx.loopTime);
+    PrintHistogram("Tx loop", result.tx.loopTime);
+}
+
+static int printHelp()
+{
+    printf("Usage: streamBenchmark [duration_s] [sample_rate_Hz] [channels]\n"
+           "  duration_s     - time to stream each samples format (default: 2)\n"
+           "  sample_rate_Hz - simulated sampling rate, 0 - as fast as possible (default: 0)\n"
+           "  channels       - amount of channels to stream, 1 or 2 (default: 1)\n"
+           "Requires the library built with ENABLE_SIMULATED_DEVICE.\n");
+    return EXIT_FAILURE;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0))
+        return printHelp();
+
+    const double duration = argc > 1 ? atof(argv[1]) : 2;
+    const double sampleRate = argc > 2 ? atof(argv[2]) : 0;
+    const int channelCount = argc > 3 ? atoi(argv[3]) : 1;
+    if (duration <= 0 || sampleRate < 0 || channelCount < 1 || channelCount > 2)
+        return printHelp();
+
+    DeviceHandle hint;
+    hint.media = "Simulated"s;
+    std::vector<DeviceHandle> handles = DeviceRegistry::enumerate(hint);
+    if (handles.empty())
+    {
+        fprintf(stderr, "Simulated device not found\n");
+        return printHelp();
+    }
+
+    struct {
+        const char* name;
+        DataFormat format;
+    } const runs[] = { { "I12", DataFormat::I12 }, { "I16", DataFormat::I16 }, { "F32", DataFormat::F32 } };
+
+    int returnCode = EXIT_SUCCESS;
+    for (const auto& run : runs)
+    {
+        // fresh device for every run, so the statistics are not accumulated
+        SDRDevice* device = DeviceRegistry::makeDevice(handles.at(0));
+        if (!device)
+        {
+            fprintf(stderr, "Failed to create simulated device\n");
+            return EXIT_FAILURE;
+        }
+
+        BenchmarkResult result{};
+        OpStatus status;
+        // I12 samples are passed in 16 bit containers, same as I16
+        if (run.format == DataFormat::F32)
+            status = RunBenchmark<complex32f_t>(device, run.format, channelCount, sampleRate, duration, result);
+        else
+            status = RunBenchmark<complex16_t>(device, run.format, channelCount, sampleRate, duration, result);
+
+        if (status == OpStatus::Success)
+            PrintResult(run.name, channelCount, result);
+        else
+        {
+            fprintf(stderr, "%s: stream setup failed\n", run.name);
+            returnCode = EXIT_FAILURE;
+        }
+        DeviceRegistry::freeDevice(device);
+    }
+    return returnCode;
+}
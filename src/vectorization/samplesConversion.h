@@ -8,30 +8,55 @@
 
 namespace lime {
 
+template<class T> constexpr bool IsFloatingPointSample()
+{
+    return std::is_same<T, complex32f_t>::value || std::is_same<T, complex64f_t>::value || std::is_same<T, complex16f_t>::value;
+}
+
+template<class T> constexpr bool Is12BitSample()
+{
+    return std::is_same<T, complex12_t>::value || std::is_same<T, complex12packed_t>::value;
+}
+
 template<class Dest, class Src> constexpr float GetScalingRatio()
 {
     if constexpr (std::is_same<Src, complex16_t>::value == true)
     {
-        if constexpr (std::is_same<Dest, complex32f_t>::value == true || std::is_same<Dest, complex64f_t>::value == true)
+        if constexpr (IsFloatingPointSample<Dest>())
             return 1.0f / 32768;
-        else if constexpr (std::is_same<Dest, complex12_t>::value == true || std::is_same<Dest, complex12packed_t>::value == true)
+        else if constexpr (Is12BitSample<Dest>())
             return 2048.0 / 32768.0;
+        else if constexpr (std::is_same<Dest, complex8_t>::value == true)
+            return 1.0f / 256;
     }
-    else if constexpr (std::is_same<Src, complex12_t>::value == true || std::is_same<Src, complex12packed_t>::value == true)
+    else if constexpr (Is12BitSample<Src>())
     {
-        if constexpr (std::is_same<Dest, complex32f_t>::value == true || std::is_same<Dest, complex64f_t>::value == true)
+        if constexpr (IsFloatingPointSample<Dest>())
             return 1.0f / 2048;
         else if constexpr (std::is_same<Dest, complex16_t>::value == true)
             return 16;
         else if constexpr (std::is_same<Dest, complex12packed_t>::value == true)
             return 1;
+        else if constexpr (std::is_same<Dest, complex8_t>::value == true)
+            return 1.0f / 16;
     }
-    else if constexpr (std::is_same<Src, complex32f_t>::value == true || std::is_same<Src, complex64f_t>::value == true)
+    else if constexpr (IsFloatingPointSample<Src>())
     {
         if constexpr (std::is_same<Dest, complex16_t>::value == true)
             return 32767;
-        else if constexpr (std::is_same<Dest, complex12_t>::value == true || std::is_same<Dest, complex12packed_t>::value == true)
+        else if constexpr (Is12BitSample<Dest>())
             return 2047;
+        else if constexpr (std::is_same<Dest, complex8_t>::value == true)
+            return 127;
+    }
+    else if constexpr (std::is_same<Src, complex8_t>::value == true)
+    {
+        if constexpr (IsFloatingPointSample<Dest>())
+            return 1.0f / 128;
+        else if constexpr (std::is_same<Dest, complex16_t>::value == true)
+            return 256;
+        else if constexpr (Is12BitSample<Dest>())
+            return 16;
     }
     return 1;
 }
@@ -81,6 +106,86 @@ template<> constexpr void Rescale(complex16_t& dest, const complex12packed_t& sr
     dest.imag(src.imag() << 4);
 }
 
+// 8 bit results are rounded to the nearest value instead of truncated, the truncation bias is significant at this resolution
+template<int shift> constexpr int8_t RoundedShift(int value)
+{
+    const int rounded = (value + (1 << (shift - 1))) >> shift;
+    return rounded > 127 ? 127 : (rounded < -128 ? -128 : rounded);
+}
+
+constexpr int8_t RoundedFloat(float value)
+{
+    const float scaled = value * 127;
+    if (scaled >= 127)
+        return 127;
+    if (scaled <= -128)
+        return -128;
+    return static_cast<int>(scaled + (scaled < 0 ? -0.5f : 0.5f));
+}
+
+template<> constexpr void Rescale(complex8_t& dest, const complex32f_t& src)
+{
+    dest.real(RoundedFloat(src.real()));
+    dest.imag(RoundedFloat(src.imag()));
+}
+
+template<> constexpr void Rescale(complex8_t& dest, const complex16_t& src)
+{
+    dest.real(RoundedShift<8>(src.real()));
+    dest.imag(RoundedShift<8>(src.imag()));
+}
+
+template<> constexpr void Rescale(complex8_t& dest, const complex12_t& src)
+{
+    dest.real(RoundedShift<4>(src.real()));
+    dest.imag(RoundedShift<4>(src.imag()));
+}
+
+template<> constexpr void Rescale(complex8_t& dest, const complex12packed_t& src)
+{
+    dest.real(RoundedShift<4>(src.real()));
+    dest.imag(RoundedShift<4>(src.imag()));
+}
+
+template<> constexpr void Rescale(complex16_t& dest, const complex8_t& src)
+{
+    dest.real(src.real() * 256);
+    dest.imag(src.imag() * 256);
+}
+
+template<> constexpr void Rescale(complex12packed_t& dest, const complex8_t& src)
+{
+    dest.real(src.real() * 16);
+    dest.imag(src.imag() * 16);
+}
+
+/// @brief Generator of triangular probability density dither for the 8 bit quantization.
+/// Dithering makes the quantization error independent of the signal, so low level signals
+/// don't produce harmonics, at the cost of a slightly higher noise floor.
+struct TriangularDither {
+    uint32_t state{ 0x9E3779B9 };
+
+    /// @brief Gets the next dither value, the difference of two uniform values.
+    /// @tparam shift The amount of bits the quantization removes.
+    /// @return The dither in the source units, in range (-2^shift; 2^shift).
+    template<int shift> int Next()
+    {
+        // xorshift32
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        constexpr uint32_t mask = (1 << shift) - 1;
+        return static_cast<int>(state & mask) - static_cast<int>((state >> 16) & mask);
+    }
+};
+
+template<class SrcT> inline void DitheredRescale(complex8_t& dest, const SrcT& src, TriangularDither& dither)
+{
+    constexpr int shift = std::is_same<SrcT, complex16_t>::value ? 8 : 4;
+    dest.real(RoundedShift<shift>(src.real() + dither.Next<shift>()));
+    dest.imag(RoundedShift<shift>(src.imag() + dither.Next<shift>()));
+}
+
 // compile time known iteration/element count
 template<uint32_t srcCount, class DestT, class SrcT> static void fastPath_convert(DestT* dest, const SrcT* src)
 {
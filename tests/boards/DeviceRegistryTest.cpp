@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+
+#include "boards/Simulated/SimulatedSDR.h"
+#include "limesuiteng/DeviceHandle.h"
+#include "limesuiteng/DeviceRegistry.h"
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace lime;
+
+namespace {
+
+/// @brief A connection type whose devices are controlled by the test.
+class MockRegistryEntry : public DeviceRegistryEntry
+{
+  public:
+    MockRegistryEntry()
+        : DeviceRegistryEntry("Mock")
+    {
+    }
+
+    std::vector<DeviceHandle> enumerate(const DeviceHandle& hint) override
+    {
+        ++enumerateCount;
+        std::vector<DeviceHandle> results;
+        for (const auto& handle : devices)
+        {
+            if (handle.IsEqualIgnoringEmpty(hint))
+                results.push_back(handle);
+        }
+        return results;
+    }
+
+    SDRDevice* make(const DeviceHandle& handle) override
+    {
+        madeHandles.push_back(handle);
+        return new SimulatedSDR();
+    }
+
+    bool startWatching(std::function<void()> onChange) override
+    {
+        this->onChange = onChange;
+        return true;
+    }
+
+    void stopWatching() override { onChange = nullptr; }
+
+    std::vector<DeviceHandle> devices;
+    std::vector<DeviceHandle> madeHandles;
+    int enumerateCount{ 0 };
+    std::function<void()> onChange;
+};
+
+DeviceHandle MockHandle(const std::string& serial)
+{
+    DeviceHandle handle;
+    handle.media = "Mock";
+    handle.name = "MockSDR";
+    handle.serial = serial;
+    return handle;
+}
+
+DeviceHandle MockHint()
+{
+    DeviceHandle hint;
+    hint.media = "Mock";
+    return hint;
+}
+
+} // namespace
+
+TEST(DeviceRegistry, MakeDeviceOpensEnumeratedHandleDirectly)
+{
+    MockRegistryEntry entry;
+    entry.devices = { MockHandle("1") };
+
+    const auto handles = DeviceRegistry::enumerate(MockHint());
+    ASSERT_EQ(handles.size(), 1u);
+    const int enumerateCount = entry.enumerateCount;
+
+    SDRDevice* device = DeviceRegistry::makeDevice(handles.front());
+    EXPECT_NE(device, nullptr);
+    DeviceRegistry::freeDevice(device);
+    EXPECT_EQ(entry.enumerateCount, enumerateCount);
+    ASSERT_EQ(entry.madeHandles.size(), 1u);
+    EXPECT_EQ(entry.madeHandles.front().Serialize(), handles.front().Serialize());
+}
+
+TEST(DeviceRegistry, RemovedHandleIsProbedAgainInsteadOfOpenedDirectly)
+{
+    MockRegistryEntry entry;
+    entry.devices = { MockHandle("1") };
+
+    const auto handles = DeviceRegistry::enumerate(MockHint());
+    ASSERT_EQ(handles.size(), 1u);
+
+    // the enumeration forgets the owner of the gone handle
+    entry.devices.clear();
+    EXPECT_TRUE(DeviceRegistry::enumerate(MockHint()).empty());
+    EXPECT_EQ(DeviceRegistry::makeDevice(handles.front()), nullptr);
+    EXPECT_TRUE(entry.madeHandles.empty());
+}
+
+TEST(DeviceRegistry, CacheServesEnumerationAndReportsChanges)
+{
+    MockRegistryEntry entry;
+    entry.devices = { MockHandle("1") };
+
+    std::vector<std::pair<std::string, bool>> changes;
+    const int callbackId = DeviceRegistry::addHotplugCallback([&changes](const DeviceHandle& handle, bool connected) {
+        if (handle.media == "Mock")
+            changes.emplace_back(handle.serial, connected);
+    });
+
+    // long poll period, the test triggers the rescans itself
+    DeviceRegistry::enableCache(true, 60000);
+    const int enumerateCount = entry.enumerateCount;
+    EXPECT_EQ(DeviceRegistry::enumerate(MockHint()).size(), 1);
+    EXPECT_EQ(DeviceRegistry::enumerate(MockHint()).size(), 1);
+    EXPECT_EQ(entry.enumerateCount, enumerateCount);
+
+    entry.devices = { MockHandle("2") };
+    EXPECT_EQ(DeviceRegistry::rescan().size(), DeviceRegistry::enumerate().size());
+    const auto handles = DeviceRegistry::enumerate(MockHint());
+    ASSERT_EQ(handles.size(), 1);
+    EXPECT_EQ(handles.front().serial, "2");
+    EXPECT_EQ(changes, (std::vector<std::pair<std::string, bool>>{ { "1", false }, { "2", true } }));
+
+    DeviceRegistry::enableCache(false);
+    DeviceRegistry::removeHotplugCallback(callbackId);
+    entry.devices.clear();
+    EXPECT_TRUE(DeviceRegistry::enumerate(MockHint()).empty());
+}
+
+TEST(DeviceRegistry, WatchingEntryTriggersRescan)
+{
+    MockRegistryEntry entry;
+    entry.devices = { MockHandle("1") };
+
+    auto connected = std::make_shared<std::promise<std::string>>();
+    const int callbackId = DeviceRegistry::addHotplugCallback([connected](const DeviceHandle& handle, bool isConnected) {
+        if (handle.media == "Mock" && isConnected)
+            connected->set_value(handle.serial);
+    });
+
+    // the poll would not find the change during the test
+    DeviceRegistry::enableCache(true, 60000);
+    ASSERT_TRUE(entry.onChange);
+    entry.devices.push_back(MockHandle("2"));
+    entry.onChange();
+
+    auto result = connected->get_future();
+    ASSERT_EQ(result.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(result.get(), "2");
+    EXPECT_EQ(DeviceRegistry::enumerate(MockHint()).size(), 2);
+
+    DeviceRegistry::enableCache(false);
+    DeviceRegistry::removeHotplugCallback(callbackId);
+    EXPECT_FALSE(entry.onChange);
+}
+
+TEST(DeviceRegistry, HotplugCallbackCanDisableCache)
+{
+    MockRegistryEntry entry;
+
+    auto disabled = std::make_shared<std::promise<void>>();
+    const int callbackId = DeviceRegistry::addHotplugCallback([disabled](const DeviceHandle& handle, bool isConnected) {
+        if (handle.media != "Mock")
+            return;
+        // called from the monitor thread, which must not be joined by itself
+        DeviceRegistry::enableCache(false);
+        disabled->set_value();
+    });
+
+    DeviceRegistry::enableCache(true, 60000);
+    entry.devices = { MockHandle("1") };
+    entry.onChange();
+
+    auto result = disabled->get_future();
+    ASSERT_EQ(result.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    DeviceRegistry::removeHotplugCallback(callbackId);
+
+    // the enumeration probes the entries again
+    entry.devices = { MockHandle("1"), MockHandle("2") };
+    EXPECT_EQ(DeviceRegistry::enumerate(MockHint()).size(), 2);
+}
+
+TEST(DeviceRegistry, ConcurrentEnableCacheCallsAreSerialized)
+{
+    MockRegistryEntry entry;
+    entry.devices = { MockHandle("1") };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < 20; ++i)
+                DeviceRegistry::enableCache((i + t) % 2 == 0, 1);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    DeviceRegistry::enableCache(false);
+    const int enumerateCount = entry.enumerateCount;
+    EXPECT_EQ(DeviceRegistry::enumerate(MockHint()).size(), 1u);
+    EXPECT_EQ(entry.enumerateCount, enumerateCount + 1);
+}
+
+TEST(DeviceRegistry, HotplugCallbackCanEnableCacheWhileItIsDisabled)
+{
+    MockRegistryEntry entry;
+    entry.devices = { MockHandle("1") };
+
+    auto entered = std::make_shared<std::promise<void>>();
+    auto proceed = std::make_shared<std::promise<void>>();
+    std::shared_future<void> proceeding = proceed->get_future().share();
+    const int callbackId = DeviceRegistry::addHotplugCallback([entered, proceeding](const DeviceHandle& handle, bool isConnected) {
+        if (handle.media != "Mock" || !isConnected)
+            return;
+        entered->set_value();
+        proceeding.wait();
+        // the disabling thread waits for this monitor thread without holding the cache control
+        DeviceRegistry::enableCache(true, 60000);
+    });
+
+    DeviceRegistry::enableCache(true, 60000);
+    entry.devices = { MockHandle("1"), MockHandle("2") };
+    entry.onChange();
+    ASSERT_EQ(entered->get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+    std::thread disabling([]() { DeviceRegistry::enableCache(false); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    proceed->set_value();
+    disabling.join();
+    DeviceRegistry::removeHotplugCallback(callbackId);
+
+    // the monitor started by the callback got stopped as well
+    const int enumerateCount = entry.enumerateCount;
+    EXPECT_EQ(DeviceRegistry::enumerate(MockHint()).size(), 2u);
+    EXPECT_EQ(entry.enumerateCount, enumerateCount + 1);
+    EXPECT_FALSE(entry.onChange);
+}
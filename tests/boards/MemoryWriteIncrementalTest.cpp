@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+
+#include "boards/Simulated/SimulatedSDR.h"
+#include "limesuiteng/SDRDescriptor.h"
+#include "limesuiteng/types.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace lime;
+
+namespace {
+
+/// @brief A device with a sector erasable flash memory, records the operations done on it.
+class MockFlashDevice : public SimulatedSDR
+{
+  public:
+    static constexpr uint32_t sectorSize = 256;
+
+    MockFlashDevice(std::size_t sectorCount)
+        : flash(sectorCount * sectorSize, 0xFF)
+        , storage(std::make_shared<DataStorage>(this, eMemoryDevice::FPGA_FLASH))
+    {
+    }
+
+    OpStatus MemoryRead(std::shared_ptr<DataStorage> target, Region region, void* data) override
+    {
+        if (target != storage || region.address < 0 || region.address + region.size > static_cast<int32_t>(flash.size()))
+            return OpStatus::InvalidValue;
+        std::memcpy(data, flash.data() + region.address, region.size);
+        bytesRead += region.size;
+        return OpStatus::Success;
+    }
+
+    OpStatus MemoryErase(std::shared_ptr<DataStorage> target, Region region) override
+    {
+        if (target != storage || region.address % sectorSize != 0 || region.size % sectorSize != 0)
+            return OpStatus::InvalidValue;
+        std::memset(flash.data() + region.address, 0xFF, region.size);
+        erasedSectors.push_back(region.address / sectorSize);
+        return OpStatus::Success;
+    }
+
+    OpStatus MemoryWrite(std::shared_ptr<DataStorage> target, Region region, const void* data) override
+    {
+        if (target != storage || region.address < 0 || region.address + region.size > static_cast<int32_t>(flash.size()))
+            return OpStatus::InvalidValue;
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (int32_t i = 0; i < region.size; ++i)
+        {
+            // programming can only clear bits, writing without an erase would corrupt the data
+            if ((flash[region.address + i] & bytes[i]) != bytes[i])
+                return OpStatus::IOFailure;
+            flash[region.address + i] = bytes[i];
+        }
+        writtenSectors.push_back(region.address / sectorSize);
+        return OpStatus::Success;
+    }
+
+    std::vector<uint8_t> flash;
+    std::shared_ptr<DataStorage> storage;
+    std::vector<int32_t> erasedSectors;
+    std::vector<int32_t> writtenSectors;
+    std::size_t bytesRead{ 0 };
+};
+
+std::vector<uint8_t> MakeImage(std::size_t size)
+{
+    std::vector<uint8_t> image(size);
+    for (std::size_t i = 0; i < size; ++i)
+        image[i] = (i * 7 + i / 251) & 0xFF;
+    return image;
+}
+
+} // namespace
+
+TEST(MemoryWriteIncremental, WritesOnlyTheChangedSectors)
+{
+    constexpr uint32_t sectorSize = MockFlashDevice::sectorSize;
+    MockFlashDevice device(8);
+    const std::vector<uint8_t> oldImage = MakeImage(8 * sectorSize);
+    device.flash = oldImage;
+
+    std::vector<uint8_t> newImage = oldImage;
+    newImage[1 * sectorSize + 17] ^= 0x5A;
+    newImage[5 * sectorSize] ^= 0x01;
+    newImage[6 * sectorSize - 1] ^= 0x80;
+
+    std::vector<std::string> phases;
+    std::size_t comparedTotal = 0;
+    std::size_t writtenTotal = 0;
+    auto callback = [&](std::size_t bsent, std::size_t btotal, const std::string& message) {
+        if (phases.empty() || phases.back() != message)
+            phases.push_back(message);
+        if (message == "bytes compared")
+            comparedTotal = btotal;
+        else
+            writtenTotal = btotal;
+        EXPECT_LE(bsent, btotal);
+        return false;
+    };
+
+    const Region region{ 0, static_cast<int32_t>(newImage.size()) };
+    ASSERT_EQ(device.MemoryWriteIncremental(device.storage, region, newImage.data(), sectorSize, callback), OpStatus::Success);
+
+    EXPECT_EQ(device.flash, newImage);
+    EXPECT_EQ(device.erasedSectors, (std::vector<int32_t>{ 1, 5 }));
+    EXPECT_EQ(device.writtenSectors, (std::vector<int32_t>{ 1, 5 }));
+    EXPECT_EQ(phases, (std::vector<std::string>{ "bytes compared", "bytes written" }));
+    EXPECT_EQ(comparedTotal, newImage.size());
+    EXPECT_EQ(writtenTotal, 2 * sectorSize);
+}
+
+TEST(MemoryWriteIncremental, UnchangedImageIsNotWritten)
+{
+    MockFlashDevice device(4);
+    const std::vector<uint8_t> image = MakeImage(device.flash.size());
+    device.flash = image;
+
+    const Region region{ 0, static_cast<int32_t>(image.size()) };
+    ASSERT_EQ(device.MemoryWriteIncremental(device.storage, region, image.data(), MockFlashDevice::sectorSize), OpStatus::Success);
+
+    EXPECT_EQ(device.flash, image);
+    EXPECT_TRUE(device.erasedSectors.empty());
+    EXPECT_TRUE(device.writtenSectors.empty());
+    EXPECT_EQ(device.bytesRead, image.size());
+}
+
+TEST(MemoryWriteIncremental, UnalignedRegionPreservesTheRestOfTheSectors)
+{
+    constexpr uint32_t sectorSize = MockFlashDevice::sectorSize;
+    MockFlashDevice device(4);
+    const std::vector<uint8_t> oldContents = MakeImage(device.flash.size());
+    device.flash = oldContents;
+
+    // spans the end of sector 0, the whole sector 1 and the start of sector 2
+    const Region region{ sectorSize - 10, sectorSize + 20 };
+    std::vector<uint8_t> image(region.size, 0x00);
+
+    ASSERT_EQ(device.MemoryWriteIncremental(device.storage, region, image.data(), sectorSize), OpStatus::Success);
+
+    std::vector<uint8_t> expected = oldContents;
+    std::memcpy(expected.data() + region.address, image.data(), image.size());
+    EXPECT_EQ(device.flash, expected);
+    EXPECT_EQ(device.writtenSectors, (std::vector<int32_t>{ 0, 1, 2 }));
+}
+
+TEST(MemoryWriteIncremental, AbortStopsBeforeWriting)
+{
+    constexpr uint32_t sectorSize = MockFlashDevice::sectorSize;
+    MockFlashDevice device(2);
+    const std::vector<uint8_t> image = MakeImage(device.flash.size());
+
+    auto callback = [](std::size_t bsent, std::size_t btotal, const std::string& message) { return message == "bytes written"; };
+    const Region region{ 0, static_cast<int32_t>(image.size()) };
+    EXPECT_EQ(device.MemoryWriteIncremental(device.storage, region, image.data(), sectorSize, callback), OpStatus::Aborted);
+    EXPECT_TRUE(device.writtenSectors.empty());
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include "limesuiteng/LMS7002M.h"
+#include "PagedRegistersMock.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace lime;
+using namespace lime::testing;
+using namespace std::literals::string_literals;
+
+TEST(LMS7002MConfigSnapshot, RestoresBothRegisterPagesInSingleUpload)
+{
+    const std::string filename = "LMS7002MConfigSnapshotTest"s + LMS7002M::snapshotExtension;
+
+    auto sourcePort = std::make_shared<PagedRegistersMock>();
+    LMS7002M source(sourcePort);
+    source.SetActiveChannel(LMS7002M::Channel::ChA);
+    source.SPI_write(0x0086, 0x4905, true); // CGEN, shared
+    source.SPI_write(0x0105, 0x1234, true);
+    source.SPI_write(0x0121, 0x0A35, true); // SX CSW_VCO of channel A (SXR)
+    source.SetActiveChannel(LMS7002M::Channel::ChB);
+    source.SPI_write(0x0105, 0x4321, true);
+    source.SPI_write(0x0121, 0x0B47, true); // SX CSW_VCO of channel B (SXT)
+    ASSERT_EQ(source.SaveConfig(filename), OpStatus::Success);
+
+    auto targetPort = std::make_shared<PagedRegistersMock>();
+    LMS7002M target(targetPort);
+    targetPort->transactions = 0;
+    ASSERT_EQ(target.LoadConfig(filename), OpStatus::Success);
+    std::remove(filename.c_str());
+
+    EXPECT_EQ(targetPort->pages[0][0x0086], 0x4905);
+    EXPECT_EQ(targetPort->pages[0][0x0105], 0x1234);
+    EXPECT_EQ(targetPort->pages[0][0x0121], 0x0A35);
+    EXPECT_EQ(targetPort->pages[1][0x0105], 0x4321);
+    EXPECT_EQ(targetPort->pages[1][0x0121], 0x0B47);
+    EXPECT_EQ(target.GetActiveChannel(), LMS7002M::Channel::ChA);
+
+    // the same reference clock keeps the saved VCO settings, only the register upload and the logic reset remain
+    EXPECT_LE(targetPort->transactions, 8);
+}
+
+TEST(LMS7002MConfigSnapshot, RejectsTruncatedSnapshot)
+{
+    const std::string filename = "LMS7002MConfigSnapshotTruncated"s + LMS7002M::snapshotExtension;
+    {
+        LMS7002M source(std::make_shared<PagedRegistersMock>());
+        ASSERT_EQ(source.SaveConfig(filename), OpStatus::Success);
+    }
+    std::vector<char> contents;
+    {
+        std::FILE* file = std::fopen(filename.c_str(), "rb");
+        ASSERT_NE(file, nullptr);
+        contents.resize(64);
+        contents.resize(std::fread(contents.data(), 1, contents.size(), file));
+        std::fclose(file);
+        file = std::fopen(filename.c_str(), "wb");
+        std::fwrite(contents.data(), 1, contents.size(), file);
+        std::fclose(file);
+    }
+
+    LMS7002M target(std::make_shared<PagedRegistersMock>());
+    EXPECT_EQ(target.LoadConfig(filename), OpStatus::InvalidValue);
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+
+#include "boards/Simulated/SimulatedSDR.h"
+#include "limesuiteng/DeviceTelemetry.h"
+#include "limesuiteng/LMS7002M.h"
+#include "PagedRegistersMock.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+using namespace lime;
+using namespace lime::testing;
+
+TEST(LMS7002MControlLock, GainChangesFromOtherThreadKeepApplicationChannel)
+{
+    constexpr int iterations = 2000;
+
+    SimulatedSDR device;
+    LMS7002M* chip = static_cast<LMS7002M*>(device.GetInternalChip(0));
+    ASSERT_NE(chip, nullptr);
+    auto port = std::make_shared<PagedRegistersMock>();
+    chip->SetConnection(port);
+    chip->SetActiveChannel(LMS7002M::Channel::ChA);
+    chip->Modify_SPI_Reg_bits(LMS7002MCSR::CG_IAMP_TBB, 1);
+    const uint16_t channelBGain = port->pages[1][0x0119] & 0x1F; // G_PGA_RBB
+
+    // the streaming gain control changes the channel A gain, while the application configures channel B
+    std::atomic<bool> stop{ false };
+    std::thread gainControl([&]() {
+        for (int i = 0; !stop.load(); ++i)
+            device.SetGain(0, TRXDir::Rx, 0, eGainTypes::GENERIC, i % 60);
+    });
+    int mismatches = 0;
+    for (int i = 0; i < iterations; ++i)
+    {
+        const uint16_t value = 2 + i % 60;
+        chip->SetActiveChannel(LMS7002M::Channel::ChB);
+        chip->Modify_SPI_Reg_bits(LMS7002MCSR::CG_IAMP_TBB, value);
+        if (chip->Get_SPI_Reg_bits(LMS7002MCSR::CG_IAMP_TBB, true) != value)
+            ++mismatches;
+        chip->SetActiveChannel(LMS7002M::Channel::ChA);
+    }
+    stop.store(true);
+    gainControl.join();
+
+    EXPECT_EQ(mismatches, 0);
+
+    // every write landed in the page of the channel it was meant for
+    EXPECT_EQ(port->pages[0][0x0108] >> 10, 1); // CG_IAMP_TBB
+    EXPECT_EQ(port->pages[1][0x0119] & 0x1F, channelBGain);
+    EXPECT_EQ(chip->GetActiveChannel(true), LMS7002M::Channel::ChA);
+}
+
+TEST(LMS7002MControlLock, TelemetrySamplingKeepsApplicationChannel)
+{
+    // the first sample waits for the temperature sensor to settle, the rest only read the chip
+    constexpr auto duration = std::chrono::milliseconds(600);
+
+    SimulatedSDR device;
+    LMS7002M* chip = static_cast<LMS7002M*>(device.GetInternalChip(0));
+    ASSERT_NE(chip, nullptr);
+    auto port = std::make_shared<PagedRegistersMock>();
+    chip->SetConnection(port);
+    chip->SetActiveChannel(LMS7002M::Channel::ChA);
+    chip->Modify_SPI_Reg_bits(LMS7002MCSR::CG_IAMP_TBB, 1);
+
+    int mismatches = 0;
+    {
+        // the telemetry reads select both of the channels
+        TelemetrySampler sampler(&device, std::chrono::milliseconds(0), std::chrono::hours(1));
+        const auto end = std::chrono::steady_clock::now() + duration;
+        for (int i = 0; std::chrono::steady_clock::now() < end; ++i)
+        {
+            const uint16_t value = 2 + i % 60;
+            chip->SetActiveChannel(LMS7002M::Channel::ChB);
+            chip->Modify_SPI_Reg_bits(LMS7002MCSR::CG_IAMP_TBB, value);
+            if (chip->Get_SPI_Reg_bits(LMS7002MCSR::CG_IAMP_TBB, true) != value)
+                ++mismatches;
+            chip->SetActiveChannel(LMS7002M::Channel::ChA);
+        }
+    }
+
+    EXPECT_EQ(mismatches, 0);
+    EXPECT_EQ(port->pages[0][0x0108] >> 10, 1); // CG_IAMP_TBB
+    EXPECT_EQ(chip->GetActiveChannel(true), LMS7002M::Channel::ChA);
+}
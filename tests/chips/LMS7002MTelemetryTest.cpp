@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+
+#include "limesuiteng/LMS7002M.h"
+#include "PagedRegistersMock.h"
+
+#include <cmath>
+#include <memory>
+
+using namespace lime;
+using namespace lime::testing;
+
+namespace {
+
+/// @brief Sets up the read only values of the chip.
+std::shared_ptr<PagedRegistersMock> MakeChipPort()
+{
+    auto port = std::make_shared<PagedRegistersMock>();
+    port->pages[0][0x008C] = 0x2000; // CGEN locked
+    port->pages[0][0x0123] = 0x2000; // SXR locked
+    port->pages[1][0x0123] = 0x3000; // SXT not locked
+    port->pages[0][0x040E] = 0x0002;
+    port->pages[0][0x040F] = 0x1234;
+    port->pages[1][0x040E] = 0x0001;
+    port->pages[1][0x040F] = 0x0042;
+    return port;
+}
+
+} // namespace
+
+TEST(LMS7002MTelemetry, ReadsAllValuesInSingleTransaction)
+{
+    auto port = MakeChipPort();
+    LMS7002M chip(port);
+    chip.SetActiveChannel(LMS7002M::Channel::ChA);
+    chip.SPI_write(0x0400, 0x0081, true);
+    chip.SetActiveChannel(LMS7002M::Channel::ChB);
+    chip.SPI_write(0x0400, 0x4081, true); // CAPSEL of channel B selects ADC samples instead of RSSI
+    const auto pagesBefore = port->pages;
+
+    DeviceTelemetry::Module telemetry;
+    port->transactions = 0;
+    ASSERT_EQ(chip.ReadTelemetry(telemetry), OpStatus::Success);
+    EXPECT_EQ(port->transactions, 1);
+
+    EXPECT_TRUE(telemetry.cgenLocked);
+    EXPECT_TRUE(telemetry.sxLocked[static_cast<int>(TRXDir::Rx)]);
+    EXPECT_FALSE(telemetry.sxLocked[static_cast<int>(TRXDir::Tx)]);
+    ASSERT_EQ(telemetry.rssi.size(), 2);
+    EXPECT_EQ(telemetry.rssi[0], (0x1234u << 2) | 0x2);
+    EXPECT_EQ(telemetry.rssi[1], (0x0042u << 2) | 0x1);
+    EXPECT_TRUE(std::isnan(telemetry.temperature));
+
+    // the channel selection and the capture configuration are restored
+    EXPECT_EQ(port->pages, pagesBefore);
+    EXPECT_EQ(chip.GetActiveChannel(), LMS7002M::Channel::ChB);
+}
+
+TEST(LMS7002MTelemetry, ReadsStartedTemperatureMeasurement)
+{
+    auto port = MakeChipPort();
+    port->pages[0][0x002F] = 0x0001; // MASK, revision with the temperature sensor
+    port->pages[0][0x0601] = 0x0020; // internal ADC calibration done
+    port->pages[0][0x0606] = 0x4050; // Vtemp 0x40, Vptat 0x50
+    LMS7002M chip(port);
+    chip.SetActiveChannel(LMS7002M::Channel::ChA);
+    chip.Modify_SPI_Reg_bits(LMS7002MCSR::MUX_BIAS_OUT, 1);
+
+    ASSERT_EQ(chip.StartTemperatureMeasurement(), OpStatus::Success);
+    EXPECT_EQ(chip.Get_SPI_Reg_bits(LMS7002MCSR::MUX_BIAS_OUT, true), 2);
+
+    DeviceTelemetry::Module telemetry;
+    port->transactions = 0;
+    ASSERT_EQ(chip.ReadTelemetry(telemetry), OpStatus::Success);
+    EXPECT_EQ(port->transactions, 1);
+    EXPECT_DOUBLE_EQ(telemetry.temperature, (45000 + (0x50 - 0x40) * 1752) / 1e3);
+    EXPECT_EQ(chip.Get_SPI_Reg_bits(LMS7002MCSR::MUX_BIAS_OUT, true), 1);
+
+    // the measurement is read once
+    ASSERT_EQ(chip.ReadTelemetry(telemetry), OpStatus::Success);
+    EXPECT_TRUE(std::isnan(telemetry.temperature));
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "comms/ISPI.h"
+
+#include <array>
+#include <vector>
+
+namespace lime::testing {
+
+/// @brief LMS7002M registers in memory, with separate channel A and B pages selected by the MAC register.
+class PagedRegistersMock : public lime::ISPI
+{
+  public:
+    OpStatus SPI(const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        ++transactions;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const uint32_t word = MOSI[i];
+            const bool isWrite = word & (1 << 31);
+            const uint16_t address = isWrite ? (word >> 16) & 0x7FFF : word & 0x7FFF;
+            const uint16_t mac = pages[0][0x0020] & 0x3;
+            if (isWrite)
+            {
+                if (address < 0x0100 || (mac & 0x1))
+                    pages[0][address] = word & 0xFFFF;
+                if (address >= 0x0100 && (mac & 0x2))
+                    pages[1][address] = word & 0xFFFF;
+            }
+            else if (MISO)
+                MISO[i] = pages[address >= 0x0100 && mac == 2 ? 1 : 0][address];
+        }
+        return OpStatus::Success;
+    }
+
+    OpStatus SPI(uint32_t spiBusAddress, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        return SPI(MOSI, MISO, count);
+    }
+
+    std::array<std::vector<uint16_t>, 2> pages{ std::vector<uint16_t>(0x800, 0), std::vector<uint16_t>(0x800, 0) };
+    int transactions{ 0 };
+};
+
+} // namespace lime::testing
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include "cli/SPIScript.h"
+#include "boards/Simulated/SimulatedSDR.h"
+
+#include <chrono>
+#include <sstream>
+#include <string>
+
+using namespace lime;
+
+namespace {
+
+constexpr int32_t chipSelect = 0; // the LMS7002M of the simulated device
+
+/// @brief Gets the amount of SPI transactions from the summary line of the report.
+int TransactionsCount(const std::string& report)
+{
+    const std::size_t summary = report.rfind(" operations in ");
+    if (summary == std::string::npos)
+        return -1;
+    return std::stoi(report.substr(summary + 15));
+}
+
+/// @brief Counts the SPI transactions sent to the simulated chips.
+class CountingSDR : public SimulatedSDR
+{
+  public:
+    OpStatus SPI(uint32_t chipSelect, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        ++transactions;
+        return SimulatedSDR::SPI(chipSelect, MOSI, MISO, count);
+    }
+
+    int transactions{ 0 };
+};
+
+} // namespace
+
+TEST(SPIScript, ParsesAllOperations)
+{
+    SPIScript script;
+    std::string error;
+    ASSERT_TRUE(script.Parse("read 20 21 # comment\nwrite 20,FFFD; modify 0021 00F0 0050\n"
+                             "poll 28 8000 8000 50\ndelay 2\nchip FPGA",
+                    error))
+        << error;
+
+    const auto& operations = script.GetOperations();
+    ASSERT_EQ(operations.size(), 7u);
+    EXPECT_EQ(operations[0].type, SPIScript::OperationType::Read);
+    EXPECT_EQ(operations[0].address, 0x20);
+    EXPECT_EQ(operations[1].address, 0x21);
+    EXPECT_EQ(operations[2].type, SPIScript::OperationType::Write);
+    EXPECT_EQ(operations[2].value, 0xFFFD);
+    // ';' separates operations on the same line
+    EXPECT_EQ(operations[2].line, 2);
+    EXPECT_EQ(operations[3].type, SPIScript::OperationType::Modify);
+    EXPECT_EQ(operations[3].line, 2);
+    EXPECT_EQ(operations[3].mask, 0x00F0);
+    EXPECT_EQ(operations[4].type, SPIScript::OperationType::Poll);
+    EXPECT_EQ(operations[4].time_ms, 50u);
+    EXPECT_EQ(operations[5].type, SPIScript::OperationType::Delay);
+    EXPECT_EQ(operations[5].time_ms, 2u);
+    EXPECT_EQ(operations[6].type, SPIScript::OperationType::Chip);
+    EXPECT_EQ(operations[6].chip, "FPGA");
+}
+
+TEST(SPIScript, RejectsInvalidLines)
+{
+    SPIScript script;
+    std::string error;
+    EXPECT_FALSE(script.Parse("read 20\nwrite 20", error));
+    EXPECT_NE(error.find("line 2"), std::string::npos) << error;
+    EXPECT_TRUE(script.GetOperations().empty());
+
+    EXPECT_FALSE(script.Parse("read 10000", error));
+    EXPECT_FALSE(script.Parse("jump 20", error));
+    EXPECT_FALSE(script.Parse("delay 1A", error));
+    // the masked bits could never match
+    EXPECT_FALSE(script.Parse("poll 28 00FF 0100", error));
+    EXPECT_NE(error.find("mask"), std::string::npos) << error;
+}
+
+TEST(SPIScript, BatchesUntilReadValueIsNeeded)
+{
+    SimulatedSDR device;
+    SPIScript script;
+    std::string error;
+    // the reads and writes share one transaction, the modify ends it with its read, its write starts the next one
+    ASSERT_TRUE(script.Parse("write 30 1234\nwrite 31 5678\nread 30 31\nmodify 31 00F0 00A0\nread 31", error)) << error;
+
+    std::ostringstream report;
+    ASSERT_TRUE(script.Run(&device, chipSelect, report, error)) << error;
+    EXPECT_EQ(TransactionsCount(report.str()), 2) << report.str();
+
+    uint32_t word = 0x31;
+    uint32_t value = 0;
+    ASSERT_EQ(device.SPI(chipSelect, &word, &value, 1), OpStatus::Success);
+    EXPECT_EQ(value, 0x56A8u);
+}
+
+TEST(SPIScript, DelayEndsTransaction)
+{
+    SimulatedSDR device;
+    SPIScript script;
+    std::string error;
+    ASSERT_TRUE(script.Parse("write 30 1\ndelay 1\nwrite 30 2\nread 30", error)) << error;
+
+    std::ostringstream report;
+    ASSERT_TRUE(script.Run(&device, chipSelect, report, error)) << error;
+    EXPECT_EQ(TransactionsCount(report.str()), 2) << report.str();
+}
+
+TEST(SPIScript, PollCompletesWhenMaskedBitsMatch)
+{
+    SimulatedSDR device;
+    SPIScript script;
+    std::string error;
+    ASSERT_TRUE(script.Parse("write 28 C0FF\npoll 28 C000 8000 10\npoll 28 C000 C000", error)) << error;
+
+    std::ostringstream report;
+    EXPECT_FALSE(script.Run(&device, chipSelect, report, error));
+    EXPECT_NE(error.find("timed out"), std::string::npos) << error;
+
+    ASSERT_TRUE(script.Parse("write 28 C0FF\npoll 28 C000 C000", error)) << error;
+    ASSERT_TRUE(script.Run(&device, chipSelect, report, error)) << error;
+    EXPECT_NE(report.str().find("(1 reads)"), std::string::npos) << report.str();
+}
+
+TEST(SPIScript, PollWaitsBetweenReads)
+{
+    constexpr int timeout_ms = 20;
+    CountingSDR device;
+    SPIScript script;
+    std::string error;
+    ASSERT_TRUE(script.Parse("write 28 0\npoll 28 0001 0001 " + std::to_string(timeout_ms), error)) << error;
+
+    const auto start = std::chrono::steady_clock::now();
+    std::ostringstream report;
+    EXPECT_FALSE(script.Run(&device, chipSelect, report, error));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(timeout_ms));
+    // a read every millisecond at most, instead of back to back reads, plus the write and the first read
+    EXPECT_LE(device.transactions, timeout_ms + 3);
+}
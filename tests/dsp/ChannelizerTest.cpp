@@ -0,0 +1,134 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "DSP/Resampling/Channelizer.h"
+#include "limesuiteng/complex.h"
+
+#include <complex>
+#include <random>
+#include <vector>
+
+using namespace lime;
+
+namespace {
+
+// Double precision model of a single sub-channel:
+// mix the sub-channel center to DC, filter with the prototype taps, keep the samples at timestamps divisible by decimation.
+std::vector<std::complex<double>> ReferenceSubChannel(const std::vector<complex32f_t>& input,
+    uint64_t timestamp,
+    uint16_t decimation,
+    double frequency,
+    const std::vector<float>& taps)
+{
+    std::vector<std::complex<double>> mixed(input.size());
+    for (std::size_t i = 0; i < input.size(); ++i)
+    {
+        const double phase = -2 * M_PI * std::fmod(frequency * (timestamp + i), 1.0);
+        mixed[i] = std::complex<double>(input[i].real(), input[i].imag()) * std::polar(1.0, phase);
+    }
+
+    std::vector<std::complex<double>> output;
+    for (std::size_t n = 0; n < input.size(); ++n)
+    {
+        if ((timestamp + n) % decimation != 0)
+            continue;
+        std::complex<double> sum = 0;
+        for (std::size_t k = 0; k < taps.size() && k <= n; ++k)
+            sum += static_cast<double>(taps[k]) * mixed[n - k];
+        output.push_back(sum);
+    }
+    return output;
+}
+
+} // namespace
+
+TEST(Channelizer, SubChannelsMatchReferenceAcrossCalls)
+{
+    constexpr uint16_t channelCount = 8;
+    constexpr uint16_t decimation = 4; // 2x oversampled
+    constexpr uint64_t timestamp = 1001; // not aligned to the decimation
+    constexpr std::size_t inputCount = 3000;
+    const std::vector<uint16_t> outputs = { 0, 3, 5, 7 };
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(-0.5, 0.5);
+    std::vector<complex32f_t> input(inputCount);
+    for (auto& sample : input)
+        sample = complex32f_t(dist(rng), dist(rng));
+
+    Channelizer channelizer(channelCount, decimation, outputs);
+    std::vector<std::vector<complex32f_t>> output(outputs.size(), std::vector<complex32f_t>(inputCount / decimation + 16));
+    uint32_t produced = 0;
+    std::size_t offset = 0;
+    for (uint32_t chunk : { 1u, 62u, 999u, 1u, 1000u, 937u })
+    {
+        complex32f_t* dest[4];
+        for (std::size_t i = 0; i < outputs.size(); ++i)
+            dest[i] = &output[i][produced];
+        produced += channelizer.Process(&input[offset], chunk, timestamp + offset, dest);
+        offset += chunk;
+    }
+    ASSERT_EQ(offset, inputCount);
+
+    EXPECT_EQ(channelizer.GetOutputTimestamp(timestamp), 251u);
+    for (std::size_t i = 0; i < outputs.size(); ++i)
+    {
+        const double frequency = outputs[i] / static_cast<double>(channelCount);
+        const std::vector<std::complex<double>> expected =
+            ReferenceSubChannel(input, timestamp, decimation, frequency, channelizer.GetTaps());
+        ASSERT_EQ(produced, expected.size());
+        double maxError = 0;
+        for (std::size_t n = 0; n < expected.size(); ++n)
+        {
+            maxError = std::max(maxError, std::abs(expected[n].real() - output[i][n].real()));
+            maxError = std::max(maxError, std::abs(expected[n].imag() - output[i][n].imag()));
+        }
+        EXPECT_LT(maxError, 2e-5) << "sub-channel " << outputs[i];
+    }
+}
+
+TEST(Channelizer, ToneAppearsOnlyInItsSubChannel)
+{
+    constexpr uint16_t channelCount = 16;
+    constexpr uint16_t decimation = 8;
+    constexpr uint16_t toneChannel = 13; // negative frequency
+    constexpr std::size_t inputCount = 16384;
+    constexpr int16_t amplitude = 16384;
+
+    std::vector<uint16_t> outputs(channelCount);
+    for (uint16_t i = 0; i < channelCount; ++i)
+        outputs[i] = i;
+    Channelizer channelizer(channelCount, decimation, outputs);
+    // slightly off the center, still well inside the sub-channel
+    const double toneFrequency = channelizer.GetCenterFrequency(toneChannel) + 0.2 / channelCount;
+    EXPECT_NEAR(channelizer.GetCenterFrequency(toneChannel), -3.0 / channelCount, 1e-12);
+
+    std::vector<complex16_t> input(inputCount);
+    for (std::size_t i = 0; i < inputCount; ++i)
+    {
+        const double phase = 2 * M_PI * toneFrequency * i;
+        input[i] = complex16_t(std::lround(amplitude * std::cos(phase)), std::lround(amplitude * std::sin(phase)));
+    }
+
+    std::vector<std::vector<complex32f_t>> output(channelCount, std::vector<complex32f_t>(inputCount / decimation + 1));
+    std::vector<complex32f_t*> dest(channelCount);
+    for (uint16_t i = 0; i < channelCount; ++i)
+        dest[i] = output[i].data();
+    const uint32_t produced = channelizer.Process(input.data(), inputCount, 0, dest.data());
+    ASSERT_EQ(produced, inputCount / decimation);
+
+    // skip the filter settling
+    const std::size_t settled = std::ceil(channelizer.GetTaps().size() / static_cast<double>(decimation));
+    for (uint16_t channel = 0; channel < channelCount; ++channel)
+    {
+        double peak = 0;
+        for (std::size_t i = settled; i < produced; ++i)
+            peak = std::max<double>(peak, std::hypot(output[channel][i].real(), output[channel][i].imag()));
+        if (channel == toneChannel)
+            EXPECT_NEAR(peak, 0.5, 5e-3);
+        else
+            EXPECT_LT(peak, 0.5 * 1e-4) << "sub-channel " << channel;
+    }
+}
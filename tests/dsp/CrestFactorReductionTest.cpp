@@ -0,0 +1,205 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "comms/ISPI.h"
+#include "DSP/CFR/CrestFactorReduction.h"
+#include "DSP/CFR/registers.h"
+
+#include <map>
+
+using namespace lime;
+
+namespace {
+
+/// Register memory of the CFR block, every channel selected by the MAC register has its own registers.
+class CFRSPIMock : public ISPI
+{
+  public:
+    OpStatus SPI(const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        ++transactions;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            // the write flag overlaps the most significant address bit
+            const uint16_t address = (MOSI[i] >> 16) & 0x7FFF;
+            if (MOSI[i] & (1u << 31))
+            {
+                if (address == (CFR::MAC.address & 0x7FFF))
+                    mac = MOSI[i];
+                else
+                    registers[mac & 0x3][address] = MOSI[i];
+                ++writes;
+            }
+            else if (MISO)
+            {
+                const uint16_t readAddress = MOSI[i] & 0xFFFF;
+                MISO[i] = readAddress == CFR::MAC.address ? mac : registers[mac & 0x3][readAddress];
+            }
+        }
+        return OpStatus::Success;
+    }
+
+    OpStatus SPI(uint32_t chipSelect, const uint32_t* MOSI, uint32_t* MISO, uint32_t count) override
+    {
+        return SPI(MOSI, MISO, count);
+    }
+
+    uint16_t mac{ 0xA5A4 };
+    std::map<uint16_t, uint16_t> registers[4];
+    int transactions{ 0 };
+    int writes{ 0 };
+};
+
+// The previous field by field implementation, as the reference for the register contents.
+void WriteField(ISPI& spi, const Register& reg, uint16_t value)
+{
+    uint32_t mosi = reg.address;
+    uint32_t miso = 0;
+    spi.SPI(&mosi, &miso, 1);
+    const uint16_t regMask = bitMask(reg.msb, reg.lsb);
+    mosi = (1u << 31) | reg.address << 16 | (miso & ~regMask) | ((value << reg.lsb) & regMask);
+    spi.SPI(&mosi, nullptr, 1);
+}
+
+void WriteMemory(ISPI& spi, uint16_t address, uint16_t value)
+{
+    const uint32_t mosi = (1u << 31) | address << 16 | value;
+    spi.SPI(&mosi, nullptr, 1);
+}
+
+void LegacyConfigure(ISPI& spi, const CrestFactorReduction::Config& state)
+{
+    using namespace CFR;
+    for (uint8_t ch = 0; ch < 2; ++ch)
+    {
+        const auto& cfr = state.cfr[ch];
+        const auto& fir = state.fir[ch];
+        const bool useOversample = std::min<uint8_t>(cfr.interpolation, 2) != 1;
+        WriteField(spi, MAC, ch + 1);
+        WriteField(spi, RX_EQU_BYP, state.bypassRxEqualizer[ch]);
+        WriteField(spi, TX_EQU_BYP, state.bypassTxEqualizer[ch]);
+        WriteField(spi, TX_HB_BYP, !useOversample);
+        WriteField(spi, TX_HB_DEL, useOversample);
+        WriteField(spi, SLEEP_CFR, cfr.sleep);
+        WriteField(spi, BYPASS_CFR, cfr.bypass);
+        WriteField(spi, ODD_CFR, fir.coefficientsCount % 2);
+        WriteField(spi, BYPASSGAIN_CFR, cfr.bypassGain);
+
+        WriteField(spi, SLEEP_FIR, 1);
+        for (int i = 0; i < 32; ++i)
+        {
+            WriteMemory(spi, (0x000E << 6) + i, fir.coefficients[i]);
+            WriteMemory(spi, (0x000F << 6) + i, fir.coefficients[i]);
+        }
+        WriteField(spi, ODD_FIR, 0);
+        WriteField(spi, SLEEP_FIR, 0);
+        WriteField(spi, SLEEP_FIR, fir.sleep);
+        WriteField(spi, BYPASS_FIR, fir.bypass);
+
+        if (cfr.order >= 2 && cfr.order <= 32)
+        {
+            const int N = cfr.order;
+            WriteField(spi, CFR_ORDER, N);
+            WriteField(spi, SLEEP_CFR, 1);
+            uint16_t w[32];
+            for (int i = 0; i < N; ++i)
+                w[i] = static_cast<uint16_t>(32768.0 * 0.25 * (1.0 - cos(2.0 * M_PI * i / (N - 1))));
+            for (int i = 0; i < 32; ++i)
+            {
+                WriteMemory(spi, (0x000C << 6) + i, 0);
+                WriteMemory(spi, (0x000D << 6) + i, 0);
+            }
+            for (int i = 0; i < N / 2; ++i)
+                WriteMemory(spi, (0x000D << 6) + i, w[(N + 1) / 2 + i]);
+            const int offset = 16 - (N + 1) / 2;
+            for (int i = 0; i < N; ++i)
+                WriteMemory(spi, (0x000C << 6) + offset + i, w[i]);
+            WriteField(spi, ODD_CFR, N % 2);
+            WriteField(spi, SLEEP_CFR, 0);
+        }
+        WriteField(spi, thresholdSpin, cfr.threshold);
+        WriteField(spi, thresholdGain, cfr.thresholdGain);
+    }
+}
+
+void FillRegisters(CFRSPIMock& spi)
+{
+    // unrelated bits must be preserved
+    uint16_t value = 0x1234;
+    for (auto& channel : spi.registers)
+        for (uint16_t address : { 0x0086, 0x0087, 0x0088, 0x008C, 0x00AC })
+        {
+            value = value * 75 + 74;
+            channel[address] = value;
+        }
+}
+
+CrestFactorReduction::Config MakeConfig(uint8_t order, uint8_t coefficientsCount)
+{
+    CrestFactorReduction::Config config;
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        config.cfr[ch].bypass = ch == 1;
+        config.cfr[ch].sleep = true;
+        config.cfr[ch].bypassGain = ch == 0;
+        config.cfr[ch].order = order + ch;
+        config.cfr[ch].interpolation = ch + 1;
+        config.cfr[ch].threshold = 0x7ABC - ch;
+        config.cfr[ch].thresholdGain = 0x1357 + ch;
+        config.fir[ch].sleep = ch == 0;
+        config.fir[ch].bypass = ch == 1;
+        config.fir[ch].coefficientsCount = coefficientsCount;
+        for (int i = 0; i < coefficientsCount; ++i)
+            config.fir[ch].coefficients[i] = (i - 10) * 1000 + ch;
+        config.bypassRxEqualizer[ch] = ch == 0;
+        config.bypassTxEqualizer[ch] = ch == 1;
+    }
+    return config;
+}
+
+} // namespace
+
+TEST(CrestFactorReduction, ConfigureMatchesFieldByFieldWrites)
+{
+    for (const auto& [order, coefficientsCount] : { std::pair{ 16, 31 }, std::pair{ 31, 32 }, std::pair{ 0, 5 }, std::pair{ 2, 0 } })
+    {
+        const CrestFactorReduction::Config config = MakeConfig(order, coefficientsCount);
+
+        auto reference = std::make_shared<CFRSPIMock>();
+        FillRegisters(*reference);
+        LegacyConfigure(*reference, config);
+
+        auto batched = std::make_shared<CFRSPIMock>();
+        FillRegisters(*batched);
+        CrestFactorReduction cfr(batched);
+        ASSERT_EQ(cfr.Configure(config), OpStatus::Success);
+
+        EXPECT_EQ(batched->mac, reference->mac);
+        for (int ch = 0; ch < 4; ++ch)
+            EXPECT_EQ(batched->registers[ch], reference->registers[ch]) << "order " << order << ", channel " << ch;
+
+        // one MAC read, then a read and a write transaction per channel
+        EXPECT_EQ(batched->transactions, 5);
+        EXPECT_LT(batched->writes, reference->writes);
+    }
+}
+
+TEST(CrestFactorReduction, OversampleIsSetOnBothChannels)
+{
+    auto spi = std::make_shared<CFRSPIMock>();
+    FillRegisters(*spi);
+    CrestFactorReduction cfr(spi);
+
+    ASSERT_EQ(cfr.SetOversample(2), OpStatus::Success);
+    EXPECT_EQ(spi->transactions, 5);
+    EXPECT_EQ(cfr.GetOversample(), 2);
+    for (int ch = 1; ch <= 2; ++ch)
+        EXPECT_EQ(spi->registers[ch][0x0088] & 0x3, 0x2);
+
+    ASSERT_EQ(cfr.SetOversample(1), OpStatus::Success);
+    EXPECT_EQ(cfr.GetOversample(), 1);
+    for (int ch = 1; ch <= 2; ++ch)
+        EXPECT_EQ(spi->registers[ch][0x0088] & 0x3, 0x1);
+}
@@ -0,0 +1,166 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "DSP/Resampling/Downconverter.h"
+#include "limesuiteng/complex.h"
+#include "protocols/BufferInterleaving.h"
+
+#include <complex>
+#include <random>
+#include <vector>
+
+using namespace lime;
+
+namespace {
+
+// Double precision model of the downconverter:
+// mix, filter with the same taps, keep the samples at timestamps divisible by decimation.
+std::vector<std::complex<double>> ReferenceDownconvert(const std::vector<complex16_t>& input,
+    uint64_t timestamp,
+    uint16_t decimation,
+    double frequency,
+    const std::vector<float>& taps)
+{
+    std::vector<std::complex<double>> mixed(input.size());
+    for (std::size_t i = 0; i < input.size(); ++i)
+    {
+        const double phase = -2 * M_PI * std::fmod(frequency * (timestamp + i), 1.0);
+        mixed[i] = std::complex<double>(input[i].real() / 32768.0, input[i].imag() / 32768.0) * std::polar(1.0, phase);
+    }
+
+    std::vector<std::complex<double>> output;
+    for (std::size_t n = 0; n < input.size(); ++n)
+    {
+        if ((timestamp + n) % decimation != 0)
+            continue;
+        std::complex<double> sum = 0;
+        for (std::size_t k = 0; k < taps.size() && k <= n; ++k)
+            sum += static_cast<double>(taps[k]) * mixed[n - k];
+        output.push_back(sum);
+    }
+    return output;
+}
+
+} // namespace
+
+TEST(Downconverter, MatchesReferenceAcrossCalls)
+{
+    constexpr uint16_t decimation = 4;
+    constexpr double frequency = 0.1234;
+    constexpr uint64_t timestamp = 1003; // not aligned to the decimation
+    constexpr std::size_t inputCount = 4000;
+
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> dist(-16000, 16000);
+    std::vector<complex16_t> input(inputCount);
+    for (auto& sample : input)
+        sample = complex16_t(dist(rng), dist(rng));
+
+    Downconverter ddc(decimation, frequency);
+    const std::vector<std::complex<double>> expected = ReferenceDownconvert(input, timestamp, decimation, frequency, ddc.GetTaps());
+
+    // feed in uneven chunks, the result must not depend on the call boundaries
+    std::vector<complex32f_t> output(inputCount / decimation + 16);
+    uint32_t produced = 0;
+    std::size_t offset = 0;
+    for (uint32_t chunk : { 1u, 63u, 500u, 1021u, 7u })
+    {
+        produced += ddc.Process(&input[offset], 1, chunk, timestamp + offset, &output[produced]);
+        offset += chunk;
+    }
+    produced += ddc.Process(&input[offset], 1, inputCount - offset, timestamp + offset, &output[produced]);
+
+    ASSERT_EQ(produced, expected.size());
+    EXPECT_EQ(ddc.GetOutputTimestamp(timestamp), 251u);
+    double maxError = 0;
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        maxError = std::max(maxError, std::abs(expected[i].real() - output[i].real()));
+        maxError = std::max(maxError, std::abs(expected[i].imag() - output[i].imag()));
+    }
+    EXPECT_LT(maxError, 2e-5);
+}
+
+TEST(Downconverter, ShiftsToneToDCAndRejectsAliases)
+{
+    constexpr uint16_t decimation = 8;
+    constexpr double frequency = 0.2;
+    constexpr std::size_t inputCount = 16384;
+
+    auto outputAmplitude = [&](double toneFrequency) {
+        std::vector<complex16_t> input(inputCount);
+        for (std::size_t i = 0; i < inputCount; ++i)
+        {
+            const double phase = 2 * M_PI * toneFrequency * i;
+            input[i] = complex16_t(std::lround(16384 * std::cos(phase)), std::lround(16384 * std::sin(phase)));
+        }
+        Downconverter ddc(decimation, frequency);
+        std::vector<complex32f_t> output(inputCount / decimation + 1);
+        const uint32_t produced = ddc.Process(input.data(), 1, inputCount, 0, output.data());
+        // skip the filter settling
+        const std::size_t settled = std::ceil(ddc.GetTaps().size() / static_cast<double>(decimation));
+        double peak = 0;
+        for (std::size_t i = settled; i < produced; ++i)
+            peak = std::max<double>(peak, std::hypot(output[i].real(), output[i].imag()));
+        return peak;
+    };
+
+    // in band: shifted to DC with unity gain
+    EXPECT_NEAR(outputAmplitude(frequency), 0.5, 1e-3);
+    EXPECT_NEAR(outputAmplitude(frequency + 0.02), 0.5, 5e-3);
+    // out of band: would alias into the output band without filtering
+    EXPECT_LT(outputAmplitude(frequency + 1.0 / decimation), 0.5 * 1e-4);
+    EXPECT_LT(outputAmplitude(frequency - 0.5 / decimation - 0.02), 0.5 * 1e-4);
+}
+
+TEST(Downconverter, DeinterleavesLinkFormat)
+{
+    constexpr uint16_t decimation = 2;
+    constexpr uint32_t samplesPerChannel = 1020;
+
+    std::vector<complex16_t> interleaved(samplesPerChannel * 2);
+    std::vector<complex16_t> channelA(samplesPerChannel);
+    std::vector<complex16_t> channelB(samplesPerChannel);
+    for (uint32_t i = 0; i < samplesPerChannel; ++i)
+    {
+        channelA[i] = interleaved[2 * i] = complex16_t(i * 7 % 2000, -static_cast<int>(i % 300));
+        channelB[i] = interleaved[2 * i + 1] = complex16_t(-static_cast<int>(i % 500), i * 3 % 1000);
+    }
+
+    Downconverter ddcA(decimation, 0.05);
+    Downconverter ddcB(decimation, -0.1);
+    Downconverter* downconverters[2] = { &ddcA, &ddcB };
+    std::vector<complex16_t> outA(samplesPerChannel);
+    std::vector<complex16_t> outB(samplesPerChannel);
+    void* dest[2] = { outA.data(), outB.data() };
+
+    DataConversion conversion{};
+    conversion.srcFormat = DataFormat::I16;
+    conversion.destFormat = DataFormat::I16;
+    conversion.channelCount = 2;
+    const int produced = DeinterleaveDownconvert(dest,
+        reinterpret_cast<const uint8_t*>(interleaved.data()),
+        interleaved.size() * sizeof(complex16_t),
+        conversion,
+        downconverters,
+        2,
+        0);
+    ASSERT_EQ(produced, samplesPerChannel / decimation);
+
+    // same result as processing each channel separately
+    Downconverter refA(decimation, 0.05);
+    Downconverter refB(decimation, -0.1);
+    std::vector<complex16_t> expectedA(samplesPerChannel);
+    std::vector<complex16_t> expectedB(samplesPerChannel);
+    refA.Process(channelA.data(), 1, samplesPerChannel, 0, expectedA.data());
+    refB.Process(channelB.data(), 1, samplesPerChannel, 0, expectedB.data());
+    for (int i = 0; i < produced; ++i)
+    {
+        ASSERT_EQ(outA[i].real(), expectedA[i].real()) << i;
+        ASSERT_EQ(outA[i].imag(), expectedA[i].imag()) << i;
+        ASSERT_EQ(outB[i].real(), expectedB[i].real()) << i;
+        ASSERT_EQ(outB[i].imag(), expectedB[i].imag()) << i;
+    }
+}
@@ -0,0 +1,144 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "DSP/FFT/FFTBackend.h"
+
+#include <complex>
+#include <string>
+#include <vector>
+
+using namespace lime;
+
+namespace {
+
+/// @brief Counts the created plans.
+class CountingBackend : public IFFTBackend
+{
+  public:
+    explicit CountingBackend(std::shared_ptr<IFFTBackend> backend)
+        : mBackend(backend)
+    {
+    }
+
+    std::string GetName() const override { return mBackend->GetName(); }
+
+    std::shared_ptr<const IFFTPlan> CreatePlan(std::size_t size) override
+    {
+        ++created;
+        return mBackend->CreatePlan(size);
+    }
+
+    int created{ 0 };
+
+  private:
+    std::shared_ptr<IFFTBackend> mBackend;
+};
+
+std::vector<complex32f_t> DirectDFT(const std::vector<complex32f_t>& input)
+{
+    const std::size_t size = input.size();
+    std::vector<complex32f_t> output(size);
+    for (std::size_t k = 0; k < size; ++k)
+    {
+        std::complex<double> sum = 0;
+        for (std::size_t n = 0; n < size; ++n)
+        {
+            const double phase = -2 * M_PI * k * n / size;
+            sum += std::complex<double>(input[n].real(), input[n].imag()) * std::polar(1.0, phase);
+        }
+        output[k] = complex32f_t(sum.real(), sum.imag());
+    }
+    return output;
+}
+
+} // namespace
+
+TEST(FFTBackend, AllBackendsMatchDirectTransform)
+{
+    const std::vector<std::string> names = GetFFTBackendNames();
+    ASSERT_FALSE(names.empty());
+
+    for (std::size_t size : { 64, 100, 256 })
+    {
+        std::vector<complex32f_t> input(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            // a tone between the bins, with a DC offset and a ramp, so every bin gets something
+            const double phase = 2 * M_PI * 5.3 * i / size;
+            input[i] = complex32f_t(0.5 * std::cos(phase) + 0.1, 0.5 * std::sin(phase) + 0.001 * i);
+        }
+        const std::vector<complex32f_t> expected = DirectDFT(input);
+
+        for (const std::string& name : names)
+        {
+            SCOPED_TRACE(name + " " + std::to_string(size));
+            const std::shared_ptr<IFFTBackend> backend = CreateFFTBackend(name);
+            ASSERT_NE(backend, nullptr);
+            EXPECT_EQ(backend->GetName(), name);
+
+            const std::shared_ptr<const IFFTPlan> plan = backend->CreatePlan(size);
+            ASSERT_NE(plan, nullptr);
+            EXPECT_EQ(plan->GetSize(), size);
+
+            std::vector<complex32f_t> output(size);
+            plan->Execute(input.data(), output.data());
+            for (std::size_t k = 0; k < size; ++k)
+            {
+                EXPECT_NEAR(output[k].real(), expected[k].real(), 1e-3);
+                EXPECT_NEAR(output[k].imag(), expected[k].imag(), 1e-3);
+            }
+        }
+    }
+}
+
+TEST(FFTBackend, UnknownBackendIsNotCreated)
+{
+    EXPECT_EQ(CreateFFTBackend("unknown"), nullptr);
+    // the default is the first, fastest one
+    const std::shared_ptr<IFFTBackend> backend = CreateFFTBackend();
+    ASSERT_NE(backend, nullptr);
+    EXPECT_EQ(backend->GetName(), GetFFTBackendNames().front());
+}
+
+TEST(FFTPlanCache, PlansEachSizeOnce)
+{
+    auto backend = std::make_shared<CountingBackend>(CreateFFTBackend());
+    FFTPlanCache cache(backend);
+
+    const auto first = cache.GetPlan(1024);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(cache.GetPlan(1024), first);
+    EXPECT_EQ(backend->created, 1);
+
+    EXPECT_NE(cache.GetPlan(512), first);
+    EXPECT_EQ(backend->created, 2);
+    EXPECT_EQ(cache.GetPlanCount(), 2);
+}
+
+TEST(FFTPlanCache, ReleasesLeastRecentlyUsedPlans)
+{
+    constexpr std::size_t capacity = 4;
+    auto backend = std::make_shared<CountingBackend>(CreateFFTBackend());
+    FFTPlanCache cache(backend, capacity);
+
+    const auto kept = cache.GetPlan(16);
+    for (std::size_t size = 17; size < 17 + capacity * 4; ++size)
+    {
+        ASSERT_NE(cache.GetPlan(size), nullptr);
+        // the frequently used plan stays cached
+        EXPECT_EQ(cache.GetPlan(16), kept);
+        EXPECT_LE(cache.GetPlanCount(), capacity);
+    }
+    EXPECT_EQ(backend->created, 1 + capacity * 4);
+
+    // released plans are created again
+    ASSERT_NE(cache.GetPlan(17), nullptr);
+    EXPECT_EQ(backend->created, 2 + capacity * 4);
+    // and plans taken before are still usable
+    std::vector<complex32f_t> samples(16, complex32f_t(1, 0));
+    std::vector<complex32f_t> output(16);
+    kept->Execute(samples.data(), output.data());
+    EXPECT_NEAR(output[0].real(), 16, 1e-4);
+}
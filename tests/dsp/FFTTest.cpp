@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include "DSP/FFT/FFT.h"
+#include "limesuiteng/complex.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace lime;
+
+namespace {
+
+constexpr uint32_t fftSize = 256;
+
+/// @brief Waits until the workers have taken every complete frame out of the channel buffers.
+FFT::Stats WaitForWorkers(const FFT& fft, uint8_t channelCount = 1)
+{
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    FFT::Stats stats = fft.GetStats();
+    while (stats.pushed - stats.dropped - stats.processed - stats.skipped >= channelCount * fftSize &&
+           std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        stats = fft.GetStats();
+    }
+    return stats;
+}
+
+} // namespace
+
+TEST(FFT, StatsAccountForAllPushedSamples)
+{
+    FFT fft(1, fftSize);
+    const std::vector<complex32f_t> samples(fftSize * 2, complex32f_t(0.5, -0.5));
+    const complex32f_t* channels[1] = { samples.data() };
+
+    for (int i = 0; i < 4; ++i)
+    {
+        ASSERT_EQ(fft.PushSamples(channels, samples.size(), 0), samples.size());
+        WaitForWorkers(fft);
+    }
+
+    const FFT::Stats stats = WaitForWorkers(fft);
+    EXPECT_EQ(stats.pushed, 4 * samples.size());
+    // the buffer is drained between the pushes, so nothing is lost
+    EXPECT_EQ(stats.dropped, 0u);
+    EXPECT_EQ(stats.processed + stats.skipped, stats.pushed);
+    EXPECT_GT(stats.DutyCycle(), 0);
+}
+
+TEST(FFT, FullBufferDropsInsteadOfBlocking)
+{
+    constexpr uint8_t channelCount = 2;
+    FFT fft(channelCount, fftSize);
+    // much more than a channel's buffer holds, in a single push, so the workers can't make room in time
+    const std::vector<complex32f_t> samples(fftSize * 64, complex32f_t(0.5, -0.5));
+    const complex32f_t* channels[channelCount] = { samples.data(), samples.data() };
+
+    ASSERT_EQ(fft.PushSamples(channels, samples.size(), 0), samples.size());
+    FFT::Stats stats = fft.GetStats();
+    EXPECT_EQ(stats.pushed, channelCount * samples.size());
+    EXPECT_GT(stats.dropped, 0u);
+
+    // the skipped offset still consumes the whole requested count
+    ASSERT_EQ(fft.PushSamples(channels, fftSize, samples.size() - fftSize), fftSize);
+
+    stats = WaitForWorkers(fft, channelCount);
+    EXPECT_EQ(stats.pushed, channelCount * (samples.size() + fftSize));
+    EXPECT_LE(stats.dropped + stats.processed + stats.skipped, stats.pushed);
+    EXPECT_LT(stats.pushed - stats.dropped - stats.processed - stats.skipped, channelCount * fftSize);
+    EXPECT_LT(stats.DutyCycle(), 1);
+}
@@ -0,0 +1,71 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "DSP/GainControl/GainController.h"
+#include "DSP/GainControl/PowerMeter.h"
+#include "limesuiteng/complex.h"
+
+#include <vector>
+
+using namespace lime;
+
+TEST(GainControl, PowerIsRelativeToFullScale)
+{
+    constexpr uint32_t count = 1000;
+    std::vector<complex16_t> tone(count);
+    for (uint32_t n = 0; n < count; ++n)
+    {
+        const double phase = 2 * M_PI * 0.01 * n;
+        tone[n] = complex16_t(std::lround(3277 * std::cos(phase)), std::lround(3277 * std::sin(phase)));
+    }
+    tone[500] = complex16_t(32767, 0);
+
+    const PowerMeasurement power = MeasurePower(static_cast<const void*>(tone.data()), count, DataFormat::I16);
+    EXPECT_EQ(power.count, count);
+    // a tenth of the full scale, and a single full scale sample
+    EXPECT_NEAR(PowerToDecibels(power.Mean()), 10 * std::log10((0.01 * (count - 1) + 1) / count), 0.01);
+    EXPECT_NEAR(PowerToDecibels(power.peak), 0, 0.01);
+
+    const std::vector<complex32f_t> silence(count);
+    EXPECT_EQ(PowerToDecibels(MeasurePower(silence.data(), count).Mean()), -200);
+}
+
+TEST(GainControl, ReachesTargetWithoutClipping)
+{
+    const GainController controller({ -20, -1, 3, Range<double>(-12, 61) });
+
+    // a received signal at -5 dBFS with 0 dB gain, with 10 dB crest factor
+    const auto measure = [](double gain, float& mean, float& peak) {
+        mean = -5 + gain;
+        peak = std::min(mean + 10, 0.0f);
+    };
+
+    // overload is removed in a single step
+    double gain = 0;
+    float mean, peak;
+    measure(gain, mean, peak);
+    gain = controller.Update(mean, peak, gain);
+    measure(gain, mean, peak);
+    EXPECT_LE(peak, -1);
+    EXPECT_NEAR(mean, -20, 3);
+    EXPECT_EQ(controller.Update(mean, peak, gain), gain);
+
+    // a weak signal is brought up gradually, without overshooting the peak limit
+    gain = -12;
+    for (int i = 0; i < 20; ++i)
+    {
+        measure(gain, mean, peak);
+        const double next = controller.Update(mean, peak, gain);
+        EXPECT_GE(next, gain);
+        gain = next;
+    }
+    measure(gain, mean, peak);
+    EXPECT_LE(peak, -1);
+    EXPECT_NEAR(mean, -20, 3);
+
+    // the gain stays in the range
+    EXPECT_EQ(controller.Update(-100, -90, 60), 61);
+    EXPECT_EQ(controller.Update(0, 0, -11), -12);
+}
@@ -0,0 +1,115 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "DSP/IQCorrection/IQImpairmentTracker.h"
+#include "limesuiteng/complex.h"
+
+#include <complex>
+#include <random>
+#include <vector>
+
+using namespace lime;
+
+namespace {
+
+struct Impairment {
+    double dcI;
+    double dcQ;
+    double gain;
+    double phase;
+};
+
+// Applies the receiver impairments model: Q leaks from I and has a different gain, both get a DC offset.
+complex32f_t Impair(double i, double q, const Impairment& impairment)
+{
+    const double impairedQ = impairment.gain * (std::sin(impairment.phase) * i + std::cos(impairment.phase) * q);
+    return complex32f_t(i + impairment.dcI, impairedQ + impairment.dcQ);
+}
+
+} // namespace
+
+TEST(IQImpairmentTracker, FollowsChangingImpairments)
+{
+    constexpr uint32_t blockSize = 4096;
+    constexpr int blocksPerStep = 400;
+    constexpr double timeConstant = 65536;
+
+    std::mt19937 rng(11);
+    std::normal_distribution<double> noise(0, 0.2);
+    IQImpairmentTracker tracker(timeConstant);
+    std::vector<complex32f_t> block(blockSize);
+
+    // the impairments drift, e.g. after a gain change
+    for (const Impairment& impairment : { Impairment{ 0.05, -0.03, 1.1, 0.08 }, Impairment{ -0.02, 0.01, 0.93, -0.05 } })
+    {
+        for (int b = 0; b < blocksPerStep; ++b)
+        {
+            for (auto& sample : block)
+                sample = Impair(noise(rng), noise(rng), impairment);
+            tracker.Process(block.data(), blockSize);
+        }
+
+        const IQImpairments estimate = tracker.GetImpairments();
+        EXPECT_NEAR(estimate.dcI, impairment.dcI, 2e-3);
+        EXPECT_NEAR(estimate.dcQ, impairment.dcQ, 2e-3);
+        EXPECT_NEAR(estimate.gain, impairment.gain, 5e-3);
+        EXPECT_NEAR(estimate.phase, impairment.phase, 5e-3);
+
+        // the corrected signal is centered, uncorrelated and of equal power in I and Q
+        double meanI = 0, meanQ = 0, powerI = 0, powerQ = 0, cross = 0;
+        for (const auto& sample : block)
+        {
+            meanI += sample.real();
+            meanQ += sample.imag();
+            powerI += sample.real() * sample.real();
+            powerQ += sample.imag() * sample.imag();
+            cross += sample.real() * sample.imag();
+        }
+        EXPECT_NEAR(meanI / blockSize, 0, 0.01);
+        EXPECT_NEAR(meanQ / blockSize, 0, 0.01);
+        EXPECT_NEAR(powerQ / powerI, 1, 0.05);
+        EXPECT_NEAR(cross / std::sqrt(powerI * powerQ), 0, 0.05);
+    }
+}
+
+TEST(IQImpairmentTracker, RejectsToneImage)
+{
+    constexpr uint32_t blockSize = 1020;
+    constexpr int blockCount = 500;
+    constexpr double frequency = 0.0123;
+    constexpr double amplitude = 0.5;
+    const Impairment impairment{ 0.01, 0.02, 1.05, 3 * M_PI / 180 };
+
+    IQImpairmentTracker tracker(1 << 16);
+    std::vector<complex16_t> block(blockSize);
+    std::complex<double> tone = 0;
+    std::complex<double> image = 0;
+    std::complex<double> dc = 0;
+    for (int b = 0; b < blockCount; ++b)
+    {
+        for (uint32_t n = 0; n < blockSize; ++n)
+        {
+            const double phase = 2 * M_PI * frequency * (b * blockSize + n);
+            const complex32f_t impaired = Impair(amplitude * std::cos(phase), amplitude * std::sin(phase), impairment);
+            block[n] = complex16_t(std::lround(impaired.real() * 32767), std::lround(impaired.imag() * 32767));
+        }
+        tracker.Process(static_cast<void*>(block.data()), blockSize, DataFormat::I16);
+
+        if (b < blockCount - 50)
+            continue;
+        // measure the settled output
+        for (uint32_t n = 0; n < blockSize; ++n)
+        {
+            const std::complex<double> sample(block[n].real() / 32767.0, block[n].imag() / 32767.0);
+            const double phase = 2 * M_PI * frequency * (b * blockSize + n);
+            tone += sample * std::polar(1.0, -phase);
+            image += sample * std::polar(1.0, phase);
+            dc += sample;
+        }
+    }
+    // uncorrected, the image would be at about -32 dBc and the DC at -31 dBc
+    EXPECT_LT(20 * std::log10(std::abs(image) / std::abs(tone)), -60);
+    EXPECT_LT(20 * std::log10(std::abs(dc) / std::abs(tone)), -60);
+}
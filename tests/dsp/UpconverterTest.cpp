@@ -0,0 +1,171 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "DSP/Resampling/Upconverter.h"
+#include "limesuiteng/complex.h"
+#include "protocols/DataPacket.h"
+#include "protocols/SamplesPacket.h"
+#include "protocols/TxBufferManager.h"
+
+#include <complex>
+#include <vector>
+
+using namespace lime;
+
+namespace {
+
+// Amplitude of the upconverted tone after the filter has settled, relative to the input tone amplitude.
+double UpconvertedToneGain(uint16_t interpolation, double shift, double toneFrequency, double expectedFrequency)
+{
+    constexpr std::size_t inputCount = 2048;
+    constexpr float amplitude = 0.5;
+    std::vector<complex32f_t> input(inputCount);
+    for (std::size_t i = 0; i < inputCount; ++i)
+    {
+        const double phase = 2 * M_PI * toneFrequency * i;
+        input[i] = complex32f_t(amplitude * std::cos(phase), amplitude * std::sin(phase));
+    }
+
+    Upconverter duc(interpolation, shift);
+    std::vector<complex16_t> output(inputCount * interpolation);
+    EXPECT_EQ(duc.Process(input.data(), inputCount, 0, true, output.data(), 1), output.size());
+
+    // correlate with the expected output tone, so the images and the other spurs don't count
+    const std::size_t settled = duc.GetTaps().size();
+    std::complex<double> sum = 0;
+    for (std::size_t i = settled; i < output.size(); ++i)
+    {
+        const std::complex<double> sample(output[i].real() / 32767.0, output[i].imag() / 32767.0);
+        sum += sample * std::polar(1.0, -2 * M_PI * expectedFrequency * i);
+    }
+    return std::abs(sum) / (output.size() - settled) / amplitude;
+}
+
+} // namespace
+
+TEST(Upconverter, PassbandIsFlat)
+{
+    constexpr uint16_t interpolation = 4;
+    constexpr double shift = 0.15;
+    // up to 0.2 of the input rate on both sides of DC
+    for (double toneFrequency = -0.2; toneFrequency <= 0.2; toneFrequency += 0.025)
+    {
+        const double gain = UpconvertedToneGain(interpolation, shift, toneFrequency, shift + toneFrequency / interpolation);
+        EXPECT_NEAR(20 * std::log10(gain), 0, 0.01) << "tone at " << toneFrequency;
+    }
+}
+
+TEST(Upconverter, ImagesAreRejected)
+{
+    constexpr uint16_t interpolation = 4;
+    constexpr double shift = -0.1;
+    constexpr double toneFrequency = 0.1;
+    for (int image = 1; image < interpolation; ++image)
+    {
+        const double imageFrequency = shift + (toneFrequency + image) / interpolation;
+        EXPECT_LT(UpconvertedToneGain(interpolation, shift, toneFrequency, imageFrequency), 1e-4) << "image " << image;
+    }
+}
+
+TEST(Upconverter, OutputIsContinuousAcrossCalls)
+{
+    constexpr uint16_t interpolation = 3;
+    constexpr double shift = 0.0123;
+    constexpr uint64_t timestamp = 777;
+    constexpr std::size_t inputCount = 1000;
+
+    std::vector<complex16_t> input(inputCount);
+    for (std::size_t i = 0; i < inputCount; ++i)
+        input[i] = complex16_t((i * 37) % 20000 - 10000, (i * 91) % 16000 - 8000);
+
+    Upconverter whole(interpolation, shift);
+    std::vector<complex16_t> expected(inputCount * interpolation);
+    whole.Process(input.data(), inputCount, timestamp, true, expected.data(), 1);
+
+    Upconverter chunked(interpolation, shift);
+    std::vector<complex16_t> output(inputCount * interpolation);
+    std::size_t offset = 0;
+    for (uint32_t chunk : { 1u, 100u, 333u, 66u, 500u })
+    {
+        chunked.Process(&input[offset], chunk, timestamp + offset, true, &output[offset * interpolation], 1);
+        offset += chunk;
+    }
+    for (std::size_t i = 0; i < output.size(); ++i)
+    {
+        ASSERT_NEAR(output[i].real(), expected[i].real(), 1) << i;
+        ASSERT_NEAR(output[i].imag(), expected[i].imag(), 1) << i;
+    }
+}
+
+TEST(Upconverter, UntimedSamplesAreContinuous)
+{
+    constexpr uint16_t interpolation = 2;
+    constexpr double shift = 0.031;
+    constexpr std::size_t inputCount = 600;
+
+    std::vector<complex16_t> input(inputCount);
+    for (std::size_t i = 0; i < inputCount; ++i)
+        input[i] = complex16_t((i * 53) % 20000 - 10000, (i * 17) % 16000 - 8000);
+
+    Upconverter whole(interpolation, shift);
+    std::vector<complex16_t> expected(inputCount * interpolation);
+    whole.Process(input.data(), inputCount, 0, false, expected.data(), 1);
+
+    // without timestamps the callers pass whatever they have, it must not restart the filter nor the NCO
+    Upconverter chunked(interpolation, shift);
+    std::vector<complex16_t> output(inputCount * interpolation);
+    for (std::size_t offset = 0; offset < inputCount; offset += 200)
+        chunked.Process(&input[offset], 200, 0, false, &output[offset * interpolation], 1);
+    for (std::size_t i = 0; i < output.size(); ++i)
+    {
+        ASSERT_NEAR(output[i].real(), expected[i].real(), 1) << i;
+        ASSERT_NEAR(output[i].imag(), expected[i].imag(), 1) << i;
+    }
+}
+
+TEST(Upconverter, TxPacketTimestampsAreInterpolated)
+{
+    using PacketType = SamplesPacket<2>;
+    constexpr uint16_t interpolation = 4;
+    constexpr uint32_t samplesInPkt = 256;
+    constexpr uint32_t inputCount = 200;
+    constexpr uint64_t timestamp = 1000;
+
+    std::vector<uint8_t> packetMemory(PacketType::headerSize + 2 * inputCount * sizeof(complex32f_t));
+    PacketType* pkt = PacketType::ConstructSamplesPacket(packetMemory.data(), inputCount, sizeof(complex32f_t));
+    pkt->Reset();
+    pkt->timestamp = timestamp;
+    pkt->useTimestamp = true;
+    pkt->flush = true;
+    std::vector<complex32f_t> samples(inputCount, complex32f_t(0.5, 0));
+    const complex32f_t* src[2] = { samples.data(), nullptr };
+    ASSERT_EQ(pkt->push(src, inputCount), static_cast<int>(inputCount));
+
+    Upconverter duc(interpolation, 0);
+    TxBufferManager<PacketType> output(false, false, samplesInPkt, 16, DataFormat::F32);
+    output.SetUpconverters({ &duc });
+    std::vector<uint8_t> buffer(65536);
+    output.Reset(buffer.data(), buffer.size());
+    EXPECT_TRUE(output.consume(pkt));
+    EXPECT_TRUE(pkt->empty());
+
+    // every packet takes whole input samples, its timestamp is counted at the output rate
+    uint64_t expectedCounter = timestamp * interpolation;
+    uint32_t totalSamples = 0;
+    uint32_t offset = 0;
+    for (int i = 0; i < output.packetCount(); ++i)
+    {
+        const StreamHeader* header = reinterpret_cast<const StreamHeader*>(buffer.data() + offset);
+        const uint32_t packetSamples = header->GetPayloadSize() / sizeof(complex16_t);
+        EXPECT_EQ(header->counter, expectedCounter);
+        EXPECT_LE(packetSamples, samplesInPkt);
+        expectedCounter += packetSamples;
+        totalSamples += packetSamples;
+        offset += sizeof(StreamHeader) + header->GetPayloadSize();
+    }
+    // the last packet can be padded to the bus width
+    EXPECT_GE(totalSamples, inputCount * interpolation);
+    EXPECT_LT(totalSamples, inputCount * interpolation + 4);
+}
@@ -0,0 +1,110 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "DSP/FFT/WelchEstimator.h"
+#include "limesuiteng/complex.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace lime;
+
+TEST(WelchEstimator, ToneIsScaledAndCentred)
+{
+    constexpr std::size_t fftSize = 1024;
+    constexpr int toneBin = 100;
+    constexpr float amplitude = 0.5;
+
+    WelchConfig config;
+    config.size = fftSize;
+    config.overlap = 0.5;
+    config.window = FFT::WindowFunctionType::HANNING;
+    config.averageCount = 8;
+    WelchEstimator estimator(config);
+
+    // exactly (averageCount - 1) hops after the first segment produce the first result
+    const std::size_t samplesCount = fftSize + (config.averageCount - 1) * fftSize / 2;
+    for (int sign : { 1, -1 })
+    {
+        std::vector<complex32f_t> samples(samplesCount);
+        for (std::size_t i = 0; i < samplesCount; ++i)
+        {
+            const double phase = 2 * M_PI * sign * toneBin * i / fftSize;
+            samples[i] = complex32f_t(amplitude * std::cos(phase), amplitude * std::sin(phase));
+        }
+        ASSERT_EQ(estimator.Process(samples.data(), samples.size()), 1u);
+
+        const std::vector<float>& bins = estimator.GetResult();
+        ASSERT_EQ(bins.size(), fftSize);
+        const std::size_t peak = std::max_element(bins.begin(), bins.end()) - bins.begin();
+        EXPECT_EQ(peak, fftSize / 2 - 1 + sign * toneBin);
+        EXPECT_NEAR(bins[peak], amplitude * amplitude, 1e-4);
+        // Hann sidelobes are far down
+        EXPECT_LT(bins[peak + 10], bins[peak] * 1e-4);
+        estimator.Restart();
+    }
+}
+
+TEST(WelchEstimator, NoiseFloorMatchesVariance)
+{
+    constexpr std::size_t fftSize = 256;
+    constexpr double sampleRate = 1e6;
+    constexpr double sigma = 0.1;
+
+    WelchConfig config;
+    config.size = fftSize;
+    config.overlap = 0.75;
+    config.window = FFT::WindowFunctionType::BLACKMAN_HARRIS;
+    config.averageCount = 400;
+    config.scaling = WelchConfig::Scaling::Density;
+    config.sampleRate = sampleRate;
+    WelchEstimator estimator(config);
+
+    std::mt19937 generator(1234);
+    std::normal_distribution<float> noise(0, sigma / std::sqrt(2.0));
+    std::vector<complex32f_t> samples(fftSize / 4);
+    while (estimator.GetResultsCount() == 0)
+    {
+        for (auto& sample : samples)
+            sample = complex32f_t(noise(generator), noise(generator));
+        estimator.Process(samples.data(), samples.size());
+    }
+
+    const std::vector<float>& bins = estimator.GetResult();
+    double mean = 0;
+    for (float bin : bins)
+        mean += bin;
+    mean /= bins.size();
+    const double expectedDensity = sigma * sigma / sampleRate;
+    EXPECT_NEAR(mean, expectedDensity, expectedDensity * 0.02);
+    // averaging 400 segments flattens the floor to within a few dB
+    for (float bin : bins)
+        EXPECT_NEAR(10 * std::log10(bin / expectedDensity), 0, 1.5);
+}
+
+TEST(WelchEstimator, ExponentialAveragingConverges)
+{
+    constexpr std::size_t fftSize = 64;
+
+    WelchConfig config;
+    config.size = fftSize;
+    config.overlap = 0;
+    config.window = FFT::WindowFunctionType::NONE;
+    config.averaging = WelchConfig::Averaging::Exponential;
+    config.averageCount = 1;
+    config.alpha = 0.5;
+    WelchEstimator estimator(config);
+
+    // constant input only has DC, at full power after the first segment already
+    std::vector<complex32f_t> samples(fftSize * 4, complex32f_t(1, 0));
+    EXPECT_EQ(estimator.Process(samples.data(), samples.size()), 4u);
+    EXPECT_NEAR(estimator.GetResult()[fftSize / 2 - 1], 1.0, 1e-5);
+
+    // switching off the input halves the power with every segment
+    std::fill(samples.begin(), samples.end(), complex32f_t(0, 0));
+    EXPECT_EQ(estimator.Process(samples.data(), fftSize * 2), 2u);
+    EXPECT_NEAR(estimator.GetResult()[fftSize / 2 - 1], 0.25, 1e-5);
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include "logger/AsyncLogger.h"
+#include "limesuiteng/Logger.h"
+
+#include <cstdarg>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace lime;
+
+namespace {
+
+/// @brief Collects the delivered messages.
+struct MessageCollector {
+    void Add(const std::string& message)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        messages.push_back(message);
+    }
+
+    std::vector<std::string> Get()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return messages;
+    }
+
+    std::mutex mutex;
+    std::vector<std::string> messages;
+};
+
+std::shared_ptr<const LogHandler> MakeSink(MessageCollector& collector)
+{
+    return std::make_shared<const LogHandler>(
+        [&collector](const LogLevel level, const std::string& message) { collector.Add(message); });
+}
+
+bool PostFormatted(AsyncLogger& logger, const std::shared_ptr<const LogHandler>& sink, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    const bool posted = logger.Post(LogLevel::Info, sink, format, args);
+    va_end(args);
+    return posted;
+}
+
+} // namespace
+
+TEST(AsyncLogger, FlushDeliversQueuedMessagesInOrder)
+{
+    AsyncLogger& logger = AsyncLogger::Instance();
+    logger.Enable(true);
+
+    MessageCollector collector;
+    const auto sink = MakeSink(collector);
+    for (int i = 0; i < 100; ++i)
+        ASSERT_TRUE(logger.Post(LogLevel::Info, sink, std::to_string(i).c_str()));
+    logger.Flush();
+    logger.Enable(false);
+
+    const auto messages = collector.Get();
+    ASSERT_EQ(messages.size(), 100u);
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(messages[i], std::to_string(i));
+}
+
+TEST(AsyncLogger, DisablingDeliversQueuedMessages)
+{
+    AsyncLogger& logger = AsyncLogger::Instance();
+    logger.Enable(true);
+
+    MessageCollector collector;
+    const auto sink = MakeSink(collector);
+    for (int i = 0; i < 10; ++i)
+        ASSERT_TRUE(logger.Post(LogLevel::Info, sink, "message"));
+    logger.Enable(false);
+
+    EXPECT_EQ(collector.Get().size(), 10u);
+}
+
+TEST(AsyncLogger, QueuedMessageKeepsSinkAlive)
+{
+    AsyncLogger& logger = AsyncLogger::Instance();
+    logger.Enable(true);
+
+    MessageCollector collector;
+    auto sink = MakeSink(collector);
+    const std::weak_ptr<const LogHandler> observer = sink;
+    ASSERT_TRUE(logger.Post(LogLevel::Info, sink, "after release"));
+    sink.reset(); // the owner of the callback goes away before the message is delivered
+    logger.Enable(false);
+
+    ASSERT_EQ(collector.Get().size(), 1u);
+    EXPECT_EQ(collector.Get()[0], "after release");
+    // the queue releases the sink once the message is delivered
+    EXPECT_TRUE(observer.expired());
+}
+
+TEST(AsyncLogger, LongMessagesAreTruncatedAtSameLengthAsSynchronous)
+{
+    AsyncLogger& logger = AsyncLogger::Instance();
+    logger.Enable(true);
+
+    MessageCollector collector;
+    const auto sink = MakeSink(collector);
+    const std::string fitting(AsyncLogger::MAX_MSG_LEN - 1, 'a');
+    const std::string tooLong(AsyncLogger::MAX_MSG_LEN + 100, 'b');
+    ASSERT_TRUE(logger.Post(LogLevel::Info, sink, fitting.c_str()));
+    ASSERT_TRUE(logger.Post(LogLevel::Info, sink, tooLong.c_str()));
+    ASSERT_TRUE(PostFormatted(logger, sink, "%s", fitting.c_str()));
+    logger.Enable(false);
+
+    const auto messages = collector.Get();
+    ASSERT_EQ(messages.size(), 3u);
+    EXPECT_EQ(messages[0], fitting);
+    EXPECT_EQ(messages[1], tooLong.substr(0, AsyncLogger::MAX_MSG_LEN - 1));
+    EXPECT_EQ(messages[2], fitting);
+}
+
+TEST(AsyncLogger, GlobalHandlerReceivesMessagesFromLoggingThread)
+{
+    MessageCollector collector;
+    registerLogHandler([&collector](const LogLevel level, const std::string& message) { collector.Add(message); });
+    enableAsyncLogging(true);
+    lime::info("asynchronous");
+    flushLog();
+    enableAsyncLogging(false);
+    registerLogHandler(LogHandler(nullptr));
+
+    const auto messages = collector.Get();
+    ASSERT_EQ(messages.size(), 1u);
+    EXPECT_EQ(messages[0], "asynchronous");
+}
@@ -1,8 +1,10 @@
 #include <gtest/gtest.h>
 
 #include "protocols/BufferInterleaving.h"
+#include "limesuiteng/complex.h"
 
 #include <array>
+#include <vector>
 
 using namespace lime;
 
@@ -218,3 +220,110 @@ TEST(BufferDeinterleaving, MIMO_I16_to_I16)
     EXPECT_EQ(outputA, expectedOutputA);
     EXPECT_EQ(outputB, expectedOutputB);
 }
+
+TEST(BufferDeinterleaving, SISO_I16_to_I8)
+{
+    // rounded to the nearest value with halves rounded up, saturated at the top of the range
+    constexpr std::array<uint8_t, 8> src{ { 0xFF, 0x7F, 0x00, 0x80, 0x7F, 0x01, 0x7F, 0xFE } };
+    constexpr std::array<int8_t, 4> expectedOutput{ { 127, -128, 1, -2 } };
+    std::array<int8_t, 4> output;
+
+    DataConversion cfg{};
+    cfg.destFormat = DataFormat::I8;
+    cfg.srcFormat = DataFormat::I16;
+    cfg.channelCount = 1;
+
+    void* dest = output.data();
+    int samplesProduced = Deinterleave(reinterpret_cast<void**>(&dest), src.data(), src.size(), cfg);
+
+    EXPECT_EQ(samplesProduced, expectedOutput.size() / 2);
+    EXPECT_EQ(output, expectedOutput);
+}
+
+TEST(BufferDeinterleaving, SISO_I16_to_I8_DitherIsUnbiased)
+{
+    // a constant level between two int8 steps must average to its exact value
+    constexpr int sampleCount = 65536;
+    constexpr int16_t level = 0x0140; // 1.25 of int8 step
+    std::vector<complex16_t> src(sampleCount, complex16_t(level, -level));
+    std::vector<complex8_t> output(sampleCount);
+
+    DataConversion cfg{};
+    cfg.destFormat = DataFormat::I8;
+    cfg.srcFormat = DataFormat::I16;
+    cfg.channelCount = 1;
+    cfg.dither = true;
+
+    void* dest = output.data();
+    int samplesProduced =
+        Deinterleave(reinterpret_cast<void**>(&dest), reinterpret_cast<const uint8_t*>(src.data()), sampleCount * 4, cfg);
+    ASSERT_EQ(samplesProduced, sampleCount);
+
+    double sumI = 0;
+    double sumQ = 0;
+    for (const complex8_t& sample : output)
+    {
+        EXPECT_LE(std::abs(sample.real() - 1.25), 2);
+        sumI += sample.real();
+        sumQ += sample.imag();
+    }
+    EXPECT_NEAR(sumI / sampleCount, 1.25, 0.02);
+    EXPECT_NEAR(sumQ / sampleCount, -1.25, 0.02);
+}
+
+TEST(BufferDeinterleaving, SISO_I16_to_F16)
+{
+    constexpr std::array<uint8_t, 8> src{ { 0xFF, 0x7F, 0x00, 0x80, 0x00, 0x40, 0x00, 0xE0 } };
+    constexpr std::array<float, 4> expectedOutput{ { 1.0, -1.0, 0.5, -0.25 } };
+    std::array<float16_t, 4> output;
+
+    DataConversion cfg{};
+    cfg.destFormat = DataFormat::F16;
+    cfg.srcFormat = DataFormat::I16;
+    cfg.channelCount = 1;
+
+    void* dest = output.data();
+    int samplesProduced = Deinterleave(reinterpret_cast<void**>(&dest), src.data(), src.size(), cfg);
+
+    EXPECT_EQ(samplesProduced, expectedOutput.size() / 2);
+    for (std::size_t i = 0; i < expectedOutput.size(); ++i)
+        EXPECT_EQ(static_cast<float>(output[i]), expectedOutput[i]) << i;
+}
+
+TEST(BufferInterleaving, SISO_I8_to_I16)
+{
+    std::array<int8_t, 4> inputSamples = { { 127, -128, 1, -1 } };
+    const int complexSamplesCount = inputSamples.size() / 2;
+    std::array<uint8_t, 8> output{};
+
+    DataConversion cfg{};
+    cfg.destFormat = DataFormat::I16;
+    cfg.srcFormat = DataFormat::I8;
+    cfg.channelCount = 1;
+
+    void* src = inputSamples.data();
+    int bytesProduced = Interleave(output.data(), reinterpret_cast<void**>(&src), complexSamplesCount, cfg);
+
+    constexpr std::array<uint8_t, 8> expectedOutput{ { 0x00, 0x7F, 0x00, 0x80, 0x00, 0x01, 0x00, 0xFF } };
+    EXPECT_EQ(bytesProduced, expectedOutput.size());
+    EXPECT_EQ(output, expectedOutput);
+}
+
+TEST(BufferInterleaving, SISO_F16_to_I16)
+{
+    std::array<float16_t, 4> inputSamples = { { 1.0f, -1.0f, 0.5f, -0.25f } };
+    const int complexSamplesCount = inputSamples.size() / 2;
+    std::array<uint8_t, 8> output{};
+
+    DataConversion cfg{};
+    cfg.destFormat = DataFormat::I16;
+    cfg.srcFormat = DataFormat::F16;
+    cfg.channelCount = 1;
+
+    void* src = inputSamples.data();
+    int bytesProduced = Interleave(output.data(), reinterpret_cast<void**>(&src), complexSamplesCount, cfg);
+
+    constexpr std::array<uint8_t, 8> expectedOutput{ { 0xFF, 0x7F, 0x01, 0x80, 0xFF, 0x3F, 0x01, 0xE0 } };
+    EXPECT_EQ(bytesProduced, expectedOutput.size());
+    EXPECT_EQ(output, expectedOutput);
+}
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include "protocols/RxHistoryBuffer.h"
+
+#include <array>
+#include <numeric>
+#include <vector>
+
+using namespace lime;
+
+namespace {
+
+std::vector<int32_t> Sequence(int32_t first, std::size_t count)
+{
+    std::vector<int32_t> values(count);
+    std::iota(values.begin(), values.end(), first);
+    return values;
+}
+
+} // namespace
+
+TEST(RxHistoryBuffer, ReadsBackWindowByTimestamp)
+{
+    RxHistoryBuffer history(64, 1, sizeof(int32_t));
+
+    for (int ts = 1000; ts < 1000 + 40; ts += 8)
+    {
+        const std::vector<int32_t> samples = Sequence(ts, 8);
+        const void* src[2] = { samples.data(), nullptr };
+        history.Write(src, samples.size(), ts);
+    }
+
+    uint64_t oldest = 0, newest = 0;
+    ASSERT_TRUE(history.GetRange(&oldest, &newest));
+    EXPECT_EQ(oldest, 1000u);
+    EXPECT_EQ(newest, 1040u);
+
+    std::array<int32_t, 10> output{};
+    void* dest[2] = { output.data(), nullptr };
+    ASSERT_EQ(history.Read(dest, 1013, output.size()), OpStatus::Success);
+    for (std::size_t i = 0; i < output.size(); ++i)
+        EXPECT_EQ(output[i], 1013 + static_cast<int32_t>(i));
+
+    EXPECT_EQ(history.Read(dest, 1035, output.size()), OpStatus::OutOfRange);
+    EXPECT_EQ(history.Read(dest, 990, output.size()), OpStatus::OutOfRange);
+}
+
+TEST(RxHistoryBuffer, OverwritesOldestSamplesWhenWrapping)
+{
+    RxHistoryBuffer history(32, 2, sizeof(int32_t));
+
+    for (int ts = 0; ts < 100; ts += 10)
+    {
+        const std::vector<int32_t> a = Sequence(ts, 10);
+        const std::vector<int32_t> b = Sequence(-ts, 10);
+        const void* src[2] = { a.data(), b.data() };
+        history.Write(src, a.size(), ts);
+    }
+
+    uint64_t oldest = 0, newest = 0;
+    ASSERT_TRUE(history.GetRange(&oldest, &newest));
+    EXPECT_EQ(oldest, 100u - 32u);
+    EXPECT_EQ(newest, 100u);
+
+    std::array<int32_t, 32> outA{};
+    std::array<int32_t, 32> outB{};
+    void* dest[2] = { outA.data(), outB.data() };
+    ASSERT_EQ(history.Read(dest, oldest, outA.size()), OpStatus::Success);
+    for (std::size_t i = 0; i < outA.size(); ++i)
+    {
+        const int32_t ts = oldest + i;
+        EXPECT_EQ(outA[i], ts);
+        EXPECT_EQ(outB[i], -(ts / 10 * 10) + ts % 10);
+    }
+
+    EXPECT_EQ(history.Read(dest, oldest - 1, 4), OpStatus::OutOfRange);
+}
+
+TEST(RxHistoryBuffer, LostSamplesAreZeroed)
+{
+    RxHistoryBuffer history(64, 1, sizeof(int32_t));
+
+    const std::vector<int32_t> first = Sequence(1, 8);
+    const std::vector<int32_t> second = Sequence(17, 8);
+    const void* src[2] = { first.data(), nullptr };
+    history.Write(src, first.size(), 0);
+    src[0] = second.data();
+    history.Write(src, second.size(), 16);
+
+    std::array<int32_t, 24> output{};
+    void* dest[2] = { output.data(), nullptr };
+    ASSERT_EQ(history.Read(dest, 0, output.size()), OpStatus::Success);
+    for (int i = 0; i < 24; ++i)
+        EXPECT_EQ(output[i], (i >= 8 && i < 16) ? 0 : i + 1);
+}
+
+TEST(RxHistoryBuffer, RestartsWhenTimestampGoesBackwards)
+{
+    RxHistoryBuffer history(64, 1, sizeof(int32_t));
+
+    const std::vector<int32_t> samples = Sequence(0, 16);
+    const void* src[2] = { samples.data(), nullptr };
+    history.Write(src, samples.size(), 500);
+    history.Write(src, samples.size(), 10);
+
+    uint64_t oldest = 0, newest = 0;
+    ASSERT_TRUE(history.GetRange(&oldest, &newest));
+    EXPECT_EQ(oldest, 10u);
+    EXPECT_EQ(newest, 26u);
+
+    history.Reset();
+    EXPECT_FALSE(history.GetRange(&oldest, &newest));
+}
@@ -0,0 +1,427 @@
+#include <gtest/gtest.h>
+
+#include "boards/Simulated/SimulatedSDR.h"
+#include "comms/SimulatedDMA.h"
+#include "limesuiteng/StreamConfig.h"
+#include "limesuiteng/complex.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace lime;
+
+namespace {
+
+/// @brief Receives the given amount of blocks, each of which has to start right where the previous one ended.
+template<class T> void ReceiveContinuousBlocks(SimulatedSDR& device, T* const* samples, uint32_t samplesInCall, int callsCount)
+{
+    uint64_t expectedTimestamp = 0;
+    for (int i = 0; i < callsCount; ++i)
+    {
+        StreamMeta rxMeta{};
+        ASSERT_EQ(device.StreamRx(0, samples, samplesInCall, &rxMeta), samplesInCall);
+        if (i > 0)
+        {
+            ASSERT_EQ(rxMeta.timestamp, expectedTimestamp);
+        }
+        expectedTimestamp = rxMeta.timestamp + samplesInCall;
+    }
+}
+
+} // namespace
+
+TEST(SimulatedStream, RxTimestampsAreContinuousAndTxIsOnTime)
+{
+    constexpr double sampleRate = 10e6;
+    constexpr uint32_t samplesInCall = 2048;
+    constexpr int callsCount = 1000;
+
+    SimulatedSDR device;
+    StreamConfig stream;
+    stream.channels[TRXDir::Rx] = { 0, 1 };
+    stream.channels[TRXDir::Tx] = { 0, 1 };
+    stream.format = DataFormat::F32;
+    stream.linkFormat = DataFormat::I16;
+    stream.hintSampleRate = sampleRate;
+    ASSERT_EQ(device.StreamSetup(stream, 0), OpStatus::Success);
+
+    std::vector<complex32f_t> buffers[2] = { std::vector<complex32f_t>(samplesInCall), std::vector<complex32f_t>(samplesInCall) };
+    complex32f_t* rxSamples[2] = { buffers[0].data(), buffers[1].data() };
+    const complex32f_t* txSamples[2] = { buffers[0].data(), buffers[1].data() };
+
+    device.StreamStart(0);
+    uint64_t expectedTimestamp = 0;
+    int gaps = 0;
+    for (int i = 0; i < callsCount; ++i)
+    {
+        StreamMeta rxMeta{};
+        ASSERT_EQ(device.StreamRx(0, rxSamples, samplesInCall, &rxMeta), samplesInCall);
+        if (i > 0 && rxMeta.timestamp != expectedTimestamp)
+        {
+            ASSERT_GT(rxMeta.timestamp, expectedTimestamp);
+            ++gaps;
+        }
+        expectedTimestamp = rxMeta.timestamp + samplesInCall;
+
+        StreamMeta txMeta{};
+        txMeta.timestamp = rxMeta.timestamp + sampleRate / 100;
+        txMeta.waitForTimestamp = true;
+        txMeta.flushPartialPacket = false;
+        ASSERT_EQ(device.StreamTx(0, txSamples, samplesInCall, &txMeta), samplesInCall);
+    }
+    // test tone is produced at 0.7 of the full scale
+    EXPECT_NEAR(std::hypot(buffers[1][0].real(), buffers[1][0].imag()), 0.7, 0.01);
+
+    StreamStats rxStats;
+    StreamStats txStats;
+    device.StreamStatus(0, &rxStats, &txStats);
+    device.StreamStop(0);
+    device.StreamDestroy(0);
+
+    // the stream runs in real time, a loaded machine can occasionally fall behind, only a sustained loss is an error
+    EXPECT_LE(gaps, callsCount / 100);
+    ASSERT_GT(rxStats.packets, 0);
+    EXPECT_LE(rxStats.loss + rxStats.overrun, rxStats.packets / 100);
+    EXPECT_GT(rxStats.dmaToFifo.count, 0u);
+    EXPECT_LE(device.GetRxDMA()->GetOverflowCount(), rxStats.packets / 100);
+
+    const SimulatedDMA::TxStats txDMAStats = device.GetTxDMA()->GetTxStats();
+    EXPECT_GT(txDMAStats.samples, 0u);
+    EXPECT_LE(txDMAStats.late, txDMAStats.packets / 100);
+    EXPECT_EQ(txDMAStats.discontinuities, 0u);
+}
+
+TEST(SimulatedStream, RxHistoryLongerThanCapacityIsRejected)
+{
+    SimulatedSDR device;
+    StreamConfig stream;
+    stream.channels[TRXDir::Rx] = { 0 };
+    stream.format = DataFormat::I16;
+    stream.linkFormat = DataFormat::I16;
+    stream.hintSampleRate = 122.88e6;
+    // over 2^32 samples, would wrap around to a small buffer
+    stream.extraConfig.rxHistoryDuration = 40;
+    EXPECT_EQ(device.StreamSetup(stream, 0), OpStatus::OutOfRange);
+}
+
+TEST(SimulatedStream, TxWaveformUploadIsComplete)
+{
+    constexpr uint32_t samplesCount = 100000;
+
+    SimulatedSDR device;
+    StreamConfig stream;
+    stream.channels[TRXDir::Tx] = { 0 };
+    stream.format = DataFormat::I16;
+    stream.linkFormat = DataFormat::I16;
+
+    std::vector<complex16_t> waveform(samplesCount);
+    for (uint32_t i = 0; i < samplesCount; ++i)
+        waveform[i] = complex16_t(i & 0x7FFF, -static_cast<int16_t>(i & 0x7FFF));
+    const void* samples[2] = { waveform.data(), nullptr };
+
+    std::size_t lastProgress = 0;
+    int progressUpdates = 0;
+    auto callback = [&](std::size_t sent, std::size_t total, const std::string&) {
+        EXPECT_GE(sent, lastProgress);
+        EXPECT_EQ(total, samplesCount);
+        lastProgress = sent;
+        ++progressUpdates;
+        return false;
+    };
+    ASSERT_EQ(device.UploadTxWaveform(stream, 0, samples, samplesCount, callback), OpStatus::Success);
+    EXPECT_EQ(lastProgress, samplesCount);
+    EXPECT_GT(progressUpdates, 1);
+
+    const std::vector<uint8_t>& loaded = device.GetTxDMA()->GetWaveform();
+    ASSERT_EQ(loaded.size(), samplesCount * sizeof(complex16_t));
+    EXPECT_EQ(std::memcmp(loaded.data(), waveform.data(), loaded.size()), 0);
+}
+
+TEST(SimulatedStream, RxI8SamplesAreScaledAndContinuous)
+{
+    constexpr uint32_t samplesInCall = 1000;
+    constexpr int callsCount = 100;
+
+    SimulatedSDR device;
+    StreamConfig stream;
+    stream.channels[TRXDir::Rx] = { 0 };
+    stream.format = DataFormat::I8;
+    stream.linkFormat = DataFormat::I16;
+    stream.extraConfig.rxDither = true;
+    ASSERT_EQ(device.StreamSetup(stream, 0), OpStatus::Success);
+
+    std::vector<complex8_t> buffer(samplesInCall);
+    complex8_t* rxSamples[2] = { buffer.data(), nullptr };
+
+    device.StreamStart(0);
+    ASSERT_NO_FATAL_FAILURE(ReceiveContinuousBlocks(device, rxSamples, samplesInCall, callsCount));
+    device.StreamStop(0);
+    device.StreamDestroy(0);
+
+    // test tone at 0.7 of the full scale, dithering adds at most one step to each component
+    for (const complex8_t& sample : buffer)
+        ASSERT_NEAR(std::hypot(sample.real(), sample.imag()), 0.7 * 128, 2);
+}
+
+TEST(SimulatedStream, RxI8HistoryMatchesReceivedSamples)
+{
+    constexpr uint32_t samplesInCall = 1000;
+
+    SimulatedSDR device;
+    StreamConfig stream;
+    stream.channels[TRXDir::Rx] = { 0 };
+    stream.format = DataFormat::I8;
+    stream.linkFormat = DataFormat::I16;
+    stream.hintSampleRate = 10e6;
+    stream.extraConfig.rxHistoryDuration = 0.01;
+    ASSERT_EQ(device.StreamSetup(stream, 0), OpStatus::Success);
+
+    std::vector<complex8_t> received(samplesInCall);
+    std::vector<complex8_t> retained(samplesInCall);
+    complex8_t* rxSamples[2] = { received.data(), nullptr };
+    complex8_t* historySamples[2] = { retained.data(), nullptr };
+
+    device.StreamStart(0);
+    StreamMeta rxMeta{};
+    ASSERT_EQ(device.StreamRx(0, rxSamples, samplesInCall, &rxMeta), samplesInCall);
+    EXPECT_EQ(device.StreamRxHistory(0, historySamples, rxMeta.timestamp, samplesInCall), OpStatus::Success);
+    device.StreamStop(0);
+    device.StreamDestroy(0);
+
+    EXPECT_EQ(std::memcmp(received.data(), retained.data(), samplesInCall * sizeof(complex8_t)), 0);
+}
+
+TEST(SimulatedStream, RxDownconversionMovesToneToDC)
+{
+    constexpr double sampleRate = 10e6;
+    constexpr uint16_t decimation = 4;
+    constexpr uint32_t samplesInCall = 1024;
+    constexpr int callsCount = 50;
+
+    SimulatedSDR device;
+    StreamConfig stream;
+    stream.channels[TRXDir::Rx] = { 0, 1 };
+    stream.format = DataFormat::F32;
+    stream.linkFormat = DataFormat::I16;
+    stream.hintSampleRate = sampleRate;
+    stream.extraConfig.rxDownconversion.rateRatio = decimation;
+    // the simulated test tone is at a fifth of the sampling rate
+    stream.extraConfig.rxDownconversion.frequencyOffset[0] = sampleRate / 5;
+    stream.extraConfig.rxDownconversion.frequencyOffset[1] = sampleRate / 5;
+    ASSERT_EQ(device.StreamSetup(stream, 0), OpStatus::Success);
+
+    std::vector<complex32f_t> buffers[2] = { std::vector<complex32f_t>(samplesInCall), std::vector<complex32f_t>(samplesInCall) };
+    complex32f_t* rxSamples[2] = { buffers[0].data(), buffers[1].data() };
+
+    device.StreamStart(0);
+    ASSERT_NO_FATAL_FAILURE(ReceiveContinuousBlocks(device, rxSamples, samplesInCall, callsCount));
+    device.StreamStop(0);
+    device.StreamDestroy(0);
+
+    // the filter has long settled, the tone is a constant at 0.7 of the full scale
+    for (const auto& channel : buffers)
+    {
+        EXPECT_NEAR(std::hypot(channel.front().real(), channel.front().imag()), 0.7, 0.01);
+        for (const complex32f_t& sample : channel)
+        {
+            ASSERT_NEAR(sample.real(), channel.front().real(), 0.01);
+            ASSERT_NEAR(sample.imag(), channel.front().imag(), 0.01);
+        }
+    }
+}
+
+TEST(SimulatedStream, RxChannelizationSeparatesSubChannels)
+{
+    constexpr uint16_t channelCount = 20;
+    constexpr uint16_t decimation = 10;
+    constexpr uint32_t samplesInCall = 500;
+    constexpr int callsCount = 40;
+
+    SimulatedSDR device;
+    StreamConfig stream;
+    stream.channels[TRXDir::Rx] = { 0 };
+    stream.format = DataFormat::F32;
+    stream.linkFormat = DataFormat::I16;
+    stream.extraConfig.rxChannelization.channelCount = channelCount;
+    stream.extraConfig.rxChannelization.decimation = decimation;
+    // the simulated test tone is at a fifth of the sampling rate, the center of the sub-channel 4
+    stream.extraConfig.rxChannelization.outputs = { 4, 0, 16 };
+    ASSERT_EQ(device.StreamSetup(stream, 0), OpStatus::Success);
+
+    std::vector<complex32f_t> buffers[3];
+    complex32f_t* rxSamples[3];
+    for (int i = 0; i < 3; ++i)
+    {
+        buffers[i].resize(samplesInCall);
+        rxSamples[i] = buffers[i].data();
+    }
+
+    device.StreamStart(0);
+    ASSERT_NO_FATAL_FAILURE(ReceiveContinuousBlocks(device, rxSamples, samplesInCall, callsCount));
+    device.StreamStop(0);
+    device.StreamDestroy(0);
+
+    // the filter has long settled, the tone is a constant at 0.7 of the full scale in its sub-channel only
+    const complex32f_t first = buffers[0].front();
+    EXPECT_NEAR(std::hypot(first.real(), first.imag()), 0.7, 0.01);
+    for (const complex32f_t& sample : buffers[0])
+    {
+        ASSERT_NEAR(sample.real(), first.real(), 0.01);
+        ASSERT_NEAR(sample.imag(), first.imag(), 0.01);
+    }
+    for (int i = 1; i < 3; ++i)
+    {
+        for (const complex32f_t& sample : buffers[i])
+            ASSERT_LT(std::hypot(sample.real(), sample.imag()), 1e-3);
+    }
+}
+
+TEST(SimulatedStream, RxImpairmentCorrectionKeepsCleanTone)
+{
+    constexpr uint32_t samplesInCall = 1020;
+    constexpr int callsCount = 50;
+
+    SimulatedSDR device;
+    StreamConfig stream;
+    stream.channels[TRXDir::Rx] = { 0, 1 };
+    stream.format = DataFormat::F32;
+    stream.linkFormat = DataFormat::I16;
+    stream.hintSampleRate = 10e6;
+    stream.extraConfig.rxImpairmentCorrection.dc = true;
+    stream.extraConfig.rxImpairmentCorrection.iq = true;
+    stream.extraConfig.rxImpairmentCorrection.timeConstant = 4096;
+    stream.extraConfig.rxDownconversion.rateRatio = 2;
+    // the impairments would be estimated after the frequency shift
+    EXPECT_NE(device.StreamSetup(stream, 0), OpStatus::Success);
+
+    stream.extraConfig.rxDownconversion.rateRatio = 1;
+    ASSERT_EQ(device.StreamSetup(stream, 0), OpStatus::Success);
+
+    std::vector<complex32f_t> buffers[2] = { std::vector<complex32f_t>(samplesInCall), std::vector<complex32f_t>(samplesInCall) };
+    complex32f_t* rxSamples[2] = { buffers[0].data(), buffers[1].data() };
+
+    device.StreamStart(0);
+    for (int i = 0; i < callsCount; ++i)
+    {
+        StreamMeta rxMeta{};
+        ASSERT_EQ(device.StreamRx(0, rxSamples, samplesInCall, &rxMeta), samplesInCall);
+    }
+    device.StreamStop(0);
+    device.StreamDestroy(0);
+
+    // the simulated tone has no impairments, the correction must not add any
+    for (const auto& channel : buffers)
+    {
+        for (const complex32f_t& sample : channel)
+            ASSERT_NEAR(std::hypot(sample.real(), sample.imag()), 0.7, 0.01);
+    }
+}
+
+TEST(SimulatedStream, RxPowerIsMeteredAndGainControlled)
+{
+    constexpr uint32_t samplesInCall = 10000;
+    // longer than the statistics period
+    constexpr int callsCount = 250;
+
+    SimulatedSDR device;
+    StreamConfig stream;
+    stream.channels[TRXDir::Rx] = { 0, 1 };
+    stream.format = DataFormat::I16;
+    stream.linkFormat = DataFormat::I16;
+    stream.hintSampleRate = 2e6;
+    stream.extraConfig.rxGainControl.enabled = true;
+    stream.extraConfig.rxGainControl.targetPower = -20;
+    for (uint8_t channel : stream.channels[TRXDir::Rx])
+        ASSERT_EQ(device.SetGain(0, TRXDir::Rx, channel, eGainTypes::GENERIC, 30), OpStatus::Success);
+    ASSERT_EQ(device.StreamSetup(stream, 0), OpStatus::Success);
+
+    std::vector<complex16_t> buffers[2] = { std::vector<complex16_t>(samplesInCall), std::vector<complex16_t>(samplesInCall) };
+    complex16_t* rxSamples[2] = { buffers[0].data(), buffers[1].data() };
+
+    device.StreamStart(0);
+    StreamMeta rxMeta{};
+    uint64_t lastGainTimestamp = 0;
+    for (int i = 0; i < callsCount; ++i)
+    {
+        ASSERT_EQ(device.StreamRx(0, rxSamples, samplesInCall, &rxMeta), samplesInCall);
+        ASSERT_GE(rxMeta.gainTimestamp, lastGainTimestamp);
+        ASSERT_LT(rxMeta.gainTimestamp, rxMeta.timestamp + samplesInCall);
+        lastGainTimestamp = rxMeta.gainTimestamp;
+    }
+    StreamStats stats;
+    device.StreamStatus(0, &stats, nullptr);
+    device.StreamStop(0);
+    device.StreamDestroy(0);
+
+    // the simulated tone is at 0.7 of the full scale
+    const float tonePower = 20 * std::log10(0.7);
+    for (int i = 0; i < 2; ++i)
+    {
+        EXPECT_NEAR(rxMeta.meanPower[i], tonePower, 0.05);
+        EXPECT_NEAR(rxMeta.peakPower[i], tonePower, 0.05);
+        EXPECT_NEAR(stats.meanPower[i], tonePower, 0.05);
+        // the simulated level doesn't follow the gain, so it's reduced to the minimum
+        EXPECT_EQ(rxMeta.gain[i], -12);
+    }
+    EXPECT_GT(lastGainTimestamp, 0u);
+}
+
+TEST(SimulatedStream, TxUpconversionTimestampsAreInterpolated)
+{
+    constexpr double sampleRate = 10e6;
+    constexpr uint16_t interpolation = 4;
+    constexpr uint32_t samplesInCall = 2048;
+    constexpr int callsCount = 200;
+
+    SimulatedSDR device;
+    StreamConfig stream;
+    stream.channels[TRXDir::Rx] = { 0 };
+    stream.channels[TRXDir::Tx] = { 0 };
+    stream.format = DataFormat::F32;
+    stream.linkFormat = DataFormat::I16;
+    stream.hintSampleRate = sampleRate;
+    stream.extraConfig.txUpconversion.rateRatio = interpolation;
+    stream.extraConfig.txUpconversion.frequencyOffset[0] = sampleRate / 8;
+    ASSERT_EQ(device.StreamSetup(stream, 0), OpStatus::Success);
+
+    std::vector<complex32f_t> rxBuffer(samplesInCall * interpolation);
+    std::vector<complex32f_t> txBuffer(samplesInCall, complex32f_t(0.5, 0));
+    complex32f_t* rxSamples[2] = { rxBuffer.data(), nullptr };
+    const complex32f_t* txSamples[2] = { txBuffer.data(), nullptr };
+
+    device.StreamStart(0);
+    StreamMeta rxMeta{};
+    ASSERT_EQ(device.StreamRx(0, rxSamples, rxBuffer.size(), &rxMeta), rxBuffer.size());
+    // Tx timestamps count the samples before interpolation, the lead leaves the upconversion time to catch up after
+    // scheduling hiccups, late packets would be dropped before reaching the DMA
+    uint64_t txTimestamp = (rxMeta.timestamp + sampleRate / 10) / interpolation;
+    for (int i = 0; i < callsCount; ++i)
+    {
+        StreamMeta txMeta{};
+        txMeta.timestamp = txTimestamp;
+        txMeta.waitForTimestamp = true;
+        txMeta.flushPartialPacket = i == callsCount - 1;
+        ASSERT_EQ(device.StreamTx(0, txSamples, samplesInCall, &txMeta), samplesInCall);
+        txTimestamp += samplesInCall;
+
+        // keep the Rx side drained, it provides the hardware time
+        ASSERT_EQ(device.StreamRx(0, rxSamples, rxBuffer.size(), &rxMeta), rxBuffer.size());
+    }
+
+    // every sample given to StreamTx() is interpolated into exactly that many link samples
+    const uint64_t expectedSamples = static_cast<uint64_t>(callsCount) * samplesInCall * interpolation;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (device.GetTxDMA()->GetTxStats().samples < expectedSamples && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    device.StreamStop(0);
+    device.StreamDestroy(0);
+
+    // lateness depends on the real time scheduling, only the timestamps continuity is checked
+    const SimulatedDMA::TxStats txDMAStats = device.GetTxDMA()->GetTxStats();
+    EXPECT_EQ(txDMAStats.samples, expectedSamples);
+    EXPECT_EQ(txDMAStats.discontinuities, 0u);
+}